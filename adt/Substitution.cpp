@@ -31,7 +31,7 @@ Substitution<T> Substitution<T>::Trivial;
 template <>
 std::string apply(const Substitution<std::string>& sub, const std::string& input)
 {
-    if (sub == Substitution<std::string>::Trivial)
+    if (sub == Substitution<std::string>::Trivial || sub.from().empty())
         return input;
 
     std::string substituted = input;
@@ -43,6 +43,28 @@ std::string apply(const Substitution<std::string>& sub, const std::string& input
     return substituted;
 }
 
+template <>
+std::string apply(const std::vector<Substitution<std::string>>& seq, const std::string& input)
+{
+    // Leftmost first; at the same position, the earliest in the sequence.
+    std::string substituted;
+    std::string::size_type pos = 0;
+    while (pos < input.size()) {
+        auto sub = seq.begin();
+        for (; sub != seq.end(); ++sub) {
+            if (!sub->from().empty() && !input.compare(pos, sub->from().size(), sub->from()))
+                break;
+        }
+        if (sub == seq.end()) {
+            substituted += input[pos++];
+            continue;
+        }
+        substituted += sub->to();
+        pos += sub->from().size();
+    }
+    return substituted;
+}
+
 template <>
 std::string applyOnce(const std::vector<Substitution<std::string>>& seq, const std::string& input)
 {
@@ -60,4 +82,10 @@ std::string applyOnce(const std::vector<Substitution<std::string>>& seq, const s
     return substituted;
 }
 
+template <>
+std::string applyOnce(const Substitution<std::string>& sub, const std::string& input)
+{
+    return applyOnce(std::vector<Substitution<std::string>>{ sub }, input);
+}
+
 } // namespace psyche
@@ -17,150 +17,410 @@
  * USA
  *****************************************************************************/
 
+
 #ifndef PSYCHE_VERSIONED_MAP_H__
 #define PSYCHE_VERSIONED_MAP_H__
 
-#include <algorithm>
+#include <cstddef>
 #include <cstdint>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <utility>
 #include <vector>
-#include <unordered_map>
 
 namespace psyche {
 
 /*!
  * A versioned map.
+ *
+ * Implemented as a persistent hash array mapped trie: every revision is an
+ * immutable root that shares all untouched nodes (and the entries themselves)
+ * with the revisions it derives from. Taking and applying a revision is O(1);
+ * an insertion copies only the path to its entry.
  */
-template <class KeyT, class ValueT>
+template <class KeyT, class ValueT, class HashT = std::hash<KeyT>>
 class VersionedMap
 {
+public:
+    using value_type = std::pair<const KeyT, ValueT>;
+
 private:
-    using BaseMap = std::unordered_map<KeyT, ValueT>;
+    struct Leaf
+    {
+        template <class V>
+        Leaf(std::size_t hash, const KeyT& key, V&& value)
+            : hash_(hash), entry_(key, std::forward<V>(value))
+        {}
+        std::size_t hash_;
+        value_type entry_;
+    };
+
+    struct Node;
+    using LeafPtr = std::shared_ptr<const Leaf>;
+    using NodePtr = std::shared_ptr<const Node>;
+
+    //! Either an entry or a subtrie.
+    struct Slot
+    {
+        LeafPtr leaf_;
+        NodePtr node_;
+    };
+
+    /*!
+     * A trie node, indexed by 5 bits of the hash at each level. Below the
+     * last level, a node is a plain list of colliding entries.
+     */
+    struct Node
+    {
+        std::uint32_t bitmap_ { 0 };
+        std::vector<Slot> slots_;
+    };
+
+    static constexpr unsigned kBits = 5;
+    static constexpr unsigned kHashBits = sizeof(std::size_t) * 8;
 
 public:
-    using iterator = typename BaseMap::iterator;
-    using const_iterator = typename BaseMap::const_iterator;
+    class const_iterator
+    {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = typename VersionedMap::value_type;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const value_type*;
+        using reference = const value_type&;
+
+        const_iterator() = default;
+
+        reference operator*() const { return slot().leaf_->entry_; }
+        pointer operator->() const { return &slot().leaf_->entry_; }
+
+        const_iterator& operator++();
+        const_iterator operator++(int) { auto it = *this; ++*this; return it; }
+
+        bool operator==(const const_iterator& other) const { return path_ == other.path_; }
+        bool operator!=(const const_iterator& other) const { return path_ != other.path_; }
 
-    VersionedMap() = default;
+    private:
+        friend class VersionedMap;
+
+        const Slot& slot() const { return path_.back().first->slots_[path_.back().second]; }
+        void descend();
+
+        //! Nodes from the root, with the slot taken in each (empty at the end).
+        std::vector<std::pair<const Node*, std::size_t>> path_;
+    };
+    using iterator = const_iterator;
+
+    VersionedMap() : roots_(1) {}
 
     void insertOrAssign(const KeyT& key, const ValueT& value);
     void insertOrAssign(const KeyT& key, ValueT&& value);
 
-    void applyRevision(uint32_t revision);
+    void applyRevision(uint32_t revision) { curRevision_ = revision; }
     uint32_t revision() const { return curRevision_; }
 
+    /*!
+     * Every insertion adds a revision, and a revision keeps its entries alive
+     * for as long as the map lives. Once only a few of them are still of use,
+     * drop all others: the given revisions (and the current one) are kept, and
+     * renumbered in place. Revision 0 remains the empty map.
+     */
+    void retainRevisions(std::vector<uint32_t>& revisions);
+    std::size_t revisionCount() const { return roots_.size(); }
+
+    std::size_t size() const { return roots_[curRevision_].size_; }
+    bool empty() const { return !size(); }
+
     // Basic traversal.
-    const_iterator begin() const { return map_.begin(); }
-    const_iterator end() const { return map_.end(); }
-    const_iterator cbegin() const { return map_.begin(); }
-    const_iterator cend() const { return map_.end(); }
-    const_iterator find(const KeyT& key) const { return map_.find(key); }
+    const_iterator begin() const;
+    const_iterator end() const { return const_iterator(); }
+    const_iterator cbegin() const { return begin(); }
+    const_iterator cend() const { return end(); }
+    const_iterator find(const KeyT& key) const { return find(key, curRevision_); }
+    const_iterator find(const KeyT& key, uint32_t revision) const;
+
+    /*!
+     * Visit the keys whose entries differ between two revisions, as in
+     * `visitor(key, valueInA, valueInB)`, with a null value for a key that is
+     * absent from a revision. Subtries shared by both revisions are skipped,
+     * so the cost is proportional to what changed since they diverged.
+     */
+    template <class VisitorT>
+    void diff(uint32_t revisionA, uint32_t revisionB, VisitorT visitor) const;
 
 private:
-    void insertOrAssignCore(const KeyT& key, const ValueT& value);
-    void insertOrAssignCore(const KeyT& key, ValueT&& value);
+    template <class V>
+    void insertOrAssignCore(const KeyT& key, V&& value);
 
-    // Encapsulates the action, as GoF's command pattern.
-    struct Command
-    {
-        enum OpCode
-        {
-            Insert,
-            Remove
-        };
-
-        Command(const KeyT& key, const ValueT& value, OpCode code)
-            : key_(key), value_(value), opCode_(code)
-        {}
-        const KeyT key_;
-        const ValueT value_;
-        OpCode opCode_;
-    };
+    static NodePtr insert(const Node* node, unsigned shift, LeafPtr leaf, bool& grown);
 
-    void storeCommand(const Command& command);
+    template <class VisitorT>
+    static void diffNodes(const Node* a, const Node* b, unsigned shift, VisitorT& visitor);
+    template <class VisitorT>
+    static void diffLeaves(const std::vector<const Leaf*>& a,
+                           const std::vector<const Leaf*>& b,
+                           VisitorT& visitor);
+    static void collect(const Leaf* leaf, const Node* node, std::vector<const Leaf*>& leaves);
 
-    //! Commands for each given revision.
-    std::vector<Command> commands_;
+    static std::size_t indexOf(std::uint32_t bitmap, std::uint32_t bit)
+    {
+        return __builtin_popcount(bitmap & (bit - 1));
+    }
+    static std::uint32_t bitOf(std::size_t hash, unsigned shift)
+    {
+        return 1u << ((hash >> shift) & ((1u << kBits) - 1));
+    }
 
-    //!@{
-    /*!
-     * Revisioning mechanism.
-     */
-    uint32_t curRevision_ { 0 };
-    uint32_t revisionCnt_ { 0 };
-    std::unordered_map<uint32_t, uint32_t> reverts_;
-    //!@}
+    struct Root
+    {
+        NodePtr node_;
+        std::size_t size_ { 0 };
+    };
 
-    //! The actual underlying map.
-    BaseMap map_;
+    //! The root of each revision; the first one is the empty map. Grows by
+    //! one per insertion, until retainRevisions is called.
+    std::vector<Root> roots_;
+    uint32_t curRevision_ { 0 };
 };
 
-template <class KeyT, class ValueT>
-void VersionedMap<KeyT, ValueT>::insertOrAssign(const KeyT& key,
-                                                const ValueT& value)
+template <class KeyT, class ValueT, class HashT>
+void VersionedMap<KeyT, ValueT, HashT>::insertOrAssign(const KeyT& key,
+                                                       const ValueT& value)
 {
-    storeCommand(Command(key, value, Command::Insert));
     insertOrAssignCore(key, value);
 }
 
-template <class KeyT, class ValueT>
-void VersionedMap<KeyT, ValueT>::insertOrAssignCore(const KeyT& key,
-                                                    const ValueT& value)
+template <class KeyT, class ValueT, class HashT>
+void VersionedMap<KeyT, ValueT, HashT>::insertOrAssign(const KeyT& key,
+                                                       ValueT&& value)
 {
-    map_[key] = value;
+    insertOrAssignCore(key, std::move(value));
 }
 
-template <class KeyT, class ValueT>
-void VersionedMap<KeyT, ValueT>::insertOrAssign(const KeyT& key,
-                                                ValueT&& value)
+template <class KeyT, class ValueT, class HashT>
+template <class V>
+void VersionedMap<KeyT, ValueT, HashT>::insertOrAssignCore(const KeyT& key,
+                                                           V&& value)
 {
-    storeCommand(Command(key, value, Command::Insert));
-    insertOrAssignCore(key, std::move(value));
+    // We don't require ValueT to have a default constructor (Range, for
+    // instance, doesn't have one, and this is by design).
+    auto leaf = std::make_shared<const Leaf>(HashT()(key), key, std::forward<V>(value));
+    const Root& cur = roots_[curRevision_];
+    bool grown = false;
+    Root root;
+    root.node_ = insert(cur.node_.get(), 0, std::move(leaf), grown);
+    root.size_ = cur.size_ + grown;
+    roots_.push_back(std::move(root));
+    curRevision_ = roots_.size() - 1;
+}
+
+template <class KeyT, class ValueT, class HashT>
+void VersionedMap<KeyT, ValueT, HashT>::retainRevisions(std::vector<uint32_t>& revisions)
+{
+    std::vector<uint32_t> renumbered(roots_.size(), 0);
+    std::vector<Root> kept(1);
+    auto keep = [&] (uint32_t& revision) {
+        if (revision && !renumbered[revision]) {
+            renumbered[revision] = kept.size();
+            kept.push_back(std::move(roots_[revision]));
+        }
+        revision = renumbered[revision];
+    };
+
+    keep(curRevision_);
+    for (auto& revision : revisions)
+        keep(revision);
+    roots_.swap(kept);
+}
+
+template <class KeyT, class ValueT, class HashT>
+auto VersionedMap<KeyT, ValueT, HashT>::insert(const Node* node,
+                                               unsigned shift,
+                                               LeafPtr leaf,
+                                               bool& grown) -> NodePtr
+{
+    auto copy = node ? std::make_shared<Node>(*node) : std::make_shared<Node>();
+
+    // Out of hash bits: a list of colliding entries.
+    if (shift >= kHashBits) {
+        for (auto& slot : copy->slots_) {
+            if (slot.leaf_->entry_.first == leaf->entry_.first) {
+                slot.leaf_ = std::move(leaf);
+                return copy;
+            }
+        }
+        copy->slots_.push_back(Slot{ std::move(leaf), nullptr });
+        grown = true;
+        return copy;
+    }
+
+    const auto bit = bitOf(leaf->hash_, shift);
+    const auto idx = indexOf(copy->bitmap_, bit);
+    if (!(copy->bitmap_ & bit)) {
+        copy->bitmap_ |= bit;
+        copy->slots_.insert(copy->slots_.begin() + idx, Slot{ std::move(leaf), nullptr });
+        grown = true;
+        return copy;
+    }
+
+    Slot& slot = copy->slots_[idx];
+    if (slot.node_) {
+        slot.node_ = insert(slot.node_.get(), shift + kBits, std::move(leaf), grown);
+    } else if (slot.leaf_->entry_.first == leaf->entry_.first) {
+        slot.leaf_ = std::move(leaf);
+    } else {
+        bool ignored;
+        auto sub = insert(nullptr, shift + kBits, std::move(slot.leaf_), ignored);
+        slot.node_ = insert(sub.get(), shift + kBits, std::move(leaf), grown);
+        slot.leaf_ = nullptr;
+    }
+    return copy;
+}
+
+template <class KeyT, class ValueT, class HashT>
+auto VersionedMap<KeyT, ValueT, HashT>::find(const KeyT& key,
+                                             uint32_t revision) const -> const_iterator
+{
+    const_iterator it;
+    const auto hash = HashT()(key);
+    const Node* node = roots_[revision].node_.get();
+    for (unsigned shift = 0; node; shift += kBits) {
+        std::size_t idx = 0;
+        if (shift >= kHashBits) {
+            while (idx < node->slots_.size() && !(node->slots_[idx].leaf_->entry_.first == key))
+                ++idx;
+            if (idx == node->slots_.size())
+                return end();
+        } else {
+            const auto bit = bitOf(hash, shift);
+            if (!(node->bitmap_ & bit))
+                return end();
+            idx = indexOf(node->bitmap_, bit);
+        }
+
+        it.path_.emplace_back(node, idx);
+        const Slot& slot = node->slots_[idx];
+        if (slot.leaf_)
+            return slot.leaf_->entry_.first == key ? it : end();
+        node = slot.node_.get();
+    }
+    return end();
 }
 
-template <class KeyT, class ValueT>
-void VersionedMap<KeyT, ValueT>::insertOrAssignCore(const KeyT& key,
-                                                    ValueT&& value)
+template <class KeyT, class ValueT, class HashT>
+auto VersionedMap<KeyT, ValueT, HashT>::begin() const -> const_iterator
 {
-    // We don't want to use operator[] because this would require ValueT to
-    // have a default constructor (Range, for instance, doesn't have one, and
-    // this is by design). C++17 has already insert_or_assign.
-    auto it = map_.find(key);
-    if (it != map_.end())
-        it->second = std::move(value);
-    else
-        map_.insert(std::make_pair(key, std::move(value)));
+    const_iterator it;
+    if (const Node* node = roots_[curRevision_].node_.get()) {
+        it.path_.emplace_back(node, 0);
+        it.descend();
+    }
+    return it;
 }
 
-template <class KeyT, class ValueT>
-void VersionedMap<KeyT, ValueT>::storeCommand(const Command& command)
+template <class KeyT, class ValueT, class HashT>
+void VersionedMap<KeyT, ValueT, HashT>::const_iterator::descend()
 {
-    commands_.push_back(command);
-    reverts_.insert(std::make_pair(++revisionCnt_, curRevision_));
-    curRevision_ = revisionCnt_;
+    while (const Node* node = slot().node_.get())
+        path_.emplace_back(node, 0);
 }
 
-template <class KeyT, class ValueT>
-void VersionedMap<KeyT, ValueT>::applyRevision(uint32_t revision)
+template <class KeyT, class ValueT, class HashT>
+auto VersionedMap<KeyT, ValueT, HashT>::const_iterator::operator++() -> const_iterator&
 {
-    std::vector<uint32_t> ordered;
-    auto it = reverts_.find(revision);
-    while (it != reverts_.end()) {
-        ordered.push_back(it->second);
-        it = reverts_.find(it->second);
+    while (!path_.empty() && ++path_.back().second == path_.back().first->slots_.size())
+        path_.pop_back();
+    if (!path_.empty())
+        descend();
+    return *this;
+}
+
+template <class KeyT, class ValueT, class HashT>
+template <class VisitorT>
+void VersionedMap<KeyT, ValueT, HashT>::diff(uint32_t revisionA,
+                                             uint32_t revisionB,
+                                             VisitorT visitor) const
+{
+    diffNodes(roots_[revisionA].node_.get(), roots_[revisionB].node_.get(), 0, visitor);
+}
+
+template <class KeyT, class ValueT, class HashT>
+template <class VisitorT>
+void VersionedMap<KeyT, ValueT, HashT>::diffNodes(const Node* a,
+                                                  const Node* b,
+                                                  unsigned shift,
+                                                  VisitorT& visitor)
+{
+    if (a == b)
+        return;
+
+    // Either side is empty or entries collide.
+    if (!a || !b || shift >= kHashBits) {
+        std::vector<const Leaf*> leavesA, leavesB;
+        collect(nullptr, a, leavesA);
+        collect(nullptr, b, leavesB);
+        diffLeaves(leavesA, leavesB, visitor);
+        return;
     }
 
-    curRevision_ = revision;
-    if (ordered.empty())
-        return; // Nothing to do.
-
-    std::reverse(ordered.begin(), ordered.end());
-    map_.clear();
-    for (auto current : ordered) {
-        const auto& command = commands_[current];
-        ValueT value = command.value_;
-        if (command.opCode_ == Command::Insert)
-            insertOrAssignCore(command.key_, std::move(value));
+    for (auto bits = a->bitmap_ | b->bitmap_; bits; bits &= bits - 1) {
+        const std::uint32_t bit = bits & (~bits + 1);
+        const Slot* slotA = (a->bitmap_ & bit) ? &a->slots_[indexOf(a->bitmap_, bit)] : nullptr;
+        const Slot* slotB = (b->bitmap_ & bit) ? &b->slots_[indexOf(b->bitmap_, bit)] : nullptr;
+        if (slotA && slotB && slotA->node_ && slotB->node_) {
+            diffNodes(slotA->node_.get(), slotB->node_.get(), shift + kBits, visitor);
+        } else if (!slotA || !slotB || slotA->leaf_ != slotB->leaf_) {
+            // At least one side is a single entry or missing.
+            std::vector<const Leaf*> leavesA, leavesB;
+            if (slotA)
+                collect(slotA->leaf_.get(), slotA->node_.get(), leavesA);
+            if (slotB)
+                collect(slotB->leaf_.get(), slotB->node_.get(), leavesB);
+            diffLeaves(leavesA, leavesB, visitor);
+        }
+    }
+}
+
+template <class KeyT, class ValueT, class HashT>
+template <class VisitorT>
+void VersionedMap<KeyT, ValueT, HashT>::diffLeaves(const std::vector<const Leaf*>& a,
+                                                   const std::vector<const Leaf*>& b,
+                                                   VisitorT& visitor)
+{
+    std::vector<bool> matched(b.size(), false);
+    for (const auto* leafA : a) {
+        std::size_t i = 0;
+        while (i < b.size() && !(b[i]->entry_.first == leafA->entry_.first))
+            ++i;
+        if (i == b.size()) {
+            visitor(leafA->entry_.first, &leafA->entry_.second, nullptr);
+            continue;
+        }
+        matched[i] = true;
+        if (b[i] != leafA)
+            visitor(leafA->entry_.first, &leafA->entry_.second, &b[i]->entry_.second);
+    }
+
+    for (std::size_t i = 0; i < b.size(); ++i) {
+        if (!matched[i])
+            visitor(b[i]->entry_.first, nullptr, &b[i]->entry_.second);
+    }
+}
+
+template <class KeyT, class ValueT, class HashT>
+void VersionedMap<KeyT, ValueT, HashT>::collect(const Leaf* leaf,
+                                                const Node* node,
+                                                std::vector<const Leaf*>& leaves)
+{
+    if (leaf) {
+        leaves.push_back(leaf);
+        return;
     }
+    if (!node)
+        return;
+    for (const auto& slot : node->slots_)
+        collect(slot.leaf_.get(), slot.node_.get(), leaves);
 }
 
 } // namespace psyche
@@ -31,7 +31,7 @@ namespace psyche {
 class Configuration
 {
 public:
-    Configuration() : bits_(0) {}
+    Configuration() : bits_(0), jobs_(1) {}
 
     struct Bits
     {
@@ -55,6 +55,27 @@ public:
 
         //! Whether to handle GNU's error function as a printf variety.
         uint32_t handleGNUerrorFunc_  : 1;
+
+          //!< Simplify the generated constraints (not yet checked against the solver).
+        uint32_t simplifyConstraints : 1;
+
+          //!< Write the constraints in the binary format.
+        uint32_t binaryConstraints : 1;
+
+          //!< Also write the constraints partitioned into independent shards.
+        uint32_t shardConstraints : 1;
+
+          //!< Write only the constraints related to unknown symbols and types.
+        uint32_t sliceConstraints : 1;
+
+          //!< Write the declarations in dependency order, along with their dependences.
+        uint32_t sortDecls : 1;
+
+          //!< Reuse, from the manifest of a previous run, the constraints of unchanged declarations.
+        uint32_t incremental : 1;
+
+          //!< Analyze the value ranges of the variables of each function.
+        uint32_t analyzeRanges : 1;
     };
     union
     {
@@ -62,6 +83,7 @@ public:
         uint32_t bits_;
     };
 
+    unsigned jobs_; //!< Threads for the per-function stages.
     std::string nativeCC_;
     std::string dialectName_;
     std::vector<std::string> macroDefs_;
@@ -22,9 +22,16 @@
 #include "ASTDotWriter.h"
 #include "ASTNormalizer.h"
 #include "BaseTester.h"
+#include "BinaryConstraintReader.h"
 #include "Binder.h"
+#include "BufferedConstraintWriter.h"
 #include "CompilerFacade.h"
+#include "ConstraintCache.h"
 #include "ConstraintGenerator.h"
+#include "ConstraintSharder.h"
+#include "ConstraintSimplifier.h"
+#include "ConstraintSlicer.h"
+#include "ConstraintSorter.h"
 #include "ConstraintWriter.h"
 #include "DeclarationInterceptor.h"
 #include "Debug.h"
@@ -36,13 +43,17 @@
 #include "Literals.h"
 #include "Plugin.h"
 #include "ProgramValidator.h"
+#include "RangeAnalysis.h"
 #include "SourceInspector.h"
 #include "Symbols.h"
 #include "cxxopts.hpp"
 
+#include <algorithm>
+#include <fstream>
 #include <iostream>
 #include <sstream>
 #include <cstring>
+#include <unistd.h>
 
 using namespace psyche;
 using namespace psyche;
@@ -84,7 +95,9 @@ void honorFlag(bool flag, std::function<void ()> f)
 Driver::Driver(const Factory& factory)
     : factory_(factory)
     , globalNs_(nullptr)
+    , generated_(false)
     , withGenerics_(true)
+    , fullPasses_(0)
 {}
 
 TranslationUnit *Driver::unit() const
@@ -115,6 +128,7 @@ void Driver::configure(const Configuration& config)
     control_.reset();
     globalNs_ = control_.newNamespace(0, nullptr);
     config_ = config;
+    fullPasses_ = 0;
 }
 
 std::string Driver::augmentSource(const std::string& source, const std::vector<std::string>& headers)
@@ -157,6 +171,15 @@ int Driver::process(int argc, char *argv[])
                 cxxopts::value<std::string>())
             ("no-heuristic", "Disable heuristics on unresolved syntax ambiguities")
             ("no-typedef", "Forbid typedef and struct/union declarations")
+            ("simplify", "Simplify the generated constraints (experimental)")
+            ("binary", "Write constraints in binary format")
+            ("shard", "Also write constraints partitioned into independent shards")
+            ("slice", "Emit only constraints related to undeclared identifiers and unresolved types")
+            ("sort-decls", "Emit declarations in dependency order, and their dependences in a .deps file")
+            ("j,jobs", "Categorize, analyze ranges of, and generate constraints of functions on the given number of threads",
+                cxxopts::value<unsigned>()->default_value("1"))
+            ("incremental", "Regenerate only the constraints of declarations changed since the last run, as kept in a .manifest file")
+            ("ranges", "Analyze the value ranges of the variables of each function, written to a .ranges file")
             ("cc", "Specify host C compiler",
                 cxxopts::value<std::string>()->default_value("gcc"))
             ("cc-std", "Specify C dialect",
@@ -209,7 +232,15 @@ int Driver::process(int argc, char *argv[])
     config.value_.displayStats = options.count("stats");
     config.value_.noHeuristics = options.count("no-heuristic");
     config.value_.noTypedef = options.count("no-typedef");
+    config.value_.simplifyConstraints = options.count("simplify");
+    config.value_.binaryConstraints = options.count("binary");
+    config.value_.shardConstraints = options.count("shard");
+    config.value_.sliceConstraints = options.count("slice");
+    config.value_.sortDecls = options.count("sort-decls");
+    config.value_.incremental = options.count("incremental");
+    config.value_.analyzeRanges = options.count("ranges");
     config.value_.handleGNUerrorFunc_ = true; // TODO: POSIX stuff?
+    config.jobs_ = std::max(1u, options["jobs"].as<unsigned>());
     config.nativeCC_ = options["cc"].as<std::string>();
     config.dialectName_ = options["cc-std"].as<std::string>();
     config.macroDefs_ = options["cc-D"].as<std::vector<std::string>>();
@@ -225,6 +256,11 @@ int Driver::process(int argc, char *argv[])
         }
     }
 
+    const std::string manifestName =
+            FileInfo(options["output"].as<std::string>()).fullFileBaseName() + ".manifest";
+    if (config.value_.incremental && std::ifstream(manifestName))
+        manifest_ = readFile(manifestName);
+
     const std::string& source = readFile(in);
     int code = 0;
     try {
@@ -235,13 +271,27 @@ int Driver::process(int argc, char *argv[])
 
     switch (code) {
     case Exit_OK:
-        if (!constraints_.empty()) {
+        if (generated_) {
             writeFile(options["output"].as<std::string>(), constraints_);
-            if (!includes_.empty()) {
-                FileInfo fi(options["output"].as<std::string>());
+            FileInfo fi(options["output"].as<std::string>());
+            if (!includes_.empty())
                 writeFile(fi.fullFileBaseName() + ".inc", includes_);
+            if (!dependences_.empty())
+                writeFile(fi.fullFileBaseName() + ".deps", dependences_);
+            if (!shards_.empty()) {
+                std::string manifest;
+                for (auto i = 0u; i < shards_.size(); ++i) {
+                    const auto shardName = fi.fullFileBaseName() + "." + std::to_string(i) + ".cstr";
+                    writeFile(shardName, shards_[i].constraints_);
+                    manifest += FileInfo(shardName).fileName() + " " + shards_[i].summary_ + "\n";
+                }
+                writeFile(fi.fullFileBaseName() + ".shards", manifest);
             }
+            if (config.value_.incremental)
+                writeFile(manifestName, manifest_);
         }
+        if (!ranges_.empty())
+            writeFile(FileInfo(options["output"].as<std::string>()).fullFileBaseName() + ".ranges", ranges_);
         break;
 
     case Exit_ParsingError_Internal:
@@ -274,13 +324,22 @@ int Driver::process(const std::string& unitName,
 
     collectIncludes(source);
 
+    int code;
     if (Plugin::isLoaded()) {
         SourceInspector* inspector = Plugin::createInspector();
         auto includes = inspector->identifyIncludes(source);
-        return preprocess(augmentSource(source, includes));
+        code = preprocess(augmentSource(source, includes));
+    } else {
+        code = parse(source);
     }
 
-    return parse(source);
+    honorFlag(config_.value_.displayStats,
+              [this] () {
+                  std::cout << "Traversal stats" << std::endl
+                            << "  Full-tree passes   : " << fullPasses_ << std::endl;
+              });
+
+    return code;
 }
 
 void Driver::collectIncludes(const std::string& source)
@@ -313,14 +372,26 @@ int Driver::parse(const std::string& source)
     if (!unit_->parse())
         return Exit_ParsingError_Internal;
 
+    honorFlag(config_.value_.displayStats,
+              [this] () {
+                  std::cout << "Parser stats" << std::endl << unit_->parseStats() << std::endl;
+              });
+
     if (!unit_->ast() || !ast())
         return Exit_ASTError_Internal;
 
     honorFlag(config_.value_.dumpAst,
-              [this] () { ASTDotWriter(unit()).write(ast(), ".ast.dot"); });
+              [this] () {
+                  ASTDotWriter(unit()).write(ast(), ".ast.dot");
+                  ++fullPasses_;
+              });
 
+    // Programs outside the supported mode are rejected before any symbol is created.
     ProgramValidator validator(unit(), config_.value_.noTypedef);
-    validator.validate(ast());
+    if (validator.checksRegistered()) {
+        validator.validate(ast());
+        ++fullPasses_;
+    }
 
     if (control_.diagnosticCollector()->seenBlockingIssue())
         return Exit_SyntaxError;
@@ -333,9 +404,11 @@ int Driver::annotateAST()
     // Create symbols.
     Binder bind(unit());
     bind(ast(), globalNs_);
+    ++fullPasses_;
 
     // Try to disambiguate syntax ambiguities and normalize the AST according to the resolutions.
     ASTNormalizer fixer(unit(), !config_.value_.noHeuristics);
+    ++fullPasses_;
     if (!fixer.normalize(ast()))
         return Exit_UnresolvedSyntaxAmbiguityError;
 
@@ -345,47 +418,109 @@ int Driver::annotateAST()
               });
 
     honorFlag(config_.value_.dumpAst,
-              [this] () { ASTDotWriter(unit()).write(ast(), ".ast.fixed.dot"); });
+              [this] () {
+                  ASTDotWriter(unit()).write(ast(), ".ast.fixed.dot");
+                  ++fullPasses_;
+              });
 
     if (config_.value_.disambOnly)
         return Exit_OK;
 
-    return withGenerics_
-                ? instantiateGenerics()
-                : generateConstraints();
+    if (withGenerics_)
+        return instantiateGenerics();
+
+    return analyze();
+}
+
+int Driver::analyze()
+{
+    if (config_.value_.analyzeRanges) {
+        int code = analyzeRanges();
+        if (code != Exit_OK)
+            return code;
+    }
+
+    return generateConstraints();
 }
 
 int Driver::instantiateGenerics()
 {
     GenericsInstantiatior instantiator(unit());
     bool r = instantiator.quantify(ast(), globalNs_);
+    ++fullPasses_;
     if (!r)
-        return generateConstraints();
+        return analyze();
 
-    auto origSource = readFile(unit()->fileName());
-    auto newSource = instantiator.instantiate(origSource);
+    // The instantiated source is plain C, already preprocessed (if it was at all).
+    auto newSource = instantiator.instantiate();
 
     writeFile(FileInfo(unit()->fileName()).fullFileBaseName() + ".poly", newSource);
 
     // Ignore generics in next pass.
     withGenerics_ = false;
-    config_.macroDefs_.push_back("_Template=");
-    config_.macroDefs_.push_back("'_Forall(v)=v'");
-    config_.macroDefs_.push_back("'_Exists(v)=v'");
 
-    return preprocess(newSource);
+    return parse(newSource);
+}
+
+int Driver::analyzeRanges()
+{
+    RangeAnalysis ranges(unit());
+    ranges.employThreads(config_.jobs_);
+    ranges.run(ast(), globalNs_);
+    ++fullPasses_;
+    honorFlag(config_.value_.displayStats,
+              [&ranges] () {
+                  std::cout << "Range analysis stats" << std::endl
+                            << ranges.stats() << std::endl;
+              });
+
+    std::ostringstream oss;
+    ranges.print(oss);
+    ranges_ = oss.str();
+
+    return Exit_OK;
 }
 
 int Driver::generateConstraints()
 {
     // Build domain lattice.
     DomainLattice lattice(unit());
+    lattice.employThreads(config_.jobs_);
     lattice.categorize(ast(), globalNs_);
+    ++fullPasses_;
+    honorFlag(config_.value_.displayStats,
+              [&lattice] () {
+                  std::cout << "Lattice stats" << std::endl
+                            << lattice.stats() << std::endl;
+              });
 
     std::ostringstream oss;
-    auto writer = factory_.makeConstraintWriter(oss);
+    const auto format = config_.value_.binaryConstraints ? ConstraintFormat::Binary
+                                                         : ConstraintFormat::BufferedText;
+    auto writer = factory_.makeConstraintWriter(oss, format);
+
+    std::unique_ptr<ConstraintSharder> sharder;
+    if (config_.value_.shardConstraints)
+        sharder = std::make_unique<ConstraintSharder>(writer.get());
+    ConstraintWriter* target = sharder ? sharder.get() : writer.get();
+
+    std::unique_ptr<ConstraintSorter> sorter;
+    if (config_.value_.sortDecls) {
+        sorter = std::make_unique<ConstraintSorter>(target);
+        target = sorter.get();
+    }
+
+    std::unique_ptr<ConstraintSlicer> slicer;
+    if (config_.value_.sliceConstraints) {
+        slicer = std::make_unique<ConstraintSlicer>(target);
+        target = slicer.get();
+    }
+
+    std::unique_ptr<ConstraintSimplifier> simplifier;
+    if (config_.value_.simplifyConstraints)
+        simplifier = std::make_unique<ConstraintSimplifier>(target);
 
-    ConstraintGenerator generator(unit(), writer.get());
+    ConstraintGenerator generator(unit(), simplifier ? simplifier.get() : target);
     generator.employDomainLattice(&lattice);
 
     if (Plugin::isLoaded()) {
@@ -395,12 +530,102 @@ int Driver::generateConstraints()
 
     if (config_.value_.handleGNUerrorFunc_)
         generator.addPrintfLike("error", 2);
+    generator.employThreads(config_.jobs_);
+
+    ConstraintCache cache;
+    if (config_.value_.incremental) {
+        cache.load(manifest_);
+        generator.employCache(&cache);
+    }
+
     generator.generate(ast(), globalNs_);
+    ++fullPasses_;
+
+    if (config_.value_.incremental) {
+        manifest_ = cache.save();
+        honorFlag(config_.value_.displayStats,
+                  [&cache] () {
+                      std::cout << "Cache stats" << std::endl
+                                << cache.stats() << std::endl;
+                  });
+    }
 
+    if (simplifier) {
+        simplifier->flush();
+        honorFlag(config_.value_.displayStats,
+                  [&simplifier] () {
+                      std::cout << "Simplifier stats" << std::endl
+                                << simplifier->stats() << std::endl;
+                  });
+    }
+
+    if (slicer) {
+        slicer->flush();
+        honorFlag(config_.value_.displayStats,
+                  [&slicer] () {
+                      std::cout << "Slicer stats" << std::endl
+                                << slicer->stats() << std::endl;
+                  });
+    }
+
+    if (sorter) {
+        sorter->flush();
+
+        // The header tells consumers that declarations come sorted; each line
+        // that follows has a declaration and, tab-separated, its dependences.
+        dependences_ = "sorted\n";
+        for (const auto& dep : sorter->dependences()) {
+            dependences_ += dep.decl_;
+            for (const auto& d : dep.deps_)
+                dependences_ += "\t" + d;
+            dependences_ += "\n";
+        }
+        honorFlag(config_.value_.displayStats,
+                  [&sorter] () {
+                      std::cout << "Sorter stats" << std::endl
+                                << sorter->stats() << std::endl;
+                  });
+    }
+
+    if (sharder) {
+        sharder->flush();
+        shards_.clear();
+        for (auto i = 0u; i < sharder->shardCount(); ++i) {
+            std::ostringstream shardOss;
+            auto shardWriter = factory_.makeConstraintWriter(shardOss, format);
+            sharder->writeShard(i, shardWriter.get());
+            shardWriter->sync();
+            Shard shard;
+            shard.constraints_ = shardOss.str();
+            shard.summary_ = std::to_string(shardWriter->totalConstraints());
+            for (const auto& sym : sharder->shardSymbols(i))
+                shard.summary_ += " " + sym;
+            shards_.push_back(std::move(shard));
+        }
+        honorFlag(config_.value_.displayStats,
+                  [&sharder] () {
+                      std::cout << "Sharder stats" << std::endl
+                                << sharder->stats() << std::endl;
+                  });
+    }
+
+    writer->sync();
     constraints_ = oss.str();
+    generated_ = true;
 
     honorFlag(config_.value_.displayConstraints,
-              [this] () { std::cout << constraints_ << std::endl; });
+              [this] () {
+                  if (!config_.value_.binaryConstraints) {
+                      std::cout << constraints_ << std::endl;
+                      return;
+                  }
+                  std::cout.flush();
+                  {
+                      BufferedConstraintWriter text(STDOUT_FILENO);
+                      BinaryConstraintReader(constraints_).replay(&text);
+                  }
+                  std::cout << std::endl;
+              });
 
     return Exit_OK;
 }
@@ -55,6 +55,7 @@ public:
                 const Configuration& config);
 
     const std::string& constraints() const { return constraints_; }
+    const std::string& ranges() const { return ranges_; }
 
     //! Exit code of successfull run.
     static constexpr int Exit_OK = 0;
@@ -87,6 +88,8 @@ private:
     int parse(const std::string& source);
     int annotateAST();
     int instantiateGenerics();
+    int analyze();
+    int analyzeRanges();
     int generateConstraints();
 
     const Factory& factory_; // TODO: Get rid of it.
@@ -95,11 +98,25 @@ private:
     Control control_;
     Namespace* globalNs_;
     std::unique_ptr<TranslationUnit> unit_;
+    bool generated_; //!< Whether constraints were generated (possibly none, as in a slice).
     std::string constraints_;
     std::string includes_;
+    std::string dependences_;
+    std::string manifest_; //!< Constraints of each declaration, for an incremental run.
+    std::string ranges_;
+
+    struct Shard
+    {
+        std::string constraints_;
+        std::string summary_; //!< Constraint count and top-level symbols, for the manifest.
+    };
+    std::vector<Shard> shards_;
     bool withGenerics_; // TODO: Integrate with config.
+    unsigned fullPasses_; // Walks over the entire AST, for stats.
 
+    friend class TestConstraintPartitioner;
     friend class TestDisambiguator;
+    friend class TestRangeAnalysis;
 };
 
 } // namespace psyche
@@ -17,15 +17,25 @@
  *****************************************************************************/
 
 #include "Factory.h"
+#include "BinaryConstraintWriter.h"
+#include "BufferedConstraintWriter.h"
 #include "ConstraintWriter.h"
 #include "DeclarationInterceptor.h"
 #include "VisitorObserver.h"
 
 using namespace psyche;
 
-std::unique_ptr<ConstraintWriter> Factory::makeConstraintWriter(std::ostream& os) const
+std::unique_ptr<ConstraintWriter> Factory::makeConstraintWriter(std::ostream& os,
+                                                               ConstraintFormat format) const
 {
-    return std::make_unique<ConstraintWriter>(os);
+    switch (format) {
+    case ConstraintFormat::BufferedText:
+        return std::make_unique<BufferedConstraintWriter>(os);
+    case ConstraintFormat::Binary:
+        return std::make_unique<BinaryConstraintWriter>(os);
+    default:
+        return std::make_unique<ConstraintWriter>(os);
+    }
 }
 
 std::unique_ptr<VisitorObserver> Factory::makeObserver() const
@@ -28,6 +28,16 @@ class ConstraintWriter;
 class DeclarationInterceptor;
 class VisitorObserver;
 
+/*!
+ * \brief The ConstraintFormat enum
+ */
+enum class ConstraintFormat : char
+{
+    Text,
+    BufferedText, //!< Same text, formatted into a buffer rather than on the stream.
+    Binary
+};
+
 /*!
  * \brief The Factory class
  */
@@ -36,7 +46,9 @@ class Factory
 public:
     virtual ~Factory() {}
 
-    virtual std::unique_ptr<ConstraintWriter> makeConstraintWriter(std::ostream& os) const;
+    virtual std::unique_ptr<ConstraintWriter> makeConstraintWriter(
+            std::ostream& os,
+            ConstraintFormat format = ConstraintFormat::Text) const;
     virtual std::unique_ptr<VisitorObserver> makeObserver() const;
     virtual std::unique_ptr<DeclarationInterceptor> makeInterceptor() const;
 };
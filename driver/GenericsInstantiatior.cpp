@@ -74,27 +74,139 @@ bool GenericsInstantiatior::quantify(AST* ast, Scope* scope)
     return true;
 }
 
-std::string GenericsInstantiatior::instantiate(const std::string& source) const
+std::string GenericsInstantiatior::instantiate() const
 {
-    std::string newSource = source;
+    TranslationUnit* unit = translationUnit();
+    const char* source = unit->firstSourceChar();
+
+    std::vector<const Edit*> edits;
+    for (const auto& edit : edits_)
+        edits.push_back(&edit);
+    std::sort(edits.begin(), edits.end(),
+              [] (const Edit* a, const Edit* b) { return a->first_ < b->first_; });
+
+    std::string newSource;
+    newSource.reserve(unit->sourceLength() + unit->sourceLength() / 2);
+
+    // The source, up to the end, with the tokens rewritten.
+    unsigned first = 1;
+    unsigned last = unit->tokenCount();
+    while (last > first && unit->tokenKind(last - 1) == T_EOF_SYMBOL)
+        --last;
+    if (first < last) {
+        newSource.append(source, unit->tokenAt(first).bytesBegin());
+        rewrite(first, last, edits, {}, newSource);
+        newSource.append(source + unit->tokenAt(last - 1).bytesEnd());
+    } else {
+        newSource.append(source, unit->sourceLength());
+    }
+
+    // The instances, in order of definition and of recognition.
+    for (auto func : genericFuncs_) {
+        const FunctionInstantions& instances = genericFuncsTbl_.at(func);
+        GenericsDeclarationAST* ast = instances.ast_;
+
+        // Recursive calls are renamed through the instance's own substitutions.
+        std::vector<const Edit*> funcEdits;
+        auto it = genericsEdits_.find(ast);
+        if (it != genericsEdits_.end()) {
+            for (const auto& p : it->second) {
+                if (p.first != func)
+                    funcEdits.push_back(&p.second);
+            }
+        }
 
-    for (const auto& variation : genericFuncsTbl_) {
-        GenericsDeclarationAST* ast = variation.second.ast_;
+        std::vector<const FunctionInstantions::Variation*> variations;
+        for (const auto& data : instances.overloads_)
+            variations.push_back(&data.second);
+        std::sort(variations.begin(), variations.end(),
+                  [] (const auto* a, const auto* b) { return a->label_ < b->label_; });
 
-        const std::string& funcText = translationUnit()->fetchSource(ast);
-        for (const auto& data : variation.second.overloads_) {
-            std::string newFuncText = funcText;
-            for (const auto& sub : data.second.subs_)
-                newFuncText = apply(sub, newFuncText);
-            newSource += newFuncText + "\n";
+        for (const auto* variation : variations) {
+            rewrite(ast->firstToken(), ast->lastToken(), funcEdits, variation->subs_, newSource);
+            newSource += "\n";
         }
     }
 
-    newSource = applyOnce(subs_, newSource);
-
     return newSource;
 }
 
+void GenericsInstantiatior::rewrite(unsigned first,
+                                    unsigned last,
+                                    const std::vector<const Edit*>& edits,
+                                    const std::vector<Substitution<std::string>>& subs,
+                                    std::string& out) const
+{
+    TranslationUnit* unit = translationUnit();
+    const char* source = unit->firstSourceChar();
+
+    auto editIt = edits.begin();
+    std::vector<unsigned> closings; // Parenthesis of quantified types.
+    for (auto i = first; i < last; ++i) {
+        const Token& tk = unit->tokenAt(i);
+        if (i > first) {
+            const Token& prevTk = unit->tokenAt(i - 1);
+            out.append(source + prevTk.bytesEnd(), tk.bytesBegin() - prevTk.bytesEnd());
+        }
+
+        while (editIt != edits.end() && (*editIt)->first_ < i)
+            ++editIt;
+        if (editIt != edits.end() && (*editIt)->first_ == i) {
+            out += (*editIt)->text_;
+            i = (*editIt)->last_ - 1;
+            ++editIt;
+            continue;
+        }
+
+        switch (tk.kind()) {
+        case T_PSYCHEC_TEMPLATE:
+            continue;
+
+        case T_PSYCHEC_FORALL:
+        case T_PSYCHEC_EXISTS:
+            if (unit->tokenKind(i + 1) == T_LPAREN) {
+                unsigned depth = 0;
+                for (auto j = i + 1; j < last; ++j) {
+                    if (unit->tokenKind(j) == T_LPAREN) {
+                        ++depth;
+                    } else if (unit->tokenKind(j) == T_RPAREN && !--depth) {
+                        closings.push_back(j);
+                        break;
+                    }
+                }
+                ++i;
+                continue;
+            }
+            break;
+
+        case T_RPAREN:
+            if (!closings.empty() && closings.back() == i) {
+                closings.pop_back();
+                continue;
+            }
+            break;
+
+        case T_IDENTIFIER: {
+            const Identifier* id = tk.identifier;
+            auto sub = std::find_if(subs.begin(), subs.end(), [id] (const auto& sub) {
+                return sub.from().size() == id->size()
+                        && !sub.from().compare(0, id->size(), id->chars(), id->size());
+            });
+            if (sub != subs.end()) {
+                out += sub->to();
+                continue;
+            }
+            break;
+        }
+
+        default:
+            break;
+        }
+
+        out.append(source + tk.bytesBegin(), tk.bytes());
+    }
+}
+
 int GenericsInstantiatior::recognize(Function* func,
                                      const std::vector<FullySpecifiedType>& argsTypes)
 {
@@ -112,7 +224,6 @@ int GenericsInstantiatior::recognize(Function* func,
 
         std::string funcName(func->name()->identifier()->chars());
         it->second.overloads_[key].subs_.emplace_back(funcName, funcName + std::to_string(cnt));
-        it->second.overloads_[key].subs_.emplace_back("_Template", "");
 
         int cntU = func->argumentCount();
         int cntE = argsTypes.size();
@@ -123,8 +234,6 @@ int GenericsInstantiatior::recognize(Function* func,
                 continue;
 
             auto tyU = typePP_.print(func->argumentAt(i)->asArgument()->type().coreType(), scope_);
-            it->second.overloads_[key].subs_.emplace_back("_Forall(" + tyU + ")", tyU);
-
             auto tyE = typePP_.print(argsTypes[i].coreType(), scope_);
             it->second.overloads_[key].subs_.emplace_back(tyU, tyE);
         }
@@ -141,10 +250,18 @@ Scope* GenericsInstantiatior::switchScope(Scope* scope)
     return scope;
 }
 
+void GenericsInstantiatior::edit(AST* ast, const std::string& text)
+{
+    Edit e { ast->firstToken(), ast->lastToken(), text };
+    if (genericsCtx_.empty())
+        edits_.push_back(e);
+    else
+        genericsEdits_[genericsCtx_.top()].emplace_back(nullptr, e);
+}
+
 bool GenericsInstantiatior::visit(GenericsDeclarationAST* ast)
 {
-    auto funcText = translationUnit()->fetchSource(ast);
-    subs_.emplace_back(funcText, "");
+    edit(ast, "");
 
     genericsCtx_.push(ast);
     accept(ast->declaration);
@@ -170,6 +287,8 @@ bool GenericsInstantiatior::visit(FunctionDefinitionAST* ast)
     if (func->isGeneric() && ast->function_body) {
         if (genericFuncsTbl_.find(func) != genericFuncsTbl_.end())
             translationUnit()->error(ast->firstToken(), "redefinition of generic function");
+        else
+            genericFuncs_.push_back(func);
         FunctionInstantions f(genericsCtx_.top());
         genericFuncsTbl_[func] = f;
     }
@@ -179,6 +298,11 @@ bool GenericsInstantiatior::visit(FunctionDefinitionAST* ast)
 
 bool GenericsInstantiatior::visit(SimpleDeclarationAST* ast)
 {
+    // Within a generic declaration, the quantified type is left for rewrite(),
+    // to be substituted as in each instance.
+    if (!genericsCtx_.empty())
+        return false;
+
     FullySpecifiedType coreTy;
     if (ast->symbols && ast->symbols->value->asDeclaration()) {
         Declaration* decl = ast->symbols->value->asDeclaration();
@@ -188,8 +312,7 @@ bool GenericsInstantiatior::visit(SimpleDeclarationAST* ast)
     for (SpecifierListAST *it = ast->decl_specifier_list; it; it = it->next) {
         if (it->value->asQuantifiedTypeSpecifier()) {
             QuantifiedTypeSpecifierAST* specifier = it->value->asQuantifiedTypeSpecifier();
-            subs_.emplace_back(translationUnit()->fetchSource(specifier),
-                               typePP_.print(coreTy, scope_));
+            edit(specifier, typePP_.print(coreTy, scope_));
         }
     }
 
@@ -232,8 +355,13 @@ bool GenericsInstantiatior::visit(CallAST* ast)
     int cnt = recognize(sym->asFunction(), argsTypes);
 
     std::string funcName(func->name()->identifier()->chars());
-    subs_.emplace_back(translationUnit()->fetchSource(ast->base_expression),
-                       funcName + std::to_string(cnt));
+    Edit e { ast->base_expression->firstToken(),
+             ast->base_expression->lastToken(),
+             funcName + std::to_string(cnt) };
+    if (genericsCtx_.empty())
+        edits_.push_back(e);
+    else
+        genericsEdits_[genericsCtx_.top()].emplace_back(func, e);
 
     return true;
 }
@@ -29,6 +29,7 @@
 #include <string>
 #include <unordered_map>
 #include <unordered_set>
+#include <utility>
 #include <vector>
 
 namespace psyche {
@@ -39,7 +40,18 @@ public:
     GenericsInstantiatior(TranslationUnit* unit);
 
     bool quantify(AST* ast, Scope* scope);
-    std::string instantiate(const std::string& source) const;
+
+    /*!
+     * \brief instantiate
+     * \return
+     *
+     * Rewrite the unit's source, token by token, in a single pass: generic
+     * declarations are removed, calls to generic functions are renamed after
+     * their instances, quantified types are replaced, and the instances of
+     * every generic function are appended. The generics keywords are elided,
+     * so the result is plain C, and doesn't need to be preprocessed again.
+     */
+    std::string instantiate() const;
 
 private:
     using Base = ASTVisitor;
@@ -53,7 +65,16 @@ private:
 
     int recognize(Function* func, const std::vector<FullySpecifiedType>& argsTypes);
 
-    std::vector<Substitution<std::string>> subs_;
+    // Replacement of the tokens in [first_, last_) by a text.
+    struct Edit
+    {
+        unsigned first_;
+        unsigned last_;
+        std::string text_;
+    };
+
+    std::vector<Edit> edits_;
+    void edit(AST* ast, const std::string& text);
 
     struct FunctionInstantions
     {
@@ -64,7 +85,7 @@ private:
         struct Variation
         {
             int label_;
-            std::vector<Substitution<std::string>> subs_;
+            std::vector<Substitution<std::string>> subs_; //!< Of identifiers.
         };
 
         GenericsDeclarationAST* ast_;
@@ -72,8 +93,18 @@ private:
     };
 
     std::unordered_map<Function*, FunctionInstantions> genericFuncsTbl_;
+    std::vector<Function*> genericFuncs_; //!< In order of definition.
     std::stack<GenericsDeclarationAST*> genericsCtx_;
 
+    // Edits within generic declarations, along with the function called (if a call).
+    std::unordered_map<GenericsDeclarationAST*, std::vector<std::pair<Function*, Edit>>> genericsEdits_;
+
+    void rewrite(unsigned first,
+                 unsigned last,
+                 const std::vector<const Edit*>& edits,
+                 const std::vector<Substitution<std::string>>& subs,
+                 std::string& out) const;
+
     // Declarations
     bool visit(GenericsDeclarationAST* ast) override;
     bool visit(FunctionDefinitionAST* ast) override;
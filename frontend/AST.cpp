@@ -28,7 +28,8 @@
 
 using namespace psyche;
 
-AST::AST()
+AST::AST(NodeKind kind)
+    : _nodeKind(kind)
 {}
 
 AST::~AST()
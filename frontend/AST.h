@@ -101,9 +101,24 @@ class CFE_API AST: public Managed
     void operator =(const AST& other) = delete;
 
 public:
-    AST();
+    /*!
+     * \brief The NodeKind enum
+     *
+     * The kind of a concrete AST node, fixed at construction. It allows the
+     * casts below to be a compare, instead of a virtual call, and a plain
+     * `switch' on the node, instead of a chain of casts.
+     */
+    enum class NodeKind : unsigned char
+    {
+#define PSYCHE_AST_NODE(NAME) NAME,
+#include "ASTNodes.inc"
+    };
+
+    AST(NodeKind kind);
     virtual ~AST();
 
+    NodeKind nodeKind() const { return _nodeKind; }
+
     void accept(ASTVisitor* visitor);
 
     static void accept(AST* ast, ASTVisitor* visitor)
@@ -143,148 +158,154 @@ public:
 
     virtual AST* clone(MemoryPool *pool) const = 0;
 
-    virtual AccessDeclarationAST* asAccessDeclaration() { return 0; }
-    virtual AliasDeclarationAST* asAliasDeclaration() { return 0; }
-    virtual AlignmentSpecifierAST* asAlignmentSpecifier() { return 0; }
-    virtual AlignofExpressionAST* asAlignofExpression() { return 0; }
-    virtual AmbiguousStatementAST* asAmbiguousStatement() { return 0; }
-    virtual EmptyNameAST* asEmptyName() { return 0; }
-    virtual ArrayAccessAST* asArrayAccess() { return 0; }
-    virtual ArrayDeclaratorAST* asArrayDeclarator() { return 0; }
-    virtual ArrayInitializerAST* asArrayInitializer() { return 0; }
-    virtual AsmDefinitionAST* asAsmDefinition() { return 0; }
+    inline AccessDeclarationAST* asAccessDeclaration();
+    inline AliasDeclarationAST* asAliasDeclaration();
+    inline AlignmentSpecifierAST* asAlignmentSpecifier();
+    inline AlignofExpressionAST* asAlignofExpression();
+    inline AmbiguousStatementAST* asAmbiguousStatement();
+    inline EmptyNameAST* asEmptyName();
+    inline ArrayAccessAST* asArrayAccess();
+    inline ArrayDeclaratorAST* asArrayDeclarator();
+    inline ArrayInitializerAST* asArrayInitializer();
+    inline AsmDefinitionAST* asAsmDefinition();
     virtual AttributeSpecifierAST* asAttributeSpecifier() { return 0; }
-    virtual BaseSpecifierAST* asBaseSpecifier() { return 0; }
-    virtual BinaryExpressionAST* asBinaryExpression() { return 0; }
-    virtual BitfieldDeclaratorAST* asBitfieldDeclarator() { return 0; }
-    virtual BoolLiteralAST* asBoolLiteral() { return 0; }
-    virtual BracedInitializerAST* asBracedInitializer() { return 0; }
-    virtual BracketDesignatorAST* asBracketDesignator() { return 0; }
-    virtual BreakStatementAST* asBreakStatement() { return 0; }
-    virtual CallAST* asCall() { return 0; }
-    virtual CaptureAST* asCapture() { return 0; }
-    virtual CaseStatementAST* asCaseStatement() { return 0; }
-    virtual CastExpressionAST* asCastExpression() { return 0; }
-    virtual CatchClauseAST* asCatchClause() { return 0; }
-    virtual ClassSpecifierAST* asClassSpecifier() { return 0; }
-    virtual CompoundExpressionAST* asCompoundExpression() { return 0; }
-    virtual CompoundLiteralAST* asCompoundLiteral() { return 0; }
-    virtual CompoundStatementAST* asCompoundStatement() { return 0; }
-    virtual ConditionAST* asCondition() { return 0; }
-    virtual ConditionalExpressionAST* asConditionalExpression() { return 0; }
-    virtual ContinueStatementAST* asContinueStatement() { return 0; }
-    virtual ConversionFunctionIdAST* asConversionFunctionId() { return 0; }
+    inline BaseSpecifierAST* asBaseSpecifier();
+    inline BinaryExpressionAST* asBinaryExpression();
+    inline BitfieldDeclaratorAST* asBitfieldDeclarator();
+    inline BoolLiteralAST* asBoolLiteral();
+    inline BracedInitializerAST* asBracedInitializer();
+    inline BracketDesignatorAST* asBracketDesignator();
+    inline BreakStatementAST* asBreakStatement();
+    inline CallAST* asCall();
+    inline CaptureAST* asCapture();
+    inline CaseStatementAST* asCaseStatement();
+    inline CastExpressionAST* asCastExpression();
+    inline CatchClauseAST* asCatchClause();
+    inline ClassSpecifierAST* asClassSpecifier();
+    inline CompoundExpressionAST* asCompoundExpression();
+    inline CompoundLiteralAST* asCompoundLiteral();
+    inline CompoundStatementAST* asCompoundStatement();
+    inline ConditionAST* asCondition();
+    inline ConditionalExpressionAST* asConditionalExpression();
+    inline ContinueStatementAST* asContinueStatement();
+    inline ConversionFunctionIdAST* asConversionFunctionId();
     virtual CoreDeclaratorAST* asCoreDeclarator() { return 0; }
-    virtual CppCastExpressionAST* asCppCastExpression() { return 0; }
-    virtual CtorInitializerAST* asCtorInitializer() { return 0; }
+    inline CppCastExpressionAST* asCppCastExpression();
+    inline CtorInitializerAST* asCtorInitializer();
     virtual DeclarationAST* asDeclaration() { return 0; }
-    virtual DeclarationStatementAST* asDeclarationStatement() { return 0; }
-    virtual DeclaratorAST* asDeclarator() { return 0; }
-    virtual DeclaratorIdAST* asDeclaratorId() { return 0; }
-    virtual DecltypeSpecifierAST* asDecltypeSpecifier() { return 0; }
-    virtual DeleteExpressionAST* asDeleteExpression() { return 0; }
-    virtual DesignatedInitializerAST* asDesignatedInitializer() { return 0; }
+    inline DeclarationStatementAST* asDeclarationStatement();
+    inline DeclaratorAST* asDeclarator();
+    inline DeclaratorIdAST* asDeclaratorId();
+    inline DecltypeSpecifierAST* asDecltypeSpecifier();
+    inline DeleteExpressionAST* asDeleteExpression();
+    inline DesignatedInitializerAST* asDesignatedInitializer();
     virtual DesignatorAST* asDesignator() { return 0; }
-    virtual DestructorNameAST* asDestructorName() { return 0; }
-    virtual DoStatementAST* asDoStatement() { return 0; }
-    virtual DotDesignatorAST* asDotDesignator() { return 0; }
-    virtual DynamicExceptionSpecificationAST* asDynamicExceptionSpecification() { return 0; }
-    virtual TaggedNameAST* asTaggedName() { return 0; }
-    virtual ElaboratedTypeSpecifierAST* asElaboratedTypeSpecifier() { return 0; }
-    virtual EmptyDeclarationAST* asEmptyDeclaration() { return 0; }
-    virtual EnumSpecifierAST* asEnumSpecifier() { return 0; }
-    virtual EnumeratorAST* asEnumerator() { return 0; }
-    virtual ExceptionDeclarationAST* asExceptionDeclaration() { return 0; }
+    inline DestructorNameAST* asDestructorName();
+    inline DoStatementAST* asDoStatement();
+    inline DotDesignatorAST* asDotDesignator();
+    inline DynamicExceptionSpecificationAST* asDynamicExceptionSpecification();
+    inline TaggedNameAST* asTaggedName();
+    inline ElaboratedTypeSpecifierAST* asElaboratedTypeSpecifier();
+    inline EmptyDeclarationAST* asEmptyDeclaration();
+    inline EnumSpecifierAST* asEnumSpecifier();
+    inline EnumeratorAST* asEnumerator();
+    inline ExceptionDeclarationAST* asExceptionDeclaration();
     virtual ExceptionSpecificationAST* asExceptionSpecification() { return 0; }
     virtual ExpressionAST* asExpression() { return 0; }
-    virtual ExpressionListParenAST* asExpressionListParen() { return 0; }
-    virtual ExpressionOrDeclarationStatementAST* asExpressionOrDeclarationStatement() { return 0; }
-    virtual ExpressionStatementAST* asExpressionStatement() { return 0; }
-    virtual ForStatementAST* asForStatement() { return 0; }
-    virtual ForeachStatementAST* asForeachStatement() { return 0; }
-    virtual FunctionDeclaratorAST* asFunctionDeclarator() { return 0; }
-    virtual FunctionDefinitionAST* asFunctionDefinition() { return 0; }
-    virtual GenericsDeclarationAST* asGenericsDeclaration() { return 0; }
-    virtual GnuAttributeAST* asGnuAttribute() { return 0; }
-    virtual GnuAttributeSpecifierAST* asGnuAttributeSpecifier() { return 0; }
-    virtual GotoStatementAST* asGotoStatement() { return 0; }
-    virtual IdExpressionAST* asIdExpression() { return 0; }
-    virtual IfStatementAST* asIfStatement() { return 0; }
-    virtual LabeledStatementAST* asLabeledStatement() { return 0; }
-    virtual LambdaCaptureAST* asLambdaCapture() { return 0; }
-    virtual LambdaDeclaratorAST* asLambdaDeclarator() { return 0; }
-    virtual LambdaExpressionAST* asLambdaExpression() { return 0; }
-    virtual LambdaIntroducerAST* asLambdaIntroducer() { return 0; }
-    virtual LinkageBodyAST* asLinkageBody() { return 0; }
-    virtual LinkageSpecificationAST* asLinkageSpecification() { return 0; }
-    virtual MemInitializerAST* asMemInitializer() { return 0; }
-    virtual MemberAccessAST* asMemberAccess() { return 0; }
+    inline ExpressionListParenAST* asExpressionListParen();
+    inline ExpressionOrDeclarationStatementAST* asExpressionOrDeclarationStatement();
+    inline ExpressionStatementAST* asExpressionStatement();
+    inline ForStatementAST* asForStatement();
+    inline ForeachStatementAST* asForeachStatement();
+    inline FunctionDeclaratorAST* asFunctionDeclarator();
+    inline FunctionDefinitionAST* asFunctionDefinition();
+    inline GenericsDeclarationAST* asGenericsDeclaration();
+    inline GnuAttributeAST* asGnuAttribute();
+    inline GnuAttributeSpecifierAST* asGnuAttributeSpecifier();
+    inline GotoStatementAST* asGotoStatement();
+    inline IdExpressionAST* asIdExpression();
+    inline IfStatementAST* asIfStatement();
+    inline LabeledStatementAST* asLabeledStatement();
+    inline LambdaCaptureAST* asLambdaCapture();
+    inline LambdaDeclaratorAST* asLambdaDeclarator();
+    inline LambdaExpressionAST* asLambdaExpression();
+    inline LambdaIntroducerAST* asLambdaIntroducer();
+    inline LinkageBodyAST* asLinkageBody();
+    inline LinkageSpecificationAST* asLinkageSpecification();
+    inline MemInitializerAST* asMemInitializer();
+    inline MemberAccessAST* asMemberAccess();
     virtual NameAST* asName() { return 0; }
-    virtual NamedTypeSpecifierAST* asNamedTypeSpecifier() { return 0; }
-    virtual NamespaceAST* asNamespace() { return 0; }
-    virtual NamespaceAliasDefinitionAST* asNamespaceAliasDefinition() { return 0; }
-    virtual NestedDeclaratorAST* asNestedDeclarator() { return 0; }
-    virtual NestedExpressionAST* asNestedExpression() { return 0; }
-    virtual NestedNameSpecifierAST* asNestedNameSpecifier() { return 0; }
-    virtual NewArrayDeclaratorAST* asNewArrayDeclarator() { return 0; }
-    virtual NewExpressionAST* asNewExpression() { return 0; }
-    virtual NewTypeIdAST* asNewTypeId() { return 0; }
-    virtual NoExceptOperatorExpressionAST* asNoExceptOperatorExpression() { return 0; }
-    virtual NoExceptSpecificationAST* asNoExceptSpecification() { return 0; }
-    virtual NumericLiteralAST* asNumericLiteral() { return 0; }
-    virtual OperatorAST* asOperator() { return 0; }
-    virtual OperatorFunctionIdAST* asOperatorFunctionId() { return 0; }
-    virtual ParameterDeclarationAST* asParameterDeclaration() { return 0; }
-    virtual ParameterDeclarationClauseAST* asParameterDeclarationClause() { return 0; }
-    virtual PointerAST* asPointer() { return 0; }
-    virtual PointerLiteralAST* asPointerLiteral() { return 0; }
-    virtual PointerToMemberAST* asPointerToMember() { return 0; }
-    virtual PostIncrDecrAST* asPostIncrDecr() { return 0; }
+    inline NamedTypeSpecifierAST* asNamedTypeSpecifier();
+    inline NamespaceAST* asNamespace();
+    inline NamespaceAliasDefinitionAST* asNamespaceAliasDefinition();
+    inline NestedDeclaratorAST* asNestedDeclarator();
+    inline NestedExpressionAST* asNestedExpression();
+    inline NestedNameSpecifierAST* asNestedNameSpecifier();
+    inline NewArrayDeclaratorAST* asNewArrayDeclarator();
+    inline NewExpressionAST* asNewExpression();
+    inline NewTypeIdAST* asNewTypeId();
+    inline NoExceptOperatorExpressionAST* asNoExceptOperatorExpression();
+    inline NoExceptSpecificationAST* asNoExceptSpecification();
+    inline NumericLiteralAST* asNumericLiteral();
+    inline OperatorAST* asOperator();
+    inline OperatorFunctionIdAST* asOperatorFunctionId();
+    inline ParameterDeclarationAST* asParameterDeclaration();
+    inline ParameterDeclarationClauseAST* asParameterDeclarationClause();
+    inline PointerAST* asPointer();
+    inline PointerLiteralAST* asPointerLiteral();
+    inline PointerToMemberAST* asPointerToMember();
+    inline PostIncrDecrAST* asPostIncrDecr();
     virtual PostfixAST* asPostfix() { return 0; }
     virtual PostfixDeclaratorAST* asPostfixDeclarator() { return 0; }
     virtual PtrOperatorAST* asPtrOperator() { return 0; }
-    virtual QualifiedNameAST* asQualifiedName() { return 0; }
-    virtual QuantifiedTypeSpecifierAST* asQuantifiedTypeSpecifier() { return 0; }
-    virtual RangeBasedForStatementAST* asRangeBasedForStatement() { return 0; }
-    virtual ReferenceAST* asReference() { return 0; }
-    virtual ReturnStatementAST* asReturnStatement() { return 0; }
-    virtual SimpleDeclarationAST* asSimpleDeclaration() { return 0; }
-    virtual SimpleNameAST* asSimpleName() { return 0; }
-    virtual SimpleSpecifierAST* asSimpleSpecifier() { return 0; }
-    virtual SizeofExpressionAST* asSizeofExpression() { return 0; }
+    inline QualifiedNameAST* asQualifiedName();
+    inline QuantifiedTypeSpecifierAST* asQuantifiedTypeSpecifier();
+    inline RangeBasedForStatementAST* asRangeBasedForStatement();
+    inline ReferenceAST* asReference();
+    inline ReturnStatementAST* asReturnStatement();
+    inline SimpleDeclarationAST* asSimpleDeclaration();
+    inline SimpleNameAST* asSimpleName();
+    inline SimpleSpecifierAST* asSimpleSpecifier();
+    inline SizeofExpressionAST* asSizeofExpression();
     virtual SpecifierAST* asSpecifier() { return 0; }
     virtual StatementAST* asStatement() { return 0; }
-    virtual StaticAssertDeclarationAST* asStaticAssertDeclaration() { return 0; }
-    virtual StringLiteralAST* asStringLiteral() { return 0; }
-    virtual SwitchStatementAST* asSwitchStatement() { return 0; }
-    virtual TemplateDeclarationAST* asTemplateDeclaration() { return 0; }
-    virtual TemplateIdAST* asTemplateId() { return 0; }
-    virtual TemplateTypeParameterAST* asTemplateTypeParameter() { return 0; }
-    virtual ThisExpressionAST* asThisExpression() { return 0; }
-    virtual ThrowExpressionAST* asThrowExpression() { return 0; }
-    virtual TrailingReturnTypeAST* asTrailingReturnType() { return 0; }
-    virtual TranslationUnitAST* asTranslationUnit() { return 0; }
-    virtual TryBlockStatementAST* asTryBlockStatement() { return 0; }
-    virtual TypeConstructorCallAST* asTypeConstructorCall() { return 0; }
-    virtual TypeIdAST* asTypeId() { return 0; }
-    virtual TypeidExpressionAST* asTypeidExpression() { return 0; }
-    virtual TypenameCallExpressionAST* asTypenameCallExpression() { return 0; }
-    virtual TypenameTypeParameterAST* asTypenameTypeParameter() { return 0; }
-    virtual TypeofSpecifierAST* asTypeofSpecifier() { return 0; }
-    virtual UnaryExpressionAST* asUnaryExpression() { return 0; }
-    virtual UsingAST* asUsing() { return 0; }
-    virtual UsingDirectiveAST* asUsingDirective() { return 0; }
-    virtual WhileStatementAST* asWhileStatement() { return 0; }
+    inline StaticAssertDeclarationAST* asStaticAssertDeclaration();
+    inline StringLiteralAST* asStringLiteral();
+    inline SwitchStatementAST* asSwitchStatement();
+    inline TemplateDeclarationAST* asTemplateDeclaration();
+    inline TemplateIdAST* asTemplateId();
+    inline TemplateTypeParameterAST* asTemplateTypeParameter();
+    inline ThisExpressionAST* asThisExpression();
+    inline ThrowExpressionAST* asThrowExpression();
+    inline TrailingReturnTypeAST* asTrailingReturnType();
+    inline TranslationUnitAST* asTranslationUnit();
+    inline TryBlockStatementAST* asTryBlockStatement();
+    inline TypeConstructorCallAST* asTypeConstructorCall();
+    inline TypeIdAST* asTypeId();
+    inline TypeidExpressionAST* asTypeidExpression();
+    inline TypenameCallExpressionAST* asTypenameCallExpression();
+    inline TypenameTypeParameterAST* asTypenameTypeParameter();
+    inline TypeofSpecifierAST* asTypeofSpecifier();
+    inline UnaryExpressionAST* asUnaryExpression();
+    inline UsingAST* asUsing();
+    inline UsingDirectiveAST* asUsingDirective();
+    inline WhileStatementAST* asWhileStatement();
 
 protected:
     virtual void accept0(ASTVisitor* visitor) = 0;
     virtual bool match0(AST* , ASTMatcher *) = 0;
+
+    friend class ASTTraversal;
+
+private:
+    NodeKind _nodeKind;
 };
 
 class CFE_API StatementAST: public AST
 {
 public:
-    StatementAST()
+    StatementAST(NodeKind kind)
+        : AST(kind)
     {}
 
     virtual StatementAST* asStatement() { return this; }
@@ -295,7 +316,8 @@ public:
 class CFE_API ExpressionAST: public AST
 {
 public:
-    ExpressionAST()
+    ExpressionAST(NodeKind kind)
+        : AST(kind)
     {}
 
     virtual ExpressionAST* asExpression() { return this; }
@@ -306,7 +328,8 @@ public:
 class CFE_API DeclarationAST: public AST
 {
 public:
-    DeclarationAST()
+    DeclarationAST(NodeKind kind)
+        : AST(kind)
     {}
 
     virtual DeclarationAST* asDeclaration() { return this; }
@@ -320,8 +343,9 @@ public: // annotations
     const Name* name;
 
 public:
-    NameAST()
-        : name(0)
+    NameAST(NodeKind kind)
+        : AST(kind)
+        , name(0)
     {}
 
     virtual NameAST* asName() { return this; }
@@ -332,7 +356,8 @@ public:
 class CFE_API SpecifierAST: public AST
 {
 public:
-    SpecifierAST()
+    SpecifierAST(NodeKind kind)
+        : AST(kind)
     {}
 
     virtual SpecifierAST* asSpecifier() { return this; }
@@ -343,7 +368,8 @@ public:
 class CFE_API PtrOperatorAST: public AST
 {
 public:
-    PtrOperatorAST()
+    PtrOperatorAST(NodeKind kind)
+        : AST(kind)
     {}
 
     virtual PtrOperatorAST* asPtrOperator() { return this; }
@@ -354,7 +380,8 @@ public:
 class CFE_API PostfixAST: public ExpressionAST
 {
 public:
-    PostfixAST()
+    PostfixAST(NodeKind kind)
+        : ExpressionAST(kind)
     {}
 
     virtual PostfixAST* asPostfix() { return this; }
@@ -365,7 +392,8 @@ public:
 class CFE_API CoreDeclaratorAST: public AST
 {
 public:
-    CoreDeclaratorAST()
+    CoreDeclaratorAST(NodeKind kind)
+        : AST(kind)
     {}
 
     virtual CoreDeclaratorAST* asCoreDeclarator() { return this; }
@@ -376,7 +404,8 @@ public:
 class CFE_API PostfixDeclaratorAST: public AST
 {
 public:
-    PostfixDeclaratorAST()
+    PostfixDeclaratorAST(NodeKind kind)
+        : AST(kind)
     {}
 
     virtual PostfixDeclaratorAST* asPostfixDeclarator() { return this; }
@@ -391,10 +420,10 @@ public:
 
 public:
     SimpleSpecifierAST()
-        : specifier_token(0)
+        : SpecifierAST(NodeKind::SimpleSpecifier)
+        , specifier_token(0)
     {}
 
-    virtual SimpleSpecifierAST* asSimpleSpecifier() { return this; }
 
     virtual unsigned firstToken() const;
     virtual unsigned lastToken() const;
@@ -409,7 +438,8 @@ protected:
 class CFE_API AttributeSpecifierAST: public SpecifierAST
 {
 public:
-    AttributeSpecifierAST()
+    AttributeSpecifierAST(NodeKind kind)
+        : SpecifierAST(kind)
     {}
 
     virtual AttributeSpecifierAST* asAttributeSpecifier() { return this; }
@@ -428,14 +458,14 @@ public:
 
 public:
     AlignmentSpecifierAST()
-        : align_token(0)
+        : AttributeSpecifierAST(NodeKind::AlignmentSpecifier)
+        , align_token(0)
         , lparen_token(0)
         , typeIdExprOrAlignmentExpr(0)
         , ellipses_token(0)
         , rparen_token(0)
     {}
 
-    virtual AlignmentSpecifierAST* asAlignmentSpecifier() { return this; }
 
     virtual unsigned firstToken() const;
     virtual unsigned lastToken() const;
@@ -454,11 +484,11 @@ public:
     DeclarationAST* declaration;
 
     GenericsDeclarationAST()
-        : generics_token(0)
+        : DeclarationAST(NodeKind::GenericsDeclaration)
+        , generics_token(0)
         , declaration(0)
     {}
 
-    virtual GenericsDeclarationAST* asGenericsDeclaration() { return this; }
 
     virtual unsigned firstToken() const;
     virtual unsigned lastToken() const;
@@ -482,7 +512,8 @@ public:
 
 public:
     GnuAttributeSpecifierAST()
-        : attribute_token(0)
+        : AttributeSpecifierAST(NodeKind::GnuAttributeSpecifier)
+        , attribute_token(0)
         , first_lparen_token(0)
         , second_lparen_token(0)
         , attribute_list(0)
@@ -490,7 +521,6 @@ public:
         , second_rparen_token(0)
     {}
 
-    virtual GnuAttributeSpecifierAST* asGnuAttributeSpecifier() { return this; }
 
     virtual unsigned firstToken() const;
     virtual unsigned lastToken() const;
@@ -513,14 +543,14 @@ public:
 
 public:
     GnuAttributeAST()
-        : identifier_token(0)
+        : AST(NodeKind::GnuAttribute)
+        , identifier_token(0)
         , lparen_token(0)
         , tag_token(0)
         , expression_list(0)
         , rparen_token(0)
     {}
 
-    virtual GnuAttributeAST* asGnuAttribute() { return this; }
 
     virtual unsigned firstToken() const;
     virtual unsigned lastToken() const;
@@ -542,13 +572,13 @@ public:
 
 public:
     TypeofSpecifierAST()
-        : typeof_token(0)
+        : SpecifierAST(NodeKind::TypeofSpecifier)
+        , typeof_token(0)
         , lparen_token(0)
         , expression(0)
         , rparen_token(0)
     {}
 
-    virtual TypeofSpecifierAST* asTypeofSpecifier() { return this; }
 
     virtual unsigned firstToken() const;
     virtual unsigned lastToken() const;
@@ -570,13 +600,13 @@ public:
 
 public:
     DecltypeSpecifierAST()
-        : decltype_token(0)
+        : SpecifierAST(NodeKind::DecltypeSpecifier)
+        , decltype_token(0)
         , lparen_token(0)
         , expression(0)
         , rparen_token(0)
     {}
 
-    virtual DecltypeSpecifierAST* asDecltypeSpecifier() { return this; }
 
     virtual unsigned firstToken() const;
     virtual unsigned lastToken() const;
@@ -601,7 +631,8 @@ public:
 
 public:
     DeclaratorAST()
-        : attribute_list(0)
+        : AST(NodeKind::Declarator)
+        , attribute_list(0)
         , ptr_operator_list(0)
         , core_declarator(0)
         , postfix_declarator_list(0)
@@ -610,7 +641,6 @@ public:
         , initializer(0)
     {}
 
-    virtual DeclaratorAST* asDeclarator() { return this; }
 
     virtual unsigned firstToken() const;
     virtual unsigned lastToken() const;
@@ -634,13 +664,13 @@ public:
 
 public:
     SimpleDeclarationAST()
-        : decl_specifier_list(0)
+        : DeclarationAST(NodeKind::SimpleDeclaration)
+        , decl_specifier_list(0)
         , declarator_list(0)
         , semicolon_token(0)
         , symbols(0)
     {}
 
-    virtual SimpleDeclarationAST* asSimpleDeclaration() { return this; }
 
     virtual unsigned firstToken() const;
     virtual unsigned lastToken() const;
@@ -659,10 +689,10 @@ public:
 
 public:
     EmptyDeclarationAST()
-        : semicolon_token(0)
+        : DeclarationAST(NodeKind::EmptyDeclaration)
+        , semicolon_token(0)
     {}
 
-    virtual EmptyDeclarationAST* asEmptyDeclaration() { return this; }
 
     virtual unsigned firstToken() const;
     virtual unsigned lastToken() const;
@@ -683,12 +713,12 @@ public:
 
 public:
     AccessDeclarationAST()
-        : access_specifier_token(0)
+        : DeclarationAST(NodeKind::AccessDeclaration)
+        , access_specifier_token(0)
         , slots_token(0)
         , colon_token(0)
     {}
 
-    virtual AccessDeclarationAST* asAccessDeclaration() { return this; }
 
     virtual unsigned firstToken() const;
     virtual unsigned lastToken() const;
@@ -713,7 +743,8 @@ public:
 
 public:
     AsmDefinitionAST()
-        : asm_token(0)
+        : DeclarationAST(NodeKind::AsmDefinition)
+        , asm_token(0)
         , qualifier_token(0)
         , lparen_token(0)
         , string_literal(0)
@@ -721,7 +752,6 @@ public:
         , semicolon_token(0)
     {}
 
-    virtual AsmDefinitionAST* asAsmDefinition() { return this; }
 
     virtual unsigned firstToken() const;
     virtual unsigned lastToken() const;
@@ -746,14 +776,14 @@ public: // annotations
 
 public:
     BaseSpecifierAST()
-        : virtual_token(0)
+        : AST(NodeKind::BaseSpecifier)
+        , virtual_token(0)
         , access_specifier_token(0)
         , name(0)
         , ellipsis_token(0)
         , symbol(0)
     {}
 
-    virtual BaseSpecifierAST* asBaseSpecifier() { return this; }
 
     virtual unsigned firstToken() const;
     virtual unsigned lastToken() const;
@@ -772,10 +802,10 @@ public:
 
 public:
     IdExpressionAST()
-        : name(0)
+        : ExpressionAST(NodeKind::IdExpression)
+        , name(0)
     {}
 
-    virtual IdExpressionAST* asIdExpression() { return this; }
 
     virtual unsigned firstToken() const;
     virtual unsigned lastToken() const;
@@ -796,12 +826,12 @@ public:
 
 public:
     CompoundExpressionAST()
-        : lparen_token(0)
+        : ExpressionAST(NodeKind::CompoundExpression)
+        , lparen_token(0)
         , statement(0)
         , rparen_token(0)
     {}
 
-    virtual CompoundExpressionAST* asCompoundExpression() { return this; }
 
     virtual unsigned firstToken() const;
     virtual unsigned lastToken() const;
@@ -823,13 +853,13 @@ public:
 
 public:
     CompoundLiteralAST()
-        : lparen_token(0)
+        : ExpressionAST(NodeKind::CompoundLiteral)
+        , lparen_token(0)
         , type_id(0)
         , rparen_token(0)
         , initializer(0)
     {}
 
-    virtual CompoundLiteralAST* asCompoundLiteral() { return this; }
 
     virtual unsigned firstToken() const;
     virtual unsigned lastToken() const;
@@ -850,12 +880,12 @@ public:
 
 public:
     BinaryExpressionAST()
-        : left_expression(0)
+        : ExpressionAST(NodeKind::BinaryExpression)
+        , left_expression(0)
         , binary_op_token(0)
         , right_expression(0)
     {}
 
-    virtual BinaryExpressionAST* asBinaryExpression() { return this; }
 
     virtual unsigned firstToken() const;
     virtual unsigned lastToken() const;
@@ -880,13 +910,13 @@ public: // annotations
 
 public:
     CastExpressionAST()
-        : lparen_token(0)
+        : ExpressionAST(NodeKind::CastExpression)
+        , lparen_token(0)
         , type_id(0)
         , rparen_token(0)
         , expression(0)
     {}
 
-    virtual CastExpressionAST* asCastExpression() { return this; }
 
     virtual unsigned firstToken() const;
     virtual unsigned lastToken() const;
@@ -917,7 +947,8 @@ public: // annotations
 
 public:
     ClassSpecifierAST()
-        : classkey_token(0)
+        : SpecifierAST(NodeKind::ClassSpecifier)
+        , classkey_token(0)
         , attribute_list(0)
         , name(0)
         , final_token(0)
@@ -930,7 +961,6 @@ public:
         , symbol(0)
     {}
 
-    virtual ClassSpecifierAST* asClassSpecifier() { return this; }
 
     virtual unsigned firstToken() const;
     virtual unsigned lastToken() const;
@@ -952,13 +982,13 @@ public:
 
 public:
     CaseStatementAST()
-        : case_token(0)
+        : StatementAST(NodeKind::CaseStatement)
+        , case_token(0)
         , expression(0)
         , colon_token(0)
         , statement(0)
     {}
 
-    virtual CaseStatementAST* asCaseStatement() { return this; }
 
     virtual unsigned firstToken() const;
     virtual unsigned lastToken() const;
@@ -982,13 +1012,13 @@ public: // annotations
 
 public:
     CompoundStatementAST()
-        : lbrace_token(0)
+        : StatementAST(NodeKind::CompoundStatement)
+        , lbrace_token(0)
         , statement_list(0)
         , rbrace_token(0)
         , symbol(0)
     {}
 
-    virtual CompoundStatementAST* asCompoundStatement() { return this; }
 
     virtual unsigned firstToken() const;
     virtual unsigned lastToken() const;
@@ -1008,11 +1038,11 @@ public:
 
 public:
     ConditionAST()
-        : type_specifier_list(0)
+        : ExpressionAST(NodeKind::Condition)
+        , type_specifier_list(0)
         , declarator(0)
     {}
 
-    virtual ConditionAST* asCondition() { return this; }
 
     virtual unsigned firstToken() const;
     virtual unsigned lastToken() const;
@@ -1035,14 +1065,14 @@ public:
 
 public:
     ConditionalExpressionAST()
-        : condition(0)
+        : ExpressionAST(NodeKind::ConditionalExpression)
+        , condition(0)
         , question_token(0)
         , left_expression(0)
         , colon_token(0)
         , right_expression(0)
     {}
 
-    virtual ConditionalExpressionAST* asConditionalExpression() { return this; }
 
     virtual unsigned firstToken() const;
     virtual unsigned lastToken() const;
@@ -1067,7 +1097,8 @@ public:
 
 public:
     CppCastExpressionAST()
-        : cast_token(0)
+        : ExpressionAST(NodeKind::CppCastExpression)
+        , cast_token(0)
         , less_token(0)
         , type_id(0)
         , greater_token(0)
@@ -1076,7 +1107,6 @@ public:
         , rparen_token(0)
     {}
 
-    virtual CppCastExpressionAST* asCppCastExpression() { return this; }
 
     virtual unsigned firstToken() const;
     virtual unsigned lastToken() const;
@@ -1097,12 +1127,12 @@ public:
 
 public:
     CtorInitializerAST()
-        : colon_token(0)
+        : AST(NodeKind::CtorInitializer)
+        , colon_token(0)
         , member_initializer_list(0)
         , dot_dot_dot_token(0)
     {}
 
-    virtual CtorInitializerAST* asCtorInitializer() { return this; }
 
     virtual unsigned firstToken() const;
     virtual unsigned lastToken() const;
@@ -1121,10 +1151,10 @@ public:
 
 public:
     DeclarationStatementAST()
-        : declaration(0)
+        : StatementAST(NodeKind::DeclarationStatement)
+        , declaration(0)
     {}
 
-    virtual DeclarationStatementAST* asDeclarationStatement() { return this; }
 
     virtual unsigned firstToken() const;
     virtual unsigned lastToken() const;
@@ -1144,11 +1174,11 @@ public:
 
 public:
     DeclaratorIdAST()
-        : dot_dot_dot_token(0)
+        : CoreDeclaratorAST(NodeKind::DeclaratorId)
+        , dot_dot_dot_token(0)
         , name(0)
     {}
 
-    virtual DeclaratorIdAST* asDeclaratorId() { return this; }
 
     virtual unsigned firstToken() const;
     virtual unsigned lastToken() const;
@@ -1169,12 +1199,12 @@ public:
 
 public:
     NestedDeclaratorAST()
-        : lparen_token(0)
+        : CoreDeclaratorAST(NodeKind::NestedDeclarator)
+        , lparen_token(0)
         , declarator(0)
         , rparen_token(0)
     {}
 
-    virtual NestedDeclaratorAST* asNestedDeclarator() { return this; }
 
     virtual unsigned firstToken() const;
     virtual unsigned lastToken() const;
@@ -1193,10 +1223,10 @@ public:
 
 public:
     BitfieldDeclaratorAST()
-        : colon_token(0)
+        : PostfixDeclaratorAST(NodeKind::BitfieldDeclarator)
+        , colon_token(0)
     {}
 
-    virtual BitfieldDeclaratorAST* asBitfieldDeclarator() { return this; }
 
     virtual unsigned firstToken() const;
     virtual unsigned lastToken() const;
@@ -1227,7 +1257,8 @@ public: // annotations
 
 public:
     FunctionDeclaratorAST()
-        : lparen_token(0)
+        : PostfixDeclaratorAST(NodeKind::FunctionDeclarator)
+        , lparen_token(0)
         , parameter_declaration_clause(0)
         , rparen_token(0)
         , psychec_omission_token(0)
@@ -1239,7 +1270,6 @@ public:
         , symbol(0)
     {}
 
-    virtual FunctionDeclaratorAST* asFunctionDeclarator() { return this; }
 
     virtual unsigned firstToken() const;
     virtual unsigned lastToken() const;
@@ -1260,12 +1290,12 @@ public:
 
 public:
     ArrayDeclaratorAST()
-        : lbracket_token(0)
+        : PostfixDeclaratorAST(NodeKind::ArrayDeclarator)
+        , lbracket_token(0)
         , expression(0)
         , rbracket_token(0)
     {}
 
-    virtual ArrayDeclaratorAST* asArrayDeclarator() { return this; }
 
     virtual unsigned firstToken() const;
     virtual unsigned lastToken() const;
@@ -1288,14 +1318,14 @@ public:
 
 public:
     DeleteExpressionAST()
-        : scope_token(0)
+        : ExpressionAST(NodeKind::DeleteExpression)
+        , scope_token(0)
         , delete_token(0)
         , lbracket_token(0)
         , rbracket_token(0)
         , expression(0)
     {}
 
-    virtual DeleteExpressionAST* asDeleteExpression() { return this; }
 
     virtual unsigned firstToken() const;
     virtual unsigned lastToken() const;
@@ -1320,7 +1350,8 @@ public:
 
 public:
     DoStatementAST()
-        : do_token(0)
+        : StatementAST(NodeKind::DoStatement)
+        , do_token(0)
         , statement(0)
         , while_token(0)
         , lparen_token(0)
@@ -1329,7 +1360,6 @@ public:
         , semicolon_token(0)
     {}
 
-    virtual DoStatementAST* asDoStatement() { return this; }
 
     virtual unsigned firstToken() const;
     virtual unsigned lastToken() const;
@@ -1348,10 +1378,10 @@ public:
 
 public:
     NamedTypeSpecifierAST()
-        : name(0)
+        : SpecifierAST(NodeKind::NamedTypeSpecifier)
+        , name(0)
     {}
 
-    virtual NamedTypeSpecifierAST* asNamedTypeSpecifier() { return this; }
 
     virtual unsigned firstToken() const;
     virtual unsigned lastToken() const;
@@ -1371,11 +1401,11 @@ public:
 
 public:
     ElaboratedTypeSpecifierAST()
-        : attribute_list(0)
+        : SpecifierAST(NodeKind::ElaboratedTypeSpecifier)
+        , attribute_list(0)
         , name(0)
     {}
 
-    virtual ElaboratedTypeSpecifierAST* asElaboratedTypeSpecifier() { return this; }
 
     virtual unsigned firstToken() const;
     virtual unsigned lastToken() const;
@@ -1405,7 +1435,8 @@ public: // annotations
 
 public:
     EnumSpecifierAST()
-        : enum_token(0)
+        : SpecifierAST(NodeKind::EnumSpecifier)
+        , enum_token(0)
         , key_token(0)
         , name(0)
         , colon_token(0)
@@ -1417,7 +1448,6 @@ public:
         , symbol(0)
     {}
 
-    virtual EnumSpecifierAST* asEnumSpecifier() { return this; }
 
     virtual unsigned firstToken() const;
     virtual unsigned lastToken() const;
@@ -1439,13 +1469,13 @@ public:
 
 public:
     EnumeratorAST()
-        : identifier_token(0)
+        : AST(NodeKind::Enumerator)
+        , identifier_token(0)
         , attribute_list(0)
         , equal_token(0)
         , expression(0)
     {}
 
-    virtual EnumeratorAST* asEnumerator() { return this; }
 
     virtual unsigned firstToken() const;
     virtual unsigned lastToken() const;
@@ -1466,12 +1496,12 @@ public:
 
 public:
     ExceptionDeclarationAST()
-        : type_specifier_list(0)
+        : DeclarationAST(NodeKind::ExceptionDeclaration)
+        , type_specifier_list(0)
         , declarator(0)
         , dot_dot_dot_token(0)
     {}
 
-    virtual ExceptionDeclarationAST* asExceptionDeclaration() { return this; }
 
     virtual unsigned firstToken() const;
     virtual unsigned lastToken() const;
@@ -1486,7 +1516,8 @@ protected:
 class CFE_API ExceptionSpecificationAST: public AST
 {
 public:
-    ExceptionSpecificationAST()
+    ExceptionSpecificationAST(NodeKind kind)
+        : AST(kind)
     {}
 
     virtual ExceptionSpecificationAST* asExceptionSpecification() { return this; }
@@ -1505,14 +1536,14 @@ public:
 
 public:
     DynamicExceptionSpecificationAST()
-        : throw_token(0)
+        : ExceptionSpecificationAST(NodeKind::DynamicExceptionSpecification)
+        , throw_token(0)
         , lparen_token(0)
         , dot_dot_dot_token(0)
         , type_id_list(0)
         , rparen_token(0)
     {}
 
-    virtual DynamicExceptionSpecificationAST* asDynamicExceptionSpecification() { return this; }
 
     virtual unsigned firstToken() const;
     virtual unsigned lastToken() const;
@@ -1534,13 +1565,13 @@ public:
 
 public:
     NoExceptSpecificationAST()
-        : noexcept_token(0)
+        : ExceptionSpecificationAST(NodeKind::NoExceptSpecification)
+        , noexcept_token(0)
         , lparen_token(0)
         , expression(0)
         , rparen_token(0)
     {}
 
-    virtual NoExceptSpecificationAST* asNoExceptSpecification() { return this; }
 
     virtual unsigned firstToken() const;
     virtual unsigned lastToken() const;
@@ -1560,11 +1591,11 @@ public:
 
 public:
     ExpressionOrDeclarationStatementAST()
-        : expression(0)
+        : StatementAST(NodeKind::ExpressionOrDeclarationStatement)
+        , expression(0)
         , declaration(0)
     {}
 
-    virtual ExpressionOrDeclarationStatementAST* asExpressionOrDeclarationStatement() { return this; }
 
     virtual unsigned firstToken() const;
     virtual unsigned lastToken() const;
@@ -1584,11 +1615,11 @@ public:
 
 public:
     ExpressionStatementAST()
-        : expression(0)
+        : StatementAST(NodeKind::ExpressionStatement)
+        , expression(0)
         , semicolon_token(0)
     {}
 
-    virtual ExpressionStatementAST* asExpressionStatement() { return this; }
 
     virtual unsigned firstToken() const;
     virtual unsigned lastToken() const;
@@ -1610,11 +1641,11 @@ public:
 
 public:
     AmbiguousStatementAST()
-        : declarationStmt(0)
+        : StatementAST(NodeKind::AmbiguousStatement)
+        , declarationStmt(0)
         , expressionStmt(0)
     {}
 
-    virtual AmbiguousStatementAST* asAmbiguousStatement() { return this; }
 
     virtual unsigned firstToken() const;
     virtual unsigned lastToken() const;
@@ -1639,14 +1670,14 @@ public: // annotations
 
 public:
     FunctionDefinitionAST()
-        : decl_specifier_list(0)
+        : DeclarationAST(NodeKind::FunctionDefinition)
+        , decl_specifier_list(0)
         , declarator(0)
         , ctor_initializer(0)
         , function_body(0)
         , symbol(0)
     {}
 
-    virtual FunctionDefinitionAST* asFunctionDefinition() { return this; }
 
     virtual unsigned firstToken() const;
     virtual unsigned lastToken() const;
@@ -1678,7 +1709,8 @@ public: // annotations
 
 public:
     ForeachStatementAST()
-        : foreach_token(0)
+        : StatementAST(NodeKind::ForeachStatement)
+        , foreach_token(0)
         , lparen_token(0)
         , type_specifier_list(0)
         , declarator(0)
@@ -1690,7 +1722,6 @@ public:
         , symbol(0)
     {}
 
-    virtual ForeachStatementAST* asForeachStatement() { return this; }
 
     virtual unsigned firstToken() const;
     virtual unsigned lastToken() const;
@@ -1721,7 +1752,8 @@ public: // annotations
 
 public:
     RangeBasedForStatementAST()
-        : for_token(0)
+        : StatementAST(NodeKind::RangeBasedForStatement)
+        , for_token(0)
         , lparen_token(0)
         , type_specifier_list(0)
         , declarator(0)
@@ -1732,7 +1764,6 @@ public:
         , symbol(0)
     {}
 
-    virtual RangeBasedForStatementAST* asRangeBasedForStatement() { return this; }
 
     virtual unsigned firstToken() const;
     virtual unsigned lastToken() const;
@@ -1761,7 +1792,8 @@ public: // annotations
 
 public:
     ForStatementAST()
-        : for_token(0)
+        : StatementAST(NodeKind::ForStatement)
+        , for_token(0)
         , lparen_token(0)
         , initializer(0)
         , condition(0)
@@ -1772,7 +1804,6 @@ public:
         , symbol(0)
     {}
 
-    virtual ForStatementAST* asForStatement() { return this; }
 
     virtual unsigned firstToken() const;
     virtual unsigned lastToken() const;
@@ -1800,7 +1831,8 @@ public: // annotations
 
 public:
     IfStatementAST()
-        : if_token(0)
+        : StatementAST(NodeKind::IfStatement)
+        , if_token(0)
         , lparen_token(0)
         , condition(0)
         , rparen_token(0)
@@ -1810,7 +1842,6 @@ public:
         , symbol(0)
     {}
 
-    virtual IfStatementAST* asIfStatement() { return this; }
 
     virtual unsigned firstToken() const;
     virtual unsigned lastToken() const;
@@ -1831,12 +1862,12 @@ public:
 
 public:
     ArrayInitializerAST()
-        : lbrace_token(0)
+        : ExpressionAST(NodeKind::ArrayInitializer)
+        , lbrace_token(0)
         , expression_list(0)
         , rbrace_token(0)
     {}
 
-    virtual ArrayInitializerAST* asArrayInitializer() { return this; }
 
     virtual unsigned firstToken() const;
     virtual unsigned lastToken() const;
@@ -1857,12 +1888,12 @@ public:
 
 public:
     LabeledStatementAST()
-        : label_token(0)
+        : StatementAST(NodeKind::LabeledStatement)
+        , label_token(0)
         , colon_token(0)
         , statement(0)
     {}
 
-    virtual LabeledStatementAST* asLabeledStatement() { return this; }
 
     virtual unsigned firstToken() const;
     virtual unsigned lastToken() const;
@@ -1883,12 +1914,12 @@ public:
 
 public:
     LinkageBodyAST()
-        : lbrace_token(0)
+        : DeclarationAST(NodeKind::LinkageBody)
+        , lbrace_token(0)
         , declaration_list(0)
         , rbrace_token(0)
     {}
 
-    virtual LinkageBodyAST* asLinkageBody() { return this; }
     virtual unsigned firstToken() const;
     virtual unsigned lastToken() const;
 
@@ -1908,12 +1939,12 @@ public:
 
 public:
     LinkageSpecificationAST()
-        : extern_token(0)
+        : DeclarationAST(NodeKind::LinkageSpecification)
+        , extern_token(0)
         , extern_type_token(0)
         , declaration(0)
     {}
 
-    virtual LinkageSpecificationAST* asLinkageSpecification() { return this; }
 
     virtual unsigned firstToken() const;
     virtual unsigned lastToken() const;
@@ -1934,11 +1965,11 @@ public:
 
 public:
     MemInitializerAST()
-        : name(0)
+        : AST(NodeKind::MemInitializer)
+        , name(0)
         , expression(0)
     {}
 
-    virtual MemInitializerAST* asMemInitializer() { return this; }
 
     virtual unsigned firstToken() const;
     virtual unsigned lastToken() const;
@@ -1958,11 +1989,11 @@ public:
 
 public:
     NestedNameSpecifierAST()
-        : class_or_namespace_name(0)
+        : AST(NodeKind::NestedNameSpecifier)
+        , class_or_namespace_name(0)
         , scope_token(0)
     {}
 
-    virtual NestedNameSpecifierAST* asNestedNameSpecifier() { return this; }
 
     virtual unsigned firstToken() const;
     virtual unsigned lastToken() const;
@@ -1983,12 +2014,12 @@ public:
 
 public:
     QualifiedNameAST()
-        : global_scope_token(0)
+        : NameAST(NodeKind::QualifiedName)
+        , global_scope_token(0)
         , nested_name_specifier_list(0)
         , unqualified_name(0)
     {}
 
-    virtual QualifiedNameAST* asQualifiedName() { return this; }
 
     virtual unsigned firstToken() const;
     virtual unsigned lastToken() const;
@@ -2010,13 +2041,13 @@ public:
 
 public:
     QuantifiedTypeSpecifierAST()
-        : quantifier_token(0)
+        : SpecifierAST(NodeKind::QuantifiedTypeSpecifier)
+        , quantifier_token(0)
         , lparen_token(0)
         , name(0)
         , rparen_token(0)
     {}
 
-    virtual QuantifiedTypeSpecifierAST* asQuantifiedTypeSpecifier() { return this; }
 
     virtual unsigned firstToken() const;
     virtual unsigned lastToken() const;
@@ -2036,11 +2067,11 @@ public:
 
 public:
     TaggedNameAST()
-        : tag_token(0)
+        : NameAST(NodeKind::TaggedName)
+        , tag_token(0)
         , core_name(0)
     {}
 
-    virtual TaggedNameAST* asTaggedName() { return this; }
 
     virtual unsigned firstToken() const;
     virtual unsigned lastToken() const;
@@ -2060,11 +2091,11 @@ public:
 
 public:
     OperatorFunctionIdAST()
-        : operator_token(0)
+        : NameAST(NodeKind::OperatorFunctionId)
+        , operator_token(0)
         , op(0)
     {}
 
-    virtual OperatorFunctionIdAST* asOperatorFunctionId() { return this; }
 
     virtual unsigned firstToken() const;
     virtual unsigned lastToken() const;
@@ -2085,12 +2116,12 @@ public:
 
 public:
     ConversionFunctionIdAST()
-        : operator_token(0)
+        : NameAST(NodeKind::ConversionFunctionId)
+        , operator_token(0)
         , type_specifier_list(0)
         , ptr_operator_list(0)
     {}
 
-    virtual ConversionFunctionIdAST* asConversionFunctionId() { return this; }
 
     virtual unsigned firstToken() const;
     virtual unsigned lastToken() const;
@@ -2106,9 +2137,9 @@ class CFE_API EmptyNameAST: public NameAST
 {
 public:
     EmptyNameAST()
+        : NameAST(NodeKind::EmptyName)
     {}
 
-    virtual EmptyNameAST* asEmptyName() { return this; }
     virtual unsigned firstToken() const { return 0; }
     virtual unsigned lastToken() const { return 0; }
 
@@ -2126,10 +2157,10 @@ public:
 
 public:
     SimpleNameAST()
-        : identifier_token(0)
+        : NameAST(NodeKind::SimpleName)
+        , identifier_token(0)
     {}
 
-    virtual SimpleNameAST* asSimpleName() { return this; }
 
     virtual unsigned firstToken() const;
     virtual unsigned lastToken() const;
@@ -2149,11 +2180,11 @@ public:
 
 public:
     DestructorNameAST()
-        : tilde_token(0)
+        : NameAST(NodeKind::DestructorName)
+        , tilde_token(0)
         , unqualified_name(0)
     {}
 
-    virtual DestructorNameAST* asDestructorName() { return this; }
 
     virtual unsigned firstToken() const;
     virtual unsigned lastToken() const;
@@ -2176,14 +2207,14 @@ public:
 
 public:
     TemplateIdAST()
-        : template_token(0)
+        : NameAST(NodeKind::TemplateId)
+        , template_token(0)
         , identifier_token(0)
         , less_token(0)
         , template_argument_list(0)
         , greater_token(0)
     {}
 
-    virtual TemplateIdAST* asTemplateId() { return this; }
 
     virtual unsigned firstToken() const;
     virtual unsigned lastToken() const;
@@ -2209,7 +2240,8 @@ public: // annotations
 
 public:
     NamespaceAST()
-        : inline_token(0)
+        : DeclarationAST(NodeKind::Namespace)
+        , inline_token(0)
         , namespace_token(0)
         , identifier_token(0)
         , attribute_list(0)
@@ -2217,7 +2249,6 @@ public:
         , symbol(0)
     {}
 
-    virtual NamespaceAST* asNamespace() { return this; }
 
     virtual unsigned firstToken() const;
     virtual unsigned lastToken() const;
@@ -2240,14 +2271,14 @@ public:
 
 public:
     NamespaceAliasDefinitionAST()
-        : namespace_token(0)
+        : DeclarationAST(NodeKind::NamespaceAliasDefinition)
+        , namespace_token(0)
         , namespace_name_token(0)
         , equal_token(0)
         , name(0)
         , semicolon_token(0)
     {}
 
-    virtual NamespaceAliasDefinitionAST* asNamespaceAliasDefinition() { return this; }
 
     virtual unsigned firstToken() const;
     virtual unsigned lastToken() const;
@@ -2273,7 +2304,8 @@ public: // annotations
 
 public:
     AliasDeclarationAST()
-        : using_token(0)
+        : DeclarationAST(NodeKind::AliasDeclaration)
+        , using_token(0)
         , name(0)
         , equal_token(0)
         , typeId(0)
@@ -2281,7 +2313,6 @@ public:
         , symbol(0)
     {}
 
-    virtual AliasDeclarationAST* asAliasDeclaration() { return this; }
 
     virtual unsigned firstToken() const;
     virtual unsigned lastToken() const;
@@ -2302,12 +2333,12 @@ public:
 
 public:
     ExpressionListParenAST()
-        : lparen_token(0)
+        : ExpressionAST(NodeKind::ExpressionListParen)
+        , lparen_token(0)
         , expression_list(0)
         , rparen_token(0)
     {}
 
-    virtual ExpressionListParenAST* asExpressionListParen() { return this; }
 
     virtual unsigned firstToken() const;
     virtual unsigned lastToken() const;
@@ -2328,12 +2359,12 @@ public:
 
 public:
     NewArrayDeclaratorAST()
-        : lbracket_token(0)
+        : AST(NodeKind::NewArrayDeclarator)
+        , lbracket_token(0)
         , expression(0)
         , rbracket_token(0)
     {}
 
-    virtual NewArrayDeclaratorAST* asNewArrayDeclarator() { return this; }
 
     virtual unsigned firstToken() const;
     virtual unsigned lastToken() const;
@@ -2362,7 +2393,8 @@ public:
 
 public:
     NewExpressionAST()
-        : scope_token(0)
+        : ExpressionAST(NodeKind::NewExpression)
+        , scope_token(0)
         , new_token(0)
         , new_placement(0)
         , lparen_token(0)
@@ -2372,7 +2404,6 @@ public:
         , new_initializer(0)
     {}
 
-    virtual NewExpressionAST* asNewExpression() { return this; }
 
     virtual unsigned firstToken() const;
     virtual unsigned lastToken() const;
@@ -2393,12 +2424,12 @@ public:
 
 public:
     NewTypeIdAST()
-        : type_specifier_list(0)
+        : AST(NodeKind::NewTypeId)
+        , type_specifier_list(0)
         , ptr_operator_list(0)
         , new_array_declarator_list(0)
     {}
 
-    virtual NewTypeIdAST* asNewTypeId() { return this; }
 
     virtual unsigned firstToken() const;
     virtual unsigned lastToken() const;
@@ -2419,12 +2450,12 @@ public:
 
 public:
     OperatorAST()
-        : op_token(0)
+        : AST(NodeKind::Operator)
+        , op_token(0)
         , open_token(0)
         , close_token(0)
     {}
 
-    virtual OperatorAST* asOperator() { return this; }
 
     virtual unsigned firstToken() const;
     virtual unsigned lastToken() const;
@@ -2449,14 +2480,14 @@ public: // annotations
 
 public:
     ParameterDeclarationAST()
-        : type_specifier_list(0)
+        : DeclarationAST(NodeKind::ParameterDeclaration)
+        , type_specifier_list(0)
         , declarator(0)
         , equal_token(0)
         , expression(0)
         , symbol(0)
     {}
 
-    virtual ParameterDeclarationAST* asParameterDeclaration() { return this; }
 
     virtual unsigned firstToken() const;
     virtual unsigned lastToken() const;
@@ -2476,11 +2507,11 @@ public:
 
 public:
     ParameterDeclarationClauseAST()
-        : parameter_declaration_list(0)
+        : AST(NodeKind::ParameterDeclarationClause)
+        , parameter_declaration_list(0)
         , dot_dot_dot_token(0)
     {}
 
-    virtual ParameterDeclarationClauseAST* asParameterDeclarationClause() { return this; }
 
     virtual unsigned firstToken() const;
     virtual unsigned lastToken() const;
@@ -2502,13 +2533,13 @@ public:
 
 public:
     CallAST()
-        : base_expression(0)
+        : PostfixAST(NodeKind::Call)
+        , base_expression(0)
         , lparen_token(0)
         , expression_list(0)
         , rparen_token(0)
     {}
 
-    virtual CallAST* asCall() { return this; }
 
     virtual unsigned firstToken() const;
     virtual unsigned lastToken() const;
@@ -2530,13 +2561,13 @@ public:
 
 public:
     ArrayAccessAST()
-        : base_expression(0)
+        : PostfixAST(NodeKind::ArrayAccess)
+        , base_expression(0)
         , lbracket_token(0)
         , expression(0)
         , rbracket_token(0)
     {}
 
-    virtual ArrayAccessAST* asArrayAccess() { return this; }
 
     virtual unsigned firstToken() const;
     virtual unsigned lastToken() const;
@@ -2556,11 +2587,11 @@ public:
 
 public:
     PostIncrDecrAST()
-        : base_expression(0)
+        : PostfixAST(NodeKind::PostIncrDecr)
+        , base_expression(0)
         , incr_decr_token(0)
     {}
 
-    virtual PostIncrDecrAST* asPostIncrDecr() { return this; }
 
     virtual unsigned firstToken() const;
     virtual unsigned lastToken() const;
@@ -2582,13 +2613,13 @@ public:
 
 public:
     MemberAccessAST()
-        : base_expression(0)
+        : PostfixAST(NodeKind::MemberAccess)
+        , base_expression(0)
         , access_token(0)
         , template_token(0)
         , member_name(0)
     {}
 
-    virtual MemberAccessAST* asMemberAccess() { return this; }
 
     virtual unsigned firstToken() const;
     virtual unsigned lastToken() const;
@@ -2610,13 +2641,13 @@ public:
 
 public:
     TypeidExpressionAST()
-        : typeid_token(0)
+        : ExpressionAST(NodeKind::TypeidExpression)
+        , typeid_token(0)
         , lparen_token(0)
         , expression(0)
         , rparen_token(0)
     {}
 
-    virtual TypeidExpressionAST* asTypeidExpression() { return this; }
 
     virtual unsigned firstToken() const;
     virtual unsigned lastToken() const;
@@ -2637,12 +2668,12 @@ public:
 
 public:
     TypenameCallExpressionAST()
-        : typename_token(0)
+        : ExpressionAST(NodeKind::TypenameCallExpression)
+        , typename_token(0)
         , name(0)
         , expression(0)
     {}
 
-    virtual TypenameCallExpressionAST* asTypenameCallExpression() { return this; }
 
     virtual unsigned firstToken() const;
     virtual unsigned lastToken() const;
@@ -2662,11 +2693,11 @@ public:
 
 public:
     TypeConstructorCallAST()
-        : type_specifier_list(0)
+        : ExpressionAST(NodeKind::TypeConstructorCall)
+        , type_specifier_list(0)
         , expression(0)
     {}
 
-    virtual TypeConstructorCallAST* asTypeConstructorCall() { return this; }
 
     virtual unsigned firstToken() const;
     virtual unsigned lastToken() const;
@@ -2689,14 +2720,14 @@ public:
 
 public:
     PointerToMemberAST()
-        : global_scope_token(0)
+        : PtrOperatorAST(NodeKind::PointerToMember)
+        , global_scope_token(0)
         , nested_name_specifier_list(0)
         , star_token(0)
         , cv_qualifier_list(0)
         , ref_qualifier_token(0)
     {}
 
-    virtual PointerToMemberAST* asPointerToMember() { return this; }
 
     virtual unsigned firstToken() const;
     virtual unsigned lastToken() const;
@@ -2716,11 +2747,11 @@ public:
 
 public:
     PointerAST()
-        : star_token(0)
+        : PtrOperatorAST(NodeKind::Pointer)
+        , star_token(0)
         , cv_qualifier_list(0)
     {}
 
-    virtual PointerAST* asPointer() { return this; }
 
     virtual unsigned firstToken() const;
     virtual unsigned lastToken() const;
@@ -2739,10 +2770,10 @@ public:
 
 public:
     ReferenceAST()
-        : reference_token(0)
+        : PtrOperatorAST(NodeKind::Reference)
+        , reference_token(0)
     {}
 
-    virtual ReferenceAST* asReference() { return this; }
 
     virtual unsigned firstToken() const;
     virtual unsigned lastToken() const;
@@ -2762,11 +2793,11 @@ public:
 
 public:
     BreakStatementAST()
-        : break_token(0)
+        : StatementAST(NodeKind::BreakStatement)
+        , break_token(0)
         , semicolon_token(0)
     {}
 
-    virtual BreakStatementAST* asBreakStatement() { return this; }
 
     virtual unsigned firstToken() const;
     virtual unsigned lastToken() const;
@@ -2786,11 +2817,11 @@ public:
 
 public:
     ContinueStatementAST()
-        : continue_token(0)
+        : StatementAST(NodeKind::ContinueStatement)
+        , continue_token(0)
         , semicolon_token(0)
     {}
 
-    virtual ContinueStatementAST* asContinueStatement() { return this; }
 
     virtual unsigned firstToken() const;
     virtual unsigned lastToken() const;
@@ -2811,12 +2842,12 @@ public:
 
 public:
     GotoStatementAST()
-        : goto_token(0)
+        : StatementAST(NodeKind::GotoStatement)
+        , goto_token(0)
         , identifier_token(0)
         , semicolon_token(0)
     {}
 
-    virtual GotoStatementAST* asGotoStatement() { return this; }
 
     virtual unsigned firstToken() const;
     virtual unsigned lastToken() const;
@@ -2837,12 +2868,12 @@ public:
 
 public:
     ReturnStatementAST()
-        : return_token(0)
+        : StatementAST(NodeKind::ReturnStatement)
+        , return_token(0)
         , expression(0)
         , semicolon_token(0)
     {}
 
-    virtual ReturnStatementAST* asReturnStatement() { return this; }
 
     virtual unsigned firstToken() const;
     virtual unsigned lastToken() const;
@@ -2868,14 +2899,14 @@ public: // annotations
 
 public:
     SizeofExpressionAST()
-        : sizeof_token(0)
+        : ExpressionAST(NodeKind::SizeofExpression)
+        , sizeof_token(0)
         , dot_dot_dot_token(0)
         , lparen_token(0)
         , expression(0)
         , rparen_token(0)
     {}
 
-    virtual SizeofExpressionAST* asSizeofExpression() { return this; }
 
     virtual unsigned firstToken() const;
     virtual unsigned lastToken() const;
@@ -2897,13 +2928,13 @@ public:
 
 public:
     AlignofExpressionAST()
-        : alignof_token(0)
+        : ExpressionAST(NodeKind::AlignofExpression)
+        , alignof_token(0)
         , lparen_token(0)
         , typeId(0)
         , rparen_token(0)
     {}
 
-    virtual AlignofExpressionAST* asAlignofExpression() { return this; }
 
     virtual unsigned firstToken() const;
     virtual unsigned lastToken() const;
@@ -2922,10 +2953,10 @@ public:
 
 public:
     PointerLiteralAST()
-        : literal_token(0)
+        : ExpressionAST(NodeKind::PointerLiteral)
+        , literal_token(0)
     {}
 
-    virtual PointerLiteralAST* asPointerLiteral() { return this; }
 
     virtual unsigned firstToken() const;
     virtual unsigned lastToken() const;
@@ -2944,10 +2975,10 @@ public:
 
 public:
     NumericLiteralAST()
-        : literal_token(0)
+        : ExpressionAST(NodeKind::NumericLiteral)
+        , literal_token(0)
     {}
 
-    virtual NumericLiteralAST* asNumericLiteral() { return this; }
 
     virtual unsigned firstToken() const;
     virtual unsigned lastToken() const;
@@ -2966,10 +2997,10 @@ public:
 
 public:
     BoolLiteralAST()
-        : literal_token(0)
+        : ExpressionAST(NodeKind::BoolLiteral)
+        , literal_token(0)
     {}
 
-    virtual BoolLiteralAST* asBoolLiteral() { return this; }
 
     virtual unsigned firstToken() const;
     virtual unsigned lastToken() const;
@@ -2988,10 +3019,10 @@ public:
 
 public:
     ThisExpressionAST()
-        : this_token(0)
+        : ExpressionAST(NodeKind::ThisExpression)
+        , this_token(0)
     {}
 
-    virtual ThisExpressionAST* asThisExpression() { return this; }
 
     virtual unsigned firstToken() const;
     virtual unsigned lastToken() const;
@@ -3012,12 +3043,12 @@ public:
 
 public:
     NestedExpressionAST()
-        : lparen_token(0)
+        : ExpressionAST(NodeKind::NestedExpression)
+        , lparen_token(0)
         , expression(0)
         , rparen_token(0)
     {}
 
-    virtual NestedExpressionAST* asNestedExpression() { return this; }
 
     virtual unsigned firstToken() const;
     virtual unsigned lastToken() const;
@@ -3042,7 +3073,8 @@ public:
 
 public:
     StaticAssertDeclarationAST()
-        : static_assert_token(0)
+        : DeclarationAST(NodeKind::StaticAssertDeclaration)
+        , static_assert_token(0)
         , lparen_token(0)
         , expression(0)
         , comma_token(0)
@@ -3051,7 +3083,6 @@ public:
         , semicolon_token(0)
     {}
 
-    virtual StaticAssertDeclarationAST* asStaticAssertDeclaration() { return this; }
 
     virtual unsigned firstToken() const;
     virtual unsigned lastToken() const;
@@ -3071,11 +3102,11 @@ public:
 
 public:
     StringLiteralAST()
-        : literal_token(0)
+        : ExpressionAST(NodeKind::StringLiteral)
+        , literal_token(0)
         , next(0)
     {}
 
-    virtual StringLiteralAST* asStringLiteral() { return this; }
 
     virtual unsigned firstToken() const;
     virtual unsigned lastToken() const;
@@ -3101,7 +3132,8 @@ public: // annotations
 
 public:
     SwitchStatementAST()
-        : switch_token(0)
+        : StatementAST(NodeKind::SwitchStatement)
+        , switch_token(0)
         , lparen_token(0)
         , condition(0)
         , rparen_token(0)
@@ -3109,7 +3141,6 @@ public:
         , symbol(0)
     {}
 
-    virtual SwitchStatementAST* asSwitchStatement() { return this; }
 
     virtual unsigned firstToken() const;
     virtual unsigned lastToken() const;
@@ -3136,7 +3167,8 @@ public: // annotations
 
 public:
     TemplateDeclarationAST()
-        : export_token(0)
+        : DeclarationAST(NodeKind::TemplateDeclaration)
+        , export_token(0)
         , template_token(0)
         , less_token(0)
         , template_parameter_list(0)
@@ -3145,7 +3177,6 @@ public:
         , symbol(0)
     {}
 
-    virtual TemplateDeclarationAST* asTemplateDeclaration() { return this; }
 
     virtual unsigned firstToken() const;
     virtual unsigned lastToken() const;
@@ -3165,11 +3196,11 @@ public:
 
 public:
     ThrowExpressionAST()
-        : throw_token(0)
+        : ExpressionAST(NodeKind::ThrowExpression)
+        , throw_token(0)
         , expression(0)
     {}
 
-    virtual ThrowExpressionAST* asThrowExpression() { return this; }
 
     virtual unsigned firstToken() const;
     virtual unsigned lastToken() const;
@@ -3189,11 +3220,11 @@ public:
 
 public:
     NoExceptOperatorExpressionAST()
-        : noexcept_token(0)
+        : ExpressionAST(NodeKind::NoExceptOperatorExpression)
+        , noexcept_token(0)
         , expression(0)
     {}
 
-    virtual NoExceptOperatorExpressionAST* asNoExceptOperatorExpression() { return this; }
 
     virtual unsigned firstToken() const;
     virtual unsigned lastToken() const;
@@ -3212,10 +3243,10 @@ public:
 
 public:
     TranslationUnitAST()
-        : declaration_list(0)
+        : AST(NodeKind::TranslationUnit)
+        , declaration_list(0)
     {}
 
-    virtual TranslationUnitAST* asTranslationUnit() { return this; }
 
     virtual unsigned firstToken() const;
     virtual unsigned lastToken() const;
@@ -3236,12 +3267,12 @@ public:
 
 public:
     TryBlockStatementAST()
-        : try_token(0)
+        : StatementAST(NodeKind::TryBlockStatement)
+        , try_token(0)
         , statement(0)
         , catch_clause_list(0)
     {}
 
-    virtual TryBlockStatementAST* asTryBlockStatement() { return this; }
 
     virtual unsigned firstToken() const;
     virtual unsigned lastToken() const;
@@ -3267,7 +3298,8 @@ public: // annotations
 
 public:
     CatchClauseAST()
-        : catch_token(0)
+        : StatementAST(NodeKind::CatchClause)
+        , catch_token(0)
         , lparen_token(0)
         , exception_declaration(0)
         , rparen_token(0)
@@ -3275,7 +3307,6 @@ public:
         , symbol(0)
     {}
 
-    virtual CatchClauseAST* asCatchClause() { return this; }
 
     virtual unsigned firstToken() const;
     virtual unsigned lastToken() const;
@@ -3295,11 +3326,11 @@ public:
 
 public:
     TypeIdAST()
-        : type_specifier_list(0)
+        : ExpressionAST(NodeKind::TypeId)
+        , type_specifier_list(0)
         , declarator(0)
     {}
 
-    virtual TypeIdAST* asTypeId() { return this; }
 
     virtual unsigned firstToken() const;
     virtual unsigned lastToken() const;
@@ -3325,7 +3356,8 @@ public: // annotations
 
 public:
     TypenameTypeParameterAST()
-        : classkey_token(0)
+        : DeclarationAST(NodeKind::TypenameTypeParameter)
+        , classkey_token(0)
         , dot_dot_dot_token(0)
         , name(0)
         , equal_token(0)
@@ -3333,7 +3365,6 @@ public:
         , symbol(0)
     {}
 
-    virtual TypenameTypeParameterAST* asTypenameTypeParameter() { return this; }
 
     virtual unsigned firstToken() const;
     virtual unsigned lastToken() const;
@@ -3363,7 +3394,8 @@ public:
 
 public:
     TemplateTypeParameterAST()
-        : template_token(0)
+        : DeclarationAST(NodeKind::TemplateTypeParameter)
+        , template_token(0)
         , less_token(0)
         , template_parameter_list(0)
         , greater_token(0)
@@ -3375,7 +3407,6 @@ public:
         , symbol(0)
     {}
 
-    virtual TemplateTypeParameterAST* asTemplateTypeParameter() { return this; }
 
     virtual unsigned firstToken() const;
     virtual unsigned lastToken() const;
@@ -3395,11 +3426,11 @@ public:
 
 public:
     UnaryExpressionAST()
-        : unary_op_token(0)
+        : ExpressionAST(NodeKind::UnaryExpression)
+        , unary_op_token(0)
         , expression(0)
     {}
 
-    virtual UnaryExpressionAST* asUnaryExpression() { return this; }
 
     virtual unsigned firstToken() const;
     virtual unsigned lastToken() const;
@@ -3424,14 +3455,14 @@ public: // annotations
 
 public:
     UsingAST()
-        : using_token(0)
+        : DeclarationAST(NodeKind::Using)
+        , using_token(0)
         , typename_token(0)
         , name(0)
         , semicolon_token(0)
         , symbol(0)
     {}
 
-    virtual UsingAST* asUsing() { return this; }
 
     virtual unsigned firstToken() const;
     virtual unsigned lastToken() const;
@@ -3456,14 +3487,14 @@ public:
 
 public:
     UsingDirectiveAST()
-        : using_token(0)
+        : DeclarationAST(NodeKind::UsingDirective)
+        , using_token(0)
         , namespace_token(0)
         , name(0)
         , semicolon_token(0)
         , symbol(0)
     {}
 
-    virtual UsingDirectiveAST* asUsingDirective() { return this; }
 
     virtual unsigned firstToken() const;
     virtual unsigned lastToken() const;
@@ -3489,7 +3520,8 @@ public: // annotations
 
 public:
     WhileStatementAST()
-        : while_token(0)
+        : StatementAST(NodeKind::WhileStatement)
+        , while_token(0)
         , lparen_token(0)
         , condition(0)
         , rparen_token(0)
@@ -3497,7 +3529,6 @@ public:
         , symbol(0)
     {}
 
-    virtual WhileStatementAST* asWhileStatement() { return this; }
 
     virtual unsigned firstToken() const;
     virtual unsigned lastToken() const;
@@ -3518,12 +3549,12 @@ public:
 
 public:
     LambdaExpressionAST()
-        : lambda_introducer(0)
+        : ExpressionAST(NodeKind::LambdaExpression)
+        , lambda_introducer(0)
         , lambda_declarator(0)
         , statement(0)
     {}
 
-    virtual LambdaExpressionAST* asLambdaExpression() { return this; }
 
     virtual unsigned firstToken() const;
     virtual unsigned lastToken() const;
@@ -3543,12 +3574,12 @@ public:
 
 public:
     LambdaIntroducerAST()
-        : lbracket_token(0)
+        : AST(NodeKind::LambdaIntroducer)
+        , lbracket_token(0)
         , lambda_capture(0)
         , rbracket_token(0)
     {}
 
-    virtual LambdaIntroducerAST* asLambdaIntroducer() { return this; }
     virtual unsigned firstToken() const;
     virtual unsigned lastToken() const;
 
@@ -3567,11 +3598,11 @@ public:
 
 public:
     LambdaCaptureAST()
-        : default_capture_token(0)
+        : AST(NodeKind::LambdaCapture)
+        , default_capture_token(0)
         , capture_list(0)
     {}
 
-    virtual LambdaCaptureAST* asLambdaCapture() { return this; }
     virtual unsigned firstToken() const;
     virtual unsigned lastToken() const;
 
@@ -3590,11 +3621,11 @@ public:
 
 public:
     CaptureAST()
-        : amper_token(0)
+        : AST(NodeKind::Capture)
+        , amper_token(0)
         , identifier(0)
     {}
 
-    virtual CaptureAST* asCapture() { return this; }
     virtual unsigned firstToken() const;
     virtual unsigned lastToken() const;
 
@@ -3621,7 +3652,8 @@ public: // annotations
 
 public:
     LambdaDeclaratorAST()
-        : lparen_token(0)
+        : AST(NodeKind::LambdaDeclarator)
+        , lparen_token(0)
         , parameter_declaration_clause(0)
         , rparen_token(0)
         , attributes(0)
@@ -3631,7 +3663,6 @@ public:
         , symbol(0)
     {}
 
-    virtual LambdaDeclaratorAST* asLambdaDeclarator() { return this; }
     virtual unsigned firstToken() const;
     virtual unsigned lastToken() const;
 
@@ -3652,13 +3683,13 @@ public:
 
 public:
     TrailingReturnTypeAST()
-        : arrow_token(0)
+        : AST(NodeKind::TrailingReturnType)
+        , arrow_token(0)
         , attributes(0)
         , type_specifier_list(0)
         , declarator(0)
     {}
 
-    virtual TrailingReturnTypeAST* asTrailingReturnType() { return this; }
     virtual unsigned firstToken() const;
     virtual unsigned lastToken() const;
 
@@ -3679,13 +3710,13 @@ public:
 
 public:
     BracedInitializerAST()
-        : lbrace_token(0)
+        : ExpressionAST(NodeKind::BracedInitializer)
+        , lbrace_token(0)
         , expression_list(0)
         , comma_token(0)
         , rbrace_token(0)
     {}
 
-    virtual BracedInitializerAST* asBracedInitializer() { return this; }
     virtual unsigned firstToken() const;
     virtual unsigned lastToken() const;
 
@@ -3699,7 +3730,8 @@ protected:
 class DesignatorAST: public AST
 {
 public:
-    DesignatorAST()
+    DesignatorAST(NodeKind kind)
+        : AST(kind)
     {}
 
     virtual DesignatorAST* asDesignator() { return this; }
@@ -3713,11 +3745,11 @@ public:
     unsigned identifier_token;
 public:
     DotDesignatorAST()
-        : dot_token(0)
+        : DesignatorAST(NodeKind::DotDesignator)
+        , dot_token(0)
         , identifier_token(0)
     {}
 
-    virtual DotDesignatorAST* asDotDesignator() { return this; }
     virtual unsigned firstToken() const;
     virtual unsigned lastToken() const;
 
@@ -3736,12 +3768,12 @@ public:
     unsigned rbracket_token;
 public:
     BracketDesignatorAST()
-        : lbracket_token(0)
+        : DesignatorAST(NodeKind::BracketDesignator)
+        , lbracket_token(0)
         , expression(0)
         , rbracket_token(0)
     {}
 
-    virtual BracketDesignatorAST* asBracketDesignator() { return this; }
     virtual unsigned firstToken() const;
     virtual unsigned lastToken() const;
 
@@ -3761,12 +3793,12 @@ public:
 
 public:
     DesignatedInitializerAST()
-        : designator_list(0)
+        : ExpressionAST(NodeKind::DesignatedInitializer)
+        , designator_list(0)
         , equal_token(0)
         , initializer(0)
     {}
 
-    virtual DesignatedInitializerAST* asDesignatedInitializer() { return this; }
     virtual unsigned firstToken() const;
     virtual unsigned lastToken() const;
 
@@ -3777,6 +3809,11 @@ protected:
     virtual bool match0(AST* , ASTMatcher *);
 };
 
+#define PSYCHE_AST_NODE(NAME) \
+    inline NAME##AST* AST::as##NAME() \
+    { return _nodeKind == NodeKind::NAME ? static_cast<NAME##AST*>(this) : nullptr; }
+#include "ASTNodes.inc"
+
 } // namespace psyche
 
 #endif
@@ -522,6 +522,9 @@ AmbiguousStatementAST* AmbiguousStatementAST::clone(MemoryPool *pool) const
         ast->declarationStmt = declarationStmt->clone(pool);
     if (expressionStmt)
         ast->expressionStmt = expressionStmt->clone(pool);
+    if (ambiguity)
+        ast->ambiguity = std::make_unique<psyche::SyntaxAmbiguity>(*ambiguity);
+    ast->suspiciousDecls = suspiciousDecls;
     return ast;
 }
 
@@ -0,0 +1,133 @@
+// Copyright (c) 2016-20 Leandro T. C. Melo <ltcmelo@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#ifndef PSYCHE_AST_LIST_BUILDER_H__
+#define PSYCHE_AST_LIST_BUILDER_H__
+
+#include "FrontendConfig.h"
+
+#include "MemoryPool.h"
+#include <cstddef>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace psyche {
+
+/*!
+ * \brief The ASTListRange class
+ *
+ * Lets a range-based for walk the `->next' chain of a List/SepList.
+ */
+template <class ListT>
+class ASTListRange
+{
+public:
+    class iterator
+    {
+    public:
+        explicit iterator(ListT* it) : it_(it) {}
+
+        decltype(std::declval<ListT>().value)& operator*() const { return it_->value; }
+        iterator& operator++() { it_ = it_->next; return *this; }
+        bool operator!=(const iterator& other) const { return it_ != other.it_; }
+
+    private:
+        ListT* it_;
+    };
+
+    explicit ASTListRange(ListT* list) : list_(list) {}
+
+    iterator begin() const { return iterator(list_); }
+    iterator end() const { return iterator(nullptr); }
+
+private:
+    ListT* list_;
+};
+
+template <class ListT>
+ASTListRange<ListT> listRange(ListT* list) { return ASTListRange<ListT>(list); }
+
+/*!
+ * Allocate \a size List/SepList cells, linked in order, in one contiguous chunk of \a pool;
+ * the value of the i-th cell is \a valueAt(i).
+ */
+template <class ListT, class ValueAtT>
+ListT* makeContiguousList(MemoryPool* pool, std::size_t size, ValueAtT valueAt)
+{
+    if (!size)
+        return nullptr;
+
+    ListT* cells = static_cast<ListT*>(pool->allocate(size * sizeof(ListT)));
+    for (std::size_t i = 0; i < size; ++i) {
+        ::new (&cells[i]) ListT(valueAt(i));
+        if (i)
+            cells[i - 1].next = &cells[i];
+    }
+    return cells;
+}
+
+/*!
+ * \brief The ASTListBuilder class
+ *
+ * Builds a List/SepList whose cells are allocated, all at once, in a single contiguous
+ * chunk of the MemoryPool; each cell's `next' points to the adjacent one. Code that walks
+ * the `->next' chain works unchanged, but with the locality of an array. The values are
+ * buffered (inline, up to \a N of them) until finish is called.
+ *
+ * \note The delimiter token of a SepList cell is left unset.
+ */
+template <class ListT, std::size_t N = 16>
+class ASTListBuilder
+{
+public:
+    using value_type = decltype(std::declval<ListT>().value);
+
+    void add(const value_type& value)
+    {
+        if (size_ < N)
+            inline_[size_] = value;
+        else
+            spill_.push_back(value);
+        ++size_;
+    }
+
+    std::size_t size() const { return size_; }
+    bool isEmpty() const { return size_ == 0; }
+
+    ListT* finish(MemoryPool* pool)
+    {
+        ListT* cells = makeContiguousList<ListT>(pool, size_, [this] (std::size_t i) {
+            return i < N ? inline_[i] : spill_[i - N];
+        });
+        size_ = 0;
+        spill_.clear();
+        return cells;
+    }
+
+private:
+    value_type inline_[N];
+    std::vector<value_type> spill_;
+    std::size_t size_ { 0 };
+};
+
+} // namespace psyche
+
+#endif
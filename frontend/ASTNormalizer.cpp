@@ -34,39 +34,13 @@
 
 using namespace psyche;
 
-namespace {
-
-struct FindAmbiguousNode : public ASTVisitor
-{
-    FindAmbiguousNode(psyche::TranslationUnit *unit)
-        : ASTVisitor(unit)
-        , hasAmbiguousNode_(false)
-    {}
-
-    bool operator()(const psyche::TranslationUnitAST* ast)
-    {
-        if (ast) {
-            for (DeclarationListAST* it = ast->declaration_list; it; it = it->next)
-                accept(it->value);
-        }
-        return hasAmbiguousNode_;
-    }
-
-    bool visit(AmbiguousStatementAST* ) override
-    {
-        hasAmbiguousNode_ = true;
-        return false;
-    }
-
-    bool hasAmbiguousNode_;
-};
-
-} // Anonymous
-
 ASTNormalizer::ASTNormalizer(TranslationUnit *unit, bool employHeuristic)
     : ASTVisitor(unit)
     , employHeuristic_(employHeuristic)
-{}
+    , unresolved_(false)
+{
+    enableIterativeTraversal();
+}
 
 void ASTNormalizer::Stats::reset()
 {
@@ -81,13 +55,22 @@ bool ASTNormalizer::normalize(TranslationUnitAST* ast)
     if (!ast)
         return true;
 
+    unresolved_ = false;
     for (DeclarationListAST* it = ast->declaration_list; it; it = it->next)
         accept(it->value);
 
     if (employHeuristic_)
         return true;
 
-    return !FindAmbiguousNode(translationUnit())(ast);
+    return !unresolved_;
+}
+
+bool ASTNormalizer::visit(AmbiguousStatementAST*)
+{
+    // An ambiguous statement is fixed, if at all, before it'd be visited; so
+    // this one is left unresolved.
+    unresolved_ = true;
+    return true;
 }
 
 bool ASTNormalizer::visit(CompoundStatementAST* ast)
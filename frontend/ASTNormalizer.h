@@ -63,9 +63,13 @@ private:
     bool visit(psyche::CaseStatementAST* ast);
     bool visit(psyche::DoStatementAST* ast);
 
+    // Ambiguities left unresolved (without heuristics) are found in the same walk.
+    bool visit(psyche::AmbiguousStatementAST* ast);
+
     void maybeFixAST(psyche::StatementAST* &ast);
 
     bool employHeuristic_; // On ambiguities not resolved by further syntax.
+    bool unresolved_;
     Stats stats_;
 };
 
@@ -0,0 +1,110 @@
+// Copyright (c) 2016-20 Leandro T. C. Melo <ltcmelo@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "ASTTraversal.h"
+
+#include "AST.h"
+#include "ASTVisitor.h"
+
+using namespace psyche;
+
+/*
+ * A dispatcher is the visitor actually given to AST::accept0, which is where the
+ * double-dispatch on the node type happens. When entering a node, its visit is forwarded
+ * to the real visitor and, in the case it returns true, the children (reached through
+ * preVisit) are collected instead of visited. When exiting a node, only its endVisit is
+ * forwarded.
+ */
+class ASTTraversal::Dispatcher final : public ASTVisitor
+{
+public:
+    Dispatcher(ASTVisitor* visitor, std::vector<AST*>* children, bool entering)
+        : ASTVisitor(visitor->translationUnit())
+        , visitor_(visitor)
+        , children_(children)
+        , entering_(entering)
+    {}
+
+    bool preVisit(AST* ast) override
+    {
+        children_->push_back(ast);
+        return false;
+    }
+
+#define PSYCHE_AST_NODE(NAME) \
+    bool visit(NAME##AST* ast) override \
+    { return entering_ && visitor_->visit(ast); } \
+    void endVisit(NAME##AST* ast) override \
+    { if (!entering_) visitor_->endVisit(ast); }
+#include "ASTNodes.inc"
+
+private:
+    ASTVisitor* visitor_;
+    std::vector<AST*>* children_;
+    bool entering_;
+};
+
+ASTTraversal::ASTTraversal(ASTVisitor* visitor)
+    : visitor_(visitor)
+    , enter_(new Dispatcher(visitor, &children_, true))
+    , exit_(new Dispatcher(visitor, &children_, false))
+    , maxDepth_(0)
+{}
+
+ASTTraversal::~ASTTraversal()
+{}
+
+void ASTTraversal::traverse(AST* ast)
+{
+    if (!ast)
+        return;
+
+    // Frames below the base belong to an enclosing run (a visitor that called accept
+    // from within a visit), they must be left untouched.
+    const auto base = stack_.size();
+    stack_.push_back(Frame { ast, false });
+
+    while (stack_.size() > base) {
+        if (stack_.size() > maxDepth_)
+            maxDepth_ = stack_.size();
+
+        const Frame frame = stack_.back();
+        stack_.pop_back();
+
+        if (frame.exit_) {
+            frame.ast_->accept0(exit_.get());
+            visitor_->postVisit(frame.ast_);
+            continue;
+        }
+
+        if (!visitor_->preVisit(frame.ast_)) {
+            visitor_->postVisit(frame.ast_);
+            continue;
+        }
+
+        const auto mark = children_.size();
+        frame.ast_->accept0(enter_.get());
+
+        stack_.push_back(Frame { frame.ast_, true });
+        for (auto i = children_.size(); i > mark; --i)
+            stack_.push_back(Frame { children_[i - 1], false });
+        children_.resize(mark);
+    }
+}
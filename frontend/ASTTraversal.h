@@ -0,0 +1,77 @@
+// Copyright (c) 2016-20 Leandro T. C. Melo <ltcmelo@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#ifndef PSYCHE_AST_TRAVERSAL_H__
+#define PSYCHE_AST_TRAVERSAL_H__
+
+#include "FrontendConfig.h"
+
+#include "ASTFwds.h"
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace psyche {
+
+/*!
+ * \brief The ASTTraversal class
+ *
+ * An iterative traversal engine for an ASTVisitor: instead of recursing natively through
+ * AST::accept and AST::accept0, nodes are scheduled on an explicit, heap-allocated, work
+ * stack. The order of preVisit/visit/endVisit/postVisit calls is the same of the recursive
+ * traversal, so a visitor may opt into this engine without changes in its logic.
+ *
+ * A visitor that recurses on its own, i.e., calls accept from inside a visit and returns
+ * false, still works; each such call starts a nested run on the same work stack.
+ */
+class CFE_API ASTTraversal final
+{
+    ASTTraversal(const ASTTraversal&) = delete;
+    void operator=(const ASTTraversal&) = delete;
+
+public:
+    ASTTraversal(ASTVisitor* visitor);
+    ~ASTTraversal();
+
+    void traverse(AST* ast);
+
+    //! The maximum number of pending frames seen in the work stack.
+    std::size_t maxStackDepth() const { return maxDepth_; }
+
+private:
+    struct Frame
+    {
+        AST* ast_;
+        bool exit_;
+    };
+
+    class Dispatcher;
+
+    ASTVisitor* visitor_;
+    std::unique_ptr<Dispatcher> enter_;
+    std::unique_ptr<Dispatcher> exit_;
+    std::vector<Frame> stack_;
+    std::vector<AST*> children_;
+    std::size_t maxDepth_;
+};
+
+} // namespace psyche
+
+#endif
@@ -21,6 +21,7 @@
 
 #include "ASTVisitor.h"
 #include "AST.h"
+#include "ASTTraversal.h"
 #include "TranslationUnit.h"
 #include "Control.h"
 
@@ -34,7 +35,21 @@ ASTVisitor::~ASTVisitor()
 { }
 
 void ASTVisitor::accept(AST* ast)
-{ AST::accept(ast, this); }
+{
+    if (_traversal)
+        _traversal->traverse(ast);
+    else
+        AST::accept(ast, this);
+}
+
+void ASTVisitor::enableIterativeTraversal()
+{
+    if (!_traversal)
+        _traversal.reset(new ASTTraversal(this));
+}
+
+ASTTraversal* ASTVisitor::traversal() const
+{ return _traversal.get(); }
 
 Control *ASTVisitor::control() const
 {
@@ -26,9 +26,12 @@
 
 #include "ASTFwds.h"
 #include "FrontendFwds.h"
+#include <memory>
 
 namespace psyche {
 
+class ASTTraversal;
+
 class CFE_API ASTVisitor
 {
     ASTVisitor(const ASTVisitor &other);
@@ -66,6 +69,13 @@ public:
 
     void accept(AST* ast);
 
+    /*!
+     * Traverse the AST through an explicit work stack, instead of native recursion; see
+     * ASTTraversal. This is meant for visitors that may run over very deep ASTs.
+     */
+    void enableIterativeTraversal();
+    ASTTraversal* traversal() const;
+
     template <class PtrT, class DerivedListT>
     void accept(BaseList<PtrT, DerivedListT>* it)
     {
@@ -320,6 +330,7 @@ public:
 
 private:
    TranslationUnit *_translationUnit;
+   std::unique_ptr<ASTTraversal> _traversal;
 };
 
 } // namespace psyche
@@ -22,6 +22,7 @@
 #include "Binder.h"
 
 #include "AST.h"
+#include "ASTListBuilder.h"
 #include "Control.h"
 #include "CoreTypes.h"
 #include "Literals.h"
@@ -41,12 +42,9 @@
 using namespace psyche;
 using namespace psyche;
 
-const int Binder::kMaxDepth(100);
-
 Binder::Binder(TranslationUnit *unit)
     : ASTVisitor(unit)
     , scope_(nullptr)
-    , depth_(0)
     , exprTy_(nullptr)
     , name_(nullptr)
     , decltorIdent_(nullptr)
@@ -55,7 +53,11 @@ Binder::Binder(TranslationUnit *unit)
     , skipFunctionBodies_(false)
     , quantTyLabel_(0)
     , parentAmbiguousStmt_(nullptr)
-{}
+{
+    // Operands of expressions are left to the traversal engine, so deep expressions
+    // (long operator chains or nested parentheses) don't exhaust the native stack.
+    enableIterativeTraversal();
+}
 
 bool Binder::skipFunctionBodies() const
 {
@@ -269,19 +271,6 @@ FullySpecifiedType Binder::postfixDeclarator(PostfixDeclaratorAST* ast, const Fu
     return value;
 }
 
-bool Binder::preVisit(AST* )
-{
-    ++depth_;
-    if (depth_ > kMaxDepth)
-        return false;
-    return true;
-}
-
-void Binder::postVisit(AST* )
-{
-    --depth_;
-}
-
 bool Binder::visit(GnuAttributeAST* )
 {
     return false;
@@ -865,8 +854,8 @@ void Binder::translationUnit(TranslationUnitAST* ast)
     if (! ast)
         return;
 
-    for (DeclarationListAST* it = ast->declaration_list; it; it = it->next) {
-        this->declaration(it->value);
+    for (DeclarationAST* decl : listRange(ast->declaration_list)) {
+        this->declaration(decl);
     }
 }
 
@@ -1029,8 +1018,8 @@ bool Binder::visit(CompoundStatementAST* ast)
     ast->symbol = block;
     scope_->addMember(block);
     Scope *previousScope = switchScope(block);
-    for (StatementListAST* it = ast->statement_list; it; it = it->next) {
-        this->statement(it->value);
+    for (StatementAST* stmt : listRange(ast->statement_list)) {
+        this->statement(stmt);
     }
     (void) switchScope(previousScope);
     return false;
@@ -1302,7 +1291,7 @@ bool Binder::visit(IdExpressionAST* ast)
     if (withinAmbiguousStmt())
         return false;
 
-    if (name->asNameId())
+    if (name && name->asNameId())
         maybeResolveAmbiguity(name, &SyntaxAmbiguity::lhs, SyntaxAmbiguity::Resolution::IsExpr);
 
     return false;
@@ -1325,14 +1314,16 @@ bool Binder::visit(CompoundLiteralAST* ast)
     return false;
 }
 
-bool Binder::visit(BinaryExpressionAST* ast)
+bool Binder::visit(BinaryExpressionAST* )
 {
-    this->expression(ast->left_expression);
-    this->expression(ast->right_expression);
+    return true;
+}
 
+void Binder::endVisit(BinaryExpressionAST* ast)
+{
     if (!withinAmbiguousStmt()
             || parentAmbiguousStmt_->ambiguity->resolution() != SyntaxAmbiguity::Resolution::Unknown) {
-        return false;
+        return;
     }
 
     auto resolve = [this] (AST* astSide, void (SyntaxAmbiguity::*set) (const Name*)) {
@@ -1350,7 +1341,7 @@ bool Binder::visit(BinaryExpressionAST* ast)
     // Try to resolve ambiguity through symbol lookup.
     if (resolve(ast->left_expression, &SyntaxAmbiguity::setLhs)
             || resolve(ast->right_expression, &SyntaxAmbiguity::setRhs))
-        return false;
+        return;
 
     // Undeclared names won't produce a symbol, but maybe this name has been seen as a
     // type specifier.
@@ -1360,8 +1351,6 @@ bool Binder::visit(BinaryExpressionAST* ast)
         if (it != typeNames_.end() && (it->second.find(name) != it->second.end()))
             parentAmbiguousStmt_->ambiguity->applyResolution(SyntaxAmbiguity::Resolution::IsDecl);
     }
-
-    return false;
 }
 
 bool Binder::visit(CastExpressionAST* ast)
@@ -1396,14 +1385,9 @@ bool Binder::visit(ConditionAST* ast)
     return false;
 }
 
-bool Binder::visit(ConditionalExpressionAST* ast)
+bool Binder::visit(ConditionalExpressionAST* )
 {
-    ExpressionTy condition = this->expression(ast->condition);
-    // unsigned question_token = ast->question_token;
-    ExpressionTy left_expression = this->expression(ast->left_expression);
-    // unsigned colon_token = ast->colon_token;
-    ExpressionTy right_expression = this->expression(ast->right_expression);
-    return false;
+    return true;
 }
 
 bool Binder::visit(CppCastExpressionAST* ast)
@@ -1516,12 +1500,9 @@ bool Binder::visit(ThisExpressionAST* ast)
     return false;
 }
 
-bool Binder::visit(NestedExpressionAST* ast)
+bool Binder::visit(NestedExpressionAST* )
 {
-    // unsigned lparen_token = ast->lparen_token;
-    ExpressionTy expression = this->expression(ast->expression);
-    // unsigned rparen_token = ast->rparen_token;
-    return false;
+    return true;
 }
 
 bool Binder::visit(StringLiteralAST* ast)
@@ -1550,11 +1531,13 @@ bool Binder::visit(TypeIdAST* ast)
     return false;
 }
 
-bool Binder::visit(UnaryExpressionAST* ast)
+bool Binder::visit(UnaryExpressionAST* )
 {
-    // unsigned unary_op_token = ast->unary_op_token;
-    this->expression(ast->expression);
+    return true;
+}
 
+void Binder::endVisit(UnaryExpressionAST* ast)
+{
     if (ast->expression
             && ast->expression->asIdExpression()
             && tokenKind(ast->unary_op_token) == T_STAR) {
@@ -1562,8 +1545,6 @@ bool Binder::visit(UnaryExpressionAST* ast)
                               &SyntaxAmbiguity::rhs,
                               SyntaxAmbiguity::Resolution::IsDecl);
     }
-
-    return false;
 }
 
 bool Binder::visit(LambdaExpressionAST* ast)
@@ -1842,8 +1823,8 @@ bool Binder::visit(GenericsDeclarationAST* ast)
 bool Binder::visit(LinkageBodyAST* ast)
 {
     // unsigned lbrace_token = ast->lbrace_token;
-    for (DeclarationListAST* it = ast->declaration_list; it; it = it->next) {
-        this->declaration(it->value);
+    for (DeclarationAST* decl : listRange(ast->declaration_list)) {
+        this->declaration(decl);
     }
     // unsigned rbrace_token = ast->rbrace_token;
     return false;
@@ -1936,8 +1917,8 @@ bool Binder::visit(TemplateDeclarationAST* ast)
     ast->symbol = templ;
     Scope *previousScope = switchScope(templ);
 
-    for (DeclarationListAST* it = ast->template_parameter_list; it; it = it->next) {
-        this->declaration(it->value);
+    for (DeclarationAST* decl : listRange(ast->template_parameter_list)) {
+        this->declaration(decl);
     }
     // unsigned greater_token = ast->greater_token;
     this->declaration(ast->declaration);
@@ -1975,8 +1956,8 @@ bool Binder::visit(TemplateTypeParameterAST* ast)
     // unsigned less_token = ast->less_token;
     // ### process the template prototype
 #if 0
-    for (DeclarationListAST* it = ast->template_parameter_list; it; it = it->next) {
-        this->declaration(it->value);
+    for (DeclarationAST* decl : listRange(ast->template_parameter_list)) {
+        this->declaration(decl);
     }
 #endif
     // unsigned greater_token = ast->greater_token;
@@ -2400,8 +2381,8 @@ bool Binder::visit(ClassSpecifierAST* ast)
         this->baseSpecifier(it->value, ast->colon_token, klass);
     }
     // unsigned dot_dot_dot_token = ast->dot_dot_dot_token;
-    for (DeclarationListAST* it = ast->member_specifier_list; it; it = it->next) {
-        this->declaration(it->value);
+    for (DeclarationAST* decl : listRange(ast->member_specifier_list)) {
+        this->declaration(decl);
     }
 
     (void) switchMethodKey(previousMethodKey);
@@ -2560,20 +2541,14 @@ bool Binder::visit(CallAST* ast)
     return false;
 }
 
-bool Binder::visit(ArrayAccessAST* ast)
+bool Binder::visit(ArrayAccessAST* )
 {
-    /*ExpressionTy base_expression =*/ this->expression(ast->base_expression);
-    // unsigned lbracket_token = ast->lbracket_token;
-    /*ExpressionTy expression =*/ this->expression(ast->expression);
-    // unsigned rbracket_token = ast->rbracket_token;
-    return false;
+    return true;
 }
 
-bool Binder::visit(PostIncrDecrAST* ast)
+bool Binder::visit(PostIncrDecrAST* )
 {
-    ExpressionTy base_expression = this->expression(ast->base_expression);
-    // unsigned incr_decr_token = ast->incr_decr_token;
-    return false;
+    return true;
 }
 
 bool Binder::visit(MemberAccessAST* ast)
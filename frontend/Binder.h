@@ -97,9 +97,6 @@ protected:
     FullySpecifiedType trailingReturnType(TrailingReturnTypeAST* ast, const FullySpecifiedType &init);
     const StringLiteral *asStringLiteral(const ExpressionAST* ast);
 
-    virtual bool preVisit(AST* );
-    virtual void postVisit(AST* );
-
     // AST
     virtual bool visit(GnuAttributeAST* ast);
     virtual bool visit(DeclaratorAST* ast);
@@ -147,6 +144,7 @@ protected:
     virtual bool visit(CompoundExpressionAST* ast);
     virtual bool visit(CompoundLiteralAST* ast);
     virtual bool visit(BinaryExpressionAST* ast);
+    virtual void endVisit(BinaryExpressionAST* ast);
     virtual bool visit(CastExpressionAST* ast);
     virtual bool visit(ConditionAST* ast);
     virtual bool visit(ConditionalExpressionAST* ast);
@@ -167,6 +165,7 @@ protected:
     virtual bool visit(ThrowExpressionAST* ast);
     virtual bool visit(TypeIdAST* ast);
     virtual bool visit(UnaryExpressionAST* ast);
+    virtual void endVisit(UnaryExpressionAST* ast);
     virtual bool visit(LambdaExpressionAST* ast);
     virtual bool visit(BracedInitializerAST* ast);
     virtual bool visit(ExpressionListParenAST* ast);
@@ -235,9 +234,6 @@ protected:
 private:
     Scope* scope_;
 
-    static const int kMaxDepth;
-    int depth_;
-
     ExpressionTy exprTy_;
     const Name* name_;
     FullySpecifiedType type_;
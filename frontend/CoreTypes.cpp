@@ -34,7 +34,8 @@ void VoidType::accept0(TypeVisitor* visitor)
 { visitor->visit(this); }
 
 PointerToMemberType::PointerToMemberType(const Name* memberName, const FullySpecifiedType &elementType)
-    : memberName_(memberName)
+    : Type(TypeKind::PointerToMember)
+    , memberName_(memberName)
     , elementType_(elementType)
 {}
 
@@ -51,7 +52,8 @@ void PointerToMemberType::accept0(TypeVisitor* visitor)
 { visitor->visit(this); }
 
 PointerType::PointerType(const FullySpecifiedType &elementType)
-    : elementType_(elementType)
+    : Type(TypeKind::Pointer)
+    , elementType_(elementType)
 {}
 
 PointerType::~PointerType()
@@ -64,7 +66,8 @@ FullySpecifiedType PointerType::elementType() const
 { return elementType_; }
 
 ReferenceType::ReferenceType(const FullySpecifiedType &elementType)
-    : elementType_(elementType)
+    : Type(TypeKind::Reference)
+    , elementType_(elementType)
 {}
 
 ReferenceType::~ReferenceType()
@@ -77,7 +80,8 @@ FullySpecifiedType ReferenceType::elementType() const
 { return elementType_; }
 
 IntegerType::IntegerType(Kind kind)
-    : kind_(kind)
+    : Type(TypeKind::Integer)
+    , kind_(kind)
 {}
 
 IntegerType::~IntegerType()
@@ -118,7 +122,8 @@ unsigned int IntegerType::rank() const
 }
 
 FloatType::FloatType(Kind kind)
-    : kind_(kind)
+    : Type(TypeKind::Float)
+    , kind_(kind)
 {}
 
 FloatType::~FloatType()
@@ -131,7 +136,8 @@ FloatType::Kind FloatType::kind() const
 { return kind_; }
 
 ArrayType::ArrayType(const FullySpecifiedType &elementType, unsigned size)
-    : elementType_(elementType)
+    : Type(TypeKind::Array)
+    , elementType_(elementType)
     , size_(size)
 {}
 
@@ -148,7 +154,8 @@ unsigned ArrayType::size() const
 { return size_; }
 
 NamedType::NamedType(const Name* name)
-    : name_(name)
+    : Type(TypeKind::Named)
+    , name_(name)
 {}
 
 NamedType::~NamedType()
@@ -161,7 +168,8 @@ void NamedType::accept0(TypeVisitor* visitor)
 { visitor->visit(this); }
 
 QuantifiedType::QuantifiedType(const Name* name, QuantifiedType::Kind kind, int label)
-    : name_(name)
+    : Type(TypeKind::Quantified)
+    , name_(name)
     , kind_(kind)
     , label_(label)
 {}
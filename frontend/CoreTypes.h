@@ -32,18 +32,16 @@ namespace psyche {
 class CFE_API UndefinedType : public Type
 {
 public:
+    UndefinedType()
+        : Type(TypeKind::Undefined)
+    {}
+
     static UndefinedType* instance()
     {
         static UndefinedType ty;
         return &ty;
     }
 
-    virtual const UndefinedType* asUndefinedType() const
-    { return this; }
-
-    virtual UndefinedType* asUndefinedType()
-    { return this; }
-
 protected:
     virtual void accept0(TypeVisitor* visitor);
 };
@@ -51,11 +49,10 @@ protected:
 class CFE_API VoidType : public Type
 {
 public:
-    virtual const VoidType* asVoidType() const
-    { return this; }
+    VoidType()
+        : Type(TypeKind::Void)
+    {}
 
-    virtual VoidType* asVoidType()
-    { return this; }
 
 protected:
     virtual void accept0(TypeVisitor* visitor);
@@ -84,12 +81,6 @@ public:
 
     unsigned int rank() const;
 
-    virtual IntegerType* asIntegerType()
-    { return this; }
-
-    virtual const IntegerType* asIntegerType() const
-    { return this; }
-
 protected:
     virtual void accept0(TypeVisitor* visitor);
 
@@ -112,12 +103,6 @@ public:
 
     Kind kind() const;
 
-    virtual const FloatType* asFloatType() const
-    { return this; }
-
-    virtual FloatType* asFloatType()
-    { return this; }
-
 protected:
     virtual void accept0(TypeVisitor* visitor);
 
@@ -133,12 +118,6 @@ public:
 
     FullySpecifiedType elementType() const;
 
-    virtual const PointerType* asPointerType() const
-    { return this; }
-
-    virtual PointerType* asPointerType()
-    { return this; }
-
 protected:
     virtual void accept0(TypeVisitor* visitor);
 
@@ -155,12 +134,6 @@ public:
     const Name* memberName() const;
     FullySpecifiedType elementType() const;
 
-    virtual const PointerToMemberType* asPointerToMemberType() const
-    { return this; }
-
-    virtual PointerToMemberType* asPointerToMemberType()
-    { return this; }
-
 protected:
     virtual void accept0(TypeVisitor* visitor);
 
@@ -177,12 +150,6 @@ public:
 
     FullySpecifiedType elementType() const;
 
-    virtual const ReferenceType* asReferenceType() const
-    { return this; }
-
-    virtual ReferenceType* asReferenceType()
-    { return this; }
-
 protected:
     virtual void accept0(TypeVisitor* visitor);
 
@@ -199,12 +166,6 @@ public:
     FullySpecifiedType elementType() const;
     unsigned size() const;
 
-    virtual const ArrayType* asArrayType() const
-    { return this; }
-
-    virtual ArrayType* asArrayType()
-    { return this; }
-
 protected:
     virtual void accept0(TypeVisitor* visitor);
 
@@ -221,12 +182,6 @@ public:
 
     const Name* name() const;
 
-    virtual const NamedType* asNamedType() const
-    { return this; }
-
-    virtual NamedType* asNamedType()
-    { return this; }
-
 protected:
     virtual void accept0(TypeVisitor* visitor);
 
@@ -249,12 +204,6 @@ public:
     Kind kind() const;
     int label() const;
 
-    virtual const QuantifiedType* asQuantifiedType() const
-    { return this; }
-
-    virtual QuantifiedType* asQuantifiedType()
-    { return this; }
-
 protected:
     virtual void accept0(TypeVisitor* visitor);
 
@@ -264,6 +213,17 @@ private:
     int label_;
 };
 
+PSYCHE_DEFINE_TYPE_CAST(UndefinedType, Undefined, asUndefinedType)
+PSYCHE_DEFINE_TYPE_CAST(VoidType, Void, asVoidType)
+PSYCHE_DEFINE_TYPE_CAST(IntegerType, Integer, asIntegerType)
+PSYCHE_DEFINE_TYPE_CAST(FloatType, Float, asFloatType)
+PSYCHE_DEFINE_TYPE_CAST(PointerType, Pointer, asPointerType)
+PSYCHE_DEFINE_TYPE_CAST(PointerToMemberType, PointerToMember, asPointerToMemberType)
+PSYCHE_DEFINE_TYPE_CAST(ReferenceType, Reference, asReferenceType)
+PSYCHE_DEFINE_TYPE_CAST(ArrayType, Array, asArrayType)
+PSYCHE_DEFINE_TYPE_CAST(NamedType, Named, asNamedType)
+PSYCHE_DEFINE_TYPE_CAST(QuantifiedType, Quantified, asQuantifiedType)
+
 } // namespace psyche
 
 #endif
@@ -36,15 +36,54 @@ using namespace psyche;
 ExpressionTypeEvaluator::ExpressionTypeEvaluator(TranslationUnit *unit)
     : ASTVisitor(unit)
     , _memberAccess(0)
+    , memoize_(false)
+    , memoHit_(false)
 {}
 
 FullySpecifiedType ExpressionTypeEvaluator::evaluate(ExpressionAST* ast, Scope *scope)
 {
     scope_ = scope;
+    type_ = FullySpecifiedType();
     accept(ast);
     return type_;
 }
 
+void ExpressionTypeEvaluator::enableMemoization()
+{
+    memoize_ = true;
+}
+
+bool ExpressionTypeEvaluator::preVisit(AST* ast)
+{
+    if (!memoize_ || !ast->asExpression())
+        return true;
+
+    auto it = memo_.find(ast->asExpression());
+    if (it != memo_.end() && it->second.scope_ == scope_) {
+        type_ = it->second.type_;
+        scope_ = it->second.exitScope_;
+        memoHit_ = true;
+        return false;
+    }
+
+    entryScopes_.push_back(scope_);
+    return true;
+}
+
+void ExpressionTypeEvaluator::postVisit(AST* ast)
+{
+    if (!memoize_ || !ast->asExpression())
+        return;
+
+    if (memoHit_) {
+        memoHit_ = false;
+        return;
+    }
+
+    memo_[ast->asExpression()] = { entryScopes_.back(), type_, scope_ };
+    entryScopes_.pop_back();
+}
+
 FullySpecifiedType ExpressionTypeEvaluator::commonRealType(const FullySpecifiedType& lhsTy,
                                               const FullySpecifiedType& rhsTy) const
 {
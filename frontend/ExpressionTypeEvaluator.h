@@ -26,6 +26,7 @@
 #include "ASTVisitor.h"
 #include "FullySpecifiedType.h"
 #include <cstddef>
+#include <unordered_map>
 #include <vector>
 
 namespace psyche {
@@ -37,6 +38,14 @@ public:
 
     FullySpecifiedType evaluate(ExpressionAST* ast, Scope* scope);
 
+    /*!
+     * Keep the type of every (sub)expression evaluated, keyed by the AST and the
+     * scope in which it was evaluated, so that an expression is typed once, no
+     * matter how many enclosing expressions are evaluated afterwards. The ASTs
+     * must outlive the evaluator.
+     */
+    void enableMemoization();
+
     FullySpecifiedType commonRealType(const FullySpecifiedType&,
                                       const FullySpecifiedType&) const;
 
@@ -45,6 +54,9 @@ public:
 private:
     void process(const Identifier* id);
 
+    bool preVisit(AST* ast) override;
+    void postVisit(AST* ast) override;
+
     // Expressions
     bool visit(ArrayAccessAST* ast) override;
     bool visit(BinaryExpressionAST* ast) override;
@@ -74,6 +86,17 @@ private:
     FullySpecifiedType type_;
     Scope* scope_;
     std::size_t _memberAccess;
+
+    struct MemoEntry
+    {
+        Scope* scope_;
+        FullySpecifiedType type_;
+        Scope* exitScope_; //!< Lookups may move into a struct's scope.
+    };
+    bool memoize_;
+    bool memoHit_;
+    std::vector<Scope*> entryScopes_;
+    std::unordered_map<const ExpressionAST*, MemoEntry> memo_;
 };
 
 }
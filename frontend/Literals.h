@@ -112,17 +112,17 @@ class CFE_API Identifier: public Literal, public Name
 public:
     Identifier(const char *chars, unsigned size)
         : Literal(chars, size)
+        , Name(NameKind::NameId)
     { }
 
     virtual const Identifier* identifier() const { return this; }
 
-    virtual const Identifier* asNameId() const
-    { return this; }
-
 protected:
     virtual void accept0(NameVisitor* visitor) const;
 };
 
+PSYCHE_DEFINE_NAME_CAST(Identifier, NameId, asNameId)
+
 } // namespace psyche
 
 
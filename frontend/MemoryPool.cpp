@@ -66,11 +66,17 @@ void *MemoryPool::allocate_helper(size_t size)
 
     char *&block = _blocks[_blockCount];
 
-    if (! block)
+    // A request larger than a block (e.g., a contiguous sequence) gets a block of its own.
+    size_t blockSize = BLOCK_SIZE;
+    if (size > blockSize) {
+        blockSize = size;
+        block = (char *) std::realloc(block, blockSize);
+    } else if (! block) {
         block = (char *) std::malloc(BLOCK_SIZE);
+    }
 
     _ptr = block;
-    _end = _ptr + BLOCK_SIZE;
+    _end = _ptr + blockSize;
 
     void *addr = _ptr;
     _ptr += size;
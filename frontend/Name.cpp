@@ -28,39 +28,13 @@
 
 using namespace psyche;
 
-Name::Name()
+Name::Name(NameKind kind)
+    : nameKind_(kind)
 { }
 
 Name::~Name()
 { }
 
-bool Name::isNameId() const
-{ return asNameId() != 0; }
-
-bool Name::isEmptyName() const
-{ return asEmptyName() != 0; }
-
-bool Name::isTemplateNameId() const
-{ return asTemplateNameId() != 0; }
-
-bool Name::isDestructorNameId() const
-{ return asDestructorNameId() != 0; }
-
-bool Name::isOperatorNameId() const
-{ return asOperatorNameId() != 0; }
-
-bool Name::isConversionNameId() const
-{ return asConversionNameId() != 0; }
-
-bool Name::isQualifiedNameId() const
-{ return asQualifiedNameId() != 0; }
-
-bool Name::isSelectorNameId() const
-{ return asSelectorNameId() != 0; }
-
-bool Name::isTaggedNameId() const
-{ return asTaggedNameId() != 0; }
-
 void Name::accept(NameVisitor* visitor) const
 {
     if (visitor->preVisit(this))
@@ -32,32 +32,48 @@ namespace psyche {
 class CFE_API Name
 {
 public:
-    Name();
+    //! The concrete name, for checks and casts without a virtual call.
+    enum class NameKind : unsigned char
+    {
+        EmptyName,
+        NameId,
+        TemplateNameId,
+        DestructorNameId,
+        OperatorNameId,
+        ConversionNameId,
+        QualifiedNameId,
+        SelectorNameId,
+        TaggedNameId,
+    };
+
+    Name(NameKind kind);
     virtual ~Name();
 
+    NameKind nameKind() const { return nameKind_; }
+
     virtual const Identifier* identifier() const = 0;
 
-    bool isEmptyName() const;
+    bool isEmptyName() const { return nameKind_ == NameKind::EmptyName; }
 
-    bool isNameId() const;
-    bool isTemplateNameId() const;
-    bool isDestructorNameId() const;
-    bool isOperatorNameId() const;
-    bool isConversionNameId() const;
-    bool isQualifiedNameId() const;
-    bool isSelectorNameId() const;
-    bool isTaggedNameId() const;
+    bool isNameId() const { return nameKind_ == NameKind::NameId; }
+    bool isTemplateNameId() const { return nameKind_ == NameKind::TemplateNameId; }
+    bool isDestructorNameId() const { return nameKind_ == NameKind::DestructorNameId; }
+    bool isOperatorNameId() const { return nameKind_ == NameKind::OperatorNameId; }
+    bool isConversionNameId() const { return nameKind_ == NameKind::ConversionNameId; }
+    bool isQualifiedNameId() const { return nameKind_ == NameKind::QualifiedNameId; }
+    bool isSelectorNameId() const { return nameKind_ == NameKind::SelectorNameId; }
+    bool isTaggedNameId() const { return nameKind_ == NameKind::TaggedNameId; }
 
-    virtual const EmptyName *asEmptyName() const { return 0; }
+    inline const EmptyName* asEmptyName() const;
 
-    virtual const Identifier* asNameId() const { return 0; }
-    virtual const TemplateNameId *asTemplateNameId() const { return 0; }
-    virtual const DestructorNameId *asDestructorNameId() const { return 0; }
-    virtual const OperatorNameId *asOperatorNameId() const { return 0; }
-    virtual const ConversionNameId *asConversionNameId() const { return 0; }
-    virtual const QualifiedNameId *asQualifiedNameId() const { return 0; }
-    virtual const SelectorNameId *asSelectorNameId() const { return 0; }
-    virtual const TaggedNameId *asTaggedNameId() const { return 0; }
+    inline const Identifier* asNameId() const;
+    inline const TemplateNameId* asTemplateNameId() const;
+    inline const DestructorNameId* asDestructorNameId() const;
+    inline const OperatorNameId* asOperatorNameId() const;
+    inline const ConversionNameId* asConversionNameId() const;
+    inline const QualifiedNameId* asQualifiedNameId() const;
+    inline const SelectorNameId* asSelectorNameId() const;
+    inline const TaggedNameId* asTaggedNameId() const;
 
     void accept(NameVisitor* visitor) const;
     static void accept(const Name* name, NameVisitor* visitor);
@@ -69,8 +85,18 @@ public:
 
 protected:
     virtual void accept0(NameVisitor* visitor) const = 0;
+
+private:
+    NameKind nameKind_;
 };
 
+/*
+ * Define the cast of a concrete name; used by the headers that declare them.
+ */
+#define PSYCHE_DEFINE_NAME_CAST(CLASS, KIND, FUNC) \
+    inline const CLASS* Name::FUNC() const \
+    { return nameKind_ == NameKind::KIND ? static_cast<const CLASS*>(this) : nullptr; }
+
 } // namespace psyche
 
 
@@ -48,7 +48,8 @@ const Name* QualifiedNameId::name() const
 { return _name; }
 
 DestructorNameId::DestructorNameId(const Name* name)
-    : _name(name)
+    : Name(NameKind::DestructorNameId)
+    , _name(name)
 { }
 
 DestructorNameId::~DestructorNameId()
@@ -113,7 +114,8 @@ bool TemplateNameId::Compare::operator()(const TemplateNameId *name,
 }
 
 OperatorNameId::OperatorNameId(Kind kind)
-    : _kind(kind)
+    : Name(NameKind::OperatorNameId)
+    , _kind(kind)
 { }
 
 OperatorNameId::~OperatorNameId()
@@ -129,7 +131,8 @@ const Identifier* OperatorNameId::identifier() const
 { return 0; }
 
 TaggedNameId::TaggedNameId(Tag tag, const Name* name)
-    : _tag(tag)
+    : Name(NameKind::TaggedNameId)
+    , _tag(tag)
     , _name(name)
 { }
 
@@ -149,7 +152,8 @@ const Identifier* TaggedNameId::identifier() const
 { return _name->identifier(); }
 
 ConversionNameId::ConversionNameId(const FullySpecifiedType &type)
-    : _type(type)
+    : Name(NameKind::ConversionNameId)
+    , _type(type)
 { }
 
 ConversionNameId::~ConversionNameId()
@@ -188,6 +192,7 @@ bool SelectorNameId::hasArguments() const
 { return _hasArguments; }
 
 EmptyName::EmptyName()
+    : Name(NameKind::EmptyName)
 { }
 
 EmptyName::~EmptyName()
@@ -34,7 +34,7 @@ class CFE_API QualifiedNameId: public Name
 {
 public:
     QualifiedNameId(const Name* base, const Name* name)
-        : _base(base), _name(name) {}
+        : Name(NameKind::QualifiedNameId), _base(base), _name(name) {}
 
     virtual ~QualifiedNameId();
 
@@ -43,9 +43,6 @@ public:
     const Name* base() const;
     const Name* name() const;
 
-    virtual const QualifiedNameId *asQualifiedNameId() const
-    { return this; }
-
 protected:
     virtual void accept0(NameVisitor* visitor) const;
 
@@ -64,9 +61,6 @@ public:
 
     virtual const Identifier* identifier() const;
 
-    virtual const DestructorNameId *asDestructorNameId() const
-    { return this; }
-
 protected:
     virtual void accept0(NameVisitor* visitor) const;
 
@@ -80,7 +74,8 @@ public:
     template <typename Iterator>
     TemplateNameId(const Identifier* identifier, bool isSpecialization, Iterator first,
                    Iterator last)
-        : _identifier(identifier)
+        : Name(NameKind::TemplateNameId)
+        , _identifier(identifier)
         , _templateArguments(first, last)
         , _isSpecialization(isSpecialization) {}
 
@@ -92,9 +87,6 @@ public:
     unsigned templateArgumentCount() const;
     const FullySpecifiedType &templateArgumentAt(unsigned index) const;
 
-    virtual const TemplateNameId *asTemplateNameId() const
-    { return this; }
-
     typedef std::vector<FullySpecifiedType>::const_iterator TemplateArgumentIterator;
 
     TemplateArgumentIterator firstTemplateArgument() const { return _templateArguments.begin(); }
@@ -184,9 +176,6 @@ public:
 
     virtual const Identifier* identifier() const;
 
-    virtual const OperatorNameId *asOperatorNameId() const
-    { return this; }
-
 protected:
     virtual void accept0(NameVisitor* visitor) const;
 
@@ -214,9 +203,6 @@ public:
 
     virtual const Identifier* identifier() const;
 
-    virtual const TaggedNameId *asTaggedNameId() const
-    { return this; }
-
 protected:
     virtual void accept0(NameVisitor* visitor) const;
 
@@ -235,9 +221,6 @@ public:
 
     virtual const Identifier* identifier() const;
 
-    virtual const ConversionNameId *asConversionNameId() const
-    { return this; }
-
 protected:
     virtual void accept0(NameVisitor* visitor) const;
 
@@ -250,7 +233,7 @@ class CFE_API SelectorNameId: public Name
 public:
     template <typename Iterator>
     SelectorNameId(Iterator first, Iterator last, bool hasArguments)
-        : _names(first, last), _hasArguments(hasArguments) {}
+        : Name(NameKind::SelectorNameId), _names(first, last), _hasArguments(hasArguments) {}
 
     virtual ~SelectorNameId();
 
@@ -260,9 +243,6 @@ public:
     const Name* nameAt(unsigned index) const;
     bool hasArguments() const;
 
-    virtual const SelectorNameId *asSelectorNameId() const
-    { return this; }
-
     typedef std::vector<const Name* >::const_iterator NameIterator;
 
     NameIterator firstName() const { return _names.begin(); }
@@ -284,13 +264,19 @@ public:
 
     virtual const Identifier* identifier() const;
 
-    virtual const EmptyName *asEmptyName() const
-    { return this; }
-
 protected:
     virtual void accept0(NameVisitor* visitor) const;
 };
 
+PSYCHE_DEFINE_NAME_CAST(EmptyName, EmptyName, asEmptyName)
+PSYCHE_DEFINE_NAME_CAST(TemplateNameId, TemplateNameId, asTemplateNameId)
+PSYCHE_DEFINE_NAME_CAST(DestructorNameId, DestructorNameId, asDestructorNameId)
+PSYCHE_DEFINE_NAME_CAST(OperatorNameId, OperatorNameId, asOperatorNameId)
+PSYCHE_DEFINE_NAME_CAST(ConversionNameId, ConversionNameId, asConversionNameId)
+PSYCHE_DEFINE_NAME_CAST(QualifiedNameId, QualifiedNameId, asQualifiedNameId)
+PSYCHE_DEFINE_NAME_CAST(SelectorNameId, SelectorNameId, asSelectorNameId)
+PSYCHE_DEFINE_NAME_CAST(TaggedNameId, TaggedNameId, asTaggedNameId)
+
 } // namespace psyche
 
 #endif
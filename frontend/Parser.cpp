@@ -24,6 +24,7 @@
 #include "Lexer.h"
 #include "Control.h"
 #include "AST.h"
+#include "ASTListBuilder.h"
 #include "Literals.h"
 #include <iostream>
 #include <unordered_map>
@@ -166,34 +167,69 @@ public:
         ExpressionList,
         ParameterDeclarationClause,
         TemplateId,
-        TypeId
+        TypeId,
+
+        // Rules of the packrat memo: attempts are recorded regardless of their
+        // outcome, within a memory budget.
+        CastExpression,
+        DeclarationStatement,
+        Declarator
     };
 
 public:
-    ASTCache() {}
+    ASTCache(TranslationUnit::ParseStats *stats, std::size_t memoBudget)
+        : _stats(stats)
+    {
+        setMemoBudget(memoBudget);
+    }
+
+    void setMemoBudget(std::size_t bytes)
+    {
+        _memoCapacity = bytes / kMemoEntrySize;
+    }
+
+    bool memoEnabled() const { return _memoCapacity != 0; }
 
     void insert(ASTKind astKind, unsigned tokenIndexBeforeParsing,
-                AST* resultingAST, unsigned resultingTokenIndex, bool resultingReturnValue)
+                AST* resultingAST, unsigned resultingTokenIndex, bool resultingReturnValue,
+                unsigned variant = 0)
     {
-        const auto key = std::make_pair(astKind, tokenIndexBeforeParsing);
+        const auto key = std::make_pair(astKind | (variant << 8), tokenIndexBeforeParsing);
 
         ParseFunctionResult result;
         result.resultingAST = resultingAST;
         result.resultingTokenIndex = resultingTokenIndex;
         result.returnValue = resultingReturnValue;
         const auto keyValue = std::make_pair(key, result);
-        _cache.insert(keyValue);
+
+        if (astKind < CastExpression) {
+            _cache.insert(keyValue);
+            return;
+        }
+
+        if (!memoEnabled())
+            return;
+        if (_memo.size() >= _memoCapacity) {
+            _memo.clear();
+            ++_stats->memoFlushes_;
+        }
+        if (_memo.insert(keyValue).second)
+            ++_stats->memoInserts_;
     }
 
     AST* find(ASTKind astKind, unsigned tokenIndex,
-              unsigned *resultingTokenIndex, bool *foundInCache, bool *returnValue) const
+              unsigned *resultingTokenIndex, bool *foundInCache, bool *returnValue,
+              unsigned variant = 0) const
     {
-        const auto key = std::make_pair(astKind, tokenIndex);
-        const auto it = _cache.find(key);
-        if (it == _cache.end()) {
+        ++_stats->memoLookups_;
+        const auto key = std::make_pair(astKind | (variant << 8), tokenIndex);
+        const Cache& cache = astKind < CastExpression ? _cache : _memo;
+        const auto it = cache.find(key);
+        if (it == cache.end()) {
             *foundInCache = false;
             return 0;
         } else {
+            ++_stats->memoHits_;
             *foundInCache = true;
             *resultingTokenIndex = it->second.resultingTokenIndex;
             *returnValue = it->second.returnValue;
@@ -204,6 +240,7 @@ public:
     void clear()
     {
         _cache.clear();
+        _memo.clear();
     }
 
 private:
@@ -219,7 +256,16 @@ private:
     };
 
     typedef std::pair<int, unsigned> ASTKindAndTokenIndex;
-    std::unordered_map<ASTKindAndTokenIndex, ParseFunctionResult, KeyHasher> _cache;
+    typedef std::unordered_map<ASTKindAndTokenIndex, ParseFunctionResult, KeyHasher> Cache;
+
+    // Approximate footprint of a hash node: key, value, next pointer, and a bucket.
+    static constexpr std::size_t kMemoEntrySize =
+            sizeof(ASTKindAndTokenIndex) + sizeof(ParseFunctionResult) + 2 * sizeof(void*);
+
+    Cache _cache;
+    Cache _memo;
+    std::size_t _memoCapacity;
+    TranslationUnit::ParseStats *_stats;
 };
 
 #ifndef PSYCHE_NO_DEBUG_RULE
@@ -255,6 +301,44 @@ inline void debugPrintCheckCache(bool) {}
         } \
     } while (0)
 
+// Packrat memoization of a rule whose body is in RULE_##_. An attempt is recorded
+// whatever its outcome, but only if it reported no diagnostic and hit no depth
+// limit (those fail silently and depend on the nesting at which the rule is
+// tried), so that a later hit reproduces exactly what re-parsing would. Other
+// parser state needs no place in the key: within an expression statement, the
+// table in use is a separate one, and the initializer nesting matters only at
+// its limit. The memo keeps a pristine copy of the node and every hit gets a
+// copy of its own, since the node may end up in another alternative of an
+// ambiguity, and callers (and, later, the binder) modify what they get.
+#define MEMOIZE_RULE(ASTKind, ASTType, VARIANT, BODY) \
+    do { \
+        if (! _language.isC() || ! _astCache->memoEnabled()) \
+            return BODY; \
+        const unsigned memoVariant = ((VARIANT) << 1) | _translationUnit->blockErrors(); \
+        const unsigned memoStart = cursor(); \
+        bool foundInMemo; \
+        unsigned memoEnd; \
+        bool memoValue; \
+        AST* memoAST = _astCache->find(ASTKind, memoStart, &memoEnd, &foundInMemo, \
+                                       &memoValue, memoVariant); \
+        if (foundInMemo) { \
+            debugPrintCheckCache(memoValue); \
+            if (memoValue) \
+                node = memoAST ? ((ASTType *) memoAST)->clone(_pool) : 0; \
+            _tokenIndex = memoEnd; \
+            return memoValue; \
+        } \
+        const unsigned diagnosticCount = _translationUnit->diagnosticCount(); \
+        const unsigned depthLimitHits = _depthLimitHits; \
+        const bool memoResult = BODY; \
+        if (diagnosticCount == _translationUnit->diagnosticCount() \
+                && depthLimitHits == _depthLimitHits) { \
+            AST* result = memoResult && node ? node->clone(_pool) : 0; \
+            _astCache->insert(ASTKind, memoStart, result, cursor(), memoResult, memoVariant); \
+        } \
+        return memoResult; \
+    } while (0)
+
 #define PARSE_EXPRESSION_WITH_OPERATOR_PRECEDENCE(node, minPrecedence) { \
     if (LA() == T_THROW) { \
         if (!parseThrowExpression(node)) \
@@ -277,8 +361,9 @@ Parser::Parser(TranslationUnit *unit)
       _inExpressionStatement(false),
       _expressionDepth(0),
       _statementDepth(0),
-      _astCache(new ASTCache),
-      _expressionStatementAstCache(new ASTCache)
+      _depthLimitHits(0),
+      _astCache(new ASTCache(&_stats, unit->parseMemoBudget())),
+      _expressionStatementAstCache(new ASTCache(&_stats, unit->parseMemoBudget()))
 { }
 
 Parser::~Parser()
@@ -287,6 +372,12 @@ Parser::~Parser()
     delete _astCache;
 }
 
+void Parser::setMemoBudget(std::size_t bytes)
+{
+    _astCache->setMemoBudget(bytes);
+    _expressionStatementAstCache->setMemoBudget(bytes);
+}
+
 bool Parser::switchTemplateArguments(bool templateArguments)
 {
     bool previousTemplateArguments = _templateArguments;
@@ -606,7 +697,7 @@ bool Parser::parseTranslationUnit(TranslationUnitAST* &node)
 {
     DEBUG_THIS_RULE();
     TranslationUnitAST* ast = new (_pool) TranslationUnitAST;
-    DeclarationListAST* *decl = &ast->declaration_list;
+    ASTListBuilder<DeclarationListAST> decls;
 
     while (LA()) {
         unsigned start_declaration = cursor();
@@ -614,9 +705,7 @@ bool Parser::parseTranslationUnit(TranslationUnitAST* &node)
         DeclarationAST* declaration = 0;
 
         if (parseDeclaration(declaration)) {
-            *decl = new (_pool) DeclarationListAST;
-            (*decl)->value = declaration;
-            decl = &(*decl)->next;
+            decls.add(declaration);
         } else {
             error(start_declaration, "expected a declaration");
             rewind(start_declaration + 1);
@@ -631,6 +720,7 @@ bool Parser::parseTranslationUnit(TranslationUnitAST* &node)
 
         _templateArgumentList.clear();
     }
+    ast->declaration_list = decls.finish(_pool);
 
     node = ast;
     return true;
@@ -1539,6 +1629,13 @@ static bool maybeCppInitializer(DeclaratorAST* declarator)
 }
 
 bool Parser::parseDeclarator(DeclaratorAST* &node, SpecifierListAST* decl_specifier_list, ClassSpecifierAST* declaringClass)
+{
+    MEMOIZE_RULE(ASTCache::Declarator, DeclaratorAST,
+                 ((decl_specifier_list != 0) << 1) | (declaringClass != 0),
+                 parseDeclarator_(node, decl_specifier_list, declaringClass));
+}
+
+bool Parser::parseDeclarator_(DeclaratorAST* &node, SpecifierListAST* decl_specifier_list, ClassSpecifierAST* declaringClass)
 {
     DEBUG_THIS_RULE();
     if (! parseCoreDeclarator(node, decl_specifier_list, declaringClass))
@@ -2522,15 +2619,13 @@ bool Parser::parseInitializerClause0x(ExpressionAST* &node)
 bool Parser::parseInitializerList0x(ExpressionListAST* &node)
 {
     DEBUG_THIS_RULE();
-    ExpressionListAST* *expression_list_ptr = &node;
+    ASTListBuilder<ExpressionListAST> expressions;
     ExpressionAST* expression = 0;
 
     _initializerClauseDepth.push(1);
 
     if (parseInitializerClause0x(expression)) {
-        *expression_list_ptr = new (_pool) ExpressionListAST;
-        (*expression_list_ptr)->value = expression;
-        expression_list_ptr = &(*expression_list_ptr)->next;
+        expressions.add(expression);
 
         if (_language.cpp11 && LA() == T_DOT_DOT_DOT && (LA(2) == T_COMMA || LA(2) == T_RBRACE || LA(2) == T_RPAREN))
             consumeToken(); // ### create an argument pack
@@ -2543,21 +2638,21 @@ bool Parser::parseInitializerList0x(ExpressionListAST* &node)
             consumeToken(); // consume T_COMMA
 
             if (parseInitializerClause0x(expression)) {
-                *expression_list_ptr = new (_pool) ExpressionListAST;
-                (*expression_list_ptr)->value = expression;
+                expressions.add(expression);
 
                 if (_language.cpp11 && LA() == T_DOT_DOT_DOT && (LA(2) == T_COMMA || LA(2) == T_RBRACE || LA(2) == T_RPAREN))
                     consumeToken(); // ### create an argument pack
-
-                expression_list_ptr = &(*expression_list_ptr)->next;
             }
         }
     }
+    node = expressions.finish(_pool);
 
     const bool result = _initializerClauseDepth.top() <= MAX_EXPRESSION_DEPTH;
     _initializerClauseDepth.pop();
-    if (!result)
+    if (!result) {
+        ++_depthLimitHits;
         warning(cursor(), "Reached parse limit for initializer clause");
+    }
     return result;
 }
 
@@ -2818,21 +2913,18 @@ bool Parser::parseBaseSpecifier(BaseSpecifierListAST* &node)
 bool Parser::parseInitializerList(ExpressionListAST* &node)
 {
     DEBUG_THIS_RULE();
-    ExpressionListAST* *initializer_ptr = &node;
+    ASTListBuilder<ExpressionListAST> initializers;
     ExpressionAST* initializer = 0;
     if (parseInitializerClause(initializer)) {
-        *initializer_ptr = new (_pool) ExpressionListAST;
-        (*initializer_ptr)->value = initializer;
-        initializer_ptr = &(*initializer_ptr)->next;
+        initializers.add(initializer);
         while (LA() == T_COMMA) {
             consumeToken(); // consume T_COMMA
             initializer = 0;
             parseInitializerClause(initializer);
-            *initializer_ptr = new (_pool) ExpressionListAST;
-            (*initializer_ptr)->value = initializer;
-            initializer_ptr = &(*initializer_ptr)->next;
+            initializers.add(initializer);
         }
     }
+    node = initializers.finish(_pool);
 
     if (_language.cpp11 && LA() == T_DOT_DOT_DOT)
         consumeToken(); // ### store this token
@@ -3456,14 +3548,16 @@ bool Parser::parseCompoundStatement(StatementAST* &node)
     DEBUG_THIS_RULE();
 
     if (LA() == T_LBRACE) {
-        if (_statementDepth > MAX_STATEMENT_DEPTH)
+        if (_statementDepth > MAX_STATEMENT_DEPTH) {
+            ++_depthLimitHits;
             return false;
+        }
         ++_statementDepth;
 
         CompoundStatementAST* ast = new (_pool) CompoundStatementAST;
         ast->lbrace_token = consumeToken();
 
-        StatementListAST* *statement_ptr = &ast->statement_list;
+        ASTListBuilder<StatementListAST> statements;
         while (int tk = LA()) {
             if (tk == T_RBRACE)
                 break;
@@ -3474,11 +3568,10 @@ bool Parser::parseCompoundStatement(StatementAST* &node)
                 rewind(start_statement + 1);
                 skipUntilStatement();
             } else {
-                *statement_ptr = new (_pool) StatementListAST;
-                (*statement_ptr)->value = statement;
-                statement_ptr = &(*statement_ptr)->next;
+                statements.add(statement);
             }
         }
+        ast->statement_list = statements.finish(_pool);
         match(T_RBRACE, &ast->rbrace_token);
         node = ast;
         --_statementDepth;
@@ -3607,6 +3700,12 @@ bool Parser::parseNamespaceAliasDefinition(DeclarationAST* &node)
 }
 
 bool Parser::parseDeclarationStatement(StatementAST* &node)
+{
+    MEMOIZE_RULE(ASTCache::DeclarationStatement, StatementAST, 0,
+                 parseDeclarationStatement_(node));
+}
+
+bool Parser::parseDeclarationStatement_(StatementAST* &node)
 {
     DEBUG_THIS_RULE();
     unsigned start = cursor();
@@ -4886,6 +4985,12 @@ bool Parser::parseDeleteExpression(ExpressionAST* &node)
 }
 
 bool Parser::parseCastExpression(ExpressionAST* &node)
+{
+    MEMOIZE_RULE(ASTCache::CastExpression, ExpressionAST, _templateArguments,
+                 parseCastExpression_(node));
+}
+
+bool Parser::parseCastExpression_(ExpressionAST* &node)
 {
     DEBUG_THIS_RULE();
     if (LA() == T_LPAREN) {
@@ -5033,8 +5138,10 @@ bool Parser::parseExpression(ExpressionAST* &node)
     CHECK_CACHE(ASTCache::Expression, ExpressionAST);
     unsigned initialCursor = cursor();
 
-    if (_expressionDepth > MAX_EXPRESSION_DEPTH)
+    if (_expressionDepth > MAX_EXPRESSION_DEPTH) {
+        ++_depthLimitHits;
         return false;
+    }
 
     ++_expressionDepth;
     bool success = parseCommaExpression(node);
@@ -5051,6 +5158,7 @@ void Parser::parseExpressionWithOperatorPrecedence(ExpressionAST* &lhs, int minP
     unsigned iterations = 0;
     while (precedence(token().kind(), _templateArguments) >= minPrecedence) {
         if (++iterations > MAX_EXPRESSION_DEPTH) {
+            ++_depthLimitHits;
             warning(cursor(), "Reached parse limit for expression");
             return;
         }
@@ -5385,6 +5493,9 @@ void Parser::rewind(unsigned cursor)
         fprintf(stderr, "! rewinding from token %d to token %d\n", _tokenIndex, cursor);
 #endif
 
+    if (cursor < _tokenIndex)
+        ++_stats.backtracks_;
+
     const unsigned n = _translationUnit->tokenCount();
     if (cursor < n)
         _tokenIndex = cursor;
@@ -28,6 +28,7 @@
 #include "MemoryPool.h"
 #include "Token.h"
 #include "TranslationUnit.h"
+#include <cstddef>
 #include <map>
 #include <stack>
 
@@ -41,6 +42,10 @@ public:
 
     bool parseTranslationUnit(TranslationUnitAST* &node);
 
+    //! The memory, in bytes, the memo table may take (0 disables memoization).
+    void setMemoBudget(std::size_t bytes);
+    const TranslationUnit::ParseStats& stats() const { return _stats; }
+
 public:
     bool parseExpressionList(ExpressionListAST* &node);
     bool parseAbstractCoreDeclarator(DeclaratorAST* &node, SpecifierListAST* decl_specifier_list);
@@ -278,6 +283,7 @@ private:
     int _expressionDepth;
     int _statementDepth;
     std::stack<int> _initializerClauseDepth;
+    unsigned _depthLimitHits;
 
     MemoryPool _expressionStatementTempPool;
     std::map<unsigned, TemplateArgumentListEntry> _templateArgumentList;
@@ -286,6 +292,12 @@ private:
     ASTCache *_astCache;
     ASTCache *_expressionStatementAstCache;
 
+    TranslationUnit::ParseStats _stats;
+
+    bool parseCastExpression_(ExpressionAST* &node);
+    bool parseDeclarationStatement_(StatementAST* &node);
+    bool parseDeclarator_(DeclaratorAST* &node, SpecifierListAST* decl_specifier_list, ClassSpecifierAST* declaringClass);
+
 private:
     Parser(const Parser& source);
     void operator =(const Parser& source);
@@ -148,26 +148,33 @@ Symbol* SymbolTable::lookat(const Identifier* id) const
     Symbol* symbol = _hash[h];
     for (; symbol; symbol = symbol->_next) {
         const Name* identity = symbol->unqualifiedName();
-        if (! identity) {
+        if (! identity)
             continue;
-        } else if (const Identifier* nameId = identity->asNameId()) {
-            if (check(nameId->identifier()))
-                    break;
-        } else if (const TaggedNameId *elabName = identity->asTaggedNameId()) {
-            if (check(elabName->identifier()))
-                    break;
-        } else if (const TemplateNameId *t = identity->asTemplateNameId()) {
-            if (check(t->identifier()))
-                break;
-        } else if (const DestructorNameId *d = identity->asDestructorNameId()) {
-            if (check(d->identifier()))
-                break;
-        } else if (identity->isQualifiedNameId()) {
+
+        const Identifier* otherId;
+        switch (identity->nameKind()) {
+        case Name::NameKind::NameId:
+            otherId = static_cast<const Identifier*>(identity);
+            break;
+        case Name::NameKind::TaggedNameId:
+            otherId = static_cast<const TaggedNameId*>(identity)->identifier();
+            break;
+        case Name::NameKind::TemplateNameId:
+            otherId = static_cast<const TemplateNameId*>(identity)->identifier();
+            break;
+        case Name::NameKind::DestructorNameId:
+            otherId = static_cast<const DestructorNameId*>(identity)->identifier();
+            break;
+        case Name::NameKind::SelectorNameId:
+            otherId = static_cast<const SelectorNameId*>(identity)->identifier();
+            break;
+        case Name::NameKind::QualifiedNameId:
             return 0;
-        } else if (const SelectorNameId *selectorNameId = identity->asSelectorNameId()) {
-            if (check(selectorNameId->identifier()))
-                break;
+        default:
+            continue;
         }
+        if (check(otherId))
+            break;
     }
     return symbol;
 }
@@ -180,11 +187,11 @@ Symbol* SymbolTable::lookat(OperatorNameId::Kind operatorId) const
     const unsigned h = operatorId % _hashSize;
     Symbol* symbol = _hash[h];
     for (; symbol; symbol = symbol->_next) {
-        if (const Name* identity = symbol->unqualifiedName()) {
-            if (const OperatorNameId *op = identity->asOperatorNameId()) {
-                if (op->kind() == operatorId)
-                    break;
-            }
+        const Name* identity = symbol->unqualifiedName();
+        if (identity
+                && identity->isOperatorNameId()
+                && static_cast<const OperatorNameId*>(identity)->kind() == operatorId) {
+            break;
         }
     }
     return symbol;
@@ -235,8 +242,8 @@ SymbolTable::iterator SymbolTable::firstSymbol() const
 SymbolTable::iterator SymbolTable::lastSymbol() const
 { return _symbols + _symbolCount + 1; }
 
-Scope::Scope(TranslationUnit *translationUnit, unsigned sourceLocation, const Name* name)
-    : Symbol(translationUnit, sourceLocation, name),
+Scope::Scope(SymbolKind kind, TranslationUnit *translationUnit, unsigned sourceLocation, const Name* name)
+    : Symbol(kind, translationUnit, sourceLocation, name),
       _members(0),
       _startOffset(0),
       _endOffset(0)
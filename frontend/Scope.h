@@ -32,7 +32,7 @@ namespace psyche {
 class CFE_API Scope: public Symbol
 {
 public:
-    Scope(TranslationUnit *translationUnit, unsigned sourceLocation, const Name* name);
+    Scope(SymbolKind kind, TranslationUnit *translationUnit, unsigned sourceLocation, const Name* name);
     Scope(Clone *clone, Subst *subst, Scope *original);
     virtual ~Scope();
 
@@ -69,19 +69,14 @@ public:
     unsigned endOffset() const;
     void setEndOffset(unsigned offset);
 
-    virtual const Scope *asScope() const
-    { return this; }
-
-    virtual Scope *asScope()
-    { return this; }
-
 private:
     SymbolTable *_members;
     unsigned _startOffset;
     unsigned _endOffset;
 };
 
-} // namespace psyche
+PSYCHE_DEFINE_SYMBOL_CAST(Scope, asScope)
 
+} // namespace psyche
 
 #endif
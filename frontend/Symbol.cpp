@@ -83,8 +83,9 @@ private:
     unsigned _value;
 };
 
-Symbol::Symbol(TranslationUnit *translationUnit, unsigned sourceLocation, const Name* name)
-    : _name(0),
+Symbol::Symbol(SymbolKind kind, TranslationUnit *translationUnit, unsigned sourceLocation, const Name* name)
+    : _symbolKind(kind),
+      _name(0),
       _enclosingScope(0),
       _next(0),
       _fileId(0),
@@ -104,7 +105,8 @@ Symbol::Symbol(TranslationUnit *translationUnit, unsigned sourceLocation, const
 }
 
 Symbol::Symbol(Clone *clone, Subst *subst, Symbol* original)
-    : _name(clone->name(original->_name, subst)),
+    : _symbolKind(original->_symbolKind),
+      _name(clone->name(original->_name, subst)),
       _enclosingScope(0),
       _next(0),
       _fileId(clone->control()->stringLiteral(original->fileName(), original->fileNameLength())),
@@ -346,48 +348,6 @@ bool Symbol::isProtected() const
 bool Symbol::isPrivate() const
 { return _visibility == Private; }
 
-bool Symbol::isScope() const
-{ return asScope() != 0; }
-
-bool Symbol::isEnum() const
-{ return asEnum()  != 0; }
-
-bool Symbol::isFunction() const
-{ return asFunction() != 0; }
-
-bool Symbol::isNamespace() const
-{ return asNamespace() != 0; }
-
-bool Symbol::isTemplate() const
-{ return asTemplate() != 0; }
-
-bool Symbol::isClass() const
-{ return asClass() != 0; }
-
-bool Symbol::isForwardClassDeclaration() const
-{ return asForwardClassDeclaration() != 0; }
-
-bool Symbol::isBlock() const
-{ return asBlock() != 0; }
-
-bool Symbol::isUsingNamespaceDirective() const
-{ return asUsingNamespaceDirective() != 0; }
-
-bool Symbol::isUsingDeclaration() const
-{ return asUsingDeclaration() != 0; }
-
-bool Symbol::isDeclaration() const
-{ return asDeclaration() != 0; }
-
-bool Symbol::isArgument() const
-{ return asArgument() != 0; }
-
-bool Symbol::isTypenameArgument() const
-{ return asTypenameArgument() != 0; }
-
-bool Symbol::isBaseClass() const
-{ return asBaseClass() != 0; }
-
 void Symbol::copy(Symbol* other)
 {
     _sourceLocation = other->_sourceLocation;
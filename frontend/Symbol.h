@@ -53,14 +53,36 @@ public:
         Package
     };
 
+    /// The concrete symbol; the scopes come last, starting at Block.
+    enum class SymbolKind : unsigned char {
+        UsingNamespaceDirective,
+        UsingDeclaration,
+        NamespaceAlias,
+        Declaration,
+        EnumeratorDeclaration,
+        Argument,
+        TypenameArgument,
+        BaseClass,
+        ForwardClassDeclaration,
+        Block,
+        Enum,
+        Function,
+        Template,
+        Namespace,
+        Class,
+    };
+
 public:
-    /// Constructs a Symbol with the given source location, name and translation unit.
-    Symbol(TranslationUnit *translationUnit, unsigned sourceLocation, const Name* name);
+    /// Constructs a Symbol with the given kind, source location, name and translation unit.
+    Symbol(SymbolKind kind, TranslationUnit *translationUnit, unsigned sourceLocation, const Name* name);
     Symbol(Clone *clone, Subst *subst, Symbol* original);
 
     /// Destroy this Symbol.
     virtual ~Symbol();
 
+    /// Returns this Symbol's kind.
+    SymbolKind symbolKind() const { return _symbolKind; }
+
     /// Returns this Symbol's source location.
     unsigned sourceLocation() const;
 
@@ -131,78 +153,85 @@ public:
     bool isPrivate() const;
 
     /// Returns true if this Symbol is a Scope.
-    bool isScope() const;
+    bool isScope() const { return _symbolKind >= SymbolKind::Block; }
 
     /// Returns true if this Symbol is an Enum.
-    bool isEnum() const;
+    bool isEnum() const { return _symbolKind == SymbolKind::Enum; }
 
     /// Returns true if this Symbol is an Function.
-    bool isFunction() const;
+    bool isFunction() const { return _symbolKind == SymbolKind::Function; }
 
     /// Returns true if this Symbol is a Namespace.
-    bool isNamespace() const;
+    bool isNamespace() const { return _symbolKind == SymbolKind::Namespace; }
+
+    /// Returns true if this Symbol is a NamespaceAlias.
+    bool isNamespaceAlias() const { return _symbolKind == SymbolKind::NamespaceAlias; }
 
     /// Returns true if this Symbol is a Template.
-    bool isTemplate() const;
+    bool isTemplate() const { return _symbolKind == SymbolKind::Template; }
 
     /// Returns true if this Symbol is a Class.
-    bool isClass() const;
+    bool isClass() const { return _symbolKind == SymbolKind::Class; }
 
     /// Returns true if this Symbol is a Block.
-    bool isBlock() const;
+    bool isBlock() const { return _symbolKind == SymbolKind::Block; }
 
     /// Returns true if this Symbol is a UsingNamespaceDirective.
-    bool isUsingNamespaceDirective() const;
+    bool isUsingNamespaceDirective() const { return _symbolKind == SymbolKind::UsingNamespaceDirective; }
 
     /// Returns true if this Symbol is a UsingDeclaration.
-    bool isUsingDeclaration() const;
+    bool isUsingDeclaration() const { return _symbolKind == SymbolKind::UsingDeclaration; }
 
     /// Returns true if this Symbol is a Declaration.
-    bool isDeclaration() const;
+    bool isDeclaration() const
+    {
+        return _symbolKind == SymbolKind::Declaration
+                || _symbolKind == SymbolKind::EnumeratorDeclaration;
+    }
 
     /// Returns true if this Symbol is an Argument.
-    bool isArgument() const;
+    bool isArgument() const { return _symbolKind == SymbolKind::Argument; }
 
     /// Returns true if this Symbol is a Typename argument.
-    bool isTypenameArgument() const;
+    bool isTypenameArgument() const { return _symbolKind == SymbolKind::TypenameArgument; }
 
     /// Returns true if this Symbol is a BaseClass.
-    bool isBaseClass() const;
+    bool isBaseClass() const { return _symbolKind == SymbolKind::BaseClass; }
 
     /// Returns true if this Symbol is a ForwardClassDeclaration.
-    bool isForwardClassDeclaration() const;
-
-    virtual const Scope *asScope() const { return 0; }
-    virtual const Enum *asEnum() const { return 0; }
-    virtual const Function *asFunction() const { return 0; }
-    virtual const Namespace *asNamespace() const { return 0; }
-    virtual const Template *asTemplate() const { return 0; }
-    virtual const NamespaceAlias *asNamespaceAlias() const { return 0; }
-    virtual const Class *asClass() const { return 0; }
-    virtual const Block *asBlock() const { return 0; }
-    virtual const UsingNamespaceDirective *asUsingNamespaceDirective() const { return 0; }
-    virtual const UsingDeclaration *asUsingDeclaration() const { return 0; }
-    virtual const Declaration *asDeclaration() const { return 0; }
-    virtual const Argument *asArgument() const { return 0; }
-    virtual const TypenameArgument *asTypenameArgument() const { return 0; }
-    virtual const BaseClass *asBaseClass() const { return 0; }
-    virtual const ForwardClassDeclaration *asForwardClassDeclaration() const { return 0; }
-
-    virtual Scope *asScope() { return 0; }
-    virtual Enum *asEnum() { return 0; }
-    virtual Function *asFunction() { return 0; }
-    virtual Namespace *asNamespace() { return 0; }
-    virtual Template *asTemplate() { return 0; }
-    virtual NamespaceAlias *asNamespaceAlias() { return 0; }
-    virtual Class *asClass() { return 0; }
-    virtual Block *asBlock() { return 0; }
-    virtual UsingNamespaceDirective *asUsingNamespaceDirective() { return 0; }
-    virtual UsingDeclaration *asUsingDeclaration() { return 0; }
-    virtual Declaration *asDeclaration() { return 0; }
-    virtual Argument *asArgument() { return 0; }
-    virtual TypenameArgument *asTypenameArgument() { return 0; }
-    virtual BaseClass *asBaseClass() { return 0; }
-    virtual ForwardClassDeclaration *asForwardClassDeclaration() { return 0; }
+    bool isForwardClassDeclaration() const { return _symbolKind == SymbolKind::ForwardClassDeclaration; }
+
+    inline const Scope *asScope() const;
+    inline const Enum *asEnum() const;
+    inline const Function *asFunction() const;
+    inline const Namespace *asNamespace() const;
+    inline const Template *asTemplate() const;
+    inline const NamespaceAlias *asNamespaceAlias() const;
+    inline const Class *asClass() const;
+    inline const Block *asBlock() const;
+    inline const UsingNamespaceDirective *asUsingNamespaceDirective() const;
+    inline const UsingDeclaration *asUsingDeclaration() const;
+    inline const Declaration *asDeclaration() const;
+    inline const Argument *asArgument() const;
+    inline const TypenameArgument *asTypenameArgument() const;
+    inline const BaseClass *asBaseClass() const;
+    inline const ForwardClassDeclaration *asForwardClassDeclaration() const;
+
+    inline Scope *asScope();
+    inline Enum *asEnum();
+    inline Function *asFunction();
+    inline Namespace *asNamespace();
+    inline Template *asTemplate();
+    inline NamespaceAlias *asNamespaceAlias();
+    inline Class *asClass();
+    inline Block *asBlock();
+    inline UsingNamespaceDirective *asUsingNamespaceDirective();
+    inline UsingDeclaration *asUsingDeclaration();
+    inline Declaration *asDeclaration();
+    inline Argument *asArgument();
+    inline TypenameArgument *asTypenameArgument();
+    inline BaseClass *asBaseClass();
+    inline ForwardClassDeclaration *asForwardClassDeclaration();
 
     /// Returns this Symbol's type.
     virtual FullySpecifiedType type() const = 0;
@@ -257,6 +286,7 @@ protected:
     virtual void visitSymbol0(SymbolVisitor* visitor) = 0;
 
 private:
+    SymbolKind _symbolKind;
     const Name* _name;
     Scope *_enclosingScope;
     Symbol* _next;
@@ -278,6 +308,15 @@ private:
     friend class SymbolTable;
 };
 
+/*
+ * Define the casts of a concrete symbol; used by the headers that declare them.
+ */
+#define PSYCHE_DEFINE_SYMBOL_CAST(CLASS, FUNC) \
+    inline const CLASS* Symbol::FUNC() const \
+    { return is##CLASS() ? static_cast<const CLASS*>(this) : nullptr; } \
+    inline CLASS* Symbol::FUNC() \
+    { return is##CLASS() ? static_cast<CLASS*>(this) : nullptr; }
+
 } // namespace psyche
 
 
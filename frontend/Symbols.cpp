@@ -31,7 +31,7 @@ using namespace psyche;
 
 UsingNamespaceDirective::UsingNamespaceDirective(TranslationUnit *translationUnit,
                                                  unsigned sourceLocation, const Name* name)
-    : Symbol(translationUnit, sourceLocation, name)
+    : Symbol(SymbolKind::UsingNamespaceDirective, translationUnit, sourceLocation, name)
 { }
 
 UsingNamespaceDirective::UsingNamespaceDirective(Clone *clone, Subst *subst, UsingNamespaceDirective *original)
@@ -49,7 +49,7 @@ void UsingNamespaceDirective::visitSymbol0(SymbolVisitor* visitor)
 
 NamespaceAlias::NamespaceAlias(TranslationUnit *translationUnit,
                                unsigned sourceLocation, const Name* name)
-    : Symbol(translationUnit, sourceLocation, name), _namespaceName(0)
+    : Symbol(SymbolKind::NamespaceAlias, translationUnit, sourceLocation, name), _namespaceName(0)
 { }
 
 NamespaceAlias::NamespaceAlias(Clone *clone, Subst *subst, NamespaceAlias *original)
@@ -75,7 +75,7 @@ void NamespaceAlias::visitSymbol0(SymbolVisitor* visitor)
 
 UsingDeclaration::UsingDeclaration(TranslationUnit *translationUnit,
                                    unsigned sourceLocation, const Name* name)
-    : Symbol(translationUnit, sourceLocation, name)
+    : Symbol(SymbolKind::UsingDeclaration, translationUnit, sourceLocation, name)
 { }
 
 UsingDeclaration::UsingDeclaration(Clone *clone, Subst *subst, UsingDeclaration *original)
@@ -92,7 +92,12 @@ void UsingDeclaration::visitSymbol0(SymbolVisitor* visitor)
 { visitor->visit(this); }
 
 Declaration::Declaration(TranslationUnit *translationUnit, unsigned sourceLocation, const Name* name)
-    : Symbol(translationUnit, sourceLocation, name)
+    : Symbol(SymbolKind::Declaration, translationUnit, sourceLocation, name)
+    , _initializer(0)
+{ }
+
+Declaration::Declaration(SymbolKind kind, TranslationUnit *translationUnit, unsigned sourceLocation, const Name* name)
+    : Symbol(kind, translationUnit, sourceLocation, name)
     , _initializer(0)
 { }
 
@@ -125,7 +130,7 @@ void Declaration::visitSymbol0(SymbolVisitor* visitor)
 { visitor->visit(this); }
 
 EnumeratorDeclaration::EnumeratorDeclaration(TranslationUnit *translationUnit, unsigned sourceLocation, const Name* name)
-    : Declaration(translationUnit, sourceLocation, name)
+    : Declaration(SymbolKind::EnumeratorDeclaration, translationUnit, sourceLocation, name)
     , _constantValue(0)
 {}
 
@@ -139,7 +144,7 @@ void EnumeratorDeclaration::setConstantValue(const StringLiteral* constantValue)
 { _constantValue = constantValue; }
 
 Argument::Argument(TranslationUnit *translationUnit, unsigned sourceLocation, const Name* name)
-    : Symbol(translationUnit, sourceLocation, name),
+    : Symbol(SymbolKind::Argument, translationUnit, sourceLocation, name),
       _initializer(0)
 { }
 
@@ -171,7 +176,7 @@ void Argument::visitSymbol0(SymbolVisitor* visitor)
 { visitor->visit(this); }
 
 TypenameArgument::TypenameArgument(TranslationUnit *translationUnit, unsigned sourceLocation, const Name* name)
-    : Symbol(translationUnit, sourceLocation, name)
+    : Symbol(SymbolKind::TypenameArgument, translationUnit, sourceLocation, name)
 { }
 
 TypenameArgument::TypenameArgument(Clone *clone, Subst *subst, TypenameArgument *original)
@@ -192,12 +197,14 @@ void TypenameArgument::visitSymbol0(SymbolVisitor* visitor)
 { visitor->visit(this); }
 
 Function::Function(TranslationUnit *translationUnit, unsigned sourceLocation, const Name* name)
-    : Scope(translationUnit, sourceLocation, name),
-      _flags(0)
+    : Scope(SymbolKind::Function, translationUnit, sourceLocation, name)
+    , Type(TypeKind::Function)
+    , _flags(0)
 { }
 
 Function::Function(Clone *clone, Subst *subst, Function *original)
     : Scope(clone, subst, original)
+    , Type(TypeKind::Function)
     , _returnType(clone->type(original->_returnType, subst))
     , _flags(original->_flags)
 { }
@@ -387,7 +394,7 @@ bool Function::maybeValidPrototype(unsigned actualArgumentCount) const
 
 
 Block::Block(TranslationUnit *translationUnit, unsigned sourceLocation)
-    : Scope(translationUnit, sourceLocation, /*name = */ 0)
+    : Scope(SymbolKind::Block, translationUnit, sourceLocation, /*name = */ 0)
 { }
 
 Block::Block(Clone *clone, Subst *subst, Block *original)
@@ -410,12 +417,14 @@ void Block::visitSymbol0(SymbolVisitor* visitor)
 }
 
 Enum::Enum(TranslationUnit *translationUnit, unsigned sourceLocation, const Name* name)
-    : Scope(translationUnit, sourceLocation, name)
+    : Scope(SymbolKind::Enum, translationUnit, sourceLocation, name)
+    , Type(TypeKind::Enum)
     , _isScoped(false)
 { }
 
 Enum::Enum(Clone *clone, Subst *subst, Enum *original)
     : Scope(clone, subst, original)
+    , Type(TypeKind::Enum)
     , _isScoped(original->isScoped())
 { }
 
@@ -448,11 +457,13 @@ void Enum::visitSymbol0(SymbolVisitor* visitor)
 }
 
 Template::Template(TranslationUnit *translationUnit, unsigned sourceLocation, const Name* name)
-    : Scope(translationUnit, sourceLocation, name)
+    : Scope(SymbolKind::Template, translationUnit, sourceLocation, name)
+    , Type(TypeKind::Template)
 { }
 
 Template::Template(Clone *clone, Subst *subst, Template *original)
     : Scope(clone, subst, original)
+    , Type(TypeKind::Template)
 { }
 
 Template::~Template()
@@ -499,12 +510,14 @@ void Template::accept0(TypeVisitor* visitor)
 { visitor->visit(this); }
 
 Namespace::Namespace(TranslationUnit *translationUnit, unsigned sourceLocation, const Name* name)
-    : Scope(translationUnit, sourceLocation, name)
+    : Scope(SymbolKind::Namespace, translationUnit, sourceLocation, name)
+    , Type(TypeKind::Namespace)
     , _isInline(false)
 { }
 
 Namespace::Namespace(Clone *clone, Subst *subst, Namespace *original)
     : Scope(clone, subst, original)
+    , Type(TypeKind::Namespace)
     , _isInline(original->_isInline)
 { }
 
@@ -527,7 +540,7 @@ FullySpecifiedType Namespace::type() const
 { return FullySpecifiedType(const_cast<Namespace *>(this)); }
 
 BaseClass::BaseClass(TranslationUnit *translationUnit, unsigned sourceLocation, const Name* name)
-    : Symbol(translationUnit, sourceLocation, name),
+    : Symbol(SymbolKind::BaseClass, translationUnit, sourceLocation, name),
       _isVirtual(false)
 { }
 
@@ -563,11 +576,13 @@ void BaseClass::visitSymbol0(SymbolVisitor* visitor)
 
 ForwardClassDeclaration::ForwardClassDeclaration(TranslationUnit *translationUnit,
                                                  unsigned sourceLocation, const Name* name)
-    : Symbol(translationUnit, sourceLocation, name)
+    : Symbol(SymbolKind::ForwardClassDeclaration, translationUnit, sourceLocation, name)
+    , Type(TypeKind::ForwardClassDeclaration)
 { }
 
 ForwardClassDeclaration::ForwardClassDeclaration(Clone *clone, Subst *subst, ForwardClassDeclaration *original)
     : Symbol(clone, subst, original)
+    , Type(TypeKind::ForwardClassDeclaration)
 { }
 
 ForwardClassDeclaration::~ForwardClassDeclaration()
@@ -583,12 +598,14 @@ void ForwardClassDeclaration::accept0(TypeVisitor* visitor)
 { visitor->visit(this); }
 
 Class::Class(TranslationUnit *translationUnit, unsigned sourceLocation, const Name* name)
-    : Scope(translationUnit, sourceLocation, name),
-      _key(ClassKey)
+    : Scope(SymbolKind::Class, translationUnit, sourceLocation, name)
+    , Type(TypeKind::Class)
+    , _key(ClassKey)
 { }
 
 Class::Class(Clone *clone, Subst *subst, Class *original)
     : Scope(clone, subst, original)
+    , Type(TypeKind::Class)
     , _key(original->_key)
 {
     for (size_t i = 0; i < original->_baseClasses.size(); ++i)
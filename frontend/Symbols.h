@@ -42,12 +42,6 @@ public:
     // Symbol's interface
     virtual FullySpecifiedType type() const;
 
-    virtual const UsingNamespaceDirective *asUsingNamespaceDirective() const
-    { return this; }
-
-    virtual UsingNamespaceDirective *asUsingNamespaceDirective()
-    { return this; }
-
 protected:
     virtual void visitSymbol0(SymbolVisitor* visitor);
 };
@@ -62,12 +56,6 @@ public:
     // Symbol's interface
     virtual FullySpecifiedType type() const;
 
-    virtual const UsingDeclaration *asUsingDeclaration() const
-    { return this; }
-
-    virtual UsingDeclaration *asUsingDeclaration()
-    { return this; }
-
 protected:
     virtual void visitSymbol0(SymbolVisitor* visitor);
 };
@@ -85,12 +73,6 @@ public:
     // Symbol's interface
     virtual FullySpecifiedType type() const;
 
-    virtual const NamespaceAlias *asNamespaceAlias() const
-    { return this; }
-
-    virtual NamespaceAlias *asNamespaceAlias()
-    { return this; }
-
 protected:
     virtual void visitSymbol0(SymbolVisitor* visitor);
 
@@ -112,19 +94,12 @@ public:
     virtual FullySpecifiedType type() const;
     const StringLiteral* getInitializer() const;
 
-    virtual const Declaration *asDeclaration() const
-    { return this; }
-
-    virtual Declaration *asDeclaration()
-    { return this; }
-
-    virtual EnumeratorDeclaration *asEnumeratorDeclarator()
-    { return 0; }
-
-    virtual const EnumeratorDeclaration *asEnumeratorDeclarator() const
-    { return 0; }
+    inline EnumeratorDeclaration *asEnumeratorDeclarator();
+    inline const EnumeratorDeclaration *asEnumeratorDeclarator() const;
 
 protected:
+    Declaration(SymbolKind kind, TranslationUnit *translationUnit, unsigned sourceLocation, const Name* name);
+
     virtual void visitSymbol0(SymbolVisitor* visitor);
 
 private:
@@ -141,16 +116,22 @@ public:
     const StringLiteral* constantValue() const;
     void setConstantValue(const StringLiteral* constantValue);
 
-    virtual EnumeratorDeclaration *asEnumeratorDeclarator()
-    { return this; }
-
-    virtual const EnumeratorDeclaration *asEnumeratorDeclarator() const
-    { return this; }
-
 private:
     const StringLiteral* _constantValue;
 };
 
+inline EnumeratorDeclaration *Declaration::asEnumeratorDeclarator()
+{
+    return symbolKind() == SymbolKind::EnumeratorDeclaration
+            ? static_cast<EnumeratorDeclaration*>(this) : nullptr;
+}
+
+inline const EnumeratorDeclaration *Declaration::asEnumeratorDeclarator() const
+{
+    return symbolKind() == SymbolKind::EnumeratorDeclaration
+            ? static_cast<const EnumeratorDeclaration*>(this) : nullptr;
+}
+
 class CFE_API Argument: public Symbol
 {
 public:
@@ -168,12 +149,6 @@ public:
     // Symbol's interface
     virtual FullySpecifiedType type() const;
 
-    virtual const Argument *asArgument() const
-    { return this; }
-
-    virtual Argument *asArgument()
-    { return this; }
-
 protected:
     virtual void visitSymbol0(SymbolVisitor* visitor);
 
@@ -194,12 +169,6 @@ public:
     // Symbol's interface
     virtual FullySpecifiedType type() const;
 
-    virtual const TypenameArgument *asTypenameArgument() const
-    { return this; }
-
-    virtual TypenameArgument *asTypenameArgument()
-    { return this; }
-
 protected:
     virtual void visitSymbol0(SymbolVisitor* visitor);
 
@@ -217,12 +186,6 @@ public:
     // Symbol's interface
     virtual FullySpecifiedType type() const;
 
-    virtual const Block *asBlock() const
-    { return this; }
-
-    virtual Block *asBlock()
-    { return this; }
-
 protected:
     virtual void visitSymbol0(SymbolVisitor* visitor);
 };
@@ -237,19 +200,6 @@ public:
     // Symbol's interface
     virtual FullySpecifiedType type() const;
 
-    virtual const ForwardClassDeclaration *asForwardClassDeclaration() const
-    { return this; }
-
-    virtual ForwardClassDeclaration *asForwardClassDeclaration()
-    { return this; }
-
-    // Type's interface
-    virtual const ForwardClassDeclaration *asForwardClassDeclarationType() const
-    { return this; }
-
-    virtual ForwardClassDeclaration *asForwardClassDeclarationType()
-    { return this; }
-
 protected:
     virtual void visitSymbol0(SymbolVisitor* visitor);
     virtual void accept0(TypeVisitor* visitor);
@@ -268,19 +218,6 @@ public:
     // Symbol's interface
     virtual FullySpecifiedType type() const;
 
-    virtual const Enum *asEnum() const
-    { return this; }
-
-    virtual Enum *asEnum()
-    { return this; }
-
-    // Type's interface
-    virtual const Enum *asEnumType() const
-    { return this; }
-
-    virtual Enum *asEnumType()
-    { return this; }
-
 protected:
     virtual void visitSymbol0(SymbolVisitor* visitor);
     virtual void accept0(TypeVisitor* visitor);
@@ -356,19 +293,6 @@ public:
     // Symbol's interface
     virtual FullySpecifiedType type() const;
 
-    virtual const Function *asFunction() const
-    { return this; }
-
-    virtual Function *asFunction()
-    { return this; }
-
-    // Type's interface
-    virtual const Function *asFunctionType() const
-    { return this; }
-
-    virtual Function *asFunctionType()
-    { return this; }
-
 protected:
     virtual void visitSymbol0(SymbolVisitor* visitor);
     virtual void accept0(TypeVisitor* visitor);
@@ -407,25 +331,11 @@ public:
     // Symbol's interface
     virtual FullySpecifiedType type() const;
 
-    virtual const Template *asTemplate() const
-    { return this; }
-
-    virtual Template *asTemplate()
-    { return this; }
-
-    // Type's interface
-    virtual const Template *asTemplateType() const
-    { return this; }
-
-    virtual Template *asTemplateType()
-    { return this; }
-
 protected:
     virtual void visitSymbol0(SymbolVisitor* visitor);
     virtual void accept0(TypeVisitor* visitor);
 };
 
-
 class CFE_API Namespace: public Scope, public Type
 {
 public:
@@ -436,19 +346,6 @@ public:
     // Symbol's interface
     virtual FullySpecifiedType type() const;
 
-    virtual const Namespace *asNamespace() const
-    { return this; }
-
-    virtual Namespace *asNamespace()
-    { return this; }
-
-    // Type's interface
-    virtual const Namespace *asNamespaceType() const
-    { return this; }
-
-    virtual Namespace *asNamespaceType()
-    { return this; }
-
     bool isInline() const
     { return _isInline; }
 
@@ -480,12 +377,6 @@ public:
     virtual FullySpecifiedType type() const;
     void setType(const FullySpecifiedType &type);
 
-    virtual const BaseClass *asBaseClass() const
-    { return this; }
-
-    virtual BaseClass *asBaseClass()
-    { return this; }
-
 protected:
     virtual void visitSymbol0(SymbolVisitor* visitor);
 
@@ -521,19 +412,6 @@ public:
     // Symbol's interface
     virtual FullySpecifiedType type() const;
 
-    virtual const Class *asClass() const
-    { return this; }
-
-    virtual Class *asClass()
-    { return this; }
-
-    // Type's interface
-    virtual const Class *asClassType() const
-    { return this; }
-
-    virtual Class *asClassType()
-    { return this; }
-
 protected:
     virtual void visitSymbol0(SymbolVisitor* visitor);
     virtual void accept0(TypeVisitor* visitor);
@@ -543,7 +421,28 @@ private:
     std::vector<BaseClass *> _baseClasses;
 };
 
-} // namespace psyche
+PSYCHE_DEFINE_SYMBOL_CAST(UsingNamespaceDirective, asUsingNamespaceDirective)
+PSYCHE_DEFINE_SYMBOL_CAST(UsingDeclaration, asUsingDeclaration)
+PSYCHE_DEFINE_SYMBOL_CAST(NamespaceAlias, asNamespaceAlias)
+PSYCHE_DEFINE_SYMBOL_CAST(Declaration, asDeclaration)
+PSYCHE_DEFINE_SYMBOL_CAST(Argument, asArgument)
+PSYCHE_DEFINE_SYMBOL_CAST(TypenameArgument, asTypenameArgument)
+PSYCHE_DEFINE_SYMBOL_CAST(Block, asBlock)
+PSYCHE_DEFINE_SYMBOL_CAST(ForwardClassDeclaration, asForwardClassDeclaration)
+PSYCHE_DEFINE_SYMBOL_CAST(Enum, asEnum)
+PSYCHE_DEFINE_SYMBOL_CAST(Function, asFunction)
+PSYCHE_DEFINE_SYMBOL_CAST(Template, asTemplate)
+PSYCHE_DEFINE_SYMBOL_CAST(Namespace, asNamespace)
+PSYCHE_DEFINE_SYMBOL_CAST(BaseClass, asBaseClass)
+PSYCHE_DEFINE_SYMBOL_CAST(Class, asClass)
+
+PSYCHE_DEFINE_TYPE_CAST(ForwardClassDeclaration, ForwardClassDeclaration, asForwardClassDeclarationType)
+PSYCHE_DEFINE_TYPE_CAST(Enum, Enum, asEnumType)
+PSYCHE_DEFINE_TYPE_CAST(Function, Function, asFunctionType)
+PSYCHE_DEFINE_TYPE_CAST(Template, Template, asTemplateType)
+PSYCHE_DEFINE_TYPE_CAST(Namespace, Namespace, asNamespaceType)
+PSYCHE_DEFINE_TYPE_CAST(Class, Class, asClassType)
 
+} // namespace psyche
 
 #endif
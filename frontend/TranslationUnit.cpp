@@ -52,7 +52,9 @@ TranslationUnit::TranslationUnit(Control *control, const StringLiteral* fileId)
       _lastSourceChar(0),
       _pool(0),
       _ast(0),
-      _flags(0)
+      _flags(0),
+      _diagnosticCount(0),
+      _parseMemoBudget(32 * 1024 * 1024)
 {
     _previousTranslationUnit = control->switchTranslationUnit(this);
 }
@@ -356,9 +358,24 @@ bool TranslationUnit::parse(ParseMode mode)
         break;
     } // switch
 
+    _parseStats = parser.stats();
+
     return parsed;
 }
 
+std::ostream& psyche::operator<<(std::ostream& os, const TranslationUnit::ParseStats& s)
+{
+    os << "  Memo lookups       : " << s.memoLookups_ << std::endl
+       << "  Memo hits          : " << s.memoHits_;
+    if (s.memoLookups_)
+        os << " (" << (100 * s.memoHits_ / s.memoLookups_) << "%)";
+    os << std::endl
+       << "  Memo inserts       : " << s.memoInserts_ << std::endl
+       << "  Memo flushes       : " << s.memoFlushes_ << std::endl
+       << "  Backtracks         : " << s.backtracks_;
+    return os;
+}
+
 void TranslationUnit::pushLineOffset(unsigned offset)
 { _lineOffsets.push_back(offset); }
 
@@ -461,6 +478,7 @@ void TranslationUnit::message(DiagnosticCollector::Severity severity,
     if (f._blockErrors)
         return;
 
+    ++_diagnosticCount;
     index = std::min(index, tokenCount() - 1);
 
     unsigned line = 0, column = 0;
@@ -27,7 +27,9 @@
 #include "ASTFwds.h"
 #include "Token.h"
 #include "DiagnosticCollector.h"
+#include <cstddef>
 #include <cstdio>
+#include <iosfwd>
 #include <memory>
 #include <string>
 #include <vector>
@@ -105,6 +107,9 @@ public:
                  unsigned index,
                  const char *format, va_list ap);
 
+    //! The number of diagnostics reported (i.e., not blocked) so far.
+    unsigned diagnosticCount() const { return _diagnosticCount; }
+
     bool skipFunctionBody() const;
     void setSkipFunctionBody(bool skipFunctionBody);
 
@@ -119,6 +124,27 @@ public:
     bool parse(ParseMode mode = ParseTranlationUnit);
     bool isParsed() const;
 
+    /*!
+     * \brief The ParseStats struct
+     *
+     * Figures of the parser's memo table, where the results of (rule, token index)
+     * attempts are kept, and of its backtracking.
+     */
+    struct CFE_API ParseStats
+    {
+        std::size_t memoLookups_ { 0 };
+        std::size_t memoHits_ { 0 };
+        std::size_t memoInserts_ { 0 };
+        std::size_t memoFlushes_ { 0 };
+        std::size_t backtracks_ { 0 };
+    };
+
+    const ParseStats& parseStats() const { return _parseStats; }
+
+    //! The memory, in bytes, the parser's memo table may take (0 disables it).
+    void setParseMemoBudget(std::size_t bytes) { _parseMemoBudget = bytes; }
+    std::size_t parseMemoBudget() const { return _parseMemoBudget; }
+
     void getTokenStartPosition(unsigned index, unsigned *line,
                                unsigned *column = 0,
                                const StringLiteral* *fileName = 0) const;
@@ -211,8 +237,13 @@ private:
         Flags f;
     };
     Dialect _dialect;
+    unsigned _diagnosticCount;
+    ParseStats _parseStats;
+    std::size_t _parseMemoBudget;
 };
 
+CFE_API std::ostream& operator<<(std::ostream& os, const TranslationUnit::ParseStats& s);
+
 } // namespace psyche
 
 
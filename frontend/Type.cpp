@@ -26,57 +26,13 @@
 
 using namespace psyche;
 
-Type::Type()
+Type::Type(TypeKind kind)
+    : _typeKind(kind)
 {}
 
 Type::~Type()
 {}
 
-bool Type::isUndefinedType() const
-{ return this == UndefinedType::instance(); }
-
-bool Type::isVoidType() const
-{ return asVoidType() != 0; }
-
-bool Type::isIntegerType() const
-{ return asIntegerType() != 0; }
-
-bool Type::isFloatType() const
-{ return asFloatType() != 0; }
-
-bool Type::isPointerType() const
-{ return asPointerType()  != 0; }
-
-bool Type::isPointerToMemberType() const
-{ return asPointerToMemberType() != 0; }
-
-bool Type::isReferenceType() const
-{ return asReferenceType() != 0; }
-
-bool Type::isArrayType() const
-{ return asArrayType() != 0; }
-
-bool Type::isNamedType() const
-{ return asNamedType() != 0; }
-
-bool Type::isFunctionType() const
-{ return asFunctionType() != 0; }
-
-bool Type::isNamespaceType() const
-{ return asNamespaceType() != 0; }
-
-bool Type::isTemplateType() const
-{ return asTemplateType() != 0; }
-
-bool Type::isClassType() const
-{ return asClassType() != 0; }
-
-bool Type::isEnumType() const
-{ return asEnumType() != 0; }
-
-bool Type::isForwardClassDeclarationType() const
-{ return asForwardClassDeclarationType() != 0; }
-
 void Type::accept(TypeVisitor* visitor)
 {
     if (visitor->preVisit(this))
@@ -30,69 +30,109 @@ namespace psyche {
 class CFE_API Type
 {
 public:
-    Type();
+    /*!
+     * \brief The TypeKind enum
+     *
+     * The concrete type, fixed at construction; checks and casts are a
+     * compare on it, not a virtual call.
+     */
+    enum class TypeKind : unsigned char
+    {
+        Undefined,
+        Void,
+        Integer,
+        Float,
+        Pointer,
+        PointerToMember,
+        Reference,
+        Array,
+        Named,
+        Quantified,
+        Function,
+        Namespace,
+        Template,
+        Class,
+        Enum,
+        ForwardClassDeclaration,
+    };
+
+    Type(TypeKind kind);
     virtual ~Type();
 
-    bool isUndefinedType() const;
-    bool isVoidType() const;
-    bool isIntegerType() const;
-    bool isFloatType() const;
-    bool isPointerType() const;
-    bool isPointerToMemberType() const;
-    bool isReferenceType() const;
-    bool isArrayType() const;
-    bool isNamedType() const;
-    bool isQuantifiedType() const;
-    bool isFunctionType() const;
-    bool isNamespaceType() const;
-    bool isTemplateType() const;
-    bool isClassType() const;
-    bool isEnumType() const;
-    bool isForwardClassDeclarationType() const;
-
-    virtual const UndefinedType* asUndefinedType() const { return 0; }
-    virtual const VoidType* asVoidType() const { return 0; }
-    virtual const IntegerType* asIntegerType() const { return 0; }
-    virtual const FloatType* asFloatType() const { return 0; }
-    virtual const PointerType* asPointerType() const { return 0; }
-    virtual const PointerToMemberType* asPointerToMemberType() const { return 0; }
-    virtual const ReferenceType* asReferenceType() const { return 0; }
-    virtual const ArrayType* asArrayType() const { return 0; }
-    virtual const NamedType* asNamedType() const { return 0; }
-    virtual const QuantifiedType* asQuantifiedType() const { return 0; }
-    virtual const Function *asFunctionType() const { return 0; }
-    virtual const Namespace *asNamespaceType() const { return 0; }
-    virtual const Template *asTemplateType() const { return 0; }
-    virtual const Class *asClassType() const { return 0; }
-    virtual const Enum *asEnumType() const { return 0; }
-    virtual const ForwardClassDeclaration *asForwardClassDeclarationType() const { return 0; }
-
-    virtual UndefinedType* asUndefinedType() { return 0; }
-    virtual VoidType* asVoidType() { return 0; }
-    virtual IntegerType* asIntegerType() { return 0; }
-    virtual FloatType* asFloatType() { return 0; }
-    virtual PointerType* asPointerType() { return 0; }
-    virtual PointerToMemberType* asPointerToMemberType() { return 0; }
-    virtual ReferenceType* asReferenceType() { return 0; }
-    virtual ArrayType* asArrayType() { return 0; }
-    virtual NamedType* asNamedType() { return 0; }
-    virtual QuantifiedType* asQuantifiedType() { return 0; }
-    virtual Function *asFunctionType() { return 0; }
-    virtual Namespace *asNamespaceType() { return 0; }
-    virtual Template *asTemplateType() { return 0; }
-    virtual Class *asClassType() { return 0; }
-    virtual Enum *asEnumType() { return 0; }
-    virtual ForwardClassDeclaration *asForwardClassDeclarationType() { return 0; }
+    TypeKind typeKind() const { return _typeKind; }
+
+    bool isUndefinedType() const { return _typeKind == TypeKind::Undefined; }
+    bool isVoidType() const { return _typeKind == TypeKind::Void; }
+    bool isIntegerType() const { return _typeKind == TypeKind::Integer; }
+    bool isFloatType() const { return _typeKind == TypeKind::Float; }
+    bool isPointerType() const { return _typeKind == TypeKind::Pointer; }
+    bool isPointerToMemberType() const { return _typeKind == TypeKind::PointerToMember; }
+    bool isReferenceType() const { return _typeKind == TypeKind::Reference; }
+    bool isArrayType() const { return _typeKind == TypeKind::Array; }
+    bool isNamedType() const { return _typeKind == TypeKind::Named; }
+    bool isQuantifiedType() const { return _typeKind == TypeKind::Quantified; }
+    bool isFunctionType() const { return _typeKind == TypeKind::Function; }
+    bool isNamespaceType() const { return _typeKind == TypeKind::Namespace; }
+    bool isTemplateType() const { return _typeKind == TypeKind::Template; }
+    bool isClassType() const { return _typeKind == TypeKind::Class; }
+    bool isEnumType() const { return _typeKind == TypeKind::Enum; }
+    bool isForwardClassDeclarationType() const { return _typeKind == TypeKind::ForwardClassDeclaration; }
+
+    inline const UndefinedType* asUndefinedType() const;
+    inline const VoidType* asVoidType() const;
+    inline const IntegerType* asIntegerType() const;
+    inline const FloatType* asFloatType() const;
+    inline const PointerType* asPointerType() const;
+    inline const PointerToMemberType* asPointerToMemberType() const;
+    inline const ReferenceType* asReferenceType() const;
+    inline const ArrayType* asArrayType() const;
+    inline const NamedType* asNamedType() const;
+    inline const QuantifiedType* asQuantifiedType() const;
+    inline const Function* asFunctionType() const;
+    inline const Namespace* asNamespaceType() const;
+    inline const Template* asTemplateType() const;
+    inline const Class* asClassType() const;
+    inline const Enum* asEnumType() const;
+    inline const ForwardClassDeclaration* asForwardClassDeclarationType() const;
+
+    inline UndefinedType* asUndefinedType();
+    inline VoidType* asVoidType();
+    inline IntegerType* asIntegerType();
+    inline FloatType* asFloatType();
+    inline PointerType* asPointerType();
+    inline PointerToMemberType* asPointerToMemberType();
+    inline ReferenceType* asReferenceType();
+    inline ArrayType* asArrayType();
+    inline NamedType* asNamedType();
+    inline QuantifiedType* asQuantifiedType();
+    inline Function* asFunctionType();
+    inline Namespace* asNamespaceType();
+    inline Template* asTemplateType();
+    inline Class* asClassType();
+    inline Enum* asEnumType();
+    inline ForwardClassDeclaration* asForwardClassDeclarationType();
 
     void accept(TypeVisitor* visitor);
     static void accept(Type* type, TypeVisitor* visitor);
 
 protected:
     virtual void accept0(TypeVisitor* visitor) = 0;
+
+private:
+    TypeKind _typeKind;
 };
 
 CFE_API bool isArithmetic(const Type*);
 
+/*
+ * Define the casts of a concrete type; used by the headers that declare them.
+ */
+#define PSYCHE_DEFINE_TYPE_CAST(CLASS, KIND, FUNC) \
+    inline const CLASS* Type::FUNC() const \
+    { return _typeKind == TypeKind::KIND ? static_cast<const CLASS*>(this) : nullptr; } \
+    inline CLASS* Type::FUNC() \
+    { return _typeKind == TypeKind::KIND ? static_cast<CLASS*>(this) : nullptr; }
+
 } // namespace psyche
 
 #endif
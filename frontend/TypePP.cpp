@@ -30,14 +30,31 @@ using namespace psyche;
 template <class SyntaxT>
 TypePP<SyntaxT>::TypePP()
     : scope_(nullptr)
+    , memoizable_(true)
 {}
 
+template <class SyntaxT>
+unsigned TypePP<SyntaxT>::qualifiers(const FullySpecifiedType& fullType)
+{
+    return fullType.isUnsigned()
+            | fullType.isConst() << 1
+            | fullType.isVolatile() << 2;
+}
+
 template <class SyntaxT>
 std::string TypePP<SyntaxT>::print(const FullySpecifiedType& fullType, const Scope* scope)
 {
+    auto& memo = memo_[qualifiers(fullType)];
+    auto it = memo.find(fullType.type());
+    if (it != memo.end())
+        return it->second;
+
     text_.clear();
     scope_ = scope;
+    memoizable_ = true;
     visitType(fullType);
+    if (memoizable_)
+        memo.emplace(fullType.type(), text_);
     return text_;
 }
 
@@ -46,7 +63,7 @@ void TypePP<SyntaxT>::visitType(const FullySpecifiedType& fullType)
 {
     if (fullType.isUnsigned())
         text_.append(" unsigned ");
-    accept(fullType.type());
+    dispatch(fullType.type());
     if (fullType.isConst())
         text_.append(" const ");
     if (fullType.isVolatile())
@@ -237,6 +254,7 @@ void TypePP<SyntaxT>::visit(Class* ty)
         declName.assign("");
     }
 
+    memoizable_ = false;
     text_.append("struct ");
     text_.append(declName);
     text_.append("{ ");
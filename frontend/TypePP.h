@@ -29,6 +29,7 @@
 #include "Symbols.h"
 #include "TypeVisitor.h"
 #include <string>
+#include <unordered_map>
 
 namespace psyche {
 
@@ -38,6 +39,15 @@ class CFE_API TypePP : public TypeVisitor
 public:
     TypePP();
 
+    /*!
+     * \brief print
+     *
+     * Types are interned, and named types print as their names, so a type's
+     * text is memoized by the type and its printed qualifiers, regardless of
+     * the scope. A type containing a struct is printed afresh every time,
+     * since the struct's members are printed as well, and those may still be
+     * added (the memo is per printer, hence per unit).
+     */
     std::string print(const FullySpecifiedType& fullType, const Scope* scope);
 
 protected:
@@ -67,6 +77,12 @@ protected:
 
     std::string text_;
     const Scope* scope_;
+
+private:
+    static unsigned qualifiers(const FullySpecifiedType& fullType);
+
+    bool memoizable_;
+    std::unordered_map<const Type*, std::string> memo_[8]; //!< Indexed by qualifiers.
 };
 
 } // namespace psyche
@@ -20,7 +20,8 @@
 
 #include "TypeVisitor.h"
 
-#include "Type.h"
+#include "CoreTypes.h"
+#include "Symbols.h"
 
 using namespace psyche;
 
@@ -32,3 +33,60 @@ TypeVisitor::~TypeVisitor()
 
 void TypeVisitor::accept(Type* type)
 { Type::accept(type, this); }
+
+void TypeVisitor::dispatch(Type* type)
+{
+    if (!type)
+        return;
+
+    switch (type->typeKind()) {
+    case Type::TypeKind::Undefined:
+        visit(static_cast<UndefinedType*>(type));
+        break;
+    case Type::TypeKind::Void:
+        visit(static_cast<VoidType*>(type));
+        break;
+    case Type::TypeKind::Integer:
+        visit(static_cast<IntegerType*>(type));
+        break;
+    case Type::TypeKind::Float:
+        visit(static_cast<FloatType*>(type));
+        break;
+    case Type::TypeKind::Pointer:
+        visit(static_cast<PointerType*>(type));
+        break;
+    case Type::TypeKind::PointerToMember:
+        visit(static_cast<PointerToMemberType*>(type));
+        break;
+    case Type::TypeKind::Reference:
+        visit(static_cast<ReferenceType*>(type));
+        break;
+    case Type::TypeKind::Array:
+        visit(static_cast<ArrayType*>(type));
+        break;
+    case Type::TypeKind::Named:
+        visit(static_cast<NamedType*>(type));
+        break;
+    case Type::TypeKind::Quantified:
+        visit(static_cast<QuantifiedType*>(type));
+        break;
+    case Type::TypeKind::Function:
+        visit(static_cast<Function*>(type));
+        break;
+    case Type::TypeKind::Namespace:
+        visit(static_cast<Namespace*>(type));
+        break;
+    case Type::TypeKind::Template:
+        visit(static_cast<Template*>(type));
+        break;
+    case Type::TypeKind::Class:
+        visit(static_cast<Class*>(type));
+        break;
+    case Type::TypeKind::Enum:
+        visit(static_cast<Enum*>(type));
+        break;
+    case Type::TypeKind::ForwardClassDeclaration:
+        visit(static_cast<ForwardClassDeclaration*>(type));
+        break;
+    }
+}
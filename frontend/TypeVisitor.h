@@ -39,6 +39,14 @@ public:
 
     void accept(Type* type);
 
+    /*!
+     * \brief dispatch
+     *
+     * Visit the type through a switch on its kind: no preVisit/postVisit
+     * and no virtual accept. For visitors that don't use those hooks.
+     */
+    void dispatch(Type* type);
+
     virtual bool preVisit(Type*) { return true; }
     virtual void postVisit(Type*) {}
 
@@ -0,0 +1,83 @@
+/******************************************************************************
+ * Copyright (c) 2016 Leandro T. C. Melo (ltcmelo@gmail.com)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ * USA
+ *****************************************************************************/
+
+#ifndef PSYCHE_BINARYCONSTRAINTFORMAT_H__
+#define PSYCHE_BINARYCONSTRAINTFORMAT_H__
+
+#include <cstdint>
+
+/*
+ * The binary constraint format.
+ *
+ *   file    := magic version record*
+ *   record  := String length byte*      (defines the next string index)
+ *            | opcode operand*
+ *   operand := flag | string | type | list
+ *   string  := index
+ *   type    := (n << 2) | 0             (type variable n)
+ *            | (index << 2) | 1         (type name)
+ *            | 2 type type              (juxtaposition of two types)
+ *   list    := count type*
+ *   flag    := 0 | 1
+ *
+ * All numbers are unsigned LEB128. A record mirrors one call of the
+ * ConstraintWriter API, so replaying a file into the text writer yields the
+ * text the generator would have written. Strings are defined before the first
+ * record that refers to them.
+ */
+
+namespace psyche {
+namespace cstr {
+
+constexpr char kMagic[] = { '\x7f', 'C', 'S', 'T', 'R' };
+constexpr std::uint8_t kVersion = 1;
+
+enum class Op : std::uint8_t
+{
+    String,
+    Block,
+    Text,
+    Typedef,
+    VarDecl,
+    FuncDecl,
+    Typeof,
+    Exists,
+    TypeSection,
+    TypesSection,
+    ConstantExpression,
+    Static,
+    MemberRel,
+    PtrRel,
+    EquivRel,
+    SubtypeRel,
+    EquivMark,
+    SubtypeMark,
+    EnterGroup,
+    LeaveGroup,
+    OpenScope,
+    CloseScope,
+    BeginSection,
+    EndSection,
+    Last = EndSection
+};
+
+} // namespace cstr
+} // namespace psyche
+
+#endif
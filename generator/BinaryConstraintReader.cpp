@@ -0,0 +1,290 @@
+/******************************************************************************
+ * Copyright (c) 2016 Leandro T. C. Melo (ltcmelo@gmail.com)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ * USA
+ *****************************************************************************/
+
+#include "BinaryConstraintReader.h"
+#include "BinaryConstraintFormat.h"
+#include "ConstraintWriter.h"
+#include <cstring>
+
+using namespace psyche;
+using namespace cstr;
+
+namespace {
+
+// Bound on the nesting of juxtaposed types, against corrupted input.
+const int kMaxTypeDepth = 1024;
+
+} // anonymous
+
+BinaryConstraintReader::BinaryConstraintReader(const std::string& data)
+    : data_(data)
+    , pos_(0)
+    , depth_(0)
+    , terms_(nullptr)
+{}
+
+bool BinaryConstraintReader::isBinary(const std::string& data)
+{
+    return data.size() > sizeof(kMagic)
+            && !std::memcmp(data.data(), kMagic, sizeof(kMagic));
+}
+
+bool BinaryConstraintReader::fail(const char* reason)
+{
+    error_ = std::string(reason) + " at offset " + std::to_string(pos_);
+    return false;
+}
+
+bool BinaryConstraintReader::decode(std::uint32_t& n)
+{
+    n = 0;
+    for (int shift = 0; shift < 35; shift += 7) {
+        if (pos_ == data_.size())
+            return fail("unexpected end of data");
+        const auto byte = static_cast<unsigned char>(data_[pos_++]);
+        n |= static_cast<std::uint32_t>(byte & 0x7f) << shift;
+        if (!(byte & 0x80))
+            return true;
+    }
+    return fail("malformed number");
+}
+
+bool BinaryConstraintReader::decode(std::string& s)
+{
+    std::uint32_t idx;
+    if (!decode(idx))
+        return false;
+    if (idx >= strings_.size())
+        return fail("undefined string");
+    s = strings_[idx];
+    return true;
+}
+
+bool BinaryConstraintReader::decode(TypeTerm& ty)
+{
+    std::uint32_t code;
+    if (!decode(code))
+        return false;
+
+    switch (code & 3) {
+    case 0:
+        ty = TypeTerm::var(code >> 2);
+        return true;
+
+    case 1: {
+        const auto idx = code >> 2;
+        if (idx >= strings_.size())
+            return fail("undefined string");
+        if (names_[idx] == TypeTerm())
+            names_[idx] = terms_->intern(strings_[idx]);
+        ty = names_[idx];
+        return true;
+    }
+
+    default: {
+        if (code != 2)
+            return fail("malformed type");
+        if (depth_ == kMaxTypeDepth)
+            return fail("type nested too deeply");
+        ++depth_;
+        TypeTerm first, second;
+        const bool ok = decode(first) && decode(second);
+        --depth_;
+        if (!ok)
+            return false;
+        ty = terms_->seq(first, second);
+        return true;
+    }
+    }
+}
+
+bool BinaryConstraintReader::decode(std::vector<TypeTerm>& tys)
+{
+    std::uint32_t cnt;
+    if (!decode(cnt))
+        return false;
+    if (cnt > data_.size() - pos_)
+        return fail("malformed list");
+    tys.resize(cnt);
+    for (auto& ty : tys) {
+        if (!decode(ty))
+            return false;
+    }
+    return true;
+}
+
+bool BinaryConstraintReader::replay(ConstraintWriter* writer)
+{
+    if (!isBinary(data_))
+        return fail("not binary constraints");
+    pos_ = sizeof(kMagic);
+    if (static_cast<std::uint8_t>(data_[pos_++]) != kVersion)
+        return fail("unsupported version");
+
+    terms_ = &writer->terms();
+    strings_.clear();
+    names_.clear();
+
+    std::string s;
+    TypeTerm ty1, ty2;
+    std::vector<TypeTerm> tys;
+    std::uint32_t n;
+    while (pos_ < data_.size()) {
+        const auto op = static_cast<Op>(data_[pos_]);
+        if (op > Op::Last)
+            return fail("unknown record");
+        ++pos_;
+
+        switch (op) {
+        case Op::String:
+            if (!decode(n))
+                return false;
+            if (n > data_.size() - pos_)
+                return fail("truncated string");
+            strings_.emplace_back(data_, pos_, n);
+            names_.emplace_back();
+            pos_ += n;
+            break;
+
+        case Op::Block:
+            if (!decode(n))
+                return false;
+            writer->block(n);
+            break;
+
+        case Op::Text:
+            if (!decode(s))
+                return false;
+            writer->writeText(s);
+            break;
+
+        case Op::Typedef:
+            if (!decode(ty1) || !decode(ty2))
+                return false;
+            writer->writeTypedef(ty1, ty2);
+            break;
+
+        case Op::VarDecl:
+            if (!decode(s) || !decode(ty1))
+                return false;
+            writer->writeVarDecl(s, ty1);
+            break;
+
+        case Op::FuncDecl:
+            if (!decode(s) || !decode(tys) || !decode(ty1))
+                return false;
+            writer->writeFuncDecl(s, tys, ty1);
+            break;
+
+        case Op::Typeof:
+            if (!decode(s))
+                return false;
+            writer->writeTypeof(s);
+            break;
+
+        case Op::Exists:
+            if (!decode(ty1))
+                return false;
+            writer->writeExists(ty1);
+            break;
+
+        case Op::TypeSection:
+            if (!decode(ty1))
+                return false;
+            writer->writeTypeSection(ty1);
+            break;
+
+        case Op::TypesSection:
+            if (!decode(tys))
+                return false;
+            writer->writeTypesSection(tys);
+            break;
+
+        case Op::ConstantExpression:
+            if (!decode(s))
+                return false;
+            writer->writeConstantExpression(s);
+            break;
+
+        case Op::Static:
+            if (!decode(s))
+                return false;
+            writer->writeStatic(s);
+            break;
+
+        case Op::MemberRel:
+            if (!decode(ty1) || !decode(s) || !decode(ty2))
+                return false;
+            writer->writeMemberRel(ty1, s, ty2);
+            break;
+
+        case Op::PtrRel:
+            if (!decode(ty1) || !decode(ty2))
+                return false;
+            writer->writePtrRel(ty1, ty2);
+            break;
+
+        case Op::EquivRel:
+            if (!decode(ty1) || !decode(ty2))
+                return false;
+            writer->writeEquivRel(ty1, ty2);
+            break;
+
+        case Op::SubtypeRel:
+            if (!decode(ty1) || !decode(ty2))
+                return false;
+            writer->writeSubtypeRel(ty1, ty2);
+            break;
+
+        case Op::EquivMark:
+            writer->writeEquivMark();
+            break;
+
+        case Op::SubtypeMark:
+            writer->writeSubtypeMark();
+            break;
+
+        case Op::EnterGroup:
+            writer->enterGroup();
+            break;
+
+        case Op::LeaveGroup:
+            writer->leaveGroup();
+            break;
+
+        case Op::OpenScope:
+            writer->openScope();
+            break;
+
+        case Op::CloseScope:
+            writer->closeScope();
+            break;
+
+        case Op::BeginSection:
+            writer->beginSection();
+            break;
+
+        case Op::EndSection:
+            writer->endSection();
+            break;
+        }
+    }
+
+    return true;
+}
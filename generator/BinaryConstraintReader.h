@@ -0,0 +1,82 @@
+/******************************************************************************
+ * Copyright (c) 2016 Leandro T. C. Melo (ltcmelo@gmail.com)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ * USA
+ *****************************************************************************/
+
+#ifndef PSYCHE_BINARYCONSTRAINTREADER_H__
+#define PSYCHE_BINARYCONSTRAINTREADER_H__
+
+#include "TypeTerm.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace psyche {
+
+class ConstraintWriter;
+
+/*!
+ * \brief The BinaryConstraintReader class
+ *
+ * Read constraints in the binary format (see BinaryConstraintFormat.h) and
+ * replay them through a writer; with the (text) ConstraintWriter, that yields
+ * the textual constraints.
+ */
+class BinaryConstraintReader final
+{
+public:
+    BinaryConstraintReader(const std::string& data);
+
+    /*!
+     * \brief isBinary
+     *
+     * Whether the data starts as a binary constraints file.
+     */
+    static bool isBinary(const std::string& data);
+
+    /*!
+     * \brief replay
+     * \param writer
+     * \return
+     *
+     * Replay the constraints through the writer. On malformed input, stop and
+     * return false, with the reason available through error().
+     */
+    bool replay(ConstraintWriter* writer);
+
+    const std::string& error() const { return error_; }
+
+private:
+    bool fail(const char* reason);
+
+    bool decode(std::uint32_t& n);
+    bool decode(std::string& s);
+    bool decode(TypeTerm& ty);
+    bool decode(std::vector<TypeTerm>& tys);
+
+    const std::string& data_;
+    std::size_t pos_;
+    int depth_;
+    std::vector<std::string> strings_;
+    std::vector<TypeTerm> names_;
+    TypeTermPool* terms_;
+    std::string error_;
+};
+
+} // namespace psyche
+
+#endif
@@ -0,0 +1,343 @@
+/******************************************************************************
+ * Copyright (c) 2016 Leandro T. C. Melo (ltcmelo@gmail.com)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ * USA
+ *****************************************************************************/
+
+#include "BinaryConstraintWriter.h"
+
+using namespace psyche;
+using namespace cstr;
+
+namespace {
+
+const std::uint32_t kUndefined = ~0u;
+
+} // anonymous
+
+#define HONOR_BLOCKING_STATE \
+    do { \
+        if (blocked_) \
+            return; \
+    } while (false)
+
+
+BinaryConstraintWriter::BinaryConstraintWriter(std::ostream& os)
+    : ConstraintWriter(os)
+{
+    os_->write(kMagic, sizeof(kMagic));
+    os_->put(static_cast<char>(kVersion));
+}
+
+BinaryConstraintWriter::~BinaryConstraintWriter()
+{}
+
+void BinaryConstraintWriter::record(Op op)
+{
+    rec_.push_back(static_cast<char>(op));
+}
+
+void BinaryConstraintWriter::commit()
+{
+    if (!defs_.empty()) {
+        os_->write(defs_.data(), defs_.size());
+        defs_.clear();
+    }
+    os_->write(rec_.data(), rec_.size());
+    rec_.clear();
+}
+
+void BinaryConstraintWriter::encode(std::uint32_t n)
+{
+    while (n >= 0x80) {
+        rec_.push_back(static_cast<char>((n & 0x7f) | 0x80));
+        n >>= 7;
+    }
+    rec_.push_back(static_cast<char>(n));
+}
+
+std::uint32_t BinaryConstraintWriter::stringIndex(const std::string& s)
+{
+    auto it = strings_.find(s);
+    if (it != strings_.end())
+        return it->second;
+
+    const auto idx = static_cast<std::uint32_t>(strings_.size());
+    strings_.emplace(s, idx);
+
+    // The definition is written ahead of the record under construction.
+    std::swap(defs_, rec_);
+    record(Op::String);
+    encode(static_cast<std::uint32_t>(s.size()));
+    rec_.append(s);
+    std::swap(defs_, rec_);
+
+    return idx;
+}
+
+void BinaryConstraintWriter::encode(const std::string& s)
+{
+    encode(stringIndex(s));
+}
+
+void BinaryConstraintWriter::encode(TypeTerm ty)
+{
+    if (ty.isVar()) {
+        encode(ty.bits());
+        return;
+    }
+
+    if (ty.isSeq()) {
+        encode(static_cast<std::uint32_t>(2));
+        encode(terms_.seqOf(ty).first);
+        encode(terms_.seqOf(ty).second);
+        return;
+    }
+
+    if (ty.index() >= names_.size())
+        names_.resize(ty.index() + 1, kUndefined);
+    if (names_[ty.index()] == kUndefined)
+        names_[ty.index()] = stringIndex(terms_.nameOf(ty));
+    encode((names_[ty.index()] << 2) | 1);
+}
+
+void BinaryConstraintWriter::encode(const std::vector<TypeTerm>& tys)
+{
+    encode(static_cast<std::uint32_t>(tys.size()));
+    for (const auto ty : tys)
+        encode(ty);
+}
+
+bool BinaryConstraintWriter::block(bool b)
+{
+    // Sections are still delimited while blocked, so the blocking state is
+    // recorded as well.
+    record(Op::Block);
+    encode(static_cast<std::uint32_t>(b));
+    commit();
+    return ConstraintWriter::block(b);
+}
+
+void BinaryConstraintWriter::writeText(const std::string& text)
+{
+    HONOR_BLOCKING_STATE;
+
+    record(Op::Text);
+    encode(text);
+    commit();
+}
+
+void BinaryConstraintWriter::writeTypedef(TypeTerm ty1, TypeTerm ty2)
+{
+    HONOR_BLOCKING_STATE;
+
+    record(Op::Typedef);
+    encode(ty1);
+    encode(ty2);
+    commit();
+    ++cnt_;
+}
+
+void BinaryConstraintWriter::writeVarDecl(const std::string& name, TypeTerm type)
+{
+    HONOR_BLOCKING_STATE;
+
+    record(Op::VarDecl);
+    encode(name);
+    encode(type);
+    commit();
+    ++cnt_;
+}
+
+void BinaryConstraintWriter::writeFuncDecl(const std::string& name,
+                                           const std::vector<TypeTerm>& params,
+                                           TypeTerm ret)
+{
+    HONOR_BLOCKING_STATE;
+
+    record(Op::FuncDecl);
+    encode(name);
+    encode(params);
+    encode(ret);
+    commit();
+    ++cnt_;
+}
+
+void BinaryConstraintWriter::writeTypeof(const std::string& sym)
+{
+    HONOR_BLOCKING_STATE;
+
+    record(Op::Typeof);
+    encode(sym);
+    commit();
+    ++cnt_;
+}
+
+void BinaryConstraintWriter::writeExists(TypeTerm ty)
+{
+    HONOR_BLOCKING_STATE;
+
+    record(Op::Exists);
+    encode(ty);
+    commit();
+    ++cnt_;
+}
+
+void BinaryConstraintWriter::writeTypeSection(TypeTerm ty)
+{
+    HONOR_BLOCKING_STATE;
+
+    record(Op::TypeSection);
+    encode(ty);
+    commit();
+}
+
+void BinaryConstraintWriter::writeTypesSection(const std::vector<TypeTerm>& tys)
+{
+    HONOR_BLOCKING_STATE;
+
+    record(Op::TypesSection);
+    encode(tys);
+    commit();
+    ++cnt_;
+}
+
+void BinaryConstraintWriter::writeConstantExpression(const std::string& val)
+{
+    HONOR_BLOCKING_STATE;
+
+    record(Op::ConstantExpression);
+    encode(val);
+    commit();
+    ++cnt_;
+}
+
+void BinaryConstraintWriter::writeStatic(const std::string& val)
+{
+    HONOR_BLOCKING_STATE;
+
+    record(Op::Static);
+    encode(val);
+    commit();
+    ++cnt_;
+}
+
+void BinaryConstraintWriter::writeMemberRel(TypeTerm baseTy,
+                                            const std::string& sym,
+                                            TypeTerm symTy)
+{
+    HONOR_BLOCKING_STATE;
+
+    record(Op::MemberRel);
+    encode(baseTy);
+    encode(sym);
+    encode(symTy);
+    commit();
+    ++cnt_;
+}
+
+void BinaryConstraintWriter::writePtrRel(TypeTerm ty1, TypeTerm ty2)
+{
+    HONOR_BLOCKING_STATE;
+
+    record(Op::PtrRel);
+    encode(ty1);
+    encode(ty2);
+    commit();
+    ++cnt_;
+}
+
+void BinaryConstraintWriter::writeEquivRel(TypeTerm ty1, TypeTerm ty2)
+{
+    HONOR_BLOCKING_STATE;
+
+    record(Op::EquivRel);
+    encode(ty1);
+    encode(ty2);
+    commit();
+    ++cnt_;
+}
+
+void BinaryConstraintWriter::writeSubtypeRel(TypeTerm ty, TypeTerm subTy)
+{
+    HONOR_BLOCKING_STATE;
+
+    record(Op::SubtypeRel);
+    encode(ty);
+    encode(subTy);
+    commit();
+    ++cnt_;
+}
+
+void BinaryConstraintWriter::writeEquivMark()
+{
+    HONOR_BLOCKING_STATE;
+
+    record(Op::EquivMark);
+    commit();
+}
+
+void BinaryConstraintWriter::writeSubtypeMark()
+{
+    HONOR_BLOCKING_STATE;
+
+    record(Op::SubtypeMark);
+    commit();
+}
+
+void BinaryConstraintWriter::enterGroup()
+{
+    HONOR_BLOCKING_STATE;
+
+    record(Op::EnterGroup);
+    commit();
+}
+
+void BinaryConstraintWriter::leaveGroup()
+{
+    HONOR_BLOCKING_STATE;
+
+    record(Op::LeaveGroup);
+    commit();
+}
+
+void BinaryConstraintWriter::openScope()
+{
+    HONOR_BLOCKING_STATE;
+
+    record(Op::OpenScope);
+    commit();
+}
+
+void BinaryConstraintWriter::closeScope()
+{
+    HONOR_BLOCKING_STATE;
+
+    record(Op::CloseScope);
+    commit();
+}
+
+void BinaryConstraintWriter::beginSection()
+{
+    record(Op::BeginSection);
+    commit();
+}
+
+void BinaryConstraintWriter::endSection()
+{
+    record(Op::EndSection);
+    commit();
+}
@@ -0,0 +1,95 @@
+/******************************************************************************
+ * Copyright (c) 2016 Leandro T. C. Melo (ltcmelo@gmail.com)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ * USA
+ *****************************************************************************/
+
+#ifndef PSYCHE_BINARYCONSTRAINTWRITER_H__
+#define PSYCHE_BINARYCONSTRAINTWRITER_H__
+
+#include "BinaryConstraintFormat.h"
+#include "ConstraintWriter.h"
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace psyche {
+
+/*!
+ * \brief The BinaryConstraintWriter class
+ *
+ * Write the constraints in the binary format (see BinaryConstraintFormat.h).
+ * Type names and other strings are written once, in a string table interleaved
+ * with the records, and referred to by index thereafter.
+ */
+class BinaryConstraintWriter final : public ConstraintWriter
+{
+public:
+    BinaryConstraintWriter(std::ostream& os);
+    ~BinaryConstraintWriter() override;
+
+    bool block(bool b) override;
+    void writeText(const std::string& text) override;
+    void writeTypedef(TypeTerm ty1, TypeTerm ty2) override;
+    void writeVarDecl(const std::string& name, TypeTerm type) override;
+    void writeFuncDecl(const std::string& name,
+                       const std::vector<TypeTerm>& params,
+                       TypeTerm ret) override;
+    void writeTypeof(const std::string& sym) override;
+    void writeExists(TypeTerm ty) override;
+    void writeTypeSection(TypeTerm ty) override;
+    void writeTypesSection(const std::vector<TypeTerm>& tys) override;
+    void writeConstantExpression(const std::string& val) override;
+    void writeStatic(const std::string& val) override;
+    void writeMemberRel(TypeTerm baseTy, const std::string& sym, TypeTerm symTy) override;
+    void writePtrRel(TypeTerm ty1, TypeTerm ty2) override;
+    void writeEquivRel(TypeTerm ty1, TypeTerm ty2) override;
+    void writeSubtypeRel(TypeTerm ty, TypeTerm subTy) override;
+    void writeEquivMark() override;
+    void writeSubtypeMark() override;
+    void enterGroup() override;
+    void leaveGroup() override;
+    void openScope() override;
+    void closeScope() override;
+    void beginSection() override;
+    void endSection() override;
+
+private:
+    void record(cstr::Op op);
+    void commit();
+
+    void encode(std::uint32_t n);
+    void encode(const std::string& s);
+    void encode(TypeTerm ty);
+    void encode(const std::vector<TypeTerm>& tys);
+
+    std::uint32_t stringIndex(const std::string& s);
+
+    //! String definitions and the record being written.
+    std::string defs_;
+    std::string rec_;
+
+    std::unordered_map<std::string, std::uint32_t> strings_;
+
+    //! String index of each type name in the pool, indexed by its id.
+    std::vector<std::uint32_t> names_;
+};
+
+} // namespace psyche
+
+#endif
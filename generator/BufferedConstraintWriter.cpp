@@ -0,0 +1,79 @@
+/******************************************************************************
+ * Copyright (c) 2016 Leandro T. C. Melo (ltcmelo@gmail.com)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ * USA
+ *****************************************************************************/
+
+#include "BufferedConstraintWriter.h"
+#include <cerrno>
+#include <unistd.h>
+
+using namespace psyche;
+
+namespace {
+
+const std::size_t kBufferSize = 1 << 16;
+
+} // anonymous
+
+BufferedConstraintWriter::BufferedConstraintWriter(std::ostream& os)
+    : ConstraintWriter(os)
+    , fd_(-1)
+{
+    init();
+}
+
+BufferedConstraintWriter::BufferedConstraintWriter(int fd)
+    : fd_(fd)
+{
+    init();
+}
+
+BufferedConstraintWriter::~BufferedConstraintWriter()
+{
+    sync();
+}
+
+void BufferedConstraintWriter::init()
+{
+    buffer_.reserve(kBufferSize + kBufferSize / 4);
+    out_ = &buffer_;
+    syncSize_ = kBufferSize;
+}
+
+void BufferedConstraintWriter::sync()
+{
+    if (buffer_.empty())
+        return;
+
+    if (os_) {
+        os_->write(buffer_.data(), buffer_.size());
+    } else {
+        const char* data = buffer_.data();
+        auto left = buffer_.size();
+        while (left) {
+            const auto n = ::write(fd_, data, left);
+            if (n < 0) {
+                if (errno == EINTR)
+                    continue;
+                break;
+            }
+            data += n;
+            left -= static_cast<std::size_t>(n);
+        }
+    }
+    buffer_.clear();
+}
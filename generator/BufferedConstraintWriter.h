@@ -0,0 +1,54 @@
+/******************************************************************************
+ * Copyright (c) 2016 Leandro T. C. Melo (ltcmelo@gmail.com)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ * USA
+ *****************************************************************************/
+
+#ifndef PSYCHE_BUFFEREDCONSTRAINTWRITER_H__
+#define PSYCHE_BUFFEREDCONSTRAINTWRITER_H__
+
+#include "ConstraintWriter.h"
+#include <ostream>
+#include <string>
+
+namespace psyche {
+
+/*!
+ * \brief The BufferedConstraintWriter class
+ *
+ * Write the constraints in the text format, exactly as the ConstraintWriter
+ * does, but into a contiguous buffer that is only handed over, either to a
+ * stream or to a file descriptor, when it grows large or upon sync.
+ */
+class BufferedConstraintWriter final : public ConstraintWriter
+{
+public:
+    BufferedConstraintWriter(std::ostream& os);
+    BufferedConstraintWriter(int fd);
+    ~BufferedConstraintWriter() override;
+
+    void sync() override;
+
+private:
+    void init();
+
+    int fd_;
+    std::string buffer_;
+};
+
+} // namespace psyche
+
+#endif
@@ -0,0 +1,144 @@
+/******************************************************************************
+ * Copyright (c) 2016 Leandro T. C. Melo (ltcmelo@gmail.com)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ * USA
+ *****************************************************************************/
+
+#include "ConstraintCache.h"
+#include "ConstraintChunk.h"
+#include <cstring>
+
+using namespace psyche;
+
+namespace {
+
+constexpr char kMagic[] = { '\x7f', 'C', 'M', 'A', 'N' };
+constexpr std::uint8_t kVersion = 1;
+
+void put(std::string& data, std::uint64_t n, int bytes)
+{
+    for (auto i = 0; i < bytes; ++i)
+        data.push_back(static_cast<char>((n >> (i * 8)) & 0xff));
+}
+
+std::uint64_t get(const std::string& data, std::size_t pos, int bytes)
+{
+    std::uint64_t n = 0;
+    for (auto i = 0; i < bytes; ++i)
+        n |= static_cast<std::uint64_t>(static_cast<unsigned char>(data[pos + i])) << (i * 8);
+    return n;
+}
+
+} // anonymous
+
+ConstraintCache::ConstraintCache()
+{}
+
+bool ConstraintCache::load(const std::string& data)
+{
+    loaded_.clear();
+    if (data.size() < sizeof(kMagic) + 1
+            || std::memcmp(data.data(), kMagic, sizeof(kMagic))
+            || static_cast<std::uint8_t>(data[sizeof(kMagic)]) != kVersion) {
+        return false;
+    }
+
+    std::unordered_map<std::uint64_t, std::string> loaded;
+    auto pos = sizeof(kMagic) + 1;
+    while (pos < data.size()) {
+        if (data.size() - pos < 12)
+            return false;
+        const auto key = get(data, pos, 8);
+        const auto size = get(data, pos + 8, 4);
+        pos += 12;
+        if (size > data.size() - pos)
+            return false;
+        loaded.emplace(key, data.substr(pos, size));
+        pos += size;
+    }
+    loaded_ = std::move(loaded);
+    return true;
+}
+
+std::string ConstraintCache::save() const
+{
+    std::string data(kMagic, sizeof(kMagic));
+    data.push_back(static_cast<char>(kVersion));
+    for (const auto& chunk : current_) {
+        put(data, chunk.first, 8);
+        put(data, chunk.second.size(), 4);
+        data.append(chunk.second);
+    }
+    return data;
+}
+
+bool ConstraintCache::fetch(std::uint64_t key, ConstraintChunk* chunk)
+{
+    std::string saved;
+    {
+        std::lock_guard<std::mutex> guard(lock_);
+        auto it = current_.find(key);
+        if (it != current_.end()) {
+            saved = it->second;
+        } else {
+            auto old = loaded_.find(key);
+            if (old == loaded_.end())
+                return false;
+            saved = old->second;
+            current_.emplace(key, std::move(old->second));
+            loaded_.erase(old);
+        }
+    }
+
+    // A chunk that can't be loaded (e.g., the manifest is corrupt) is
+    // regenerated.
+    if (!chunk->load(saved))
+        return false;
+
+    std::lock_guard<std::mutex> guard(lock_);
+    ++stats_.reused_;
+    return true;
+}
+
+void ConstraintCache::store(std::uint64_t key, const ConstraintChunk& chunk)
+{
+    std::string data;
+    chunk.save(data);
+
+    std::lock_guard<std::mutex> guard(lock_);
+    current_[key] = std::move(data);
+    ++stats_.regenerated_;
+}
+
+std::uint64_t ConstraintCache::combine(std::uint64_t h, std::uint64_t v)
+{
+    return h ^ (v + 0x9e3779b97f4a7c15ull + (h << 6) + (h >> 2));
+}
+
+ConstraintCache::Stats ConstraintCache::stats() const
+{
+    Stats stats = stats_;
+    stats.stale_ = loaded_.size();
+    return stats;
+}
+
+std::ostream& psyche::operator<<(std::ostream& os, const ConstraintCache::Stats& s)
+{
+    os << "  Reused chunks      : " << s.reused_ << std::endl
+       << "  Regenerated chunks : " << s.regenerated_ << std::endl
+       << "  Stale chunks       : " << s.stale_;
+    return os;
+}
@@ -0,0 +1,96 @@
+/******************************************************************************
+ * Copyright (c) 2016 Leandro T. C. Melo (ltcmelo@gmail.com)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ * USA
+ *****************************************************************************/
+
+#ifndef PSYCHE_CONSTRAINTCACHE_H__
+#define PSYCHE_CONSTRAINTCACHE_H__
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+
+namespace psyche {
+
+class ConstraintChunk;
+
+/*!
+ * \brief The ConstraintCache class
+ *
+ * The constraints generated for each top-level declaration in a previous run,
+ * keyed by a hash of the declaration's content (its tokens, those of the
+ * declarations it refers to, and its domains in the lattice). A declaration
+ * whose key is found needn't be regenerated: its chunk is loaded instead.
+ *
+ * The cache is loaded from, and saved into, a manifest; only the chunks of the
+ * last run are saved.
+ */
+class ConstraintCache final
+{
+public:
+    ConstraintCache();
+
+    /*!
+     * \brief load
+     *
+     * Load the chunks of a manifest. Return false if the data isn't a manifest
+     * (of this version), in which case the cache remains empty.
+     */
+    bool load(const std::string& data);
+
+    //! Save the chunks of this run into a manifest.
+    std::string save() const;
+
+    /*!
+     * \brief fetch
+     *
+     * Load, into the chunk, the one saved under the key. Return false if there
+     * is none.
+     */
+    bool fetch(std::uint64_t key, ConstraintChunk* chunk);
+
+    //! Save the chunk, which must be closed already, under the key.
+    void store(std::uint64_t key, const ConstraintChunk& chunk);
+
+    //! Combine a hash with another.
+    static std::uint64_t combine(std::uint64_t h, std::uint64_t v);
+
+    struct Stats
+    {
+        std::size_t reused_ { 0 };
+        std::size_t regenerated_ { 0 };
+        std::size_t stale_ { 0 }; //!< Loaded but not reused.
+    };
+
+    Stats stats() const;
+
+private:
+    std::unordered_map<std::uint64_t, std::string> loaded_;
+    std::map<std::uint64_t, std::string> current_;
+    std::mutex lock_;
+    Stats stats_;
+};
+
+std::ostream& operator<<(std::ostream& os, const ConstraintCache::Stats& s);
+
+} // namespace psyche
+
+#endif
@@ -0,0 +1,353 @@
+/******************************************************************************
+ * Copyright (c) 2016 Leandro T. C. Melo (ltcmelo@gmail.com)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ * USA
+ *****************************************************************************/
+
+#include "ConstraintChunk.h"
+#include <cctype>
+
+using namespace psyche;
+
+namespace {
+
+// Not part of an identifier, so generated names can't clash with actual ones.
+const char kUnnamedMark = '#';
+
+// A saved term is a variable, the index of a name already saved, a new name,
+// or a sequence (followed by its two terms).
+const std::uint32_t kName = 1;
+const std::uint32_t kSeq = 2;
+const std::uint32_t kNewName = 3;
+
+void encode(std::string& data, std::uint32_t n)
+{
+    while (n >= 0x80) {
+        data.push_back(static_cast<char>((n & 0x7f) | 0x80));
+        n >>= 7;
+    }
+    data.push_back(static_cast<char>(n));
+}
+
+void encode(std::string& data, const std::string& s)
+{
+    encode(data, static_cast<std::uint32_t>(s.size()));
+    data.append(s);
+}
+
+bool decode(const std::string& data, std::size_t& pos, std::uint32_t& n)
+{
+    n = 0;
+    for (auto shift = 0u; pos < data.size() && shift < 32; shift += 7) {
+        const auto byte = static_cast<unsigned char>(data[pos++]);
+        n |= static_cast<std::uint32_t>(byte & 0x7f) << shift;
+        if (!(byte & 0x80))
+            return true;
+    }
+    return false;
+}
+
+bool decode(const std::string& data, std::size_t& pos, std::string& s)
+{
+    std::uint32_t size;
+    if (!decode(data, pos, size) || size > data.size() - pos)
+        return false;
+    s.assign(data, pos, size);
+    pos += size;
+    return true;
+}
+
+} // anonymous
+
+ConstraintChunk::ConstraintChunk(ConstraintWriter* writer)
+    : ConstraintRecorder(writer)
+{}
+
+ConstraintChunk::~ConstraintChunk()
+{}
+
+TypeTermPool& ConstraintChunk::terms()
+{
+    return terms_;
+}
+
+std::string ConstraintChunk::unnamed(const std::string& prefix, int n)
+{
+    return prefix + kUnnamedMark + std::to_string(n);
+}
+
+void ConstraintChunk::markKnown(const std::string& func, TypeTerm retTy)
+{
+    marks_.push_back(Mark{ Mark::FuncKnown, func, retTy, entries_.size() });
+}
+
+void ConstraintChunk::markCalled(const std::string& func, TypeTerm callTy)
+{
+    marks_.push_back(Mark{ Mark::FuncCalled, func, callTy, entries_.size() });
+}
+
+void ConstraintChunk::close(std::uint32_t varCnt, std::uint32_t unnamedCnt)
+{
+    varCnt_ = varCnt;
+    unnamedCnt_ = unnamedCnt;
+}
+
+bool ConstraintChunk::relocate(std::string& name)
+{
+    const auto mark = name.find(kUnnamedMark);
+    if (mark == std::string::npos || mark == 0 || mark + 1 == name.size())
+        return false;
+    for (auto i = mark + 1; i < name.size(); ++i) {
+        if (!std::isdigit(static_cast<unsigned char>(name[i])))
+            return false;
+    }
+
+    const auto n = std::stoul(name.substr(mark + 1));
+    name = name.substr(0, mark) + std::to_string(unnamedBase_ + n);
+    return true;
+}
+
+TypeTerm ConstraintChunk::relocate(TypeTerm ty)
+{
+    if (ty.isVar())
+        return ty.index() ? TypeTerm::var(varBase_ + ty.index()) : ty;
+
+    auto it = relocated_.find(ty.bits());
+    if (it != relocated_.end())
+        return it->second;
+
+    TypeTerm reloc = ty;
+    if (ty.isName()) {
+        std::string name = terms_.nameOf(ty);
+        if (relocate(name))
+            reloc = terms_.intern(name);
+    } else {
+        const auto seq = terms_.seqOf(ty);
+        reloc = terms_.seq(relocate(seq.first), relocate(seq.second));
+    }
+    relocated_.emplace(ty.bits(), reloc);
+    return reloc;
+}
+
+void ConstraintChunk::relocate(std::uint32_t varBase, std::uint32_t unnamedBase)
+{
+    varBase_ = varBase;
+    unnamedBase_ = unnamedBase;
+    relocated_.clear();
+
+    for (Entry& e : entries_) {
+        if (e.op_ == Op::Block)
+            continue;
+        e.ty1_ = relocate(e.ty1_);
+        e.ty2_ = relocate(e.ty2_);
+    }
+    for (auto& tys : lists_) {
+        for (auto& ty : tys)
+            ty = relocate(ty);
+    }
+    for (auto& s : strings_)
+        relocate(s);
+    for (Mark& mark : marks_) {
+        mark.ty_ = relocate(mark.ty_);
+        relocate(mark.func_);
+    }
+}
+
+void ConstraintChunk::save(std::string& data) const
+{
+    std::unordered_map<std::uint32_t, std::uint32_t> names;
+    std::function<void (TypeTerm)> encodeTerm = [&] (TypeTerm ty) {
+        if (ty.isVar()) {
+            encode(data, ty.bits());
+        } else if (ty.isName()) {
+            auto it = names.find(ty.index());
+            if (it != names.end()) {
+                encode(data, (it->second << 2) | kName);
+                return;
+            }
+            names.emplace(ty.index(), static_cast<std::uint32_t>(names.size()));
+            encode(data, kNewName);
+            encode(data, terms_.nameOf(ty));
+        } else {
+            encode(data, kSeq);
+            encodeTerm(terms_.seqOf(ty).first);
+            encodeTerm(terms_.seqOf(ty).second);
+        }
+    };
+
+    encode(data, varCnt_);
+    encode(data, unnamedCnt_);
+    encode(data, static_cast<std::uint32_t>(entries_.size()));
+    for (const Entry& e : entries_) {
+        data.push_back(static_cast<char>(e.op_));
+        encodeTerm(e.ty1_);
+        encodeTerm(e.ty2_);
+        encode(data, e.aux_);
+        encode(data, e.list_);
+    }
+    encode(data, static_cast<std::uint32_t>(lists_.size()));
+    for (const auto& tys : lists_) {
+        encode(data, static_cast<std::uint32_t>(tys.size()));
+        for (const auto ty : tys)
+            encodeTerm(ty);
+    }
+    encode(data, static_cast<std::uint32_t>(strings_.size()));
+    for (const auto& s : strings_)
+        encode(data, s);
+    encode(data, static_cast<std::uint32_t>(marks_.size()));
+    for (const Mark& mark : marks_) {
+        data.push_back(static_cast<char>(mark.kind_));
+        encode(data, mark.func_);
+        encodeTerm(mark.ty_);
+        encode(data, static_cast<std::uint32_t>(mark.pos_));
+    }
+}
+
+bool ConstraintChunk::load(const std::string& data)
+{
+    if (read(data))
+        return true;
+
+    entries_.clear();
+    lists_.clear();
+    strings_.clear();
+    marks_.clear();
+    varCnt_ = 0;
+    unnamedCnt_ = 0;
+    return false;
+}
+
+bool ConstraintChunk::read(const std::string& data)
+{
+    std::size_t pos = 0;
+    std::vector<TypeTerm> names;
+    std::function<bool (TypeTerm&)> decodeTerm = [&] (TypeTerm& ty) {
+        std::uint32_t n;
+        if (!decode(data, pos, n))
+            return false;
+        if (n == kNewName) {
+            std::string name;
+            if (!decode(data, pos, name))
+                return false;
+            ty = terms_.intern(name);
+            names.push_back(ty);
+        } else if (n == kSeq) {
+            TypeTerm first, second;
+            if (!decodeTerm(first) || !decodeTerm(second))
+                return false;
+            ty = terms_.seq(first, second);
+        } else if ((n & 3) == kName) {
+            if ((n >> 2) >= names.size())
+                return false;
+            ty = names[n >> 2];
+        } else {
+            ty = TypeTerm::var(n >> 2);
+        }
+        return true;
+    };
+    auto decodeOp = [&] (char& op, char last) {
+        if (pos >= data.size() || data[pos] < 0 || data[pos] > last)
+            return false;
+        op = data[pos++];
+        return true;
+    };
+
+    std::uint32_t cnt;
+    if (!decode(data, pos, varCnt_) || !decode(data, pos, unnamedCnt_) || !decode(data, pos, cnt))
+        return false;
+    entries_.resize(cnt);
+    for (Entry& e : entries_) {
+        char op;
+        if (!decodeOp(op, static_cast<char>(Op::EndSection))
+                || !decodeTerm(e.ty1_)
+                || !decodeTerm(e.ty2_)
+                || !decode(data, pos, e.aux_)
+                || !decode(data, pos, e.list_)) {
+            return false;
+        }
+        e.op_ = static_cast<Op>(op);
+    }
+    if (!decode(data, pos, cnt))
+        return false;
+    lists_.resize(cnt);
+    for (auto& tys : lists_) {
+        if (!decode(data, pos, cnt))
+            return false;
+        tys.resize(cnt);
+        for (auto& ty : tys) {
+            if (!decodeTerm(ty))
+                return false;
+        }
+    }
+    if (!decode(data, pos, cnt))
+        return false;
+    strings_.resize(cnt);
+    for (auto& s : strings_) {
+        if (!decode(data, pos, s))
+            return false;
+    }
+    if (!decode(data, pos, cnt))
+        return false;
+    marks_.resize(cnt);
+    for (Mark& mark : marks_) {
+        char kind;
+        std::uint32_t markPos;
+        if (!decodeOp(kind, Mark::FuncCalled)
+                || !decode(data, pos, mark.func_)
+                || !decodeTerm(mark.ty_)
+                || !decode(data, pos, markPos)
+                || markPos > entries_.size()) {
+            return false;
+        }
+        mark.kind_ = static_cast<Mark::Kind>(kind);
+        mark.pos_ = markPos;
+    }
+
+    // The indices within the entries must be valid.
+    for (const Entry& e : entries_) {
+        if ((e.op_ == Op::FuncDecl || e.op_ == Op::TypesSection) && e.list_ >= lists_.size())
+            return false;
+
+        switch (e.op_) {
+        case Op::Text:
+        case Op::VarDecl:
+        case Op::FuncDecl:
+        case Op::Typeof:
+        case Op::ConstantExpression:
+        case Op::Static:
+        case Op::MemberRel:
+            if (e.aux_ >= strings_.size())
+                return false;
+            break;
+
+        default:
+            break;
+        }
+    }
+    return pos == data.size();
+}
+
+void ConstraintChunk::writeTo(ConstraintWriter* writer,
+                              const std::function<void (const Mark&)>& onMark)
+{
+    auto mark = marks_.begin();
+    for (auto pos = 0u; pos <= entries_.size(); ++pos) {
+        for (; mark != marks_.end() && mark->pos_ == pos; ++mark)
+            onMark(*mark);
+        if (pos < entries_.size())
+            replay(entries_[pos], writer);
+    }
+}
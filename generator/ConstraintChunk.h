@@ -0,0 +1,125 @@
+/******************************************************************************
+ * Copyright (c) 2016 Leandro T. C. Melo (ltcmelo@gmail.com)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ * USA
+ *****************************************************************************/
+
+#ifndef PSYCHE_CONSTRAINTCHUNK_H__
+#define PSYCHE_CONSTRAINTCHUNK_H__
+
+#include "ConstraintRecorder.h"
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace psyche {
+
+/*!
+ * \brief The ConstraintChunk class
+ *
+ * A writer that records the constraints of a part of the unit, generated apart
+ * from the rest, in a pool of its own. Type variables and generated names are
+ * numbered from scratch within the chunk, and relocated before the chunk is
+ * written, in order with the others, through the actual writer.
+ *
+ * Whatever depends on the other chunks (i.e., which functions are known) is not
+ * resolved within the chunk, but marked at its position in the constraints.
+ */
+class ConstraintChunk final : public ConstraintRecorder
+{
+public:
+    ConstraintChunk(ConstraintWriter* writer);
+    ~ConstraintChunk() override;
+
+    TypeTermPool& terms() override;
+
+    //! A name generated within the chunk, as the \a n-th with the given prefix.
+    static std::string unnamed(const std::string& prefix, int n);
+
+    struct Mark
+    {
+        enum Kind : char { FuncKnown, FuncCalled };
+
+        Kind kind_;
+        std::string func_;
+        TypeTerm ty_; //!< The function's return type, or the call's type.
+        std::size_t pos_;
+    };
+
+    //!@{
+    /*!
+     * Mark, at the current position, that a function becomes known, or that the
+     * value of a function call is discarded.
+     */
+    void markKnown(const std::string& func, TypeTerm retTy);
+    void markCalled(const std::string& func, TypeTerm callTy);
+    //!@}
+
+    //! Finish the chunk, with the number of type variables and names generated.
+    void close(std::uint32_t varCnt, std::uint32_t unnamedCnt);
+
+    std::uint32_t varCount() const { return varCnt_; }
+    std::uint32_t unnamedCount() const { return unnamedCnt_; }
+
+    /*!
+     * \brief relocate
+     *
+     * Number the type variables and generated names of the chunk after the
+     * given ones.
+     */
+    void relocate(std::uint32_t varBase, std::uint32_t unnamedBase);
+
+    /*!
+     * \brief writeTo
+     *
+     * Write the constraints of the chunk through the writer, handing over each
+     * mark when its position is reached.
+     */
+    void writeTo(ConstraintWriter* writer, const std::function<void (const Mark&)>& onMark);
+
+    /*!
+     * \brief save
+     *
+     * Append the chunk, as recorded (i.e., before it's relocated), to the data.
+     */
+    void save(std::string& data) const;
+
+    /*!
+     * \brief load
+     *
+     * Record the chunk saved in the data, closed already. On malformed data,
+     * return false and leave the chunk empty.
+     */
+    bool load(const std::string& data);
+
+private:
+    bool read(const std::string& data);
+    TypeTerm relocate(TypeTerm ty);
+    bool relocate(std::string& name);
+
+    std::vector<Mark> marks_;
+    std::uint32_t varCnt_ { 0 };
+    std::uint32_t unnamedCnt_ { 0 };
+    std::uint32_t varBase_ { 0 };
+    std::uint32_t unnamedBase_ { 0 };
+    std::unordered_map<std::uint32_t, TypeTerm> relocated_;
+};
+
+} // namespace psyche
+
+#endif
@@ -22,6 +22,8 @@
 */
 
 #include "ConstraintGenerator.h"
+#include "ConstraintCache.h"
+#include "ConstraintChunk.h"
 #include "ConstraintWriter.h"
 #include "AST.h"
 #include "PsycheAssert.h"
@@ -36,16 +38,29 @@
 #include "PrintfScanner.h"
 #include "Scope.h"
 #include "Symbols.h"
+#include "Token.h"
 #include "TranslationUnit.h"
 #include "ExpressionTypeEvaluator.h"
 #include "VisitorObserver.h"
 #include <iostream>
 #include <algorithm>
+#include <atomic>
+#include <functional>
+#include <map>
+#include <memory>
+#include <thread>
+#include <unordered_set>
 
 #define VISITOR_NAME "ConstraintGenerator"
 
 #define OBSERVE(AST_NAME) ObserverInvoker<AST_NAME> invoker(observer_, ast, scope_)
 
+#define OBSERVE_DEFERRED(AST_NAME) \
+    DeferredObserverInvoker<AST_NAME> invoker(observer_, ast, scope_, \
+                                              [this] (std::function<void ()> task) { \
+                                                  defer(std::move(task)); \
+                                              })
+
 #define ENSURE_NONEMPTY_TYPE_STACK(CODE) \
     PSYCHE_ASSERT(!types_.empty(), CODE, "type stack must be nonempty")
 
@@ -56,6 +71,37 @@ using namespace psyche;
 
 namespace {
 
+/*
+ * Like an ObserverInvoker, for rules that defer their operands: the leave notification is
+ * deferred as well, so it still comes after the ones of the operands.
+ */
+template <class AstT>
+struct DeferredObserverInvoker
+{
+    DeferredObserverInvoker(VisitorObserver* o,
+                            AstT* ast,
+                            Scope* scope,
+                            std::function<void (std::function<void ()>)> defer)
+        : o_(o), ast_(ast), defer_(std::move(defer))
+    {
+        if (o_)
+            o_->enter(ast_, scope);
+    }
+
+    ~DeferredObserverInvoker()
+    {
+        if (!o_)
+            return;
+        VisitorObserver* o = o_;
+        AstT* ast = ast_;
+        defer_([o, ast] () { o->leave(ast); });
+    }
+
+    VisitorObserver* o_;
+    AstT* ast_;
+    std::function<void (std::function<void ()>)> defer_;
+};
+
 // Extract the identifier of a name. Use this only when it's guaranteed that
 // the underlying name is indeed a simple one.
 std::string extractId(const Name* name)
@@ -78,9 +124,22 @@ ConstraintGenerator::ConstraintGenerator(TranslationUnit *unit,
     : ASTVisitor(unit)
     , scope_(nullptr)
     , writer_(writer)
+    , terms_(writer->terms())
+    , intTy_(terms_.intern(kIntTy))
+    , scalarTy_(terms_.intern(kScalarTy))
+    , sizeTy_(terms_.intern(kSizeTy))
+    , defaultIntTy_(terms_.intern(kDefaultIntTy))
+    , defaultArithTy_(terms_.intern(kDefaultArithTy))
+    , defaultFloatPointTy_(terms_.intern(kDefaultFloatPointTy))
+    , defaultStrTy_(terms_.intern(kDefaultStrTy))
     , lattice_(nullptr)
     , staticDecl_(false)
+    , jobs_(1)
+    , cache_(nullptr)
+    , chunk_(nullptr)
+    , lock_(nullptr)
     , unnamedCount_(0)
+    , performing_(false)
     , observer_(nullptr)
     , interceptor_(nullptr)
 {
@@ -111,10 +170,206 @@ void ConstraintGenerator::generate(TranslationUnitAST* ast, Scope *global)
     printDebug("Let's generate constraints!!!\n");
     OBSERVE(TranslationUnitAST);
     switchScope(global_);
+    if ((jobs_ > 1 || cache_) && !observer_ && !interceptor_) {
+        generateInChunks(ast);
+        return;
+    }
     for (DeclarationListAST* it = ast->declaration_list; it; it = it->next)
         visitDeclaration(it->value);
 }
 
+void ConstraintGenerator::generateInChunks(TranslationUnitAST* ast)
+{
+    // A chunk ends at a function definition, or at the end of the unit; when
+    // caching, at every declaration.
+    std::vector<DeclarationRange> ranges;
+    DeclarationListAST* first = ast->declaration_list;
+    for (DeclarationListAST* it = first; it; it = it->next) {
+        if (cache_ || it->value->asFunctionDefinition() || !it->next) {
+            ranges.emplace_back(first, it->next);
+            first = it->next;
+        }
+    }
+
+    std::vector<std::unique_ptr<ConstraintChunk>> chunks;
+    for (auto i = 0u; i < ranges.size(); ++i)
+        chunks.emplace_back(new ConstraintChunk(writer_));
+
+    std::vector<std::uint64_t> keys;
+    if (cache_)
+        keys = fingerprint(ranges);
+
+    std::mutex lock;
+    std::atomic<std::size_t> next(0);
+    auto work = [&] () {
+        for (auto i = next++; i < ranges.size(); i = next++) {
+            if (cache_ && cache_->fetch(keys[i], chunks[i].get()))
+                continue;
+
+            ConstraintGenerator worker(translationUnit(), chunks[i].get());
+            worker.global_ = global_;
+            worker.lattice_ = lattice_;
+            worker.printfs_ = printfs_;
+            worker.chunk_ = chunks[i].get();
+            worker.lock_ = &lock;
+            worker.switchScope(global_);
+            for (DeclarationListAST* it = ranges[i].first; it != ranges[i].second; it = it->next)
+                worker.visitDeclaration(it->value);
+            chunks[i]->close(worker.supply_.count(), worker.unnamedCount_);
+            if (cache_)
+                cache_->store(keys[i], *chunks[i]);
+        }
+    };
+
+    std::vector<std::thread> threads;
+    const auto cnt = std::min<std::size_t>(jobs_, ranges.size());
+    for (auto i = 1u; i < cnt; ++i)
+        threads.emplace_back(work);
+    work();
+    for (auto& thread : threads)
+        thread.join();
+
+    // Merge in source order, numbering type variables and generated names as
+    // a sequential generation would.
+    std::uint32_t varCnt = 0;
+    for (const auto& chunk : chunks) {
+        chunk->relocate(varCnt, unnamedCount_);
+        varCnt += chunk->varCount();
+        unnamedCount_ += chunk->unnamedCount();
+
+        ConstraintChunk* current = chunk.get();
+        chunk->writeTo(writer_, [this, current] (const ConstraintChunk::Mark& mark) {
+            const TypeTerm ty = terms_.import(current->terms(), mark.ty_);
+            if (mark.kind_ == ConstraintChunk::Mark::FuncKnown)
+                knowFunction(mark.func_, ty);
+            else
+                discardCall(mark.func_, ty);
+        });
+    }
+    supply_.skip(varCnt);
+}
+
+std::vector<std::uint64_t> ConstraintGenerator::fingerprint(const std::vector<DeclarationRange>& ranges) const
+{
+    TranslationUnit* unit = translationUnit();
+    std::hash<std::string> hash;
+    auto spell = [unit] (unsigned begin, unsigned end) {
+        std::string s;
+        for (auto i = begin; i < end; ++i) {
+            s += unit->spell(i);
+            s += ' ';
+        }
+        return s;
+    };
+
+    std::vector<DeclarationAST*> decls;
+    std::vector<unsigned> starts;
+    for (const auto& range : ranges) {
+        for (DeclarationListAST* it = range.first; it != range.second; it = it->next) {
+            decls.push_back(it->value);
+            starts.push_back(it->value->firstToken());
+        }
+    }
+
+    // Which declarations declare a name: the global symbols, along with the
+    // members of structs, unions, and enums.
+    std::unordered_map<const Identifier*, std::vector<std::size_t>> declaring;
+    std::function<void (Symbol*, std::size_t)> declare = [&] (Symbol* sym, std::size_t decl) {
+        if (sym->identifier())
+            declaring[sym->identifier()].push_back(decl);
+        if (!sym->asClass() && !sym->asEnum())
+            return;
+        const Scope* scope = sym->asScope();
+        for (auto i = 0u; i < scope->memberCount(); ++i)
+            declare(scope->memberAt(i), decl);
+    };
+    for (auto i = 0u; i < global_->memberCount(); ++i) {
+        Symbol* sym = global_->memberAt(i);
+        auto it = std::upper_bound(starts.begin(), starts.end(), sym->sourceLocation());
+        if (it != starts.begin())
+            declare(sym, it - starts.begin() - 1);
+    }
+    auto refer = [&] (unsigned begin, unsigned end, std::vector<std::size_t>& refs) {
+        for (auto i = begin; i < end; ++i) {
+            if (unit->tokenKind(i) != T_IDENTIFIER)
+                continue;
+            auto it = declaring.find(unit->identifier(i));
+            if (it != declaring.end())
+                refs.insert(refs.end(), it->second.begin(), it->second.end());
+        }
+    };
+
+    // What other declarations depend on: a function's signature (but not its
+    // body), or a whole declaration.
+    std::vector<std::uint64_t> sigs(decls.size());
+    std::vector<std::vector<std::size_t>> sigRefs(decls.size());
+    for (auto d = 0u; d < decls.size(); ++d) {
+        auto end = decls[d]->lastToken();
+        FunctionDefinitionAST* func = decls[d]->asFunctionDefinition();
+        if (func && func->function_body)
+            end = func->function_body->firstToken();
+        sigs[d] = hash(spell(starts[d], end));
+        refer(starts[d], end, sigRefs[d]);
+    }
+
+    std::function<std::uint64_t (Scope*)> domains = [&] (Scope* scope) {
+        std::uint64_t h = lattice_->digest(scope);
+        for (auto i = 0u; i < scope->memberCount(); ++i) {
+            if (Scope* nested = scope->memberAt(i)->asScope())
+                h = ConstraintCache::combine(h, domains(nested));
+        }
+        return h;
+    };
+
+    std::uint64_t seed = 0;
+    for (const auto& printf : std::map<std::string, size_t>(printfs_.begin(), printfs_.end()))
+        seed = ConstraintCache::combine(seed, hash(printf.first + ':' + std::to_string(printf.second)));
+
+    std::vector<std::uint64_t> keys;
+    std::vector<std::size_t> visited(decls.size(), ranges.size());
+    std::size_t d = 0;
+    for (auto c = 0u; c < ranges.size(); ++c) {
+        const auto first = d;
+        std::uint64_t key = seed;
+        std::vector<std::size_t> refs;
+        std::unordered_set<const Identifier*> ids;
+        for (DeclarationListAST* it = ranges[c].first; it != ranges[c].second; it = it->next, ++d) {
+            key = ConstraintCache::combine(key, hash(spell(starts[d], decls[d]->lastToken())));
+            refer(starts[d], decls[d]->lastToken(), refs);
+            for (auto i = starts[d]; i < decls[d]->lastToken(); ++i) {
+                if (unit->tokenKind(i) == T_IDENTIFIER)
+                    ids.insert(unit->identifier(i));
+            }
+            FunctionDefinitionAST* func = decls[d]->asFunctionDefinition();
+            if (lattice_ && func && func->symbol)
+                key = ConstraintCache::combine(key, domains(func->symbol));
+        }
+
+        // Of the global domains, only those of what the chunk spells.
+        if (lattice_)
+            key = ConstraintCache::combine(key, lattice_->digest(global_, &ids));
+
+        // The declarations referred to, directly or not, from elsewhere.
+        std::vector<std::size_t> closure;
+        while (!refs.empty()) {
+            const auto ref = refs.back();
+            refs.pop_back();
+            if (visited[ref] == c)
+                continue;
+            visited[ref] = c;
+            closure.push_back(ref);
+            refs.insert(refs.end(), sigRefs[ref].begin(), sigRefs[ref].end());
+        }
+        std::sort(closure.begin(), closure.end());
+        for (const auto ref : closure) {
+            if (ref < first || ref >= d)
+                key = ConstraintCache::combine(key, sigs[ref]);
+        }
+        keys.push_back(key);
+    }
+    return keys;
+}
+
 void ConstraintGenerator::employDomainLattice(const DomainLattice* lattice)
 {
     lattice_ = lattice;
@@ -136,6 +391,23 @@ void ConstraintGenerator::addPrintfLike(const std::string &funcName, size_t varA
     printfs_.insert(std::make_pair(funcName, varArgPos));
 }
 
+void ConstraintGenerator::employThreads(unsigned jobs)
+{
+    jobs_ = jobs;
+}
+
+void ConstraintGenerator::employCache(ConstraintCache* cache)
+{
+    cache_ = cache;
+}
+
+std::unique_lock<std::mutex> ConstraintGenerator::lockFrontend() const
+{
+    if (!lock_)
+        return std::unique_lock<std::mutex>();
+    return std::unique_lock<std::mutex>(*lock_);
+}
+
 Scope *ConstraintGenerator::switchScope(Scope *scope)
 {
     if (!scope)
@@ -144,14 +416,14 @@ Scope *ConstraintGenerator::switchScope(Scope *scope)
     return scope;
 }
 
-void ConstraintGenerator::pushType(const std::string &ty)
+void ConstraintGenerator::pushType(TypeTerm ty)
 {
     types_.push(ty);
 }
 
-std::string ConstraintGenerator::popType()
+TypeTerm ConstraintGenerator::popType()
 {
-    std::string ty = types_.top();
+    const TypeTerm ty = types_.top();
     types_.pop();
     return ty;
 }
@@ -159,6 +431,8 @@ std::string ConstraintGenerator::popType()
 std::string ConstraintGenerator::createUnnamed(const std::string& prefix)
 {
     int count = ++unnamedCount_;
+    if (chunk_)
+        return ConstraintChunk::unnamed(prefix, count);
     return prefix + std::to_string(count);
 }
 
@@ -172,13 +446,57 @@ void ConstraintGenerator::assignTop(const std::string& name)
     writer_->endSection();
 }
 
-void ConstraintGenerator::collectExpression(const std::string &ty,
-                                            ExpressionAST* expr)
+void ConstraintGenerator::collectExpression(TypeTerm ty, ExpressionAST* expr)
 {
-    pushType(ty);
-    visitExpression(expr);
-    ENSURE_NONEMPTY_TYPE_STACK(return);
-    popType();
+    perform([this, ty, expr] () { deferExpression(ty, expr); });
+}
+
+void ConstraintGenerator::perform(std::function<void ()> task)
+{
+    // Tasks below the base belong to an enclosing perform, they must be left untouched.
+    const auto base = tasks_.size();
+    const bool performing = performing_;
+    performing_ = true;
+
+    tasks_.push_back(std::move(task));
+    while (tasks_.size() > base) {
+        std::function<void ()> next = std::move(tasks_.back());
+        tasks_.pop_back();
+
+        const auto mark = deferred_.size();
+        next();
+
+        for (auto i = deferred_.size(); i > mark; --i)
+            tasks_.push_back(std::move(deferred_[i - 1]));
+        deferred_.resize(mark);
+    }
+
+    performing_ = performing;
+}
+
+void ConstraintGenerator::defer(std::function<void ()> task)
+{
+    if (performing_)
+        deferred_.push_back(std::move(task));
+    else
+        task();
+}
+
+void ConstraintGenerator::deferExpression(TypeTerm ty, ExpressionAST* expr)
+{
+    defer([this, ty, expr] () {
+        pushType(ty);
+        accept(expr);
+        defer([this] () {
+            ENSURE_NONEMPTY_TYPE_STACK(return);
+            popType();
+        });
+    });
+}
+
+void ConstraintGenerator::deferVisit(ExpressionAST* ast)
+{
+    defer([this, ast] () { accept(ast); });
 }
 
     //--- Declarations
@@ -207,13 +525,13 @@ bool ConstraintGenerator::visit(FunctionDefinitionAST* ast)
 
 void ConstraintGenerator::visitSymbol(Function *func, StatementAST* body)
 {
-    std::vector<std::string> paramTyVars;
+    std::vector<TypeTerm> paramTyVars;
     for (auto i = 0u; i < func->argumentCount(); i++) {
-        std::string alpha = supply_.createTypeVar1();
+        const TypeTerm alpha = supply_.createTypeVar1();
         writer_->writeExists(alpha);
 
         Symbol* sym = func->argumentAt(i);
-        const std::string& ty = typePP_.print(sym->type(), scope_);
+        const TypeTerm ty = terms_.intern(typePP_.print(sym->type(), scope_));
         writer_->writeTypedef(ty, alpha);
         paramTyVars.push_back(ty);
 
@@ -222,13 +540,13 @@ void ConstraintGenerator::visitSymbol(Function *func, StatementAST* body)
 
     // Write the function prototype. When no return type is specified, adopt old-style C
     // rule and assume `int'.
-    std::string funcRet;
+    TypeTerm funcRet;
     if (func->returnType())
-        funcRet = typePP_.print(func->returnType(), scope_);
+        funcRet = terms_.intern(typePP_.print(func->returnType(), scope_));
     else
-        funcRet = kDefaultIntTy;
+        funcRet = defaultIntTy_;
 
-    const std::string& alpha = ensureTypeIsKnown(funcRet);
+    const TypeTerm alpha = ensureTypeIsKnown(funcRet);
     const Identifier* id = func->name()->asNameId()->identifier();
     const std::string funcName(id->begin(), id->end());
     writer_->writeFuncDecl(funcName, paramTyVars, funcRet);
@@ -276,15 +594,39 @@ void ConstraintGenerator::visitSymbol(Function *func, StatementAST* body)
         writer_->writeEquivRel(alpha, funcRet);
     valuedRets_.pop();
 
-    // Keep track of function returns.
+    knowFunction(funcName, funcRet);
+}
+
+void ConstraintGenerator::knowFunction(const std::string& funcName, TypeTerm funcRet)
+{
+    // Within a chunk, other chunks might know about the function.
+    if (chunk_) {
+        chunk_->markKnown(funcName, funcRet);
+        return;
+    }
+
     knownFuncNames_.insert(std::make_pair(funcName, funcRet));
     auto it = knownFuncRets_.find(funcName);
     if (it != knownFuncRets_.end()) {
-        for (const auto& ignored : it->second)
+        for (const auto ignored : it->second)
             writer_->writeEquivRel(ignored, funcRet);
     }
 }
 
+void ConstraintGenerator::discardCall(const std::string& funcName, TypeTerm callTy)
+{
+    if (chunk_) {
+        chunk_->markCalled(funcName, callTy);
+        return;
+    }
+
+    const auto it = knownFuncNames_.find(funcName);
+    if (it != knownFuncNames_.end())
+        writer_->writeEquivRel(callTy, it->second);
+    else
+        knownFuncRets_[funcName].push_back(callTy);
+}
+
 bool ConstraintGenerator::visit(SimpleDeclarationAST* ast)
 {
     if (interceptor_ && interceptor_->intercept(ast))
@@ -322,19 +664,19 @@ bool ConstraintGenerator::visit(SimpleDeclarationAST* ast)
             declName = extractId(decl->name());
         else
             declName = createUnnamed(declPrefix_);
-        std::string declTy = typePP_.print(decl->type(), scope_);
+        const TypeTerm declTy = terms_.intern(typePP_.print(decl->type(), scope_));
 
         // Altough a `typedef` is parsed as a simple declaration, its contraint
         // rule is different. We process it and break out, since there cannot
         // exist multiple typedefs within one declaration.
         if (decl->storage() == Symbol::Typedef) {
-            writer_->writeTypedef(declName, declTy);
+            writer_->writeTypedef(terms_.intern(declName), declTy);
             PSYCHE_ASSERT(!symIt->next, return false,
                           "multiple symbols within typedef cannot exist");
             return false;
         }
 
-        const std::string& alpha = ensureTypeIsKnown(declTy);
+        const TypeTerm alpha = ensureTypeIsKnown(declTy);
         writer_->writeEquivRel(alpha, declTy);
 
         // If an initializer is provided, visit the expression. Unless, if
@@ -343,14 +685,14 @@ bool ConstraintGenerator::visit(SimpleDeclarationAST* ast)
         // declaration if of an array, we'll deal with it further down.
         if (declIt->value->initializer
                 && !declIt->value->initializer->asBracedInitializer()) {
-            const std::string& rhsAlpha = supply_.createTypeVar1();
+            const TypeTerm rhsAlpha = supply_.createTypeVar1();
             writer_->writeExists(rhsAlpha);
             collectExpression(rhsAlpha, declIt->value->initializer);
 
-            const std::string& dummy = supply_.createTypeVar1();
+            const TypeTerm dummy = supply_.createTypeVar1();
             writer_->writeExists(dummy);
             pushType(dummy);
-            employLattice(lattice_->retrieveDomain(decl, scope_), domainOf(declIt->value->initializer),
+            employLattice(domainOf(decl), domainOf(declIt->value->initializer),
                           alpha, rhsAlpha, T_EQUAL);
             popType();
         }
@@ -360,7 +702,7 @@ bool ConstraintGenerator::visit(SimpleDeclarationAST* ast)
         // If this is the declaration of a struct member, we need to generate
         // a containment relationship for it.
         if (!structs_.empty()) {
-            const std::string& structTy = structs_.top();
+            const TypeTerm structTy = structs_.top();
             writer_->writeMemberRel(structTy, declName, alpha);
         }
 
@@ -384,14 +726,14 @@ bool ConstraintGenerator::visit(SimpleDeclarationAST* ast)
             do {
                 auto size = decltr->value->asArrayDeclarator()->expression;
                 if (size)
-                    collectExpression(kDefaultIntTy, size);
+                    collectExpression(defaultIntTy_, size);
                 decltr = decltr->next;
             } while (decltr && decltr->value->asArrayDeclarator());
 
             if (declIt->value->initializer
                     && declIt->value->initializer->asBracedInitializer()
                     && declIt->value->initializer->asBracedInitializer()->expression_list) {
-                std::string elem = supply_.createTypeVar1();
+                TypeTerm elem = supply_.createTypeVar1();
                 writer_->writeExists(elem);
 
                 auto init = declIt->value->initializer->asBracedInitializer()->expression_list;
@@ -407,7 +749,7 @@ bool ConstraintGenerator::visit(SimpleDeclarationAST* ast)
 
                 auto decltrs = declIt->value->postfix_declarator_list;
                 do {
-                    const std::string& ptr = supply_.createTypeVar1();
+                    const TypeTerm ptr = supply_.createTypeVar1();
                     writer_->writeExists(ptr);
                     writer_->writePtrRel(ptr, elem);
                     elem = ptr;
@@ -438,9 +780,9 @@ void ConstraintGenerator::visitName(NameAST* ast)
     accept(ast);
 }
 
-std::string ConstraintGenerator::ensureTypeIsKnown(std::string& tyName)
+TypeTerm ConstraintGenerator::ensureTypeIsKnown(TypeTerm tyName)
 {
-    std::string alpha = supply_.createTypeVar1();
+    const TypeTerm alpha = supply_.createTypeVar1();
     writer_->writeExists(alpha);
     writer_->writeTypedef(tyName, alpha);
     return alpha;
@@ -450,65 +792,57 @@ std::string ConstraintGenerator::ensureTypeIsKnown(std::string& tyName)
 
 void ConstraintGenerator::visitExpression(ExpressionAST* ast)
 {
-    accept(ast);
+    perform([this, ast] () { accept(ast); });
 }
 
 void ConstraintGenerator::employLattice(const DomainLattice::Domain& lhsDom,
                                         const DomainLattice::Domain& rhsDom,
-                                        const std::string& lhsTy,
-                                        const std::string& rhsTy,
+                                        TypeTerm lhsTy,
+                                        TypeTerm rhsTy,
                                         int op)
 {
-    printDebug("Binary expression  %s x %s\n", lhsDom.name_.c_str(), rhsDom.name_.c_str());
+    printDebug("Binary expression  %s x %s\n", lhsDom.name(), rhsDom.name());
 
     auto isInconsistent = [&lhsDom, &rhsDom] () {
         return ((lhsDom == DomainLattice::Pointer
-                    && (rhsDom == DomainLattice::Integral
-                        || rhsDom == DomainLattice::FloatingPoint
-                        || rhsDom == DomainLattice::Arithmetic))
+                    && rhsDom >= DomainLattice::Arithmetic)
                 || (rhsDom == DomainLattice::Pointer
-                    && (lhsDom == DomainLattice::Integral
-                        || lhsDom == DomainLattice::FloatingPoint
-                        || lhsDom == DomainLattice::Arithmetic)));
+                    && lhsDom >= DomainLattice::Arithmetic));
     };
 
     switch (op) {
     case T_MINUS:
         if (lhsDom == DomainLattice::Pointer && rhsDom == DomainLattice::Pointer) {
             writer_->writeEquivRel(lhsTy, rhsTy);
-            writer_->writeEquivRel(types_.top(), kDefaultArithTy);
+            writer_->writeEquivRel(types_.top(), defaultArithTy_);
             break;
         }
         // Fallthrough
 
     case T_PLUS: {
-        auto handlePtr = [this] (const std::string& ptrTy,
-                                 const std::string& otherTy,
+        auto handlePtr = [this] (TypeTerm ptrTy,
+                                 TypeTerm otherTy,
                                  const DomainLattice::Domain& otherDom) {
             writer_->writeEquivRel(types_.top(), ptrTy);
             if (otherDom == DomainLattice::Scalar) {
-                writer_->writeEquivRel(otherTy, kIntTy);
-            } else if (otherDom == DomainLattice::Arithmetic
-                        || otherDom == DomainLattice::Integral
-                        || otherDom == DomainLattice::FloatingPoint) {
-                writer_->writeEquivRel(otherTy, otherDom.ty_.empty() ? kIntTy : otherDom.ty_);
+                writer_->writeEquivRel(otherTy, intTy_);
+            } else if (otherDom >= DomainLattice::Arithmetic) {
+                writer_->writeEquivRel(otherTy, otherDom.typeName() ? terms_.intern(otherDom.typeName()) : intTy_);
             } else {
                 // TODO: report error.
             }
         };
 
-        auto handleArith = [this] (const std::string& arithTy,
-                                   const std::string& otherTy,
+        auto handleArith = [this] (TypeTerm arithTy,
+                                   TypeTerm otherTy,
                                    const DomainLattice::Domain& otherDom) {
-            if (otherDom == DomainLattice::Arithmetic
-                    || otherDom == DomainLattice::Integral
-                    || otherDom == DomainLattice::FloatingPoint) {
+            if (otherDom >= DomainLattice::Arithmetic) {
                 writer_->writeEquivRel(arithTy, otherTy);
                 writer_->writeEquivRel(types_.top(), arithTy); // TODO: Use side with higher rank.
             } else {
                 PSYCHE_ASSERT(otherDom == DomainLattice::Scalar, return, "expected scalar");
                 writer_->writeEquivRel(types_.top(), otherTy);
-                writer_->writeSubtypeRel(otherTy, kScalarTy);
+                writer_->writeSubtypeRel(otherTy, scalarTy_);
             }
         };
 
@@ -516,20 +850,16 @@ void ConstraintGenerator::employLattice(const DomainLattice::Domain& lhsDom,
             handlePtr(lhsTy, rhsTy, rhsDom);
         } else if (rhsDom == DomainLattice::Pointer) {
             handlePtr(rhsTy, lhsTy, lhsDom);
-        } else if (lhsDom == DomainLattice::Arithmetic
-                || lhsDom == DomainLattice::Integral
-                || lhsDom == DomainLattice::FloatingPoint) {
+        } else if (lhsDom >= DomainLattice::Arithmetic) {
             handleArith(lhsTy, rhsTy, rhsDom);
-        } else if (rhsDom == DomainLattice::Arithmetic
-                || rhsDom == DomainLattice::Integral
-                || rhsDom == DomainLattice::FloatingPoint) {
+        } else if (rhsDom >= DomainLattice::Arithmetic) {
             handleArith(rhsTy, lhsTy, lhsDom);
         } else {
             // Scalars
             writer_->writeEquivRel(types_.top(), lhsTy);
             writer_->writeEquivRel(lhsTy, rhsTy);
-            writer_->writeSubtypeRel(lhsTy, kScalarTy);
-            writer_->writeSubtypeRel(rhsTy, kScalarTy);
+            writer_->writeSubtypeRel(lhsTy, scalarTy_);
+            writer_->writeSubtypeRel(rhsTy, scalarTy_);
         }
         break;
     }
@@ -545,7 +875,7 @@ void ConstraintGenerator::employLattice(const DomainLattice::Domain& lhsDom,
     case T_GREATER_GREATER:
         writer_->writeEquivRel(lhsTy, rhsTy);
         writer_->writeEquivRel(types_.top(), lhsTy); // TODO: Use side with higher rank.
-        writer_->writeSubtypeRel(types_.top(), kIntTy);
+        writer_->writeSubtypeRel(types_.top(), intTy_);
         break;
 
     // Comparison
@@ -556,10 +886,10 @@ void ConstraintGenerator::employLattice(const DomainLattice::Domain& lhsDom,
     case T_EQUAL_EQUAL:
     case T_EXCLAIM_EQUAL:
         writer_->writeEquivRel(lhsTy, rhsTy);
-        writer_->writeEquivRel(types_.top(), kIntTy);
+        writer_->writeEquivRel(types_.top(), intTy_);
         if (lhsDom == DomainLattice::Scalar && rhsDom == DomainLattice::Scalar) {
-            writer_->writeEquivRel(lhsTy, kScalarTy);
-            writer_->writeEquivRel(rhsTy, kScalarTy);
+            writer_->writeEquivRel(lhsTy, scalarTy_);
+            writer_->writeEquivRel(rhsTy, scalarTy_);
         }
         break;
 
@@ -567,11 +897,11 @@ void ConstraintGenerator::employLattice(const DomainLattice::Domain& lhsDom,
     case T_AMPER_AMPER:
     case T_PIPE_PIPE:
         if (!isInconsistent()) {
-            writer_->writeEquivRel(types_.top(), kIntTy);
+            writer_->writeEquivRel(types_.top(), intTy_);
             if (lhsDom == DomainLattice::Scalar)
-                writer_->writeSubtypeRel(lhsTy, kScalarTy);
+                writer_->writeSubtypeRel(lhsTy, scalarTy_);
             if (rhsDom == DomainLattice::Scalar)
-                writer_->writeSubtypeRel(rhsTy, kScalarTy);
+                writer_->writeSubtypeRel(rhsTy, scalarTy_);
         }
         break;
 
@@ -580,8 +910,8 @@ void ConstraintGenerator::employLattice(const DomainLattice::Domain& lhsDom,
             writer_->writeSubtypeRel(lhsTy, rhsTy);
             writer_->writeEquivRel(types_.top(), lhsTy);
             if (lhsDom == DomainLattice::Scalar && rhsDom == DomainLattice::Scalar) {
-                writer_->writeSubtypeRel(lhsTy, kScalarTy);
-                writer_->writeSubtypeRel(rhsTy, kScalarTy);
+                writer_->writeSubtypeRel(lhsTy, scalarTy_);
+                writer_->writeSubtypeRel(rhsTy, scalarTy_);
             }
         }
         break;
@@ -595,12 +925,12 @@ void ConstraintGenerator::employLattice(const DomainLattice::Domain& lhsDom,
                 writer_->writeEquivRel(types_.top(), rhsTy);
             } else if (lhsDom == DomainLattice::Scalar) {
                 writer_->writeEquivRel(types_.top(), lhsTy);
-                writer_->writeSubtypeRel(lhsTy, kScalarTy);
+                writer_->writeSubtypeRel(lhsTy, scalarTy_);
                 if (rhsDom == DomainLattice::Scalar)
                     writer_->writeEquivRel(lhsTy, rhsTy);
             } else if (rhsDom == DomainLattice::Scalar) {
                 writer_->writeEquivRel(types_.top(), rhsTy);
-                writer_->writeSubtypeRel(rhsTy, kScalarTy);
+                writer_->writeSubtypeRel(rhsTy, scalarTy_);
                 if (lhsDom == DomainLattice::Scalar)
                     writer_->writeEquivRel(lhsTy, rhsTy);
             } else {
@@ -624,7 +954,7 @@ void ConstraintGenerator::employLattice(const DomainLattice::Domain& lhsDom,
         else if (rhsDom > DomainLattice::Arithmetic)
             writer_->writeEquivRel(types_.top(), rhsTy);
         else
-            writer_->writeEquivRel(types_.top(), kIntTy);
+            writer_->writeEquivRel(types_.top(), intTy_);
         break;;
 
     default:
@@ -633,24 +963,32 @@ void ConstraintGenerator::employLattice(const DomainLattice::Domain& lhsDom,
     }
 }
 
+DomainLattice::Domain ConstraintGenerator::domainOf(const Symbol* sym) const
+{
+    auto guard = lockFrontend();
+    return lattice_->retrieveDomain(sym, scope_);
+}
+
 DomainLattice::Domain ConstraintGenerator::domainOf(ExpressionAST* ast) const
 {
+    auto guard = lockFrontend();
     DomainLattice::Domain dom = DomainLattice::Undefined;
     if (lattice_) {
         dom = lattice_->retrieveDomain(ast, scope_);
         if (dom != DomainLattice::Undefined) {
             const auto& s = lattice_->fetchText(ast);
-            printDebug("Retrieved AST %s as %s\n", s.c_str(), dom.name_.c_str());
+            printDebug("Retrieved AST %s as %s\n", s.c_str(), dom.name());
         }
     }
 
     if (dom == DomainLattice::Undefined) {
-        ExpressionTypeEvaluator typeofExpr(translationUnit());
-        FullySpecifiedType ty = typeofExpr.evaluate(ast, scope_);
+        FullySpecifiedType ty = lattice_ ?
+                    lattice_->typeOf(ast, scope_) :
+                    ExpressionTypeEvaluator(translationUnit()).evaluate(ast, scope_);
         dom = DomainLattice::domainForType(ty);
         // TODO: Fetch text utility.
         const auto& s = lattice_->fetchText(ast);
-        printDebug("Typed AST %s as %s\n", s.c_str(), dom.name_.c_str());
+        printDebug("Typed AST %s as %s\n", s.c_str(), dom.name());
     }
 
     return dom;
@@ -659,20 +997,22 @@ DomainLattice::Domain ConstraintGenerator::domainOf(ExpressionAST* ast) const
 bool ConstraintGenerator::visit(ArrayAccessAST* ast)
 {
     DEBUG_VISIT(ArrayAccessAST);
-    OBSERVE(ArrayAccessAST);
+    OBSERVE_DEFERRED(ArrayAccessAST);
 
-    std::tuple<std::string, std::string, std::string> a1a2a3 = supply_.createTypeVar3();
+    std::tuple<TypeTerm, TypeTerm, TypeTerm> a1a2a3 = supply_.createTypeVar3();
     writer_->writeExists(std::get<0>(a1a2a3));
     writer_->writeExists(std::get<1>(a1a2a3));
     writer_->writeExists(std::get<2>(a1a2a3));
-    collectExpression(std::get<0>(a1a2a3), ast->base_expression);
-    collectExpression(std::get<1>(a1a2a3), ast->expression);
+    deferExpression(std::get<0>(a1a2a3), ast->base_expression);
+    deferExpression(std::get<1>(a1a2a3), ast->expression);
 
-    writer_->writePtrRel(std::get<0>(a1a2a3), std::get<2>(a1a2a3));
-    ENSURE_NONEMPTY_TYPE_STACK(return false);
-    writer_->writeEquivRel(types_.top(), std::get<2>(a1a2a3));
+    defer([this, a1a2a3] () {
+        writer_->writePtrRel(std::get<0>(a1a2a3), std::get<2>(a1a2a3));
+        ENSURE_NONEMPTY_TYPE_STACK(return);
+        writer_->writeEquivRel(types_.top(), std::get<2>(a1a2a3));
 
-    writer_->writeEquivRel(std::get<1>(a1a2a3), kSizeTy);
+        writer_->writeEquivRel(std::get<1>(a1a2a3), sizeTy_);
+    });
 
     return false;
 }
@@ -680,7 +1020,7 @@ bool ConstraintGenerator::visit(ArrayAccessAST* ast)
 bool ConstraintGenerator::visit(BinaryExpressionAST* ast)
 {
     DEBUG_VISIT(BinaryExpressionAST);
-    OBSERVE(BinaryExpressionAST);
+    OBSERVE_DEFERRED(BinaryExpressionAST);
 
     ExpressionAST* lexpr = ast->left_expression;
     ExpressionAST* rexpr = ast->right_expression;
@@ -688,32 +1028,38 @@ bool ConstraintGenerator::visit(BinaryExpressionAST* ast)
     // A comma expression is just a  sequence of unrelated expressions.
     unsigned op = tokenKind(ast->binary_op_token);
     if (op == T_COMMA) {
-        visitExpression(lexpr);
+        deferVisit(lexpr);
 
-        const std::string& alpha = supply_.createTypeVar1();
-        writer_->writeExists(alpha);
-        collectExpression(alpha, rexpr);
+        defer([this, rexpr] () {
+            const TypeTerm alpha = supply_.createTypeVar1();
+            writer_->writeExists(alpha);
+            deferExpression(alpha, rexpr);
+        });
         return false;
     }
 
     // With NULL, we don't know the underlying element type of the pointer, but we can
     // constrain the left-hand-side as a pointer.
     if (rexpr->asPointerLiteral()) {
-        std::tuple<std::string, std::string> a1a2 = supply_.createTypeVar2();
+        std::tuple<TypeTerm, TypeTerm> a1a2 = supply_.createTypeVar2();
         writer_->writeExists(std::get<0>(a1a2));
         writer_->writeExists(std::get<1>(a1a2));
-        collectExpression(std::get<0>(a1a2), lexpr);
-        writer_->writePtrRel(std::get<0>(a1a2), std::get<1>(a1a2));
+        deferExpression(std::get<0>(a1a2), lexpr);
+        defer([this, a1a2] () {
+            writer_->writePtrRel(std::get<0>(a1a2), std::get<1>(a1a2));
+        });
         return false;
     }
 
-    std::tuple<std::string, std::string> a1a2 = supply_.createTypeVar2();
+    std::tuple<TypeTerm, TypeTerm> a1a2 = supply_.createTypeVar2();
     writer_->writeExists(std::get<0>(a1a2));
     writer_->writeExists(std::get<1>(a1a2));
-    collectExpression(std::get<0>(a1a2), lexpr);
-    collectExpression(std::get<1>(a1a2), rexpr);
+    deferExpression(std::get<0>(a1a2), lexpr);
+    deferExpression(std::get<1>(a1a2), rexpr);
 
-    employLattice(domainOf(lexpr), domainOf(rexpr), std::get<0>(a1a2), std::get<1>(a1a2), op);
+    defer([this, lexpr, rexpr, a1a2, op] () {
+        employLattice(domainOf(lexpr), domainOf(rexpr), std::get<0>(a1a2), std::get<1>(a1a2), op);
+    });
 
     return false;
 }
@@ -749,7 +1095,7 @@ bool ConstraintGenerator::visit(CallAST* ast)
         if (fit != printfs_.end())
             varArgPos = fit->second;
     } else {
-        const std::string& funcVar = supply_.createTypeVar1();
+        const TypeTerm funcVar = supply_.createTypeVar1();
         writer_->writeExists(funcVar);
         collectExpression(funcVar, ast->base_expression);
         funcName = createUnnamed(stubPrefix_);
@@ -762,9 +1108,9 @@ bool ConstraintGenerator::visit(CallAST* ast)
 
     // Deal with "regular" functions, for which we generate constraints through
     // the normal expression inspection process.
-    std::vector<std::string> typeVars;
+    std::vector<TypeTerm> typeVars;
     for (ExpressionListAST* it = ast->expression_list; it; it = it->next) {
-        const std::string& typeVar = supply_.createTypeVar1();
+        const TypeTerm typeVar = supply_.createTypeVar1();
         writer_->writeExists(typeVar);
         collectExpression(typeVar, it->value);
         typeVars.push_back(typeVar);
@@ -790,7 +1136,7 @@ bool ConstraintGenerator::visit(CallAST* ast)
     std::vector<PrintfScanner::FormatSpec> specs;
     for (ExpressionListAST* it = ast->expression_list; it; it = it->next, ++argCnt) {
         if (argCnt < varArgPos) {
-            const std::string& typeVar = supply_.createTypeVar1();
+            const TypeTerm typeVar = supply_.createTypeVar1();
             writer_->writeExists(typeVar);
             collectExpression(typeVar, it->value);
             continue;
@@ -832,7 +1178,7 @@ bool ConstraintGenerator::visit(CallAST* ast)
             } else {
                 // When the format is not a string literal, there's not much
                 // we can do, except an string equivalence on the expression.
-                collectExpression(kDefaultStrTy, it->value);
+                collectExpression(defaultStrTy_, it->value);
                 return false;
             }
         }
@@ -843,15 +1189,15 @@ bool ConstraintGenerator::visit(CallAST* ast)
             switch (specs[argCnt]) {
             case PrintfScanner::Char:
             case PrintfScanner::Int:
-                collectExpression(kDefaultIntTy, it->value);
+                collectExpression(defaultIntTy_, it->value);
                 break;
 
             case PrintfScanner::FloatingPoint:
-                collectExpression(kDefaultFloatPointTy, it->value);
+                collectExpression(defaultFloatPointTy_, it->value);
                 break;
 
             case PrintfScanner::String:
-                collectExpression(kDefaultStrTy, it->value);
+                collectExpression(defaultStrTy_, it->value);
                 break;
 
             case PrintfScanner::Pointer:
@@ -868,19 +1214,19 @@ bool ConstraintGenerator::visit(CallAST* ast)
     return false;
 }
 
-void ConstraintGenerator::castExpressionHelper(const std::string& inputTy,
-                                               std::string& resultTy)
+void ConstraintGenerator::castExpressionHelper(TypeTerm inputTy, TypeTerm resultTy)
 {
-    if (resultTy != kCharTy
-            && resultTy != kShortTy
-            && resultTy != kIntTy
-            && resultTy != kLongTy
-            && resultTy != kLongLongTy
-            && resultTy != kFloatTy
-            && resultTy != kDoubleTy
-            && resultTy != kLongDoubleTy
-            && resultTy != kVoidTy
-            && resultTy != kDefaultStrTy) {
+    const std::string& resultName = terms_.nameOf(resultTy);
+    if (resultName != kCharTy
+            && resultName != kShortTy
+            && resultName != kIntTy
+            && resultName != kLongTy
+            && resultName != kLongLongTy
+            && resultName != kFloatTy
+            && resultName != kDoubleTy
+            && resultName != kLongDoubleTy
+            && resultName != kVoidTy
+            && resultTy != defaultStrTy_) {
         ensureTypeIsKnown(resultTy);
     }
     ENSURE_NONEMPTY_TYPE_STACK(return );
@@ -890,19 +1236,21 @@ void ConstraintGenerator::castExpressionHelper(const std::string& inputTy,
 bool ConstraintGenerator::visit(CastExpressionAST* ast)
 {
     DEBUG_VISIT(CastExpressionAST);
-    OBSERVE(CastExpressionAST);
+    OBSERVE_DEFERRED(CastExpressionAST);
 
-    std::string ty = typePP_.print(ast->expression_type, scope_);
+    const TypeTerm ty = terms_.intern(typePP_.print(ast->expression_type, scope_));
     castExpressionHelper(types_.top(), ty);
 
-    const std::string& alpha = supply_.createTypeVar1();
+    const TypeTerm alpha = supply_.createTypeVar1();
     writer_->writeExists(alpha);
-    collectExpression(alpha, ast->expression);
+    deferExpression(alpha, ast->expression);
 
-    auto targetDom = domainOf(ast->type_id);
+    defer([this, ast, alpha] () {
+        auto targetDom = domainOf(ast->type_id);
 
-    if (targetDom != DomainLattice::Undefined)
-        writer_->writeSubtypeRel(alpha, kScalarTy);
+        if (targetDom != DomainLattice::Undefined)
+            writer_->writeSubtypeRel(alpha, scalarTy_);
+    });
 
     return false;
 }
@@ -912,22 +1260,22 @@ void ConstraintGenerator::treatAsBool(ExpressionAST* ast)
     if (!ast)
         return;
 
-    std::string ty;
+    TypeTerm ty;
     auto dom = domainOf(ast);
-    if (!dom.ty_.empty()) {
-        ty = dom.ty_;
+    if (dom.typeName()) {
+        ty = terms_.intern(dom.typeName());
     } else {
         if (dom == DomainLattice::Arithmetic) {
-            ty = kDefaultArithTy;
+            ty = defaultArithTy_;
         } else if (dom == DomainLattice::Integral) {
-            ty = kDefaultIntTy;
+            ty = defaultIntTy_;
         } else if (dom == DomainLattice::FloatingPoint) {
-            ty = kDefaultFloatPointTy;
+            ty = defaultFloatPointTy_;
         } else {
             ty = supply_.createTypeVar1();
             writer_->writeExists(ty);
             if (dom == DomainLattice::Scalar)
-                writer_->writeSubtypeRel(ty, kScalarTy);
+                writer_->writeSubtypeRel(ty, scalarTy_);
         }
     }
 
@@ -937,11 +1285,11 @@ void ConstraintGenerator::treatAsBool(ExpressionAST* ast)
 bool ConstraintGenerator::visit(ConditionalExpressionAST* ast)
 {
     DEBUG_VISIT(ConditionalExpressionAST);
-    OBSERVE(ConditionalExpressionAST);
+    OBSERVE_DEFERRED(ConditionalExpressionAST);
 
     treatAsBool(ast->condition);
-    visitExpression(ast->left_expression);
-    visitExpression(ast->right_expression);
+    deferVisit(ast->left_expression);
+    deferVisit(ast->right_expression);
 
     return false;
 }
@@ -968,33 +1316,32 @@ bool ConstraintGenerator::visit(NumericLiteralAST* ast)
     const NumericLiteral* numLit = numericLiteral(ast->literal_token);
     PSYCHE_ASSERT(numLit, return false, "numeric literal must exist");
 
-    std::string ty;
-    if (numLit->isUnsigned())
-        ty.append(" unsigned ");
-
+    TypeTerm ty;
     writer_->beginSection();
     if (numLit->isDouble()) {
-        ty.append(kDoubleTy);
+        ty = terms_.intern(kDoubleTy);
     } else if (numLit->isFloat()) {
-        ty.append(kFloatTy);
+        ty = terms_.intern(kFloatTy);
     } else if (numLit->isLongDouble()) {
-        ty.append(kLongDoubleTy);
+        ty = terms_.intern(kLongDoubleTy);
     } else {
         if (!strcmp(numLit->chars(), "0")) {
-            const std::string& alpha = supply_.createTypeVar1();
+            const TypeTerm alpha = supply_.createTypeVar1();
             writer_->writeExists(alpha);
-            ty.append(alpha);
+            ty = alpha;
         } else if (tokenKind(ast->literal_token) == T_CHAR_LITERAL) {
             // TODO: char/int
-            ty.append(kCharTy);
+            ty = terms_.intern(kCharTy);
         } else if (numLit->isLong()) {
-            ty.append(kLongTy);
+            ty = terms_.intern(kLongTy);
         } else if (numLit->isLongLong()) {
-            ty.append(kLongLongTy);
+            ty = terms_.intern(kLongLongTy);
         } else {
-            ty.append(kDefaultIntTy);
+            ty = defaultIntTy_;
         }
     }
+    if (numLit->isUnsigned())
+        ty = terms_.seq(terms_.intern(" unsigned "), ty);
     writer_->writeTypeSection(ty);
     writer_->writeEquivMark();
     ENSURE_NONEMPTY_TYPE_STACK(return false);
@@ -1012,7 +1359,7 @@ bool ConstraintGenerator::visit(BoolLiteralAST* ast)
     // Treated as integer. It's relatively common to have C code defining `true`
     // and `false` through macros. Their meaning is obvious in such cases.
     ENSURE_NONEMPTY_TYPE_STACK(return false);
-    writer_->writeEquivRel(kDefaultIntTy, types_.top());
+    writer_->writeEquivRel(defaultIntTy_, types_.top());
 
     return false;
 }
@@ -1023,7 +1370,7 @@ bool ConstraintGenerator::visit(StringLiteralAST* ast)
     OBSERVE(StringLiteralAST);
 
     ENSURE_NONEMPTY_TYPE_STACK(return false);
-    writer_->writeEquivRel(kDefaultStrTy, types_.top());
+    writer_->writeEquivRel(defaultStrTy_, types_.top());
 
     return false;
 }
@@ -1031,36 +1378,47 @@ bool ConstraintGenerator::visit(StringLiteralAST* ast)
 bool ConstraintGenerator::visit(MemberAccessAST* ast)
 {
     DEBUG_VISIT(MemberAccessAST);
-    OBSERVE(MemberAccessAST);
+    OBSERVE_DEFERRED(MemberAccessAST);
 
-    std::tuple<std::string, std::string> a1a2 = supply_.createTypeVar2();
+    std::tuple<TypeTerm, TypeTerm> a1a2 = supply_.createTypeVar2();
     writer_->writeExists(std::get<0>(a1a2));
     writer_->writeExists(std::get<1>(a1a2));
 
-    std::string alpha3;
+    TypeTerm alpha3;
     unsigned accessTk = tokenKind(ast->access_token);
     if (accessTk == T_ARROW)  {
         alpha3 = supply_.createTypeVar1();
         writer_->writeExists(alpha3);
     }
 
-    collectExpression(std::get<0>(a1a2), ast->base_expression);
+    deferExpression(std::get<0>(a1a2), ast->base_expression);
 
-    // For a pointer access we need to insert an additional constraint.
-    if (accessTk == T_ARROW)
-        writer_->writePtrRel(std::get<0>(a1a2), std::get<1>(a1a2));
+    defer([this, ast, a1a2, alpha3, accessTk] () {
+        // For a pointer access we need to insert an additional constraint.
+        if (accessTk == T_ARROW)
+            writer_->writePtrRel(std::get<0>(a1a2), std::get<1>(a1a2));
 
-    std::string sym = extractId(ast->member_name->name);
-    if (accessTk == T_ARROW)
-        writer_->writeMemberRel(std::get<1>(a1a2), sym, alpha3);
-    else
-        writer_->writeMemberRel(std::get<0>(a1a2), sym, std::get<1>(a1a2));
+        std::string sym = extractId(ast->member_name->name);
+        if (accessTk == T_ARROW)
+            writer_->writeMemberRel(std::get<1>(a1a2), sym, alpha3);
+        else
+            writer_->writeMemberRel(std::get<0>(a1a2), sym, std::get<1>(a1a2));
 
-    ENSURE_NONEMPTY_TYPE_STACK(return false);
-    if (accessTk == T_ARROW)
-        writer_->writeEquivRel(types_.top(), alpha3);
-    else
-        writer_->writeEquivRel(types_.top(), std::get<1>(a1a2));
+        ENSURE_NONEMPTY_TYPE_STACK(return);
+        if (accessTk == T_ARROW)
+            writer_->writeEquivRel(types_.top(), alpha3);
+        else
+            writer_->writeEquivRel(types_.top(), std::get<1>(a1a2));
+    });
+
+    return false;
+}
+
+bool ConstraintGenerator::visit(NestedExpressionAST* ast)
+{
+    DEBUG_VISIT(NestedExpressionAST);
+
+    deferVisit(ast->expression);
 
     return false;
 }
@@ -1070,12 +1428,12 @@ bool ConstraintGenerator::visit(BracedInitializerAST* ast)
     DEBUG_VISIT(BracedInitializerAST);
     OBSERVE(BracedInitializerAST);
 
-    const std::string& alpha = supply_.createTypeVar1();
+    const TypeTerm alpha = supply_.createTypeVar1();
     writer_->writeExists(alpha);
 
     auto cnt = 0;
     for (auto it = ast->expression_list; it; it = it->next, ++cnt) {
-        std::string alphaField = supply_.createTypeVar1();
+        TypeTerm alphaField = supply_.createTypeVar1();
         writer_->writeExists(alphaField);
         collectExpression(alphaField, it->value);
 
@@ -1089,7 +1447,7 @@ bool ConstraintGenerator::visit(BracedInitializerAST* ast)
                 designators.push_back(it2->value);
             std::reverse(designators.begin(), designators.end());
 
-            std::string alphaDesig;
+            TypeTerm alphaDesig;
             for (auto i = 0u; i < designators.size(); ++i) {
                 auto design = designators[i];
                 if (design->asDotDesignator()) {
@@ -1120,11 +1478,11 @@ bool ConstraintGenerator::visit(BracedInitializerAST* ast)
 bool ConstraintGenerator::visit(PostIncrDecrAST* ast)
 {
     DEBUG_VISIT(PostIncrDecrAST);
-    OBSERVE(PostIncrDecrAST);
+    OBSERVE_DEFERRED(PostIncrDecrAST);
 
-    const std::string& alpha = supply_.createTypeVar1();
+    const TypeTerm alpha = supply_.createTypeVar1();
     writer_->writeExists(alpha);
-    collectExpression(alpha, ast->base_expression);
+    deferExpression(alpha, ast->base_expression);
 
     return false;
 }
@@ -1132,45 +1490,51 @@ bool ConstraintGenerator::visit(PostIncrDecrAST* ast)
 bool ConstraintGenerator::visit(UnaryExpressionAST* ast)
 {
     DEBUG_VISIT(UnaryExpressionAST);
-    OBSERVE(UnaryExpressionAST);
+    OBSERVE_DEFERRED(UnaryExpressionAST);
 
     switch(tokenKind(ast->unary_op_token)) {
     case T_AMPER: {
-        std::tuple<std::string, std::string> a1a2 = supply_.createTypeVar2();
+        std::tuple<TypeTerm, TypeTerm> a1a2 = supply_.createTypeVar2();
         writer_->writeExists(std::get<0>(a1a2));
         writer_->writeExists(std::get<1>(a1a2));
-        collectExpression(std::get<1>(a1a2), ast->expression);
+        deferExpression(std::get<1>(a1a2), ast->expression);
 
-        writer_->writePtrRel(std::get<0>(a1a2), std::get<1>(a1a2));
+        defer([this, a1a2] () {
+            writer_->writePtrRel(std::get<0>(a1a2), std::get<1>(a1a2));
 
-        ENSURE_NONEMPTY_TYPE_STACK(return false);
-        writer_->writeEquivRel(types_.top(), std::get<0>(a1a2));
+            ENSURE_NONEMPTY_TYPE_STACK(return);
+            writer_->writeEquivRel(types_.top(), std::get<0>(a1a2));
+        });
         break;
     }
 
     case T_STAR: {
-        const std::string& alpha = supply_.createTypeVar1();
+        const TypeTerm alpha = supply_.createTypeVar1();
         writer_->writeExists(alpha);
-        collectExpression(alpha, ast->expression);
+        deferExpression(alpha, ast->expression);
 
-        ENSURE_NONEMPTY_TYPE_STACK(return false);
-        writer_->writePtrRel(alpha, types_.top());
+        defer([this, alpha] () {
+            ENSURE_NONEMPTY_TYPE_STACK(return);
+            writer_->writePtrRel(alpha, types_.top());
+        });
         break;
     }
 
     case T_EXCLAIM: {
-        const std::string& alpha = supply_.createTypeVar1();
+        const TypeTerm alpha = supply_.createTypeVar1();
         writer_->writeExists(alpha);
-        collectExpression(alpha, ast->expression);
+        deferExpression(alpha, ast->expression);
 
-        ENSURE_NONEMPTY_TYPE_STACK(return false);
-        writer_->writeEquivRel(types_.top(), kDefaultIntTy);
+        defer([this] () {
+            ENSURE_NONEMPTY_TYPE_STACK(return);
+            writer_->writeEquivRel(types_.top(), defaultIntTy_);
+        });
         break;
     }
 
     default:
         // Let's visit the base expression.
-        visitExpression(ast->expression);
+        deferVisit(ast->expression);
         break;
     }
 
@@ -1184,15 +1548,15 @@ bool ConstraintGenerator::visit(SizeofExpressionAST* ast)
 
     // When sizeof's argument is a type, we need to make sure it exists.
     if (ast->expression->asTypeId()) {
-        const std::string& alpha = supply_.createTypeVar1();
+        const TypeTerm alpha = supply_.createTypeVar1();
         writer_->writeExists(alpha);
-        const std::string& ty = typePP_.print(ast->expression_type, scope_);
+        const TypeTerm ty = terms_.intern(typePP_.print(ast->expression_type, scope_));
         writer_->writeTypedef(ty, alpha);
     }
 
     // TODO: Make sizeof and related type as size_t.
     ENSURE_NONEMPTY_TYPE_STACK(return false);
-    writer_->writeEquivRel(types_.top(), kDefaultIntTy);
+    writer_->writeEquivRel(types_.top(), defaultIntTy_);
 
     return false;
 }
@@ -1202,7 +1566,7 @@ bool ConstraintGenerator::visit(psyche::PointerLiteralAST* ast)
     DEBUG_VISIT(PointerLiteralAST);
 
     // We don't know the underlying element type, but we know it's a pointer.
-    const std::string& alpha = supply_.createTypeVar1();
+    const TypeTerm alpha = supply_.createTypeVar1();
     writer_->writeExists(alpha);
     ENSURE_NONEMPTY_TYPE_STACK(return false);
     writer_->writePtrRel(types_.top(), alpha);
@@ -1238,20 +1602,20 @@ bool ConstraintGenerator::visit(ClassSpecifierAST* ast)
     DEBUG_VISIT(ClassSpecifierAST);
     OBSERVE(ClassSpecifierAST);
 
-    std::string classTy = typePP_.print(ast->symbol->type(), scope_);
-    std::string tyName;
+    const TypeTerm classTy = terms_.intern(typePP_.print(ast->symbol->type(), scope_));
+    TypeTerm tyName;
     if (ast->name->name->asEmptyName()) {
         tyName = classTy;
     } else {
         std::string head = "struct ";
         if (tokenKind(ast->classkey_token) == T_UNION)
             head = "union ";
-        tyName = head + extractId(ast->name->name);
+        tyName = terms_.intern(head + extractId(ast->name->name));
     }
 
     writer_->writeTypedef(tyName, classTy);
 
-    const std::string& alpha = supply_.createTypeVar1();
+    const TypeTerm alpha = supply_.createTypeVar1();
     writer_->writeExists(alpha);
     writer_->writeEquivRel(alpha, tyName);
 
@@ -1312,7 +1676,7 @@ bool ConstraintGenerator::visit(ExpressionStatementAST* ast)
 
     // Deal with assignment.
     if (ast->expression->asBinaryExpression()) {
-        const std::string& alpha = supply_.createTypeVar1();
+        const TypeTerm alpha = supply_.createTypeVar1();
         writer_->writeExists(alpha);
         collectExpression(alpha, ast->expression);
         return false;
@@ -1322,7 +1686,7 @@ bool ConstraintGenerator::visit(ExpressionStatementAST* ast)
     if (ast->expression->asUnaryExpression()
             && (tokenKind(ast->expression->asUnaryExpression()->unary_op_token)
             == T_STAR)) {
-        std::tuple<std::string, std::string> a1a2 = supply_.createTypeVar2();
+        std::tuple<TypeTerm, TypeTerm> a1a2 = supply_.createTypeVar2();
         writer_->writeExists(std::get<0>(a1a2));
         writer_->writeExists(std::get<1>(a1a2));
         collectExpression(std::get<0>(a1a2), ast->expression->asUnaryExpression()->expression);
@@ -1330,7 +1694,7 @@ bool ConstraintGenerator::visit(ExpressionStatementAST* ast)
         return false;
     }
 
-    const std::string& alpha = supply_.createTypeVar1();
+    const TypeTerm alpha = supply_.createTypeVar1();
     writer_->writeExists(alpha);
     collectExpression(alpha, ast->expression);
 
@@ -1342,11 +1706,7 @@ bool ConstraintGenerator::visit(ExpressionStatementAST* ast)
             && ast->expression->asCall()->base_expression->asIdExpression()) {
         const std::string& funcName =
                 trivialName(ast->expression->asCall()->base_expression->asIdExpression());
-        const auto it = knownFuncNames_.find(funcName);
-        if (it != knownFuncNames_.end())
-            writer_->writeEquivRel(alpha, it->second);
-        else
-            knownFuncRets_[funcName].push_back(alpha);
+        discardCall(funcName, alpha);
     }
 
     return false;
@@ -1387,10 +1747,10 @@ bool ConstraintGenerator::visit(EnumeratorAST* ast)
     OBSERVE(EnumeratorAST);
 
     const Identifier* ident = identifier(ast->identifier_token);
-    writer_->writeVarDecl(ident->chars(), kIntTy);
+    writer_->writeVarDecl(ident->chars(), intTy_);
 
     if (ast->expression) {
-        collectExpression(kIntTy, ast->expression);
+        collectExpression(intTy_, ast->expression);
 
         // TODO: Extend...
         if (ast->expression->asIdExpression())
@@ -1416,7 +1776,7 @@ bool ConstraintGenerator::visit(CaseStatementAST* ast)
     DEBUG_VISIT(CaseStatementAST);
     OBSERVE(CaseStatementAST);
 
-    collectExpression(kDefaultIntTy, ast->expression);
+    collectExpression(defaultIntTy_, ast->expression);
 
     // TODO: Extend...
     if (ast->expression->asIdExpression())
@@ -1465,7 +1825,7 @@ bool ConstraintGenerator::visit(ForStatementAST* ast)
     treatAsBool(ast->condition);
 
     if (ast->expression) {
-        const std::string& alpha = supply_.createTypeVar1();
+        const TypeTerm alpha = supply_.createTypeVar1();
         writer_->writeExists(alpha);
         collectExpression(alpha, ast->expression);
     }
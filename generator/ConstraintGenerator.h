@@ -22,16 +22,23 @@
 #include "ASTVisitor.h"
 #include "FreshVarSupply.h"
 #include "FullySpecifiedType.h"
+#include "TypeTerm.h"
 #include "ConstraintSyntax.h"
 #include "DomainLattice.h"
 #include "TypePP.h"
+#include <cstdint>
+#include <functional>
+#include <mutex>
 #include <stack>
 #include <string>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 namespace psyche {
 
+class ConstraintCache;
+class ConstraintChunk;
 class ConstraintWriter;
 class DeclarationInterceptor;
 class VisitorObserver;
@@ -67,7 +74,42 @@ public:
      */
     void addPrintfLike(const std::string& funcName, size_t varArgPos);
 
+    /*!
+     * \brief employThreads
+     * \param jobs
+     *
+     * Generate the constraints of each function definition (along with the
+     * declarations preceding it) on one of the given number of threads. The
+     * results are merged in source order, so the constraints are the same as
+     * those of a sequential generation. Not employed with an observer or an
+     * interceptor installed.
+     */
+    void employThreads(unsigned jobs);
+
+    /*!
+     * \brief employCache
+     * \param cache
+     *
+     * Generate the constraints of each top-level declaration apart, so those of
+     * a declaration whose content is unchanged since the cached run are reused
+     * rather than regenerated. A declaration's content comprises the one of the
+     * declarations it refers to (directly or not) and its domains. Not employed
+     * with an observer or an interceptor installed.
+     */
+    void employCache(ConstraintCache* cache);
+
 private:
+    using DeclarationRange = std::pair<psyche::DeclarationListAST*, psyche::DeclarationListAST*>;
+
+    void generateInChunks(psyche::TranslationUnitAST* ast);
+
+    /*!
+     * \brief fingerprint
+     *
+     * Return the key, in the cache, of each range of top-level declarations.
+     */
+    std::vector<std::uint64_t> fingerprint(const std::vector<DeclarationRange>& ranges) const;
+
     /*!
      * \brief switchScope
      * \param scope
@@ -94,6 +136,7 @@ private:
     bool visit(psyche::ConditionalExpressionAST* ast) override;
     bool visit(psyche::IdExpressionAST* ast) override;
     bool visit(psyche::MemberAccessAST* ast) override;
+    bool visit(psyche::NestedExpressionAST* ast) override;
     bool visit(psyche::UnaryExpressionAST* ast) override;
     bool visit(psyche::NumericLiteralAST* ast) override;
     bool visit(psyche::BoolLiteralAST* ast) override;
@@ -128,6 +171,17 @@ private:
     // Symbol visits.
     void visitSymbol(psyche::Function* func, psyche::StatementAST* body);
 
+    //!@{
+    /*!
+     * Keep track of the return types of functions: when a function becomes
+     * known, and when the value of a call is discarded.
+     *
+     * \sa knownFuncNames_, knownFuncRets_
+     */
+    void knowFunction(const std::string& funcName, TypeTerm funcRet);
+    void discardCall(const std::string& funcName, TypeTerm callTy);
+    //!@}
+
     //! Scope we're in and the global scope.
     psyche::Scope *scope_;
     psyche::Scope *global_;
@@ -135,6 +189,22 @@ private:
     //! Writer we use to generate the constraints.
     ConstraintWriter *writer_;
 
+    //! Pool of the writer, in which type names are interned.
+    TypeTermPool& terms_;
+
+    //!@{
+    /*!
+     * Builtin type names, interned upfront.
+     */
+    const TypeTerm intTy_;
+    const TypeTerm scalarTy_;
+    const TypeTerm sizeTy_;
+    const TypeTerm defaultIntTy_;
+    const TypeTerm defaultArithTy_;
+    const TypeTerm defaultFloatPointTy_;
+    const TypeTerm defaultStrTy_;
+    //!@}
+
     //! Type name speller.
     TypePP<ConstraintSyntax> typePP_;
 
@@ -152,9 +222,23 @@ private:
      * Domain lattice analysis.
      */
     void employLattice(const DomainLattice::Domain &lhsDom, const DomainLattice::Domain &rhsDom,
-                       const std::string &lhsTy, const std::string &rhsTy,
+                       TypeTerm lhsTy, TypeTerm rhsTy,
                        int op);
     DomainLattice::Domain domainOf(psyche::ExpressionAST* ast) const;
+    DomainLattice::Domain domainOf(const psyche::Symbol* sym) const;
+    //!@}
+
+    //!@{
+    /*!
+     * Generation in chunks: the number of threads, the cache, the chunk into
+     * which a worker generates, and the lock for the frontend (whose types are
+     * interned on demand) and the lattice.
+     */
+    unsigned jobs_;
+    ConstraintCache* cache_;
+    ConstraintChunk* chunk_;
+    std::mutex* lock_;
+    std::unique_lock<std::mutex> lockFrontend() const;
     //!@}
 
     //!@{
@@ -165,9 +249,9 @@ private:
      *
      * \sa pushType, popType
      */
-    std::stack<std::string> types_;
-    void pushType(const std::string& ty);
-    std::string popType();
+    std::stack<TypeTerm> types_;
+    void pushType(TypeTerm ty);
+    TypeTerm popType();
     //!@}
 
     /*!
@@ -191,7 +275,7 @@ private:
     void assignTop(const std::string& name);
 
     // Helpers
-    void castExpressionHelper(const std::string &inputTy, std::string& resultTy);
+    void castExpressionHelper(TypeTerm inputTy, TypeTerm resultTy);
 
     /*!
      * Convert boolean expressions to int.
@@ -202,7 +286,27 @@ private:
      * Encapsulates the steps to enter a new expression rule and generate its
      * corresponding constraints.
      */
-    void collectExpression(const std::string& ty, psyche::ExpressionAST* expr);
+    void collectExpression(TypeTerm ty, psyche::ExpressionAST* expr);
+
+    //!@{
+    /*!
+     * Expression rules don't recurse into their operands: the operands, and whatever
+     * follows them in the rule, are deferred as tasks. Tasks run in the order they
+     * are deferred, but after the tasks deferred by those tasks, which yields the
+     * same constraints of a recursive traversal without exhausting the native stack
+     * on deep expressions. A task deferred while no tasks are being performed runs
+     * right away.
+     *
+     * \sa collectExpression, visitExpression
+     */
+    std::vector<std::function<void ()>> tasks_;
+    std::vector<std::function<void ()>> deferred_;
+    bool performing_;
+    void perform(std::function<void ()> task);
+    void defer(std::function<void ()> task);
+    void deferExpression(TypeTerm ty, psyche::ExpressionAST* expr);
+    void deferVisit(psyche::ExpressionAST* ast);
+    //!@}
 
     /*!
      * \brief ensureTypeIsKnown
@@ -213,7 +317,7 @@ private:
      * particular, for the return type of a function, for a cast expression, and
      * for a declaration.
      */
-    std::string ensureTypeIsKnown(std::string& tyName);
+    TypeTerm ensureTypeIsKnown(TypeTerm tyName);
 
     //!@{
     /*!
@@ -223,11 +327,11 @@ private:
      * problem for the parameters but because return values may be discarded
      * (i.e. expression statement) we keep track of the ones we know.
      */
-    std::unordered_map<std::string, std::string> knownFuncNames_;
-    std::unordered_map<std::string, std::vector<std::string>> knownFuncRets_;
+    std::unordered_map<std::string, TypeTerm> knownFuncNames_;
+    std::unordered_map<std::string, std::vector<TypeTerm>> knownFuncRets_;
     //!@}
 
-    std::stack<std::string> structs_;
+    std::stack<TypeTerm> structs_;
     std::vector<std::string> field_;
 
     /*!
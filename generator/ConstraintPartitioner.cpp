@@ -0,0 +1,547 @@
+/******************************************************************************
+ * Copyright (c) 2016 Leandro T. C. Melo (ltcmelo@gmail.com)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ * USA
+ *****************************************************************************/
+
+#include "ConstraintPartitioner.h"
+#include "BuiltinNames.h"
+#include <algorithm>
+#include <cctype>
+#include <iterator>
+
+using namespace psyche;
+
+namespace {
+
+// Type names made only of these don't relate constraints: C's own, and the
+// ones reserved by the solver.
+const char* const kBuiltinWords[] = {
+    "void", "char", "short", "int", "long", "float", "double", "signed",
+    "unsigned", "_Bool", "_Complex", "const", "volatile", "restrict",
+    kScalarTy
+};
+
+bool isBuiltinWord(const std::string& word)
+{
+    for (const auto builtin : kBuiltinWords) {
+        if (word == builtin)
+            return true;
+    }
+    return false;
+}
+
+bool isTag(const std::string& word)
+{
+    return word == "struct" || word == "union" || word == "enum";
+}
+
+const char kVarKey = 'v';
+const char kTypeKey = 't';
+const char kSymKey = 's';
+
+std::string key(char kind, const std::string& s)
+{
+    std::string k(1, kind);
+    k += s;
+    return k;
+}
+
+} // anonymous
+
+ConstraintPartitioner::ConstraintPartitioner(ConstraintWriter* writer)
+    : ConstraintRecorder(writer)
+{}
+
+ConstraintPartitioner::~ConstraintPartitioner()
+{}
+
+bool ConstraintPartitioner::isSymbolKey(const std::string& key)
+{
+    return key[0] == kSymKey;
+}
+
+bool ConstraintPartitioner::isTypeNameKey(const std::string& key)
+{
+    return key[0] == kTypeKey;
+}
+
+std::string ConstraintPartitioner::symbolKey(const std::string& sym)
+{
+    return key(kSymKey, sym);
+}
+
+const std::vector<std::string>& ConstraintPartitioner::nameKeys(TypeTerm ty)
+{
+    auto it = nameKeys_.find(ty.index());
+    if (it != nameKeys_.end())
+        return it->second;
+
+    std::vector<std::string> keys;
+    const std::string& name = terms().nameOf(ty);
+    std::string tag;
+    for (auto i = 0u; i < name.size();) {
+        const auto c = static_cast<unsigned char>(name[i]);
+        if (!std::isalpha(c) && c != '_') {
+            ++i;
+            continue;
+        }
+        auto j = i + 1;
+        while (j < name.size()
+                && (std::isalnum(static_cast<unsigned char>(name[j])) || name[j] == '_')) {
+            ++j;
+        }
+        std::string word = name.substr(i, j - i);
+        i = j;
+
+        if (isTag(word)) {
+            tag = word + ' ';
+            continue;
+        }
+        if (!tag.empty()) {
+            keys.push_back(key(kTypeKey, tag + word));
+            tag.clear();
+        } else if (!isBuiltinWord(word)) {
+            keys.push_back(key(kTypeKey, word));
+        }
+    }
+
+    return nameKeys_.emplace(ty.index(), std::move(keys)).first->second;
+}
+
+void ConstraintPartitioner::collectKeys(TypeTerm ty, std::vector<std::string>& keys)
+{
+    if (ty.isVar()) {
+        keys.push_back(key(kVarKey, std::to_string(ty.index())));
+    } else if (ty.isName()) {
+        const auto& names = nameKeys(ty);
+        keys.insert(keys.end(), names.begin(), names.end());
+    } else {
+        collectKeys(terms().seqOf(ty).first, keys);
+        collectKeys(terms().seqOf(ty).second, keys);
+    }
+}
+
+void ConstraintPartitioner::collectKeys(const Item& item, std::vector<std::string>& keys)
+{
+    // Symbols declared within nested scopes are not free.
+    std::vector<std::unordered_set<std::string>> scopes(1);
+    auto isFree = [&scopes] (const std::string& sym) {
+        for (auto i = 1u; i < scopes.size(); ++i) {
+            if (scopes[i].count(sym))
+                return false;
+        }
+        return true;
+    };
+
+    for (auto pos = item.begin_; pos < item.end_; ++pos) {
+        const Entry& e = entries_[pos];
+        collectKeys(e.ty1_, keys);
+        collectKeys(e.ty2_, keys);
+        if (e.op_ == Op::FuncDecl || e.op_ == Op::TypesSection) {
+            for (const auto ty : lists_[e.list_])
+                collectKeys(ty, keys);
+        }
+
+        switch (e.op_) {
+        case Op::OpenScope:
+            scopes.emplace_back();
+            break;
+
+        case Op::CloseScope:
+            if (scopes.size() > 1)
+                scopes.pop_back();
+            break;
+
+        case Op::VarDecl:
+        case Op::FuncDecl:
+            if (scopes.size() == 1)
+                keys.push_back(key(kSymKey, strings_[e.aux_]));
+            else
+                scopes.back().insert(strings_[e.aux_]);
+            break;
+
+        case Op::Typeof:
+        case Op::Static:
+        case Op::ConstantExpression:
+            if (isFree(strings_[e.aux_]))
+                keys.push_back(key(kSymKey, strings_[e.aux_]));
+            break;
+
+        default:
+            break;
+        }
+    }
+}
+
+bool ConstraintPartitioner::isKnown(TypeTerm ty, const std::unordered_set<std::uint32_t>& known)
+{
+    if (ty.isVar())
+        return known.count(ty.index()) != 0;
+    if (ty.isName())
+        return nameKeys(ty).empty();
+    return isKnown(terms().seqOf(ty).first, known) && isKnown(terms().seqOf(ty).second, known);
+}
+
+std::uint32_t ConstraintPartitioner::declarationEnd(const Item& item) const
+{
+    auto pos = item.head_ + 1;
+    while (pos < item.end_ && entries_[pos].op_ == Op::Static)
+        ++pos;
+    return pos;
+}
+
+bool ConstraintPartitioner::isShared(const Item& item)
+{
+    // A declaration, with its prologue and storage.
+    const Entry& e = entries_[item.head_];
+    if (e.op_ != Op::VarDecl && e.op_ != Op::FuncDecl && e.op_ != Op::Typedef)
+        return false;
+    if (declarationEnd(item) != item.end_)
+        return false;
+
+    // For a typedef, only the type being defined may be a non-builtin.
+    if (e.op_ == Op::Typedef) {
+        if (item.begin_ != item.head_)
+            return false;
+        std::vector<std::string> keys;
+        collectKeys(e.ty2_, keys);
+        if (!keys.empty())
+            return false;
+        collectKeys(e.ty1_, keys);
+        return std::none_of(keys.begin(), keys.end(),
+                            [] (const std::string& k) { return k[0] == kVarKey; });
+    }
+
+    // The declared type must be fully known; a type variable is known once the
+    // prologue binds it to a known type.
+    std::unordered_set<std::uint32_t> known;
+    for (bool grew = true; grew;) {
+        grew = false;
+        for (auto pos = item.begin_; pos < item.head_; ++pos) {
+            const Entry& b = entries_[pos];
+            if (b.op_ != Op::Typedef && b.op_ != Op::EquivRel)
+                continue;
+            if (b.ty2_.isVar() && !known.count(b.ty2_.index()) && isKnown(b.ty1_, known))
+                grew |= known.insert(b.ty2_.index()).second;
+            if (b.ty1_.isVar() && !known.count(b.ty1_.index()) && isKnown(b.ty2_, known))
+                grew |= known.insert(b.ty1_.index()).second;
+        }
+    }
+
+    for (auto pos = item.begin_; pos < item.end_; ++pos) {
+        const Entry& b = entries_[pos];
+        switch (b.op_) {
+        case Op::Exists:
+        case Op::Typedef:
+        case Op::EquivRel:
+        case Op::SubtypeRel:
+        case Op::VarDecl:
+        case Op::Static:
+            break;
+
+        case Op::FuncDecl:
+            for (const auto ty : lists_[b.list_]) {
+                if (!isKnown(ty, known))
+                    return false;
+            }
+            break;
+
+        default:
+            return false;
+        }
+        if (!isKnown(b.ty1_, known) || !isKnown(b.ty2_, known))
+            return false;
+    }
+    return true;
+}
+
+void ConstraintPartitioner::split()
+{
+    items_.clear();
+    auto extend = [this] (std::uint32_t pos) {
+        if (items_.empty())
+            items_.push_back(Item{ pos, pos + 1, pos, false });
+        else
+            items_.back().end_ = pos + 1;
+    };
+
+    int depth = 0;
+    for (auto pos = 0u; pos < entries_.size(); ++pos) {
+        const Op op = entries_[pos].op_;
+        if (depth) {
+            extend(pos);
+            if (op == Op::OpenScope)
+                ++depth;
+            else if (op == Op::CloseScope)
+                --depth;
+            continue;
+        }
+
+        switch (op) {
+        case Op::OpenScope:
+            // The scope is the body of the preceding declaration.
+            extend(pos);
+            ++depth;
+            break;
+
+        case Op::Block:
+        case Op::CloseScope:
+        case Op::Static:
+        case Op::Typeof:
+        case Op::TypeSection:
+        case Op::TypesSection:
+        case Op::EquivMark:
+        case Op::SubtypeMark:
+        case Op::EnterGroup:
+        case Op::LeaveGroup:
+        case Op::EndSection:
+            extend(pos);
+            break;
+
+        default:
+            items_.push_back(Item{ pos, pos + 1, pos, false });
+            break;
+        }
+    }
+}
+
+void ConstraintPartitioner::attachPrologues()
+{
+    // The existentials that introduce the type variables of a declaration, and
+    // the typedefs and relations that bind them, are a prologue to it.
+    std::vector<Item> items;
+    items.reserve(items_.size());
+    bool prologue = false;
+    for (const Item& item : items_) {
+        const Entry& e = entries_[item.begin_];
+        const bool binder = e.op_ == Op::Exists
+                || (prologue && ((e.op_ == Op::Typedef && e.ty2_.isVar())
+                                 || e.op_ == Op::EquivRel
+                                 || e.op_ == Op::SubtypeRel
+                                 || e.op_ == Op::PtrRel));
+        const bool decl = e.op_ == Op::VarDecl || e.op_ == Op::FuncDecl;
+        if (prologue && (binder || decl)) {
+            items.back().end_ = item.end_;
+            if (decl)
+                items.back().head_ = item.head_;
+        } else {
+            items.push_back(item);
+        }
+        prologue = binder;
+    }
+    items_ = std::move(items);
+}
+
+std::uint32_t ConstraintPartitioner::find(std::uint32_t item)
+{
+    while (parent_[item] != item) {
+        parent_[item] = parent_[parent_[item]];
+        item = parent_[item];
+    }
+    return item;
+}
+
+void ConstraintPartitioner::unite(std::uint32_t item1, std::uint32_t item2)
+{
+    item1 = find(item1);
+    item2 = find(item2);
+    if (item1 == item2)
+        return;
+
+    // The component is identified by its first item.
+    if (item2 < item1)
+        std::swap(item1, item2);
+    parent_[item2] = item1;
+}
+
+void ConstraintPartitioner::partition()
+{
+    split();
+    attachPrologues();
+    const auto cnt = static_cast<std::uint32_t>(items_.size());
+    parent_.resize(cnt);
+    for (auto i = 0u; i < cnt; ++i)
+        parent_[i] = i;
+
+    keys_.assign(cnt, std::vector<std::string>());
+    components_.clear();
+    unreferenced_.clear();
+    declaredSymbols_.clear();
+    definedTypeNames_.clear();
+
+    std::unordered_map<std::string, std::vector<std::uint32_t>> provided;
+    std::unordered_map<std::string, std::vector<std::uint32_t>> declarers;
+    for (auto i = 0u; i < cnt; ++i) {
+        Item& item = items_[i];
+        item.shared_ = isShared(item);
+        if (item.shared_) {
+            std::vector<std::string> provides;
+            collectKeys(item, provides);
+            for (const auto& k : provides)
+                provided[k].push_back(i);
+        } else {
+            collectKeys(item, keys_[i]);
+        }
+
+        const Entry& e = entries_[item.head_];
+        if (e.op_ == Op::VarDecl || e.op_ == Op::FuncDecl) {
+            const auto sym = key(kSymKey, strings_[e.aux_]);
+            declaredSymbols_.insert(sym);
+            if (!item.shared_)
+                declarers[sym].push_back(i);
+        } else if (e.op_ == Op::Typedef && !e.ty2_.isVar()) {
+            std::vector<std::string> names;
+            collectKeys(e.ty1_, names);
+            definedTypeNames_.insert(names.begin(), names.end());
+        }
+    }
+
+    // A declared symbol relates only the items declaring it. An item that
+    // refers to one gets, instead, the declaration along with what it, in turn,
+    // refers to (but for its own type variables).
+    std::unordered_map<std::uint32_t, std::vector<std::string>> declKeys;
+    for (const auto& d : declarers) {
+        for (const auto j : d.second) {
+            const Item& item = items_[j];
+            std::vector<std::string> keys;
+            collectKeys(Item{ item.begin_, declarationEnd(item), item.head_, false }, keys);
+            auto& own = declKeys[j];
+            std::copy_if(keys.begin(), keys.end(), std::back_inserter(own),
+                         [&d] (const std::string& k) { return k[0] != kVarKey && k != d.first; });
+        }
+    }
+
+    std::vector<std::vector<std::uint32_t>> declarationsOf(cnt);
+    for (auto i = 0u; i < cnt; ++i) {
+        if (items_[i].shared_)
+            continue;
+        std::vector<std::string> keys;
+        std::vector<std::string> pending = keys_[i];
+        std::unordered_set<std::string> seen(pending.begin(), pending.end());
+        while (!pending.empty()) {
+            const auto k = std::move(pending.back());
+            pending.pop_back();
+            auto d = declarers.find(k);
+            if (provided.count(k)
+                    || d == declarers.end()
+                    || std::find(d->second.begin(), d->second.end(), i) != d->second.end()) {
+                keys.push_back(k);
+                continue;
+            }
+            for (const auto j : d->second) {
+                declarationsOf[i].push_back(j);
+                for (const auto& dk : declKeys[j]) {
+                    if (seen.insert(dk).second)
+                        pending.push_back(dk);
+                }
+            }
+        }
+        keys_[i] = std::move(keys);
+    }
+
+    // Keys provided by shared declarations don't relate the items using them.
+    std::unordered_map<std::string, std::uint32_t> owners;
+    for (auto i = 0u; i < cnt; ++i) {
+        for (const auto& k : keys_[i]) {
+            if (provided.count(k))
+                continue;
+            auto it = owners.emplace(k, i).first;
+            unite(it->second, i);
+        }
+    }
+
+    // Components are numbered in the order of their first item; each one gets
+    // the shared declarations it refers to.
+    std::unordered_map<std::uint32_t, std::uint32_t> componentOf;
+    std::vector<std::unordered_set<std::uint32_t>> sharedOf;
+    std::vector<std::unordered_set<std::uint32_t>> declarationsOfComponent;
+    for (auto i = 0u; i < cnt; ++i) {
+        if (items_[i].shared_)
+            continue;
+        const auto root = find(i);
+        auto it = componentOf.find(root);
+        if (it == componentOf.end()) {
+            it = componentOf.emplace(root, static_cast<std::uint32_t>(components_.size())).first;
+            components_.emplace_back();
+            sharedOf.emplace_back();
+            declarationsOfComponent.emplace_back();
+        }
+        for (const auto& k : keys_[i]) {
+            auto p = provided.find(k);
+            if (p != provided.end())
+                sharedOf[it->second].insert(p->second.begin(), p->second.end());
+        }
+        for (const auto j : declarationsOf[i]) {
+            if (find(j) != root)
+                declarationsOfComponent[it->second].insert(j);
+        }
+
+        Component& component = components_[it->second];
+        component.items_.push_back(i);
+        const Entry& e = entries_[items_[i].head_];
+        if (e.op_ == Op::VarDecl || e.op_ == Op::FuncDecl)
+            component.symbols_.push_back(strings_[e.aux_]);
+    }
+
+    std::vector<bool> referenced(cnt, false);
+    for (auto c = 0u; c < components_.size(); ++c) {
+        auto& shared = components_[c].shared_;
+        shared.assign(sharedOf[c].begin(), sharedOf[c].end());
+        std::sort(shared.begin(), shared.end());
+        for (const auto i : shared)
+            referenced[i] = true;
+
+        auto& declarations = components_[c].declarations_;
+        declarations.assign(declarationsOfComponent[c].begin(), declarationsOfComponent[c].end());
+        std::sort(declarations.begin(), declarations.end());
+    }
+    for (auto i = 0u; i < cnt; ++i) {
+        if (items_[i].shared_ && !referenced[i])
+            unreferenced_.push_back(i);
+    }
+}
+
+void ConstraintPartitioner::writeItems(const std::vector<std::uint32_t>& items,
+                                       ConstraintWriter* writer)
+{
+    for (const auto i : items) {
+        for (auto pos = items_[i].begin_; pos < items_[i].end_; ++pos)
+            replay(entries_[pos], writer);
+    }
+}
+
+void ConstraintPartitioner::writeItems(const std::vector<std::uint32_t>& items,
+                                       const std::vector<std::uint32_t>& declarations,
+                                       ConstraintWriter* writer)
+{
+    auto writeRange = [this, writer] (std::uint32_t begin, std::uint32_t end) {
+        for (auto pos = begin; pos < end; ++pos)
+            replay(entries_[pos], writer);
+    };
+
+    // An item that is in both is written whole.
+    auto d = declarations.begin();
+    for (const auto i : items) {
+        for (; d != declarations.end() && *d <= i; ++d) {
+            if (*d != i)
+                writeRange(items_[*d].begin_, declarationEnd(items_[*d]));
+        }
+        writeRange(items_[i].begin_, items_[i].end_);
+    }
+    for (; d != declarations.end(); ++d)
+        writeRange(items_[*d].begin_, declarationEnd(items_[*d]));
+}
@@ -0,0 +1,135 @@
+/******************************************************************************
+ * Copyright (c) 2016 Leandro T. C. Melo (ltcmelo@gmail.com)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ * USA
+ *****************************************************************************/
+
+#ifndef PSYCHE_CONSTRAINTPARTITIONER_H__
+#define PSYCHE_CONSTRAINTPARTITIONER_H__
+
+#include "ConstraintRecorder.h"
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace psyche {
+
+/*!
+ * \brief The ConstraintPartitioner class
+ *
+ * Base of the writers that partition the recorded constraints into independent
+ * components. The top-level constraints (e.g., a function with its body) are
+ * grouped, through a union-find, whenever they share a type variable, a
+ * (non-builtin) type name, or an undeclared symbol. Declarations of fully known
+ * types are not grouped, but belong to every component that refers to them; of
+ * the other declarations, a component that refers to one gets only the
+ * declaration itself (without a body), and is grouped with what it refers to.
+ */
+class ConstraintPartitioner : public ConstraintRecorder
+{
+public:
+    ~ConstraintPartitioner() override;
+
+protected:
+    ConstraintPartitioner(ConstraintWriter* writer);
+
+    //! Top-level constraint, as a range of entries.
+    struct Item
+    {
+        std::uint32_t begin_;
+        std::uint32_t end_;
+        std::uint32_t head_; //!< The first entry or, after a prologue, the declaration.
+        bool shared_;
+    };
+
+    struct Component
+    {
+        std::vector<std::uint32_t> items_;
+        std::vector<std::uint32_t> shared_; //!< Shared declarations referred to.
+        std::vector<std::uint32_t> declarations_; //!< Items of other components whose declarations are referred to.
+        std::vector<std::string> symbols_; //!< Symbols declared at the top level.
+    };
+
+    /*!
+     * \brief partition
+     *
+     * Partition the recorded constraints into components, numbered in the order
+     * of their first item. A declaration's item includes its prologue: the
+     * existentials and typedefs that bind the types of the declaration.
+     */
+    void partition();
+
+    //! Split the recorded constraints into top-level items.
+    void split();
+
+    //! Write the given items, in order, through the writer.
+    void writeItems(const std::vector<std::uint32_t>& items, ConstraintWriter* writer);
+
+    /*!
+     * \brief writeItems
+     *
+     * Write the given items and, of the given declarations, only the declaration
+     * part, in the original order, through the writer. Both must be sorted.
+     */
+    void writeItems(const std::vector<std::uint32_t>& items,
+                    const std::vector<std::uint32_t>& declarations,
+                    ConstraintWriter* writer);
+
+    //!@{
+    /*!
+     * Keys through which items are related: type variables, type names, and symbols.
+     */
+    void collectKeys(const Item& item, std::vector<std::string>& keys);
+    void collectKeys(TypeTerm ty, std::vector<std::string>& keys);
+    static bool isSymbolKey(const std::string& key);
+    static bool isTypeNameKey(const std::string& key);
+    static std::string symbolKey(const std::string& sym);
+    //!@}
+
+    std::vector<Item> items_;
+
+    //! Keys relating each item, with the declared symbols it refers to resolved.
+    std::vector<std::vector<std::string>> keys_;
+    std::vector<Component> components_;
+
+    //! Shared declarations referred to by no component.
+    std::vector<std::uint32_t> unreferenced_;
+
+    //! Symbols declared at the top level.
+    std::unordered_set<std::string> declaredSymbols_;
+
+    //! Type names defined by a typedef.
+    std::unordered_set<std::string> definedTypeNames_;
+
+private:
+    void attachPrologues();
+    bool isShared(const Item& item);
+    bool isKnown(TypeTerm ty, const std::unordered_set<std::uint32_t>& known);
+    std::uint32_t declarationEnd(const Item& item) const;
+    const std::vector<std::string>& nameKeys(TypeTerm ty);
+
+    std::uint32_t find(std::uint32_t item);
+    void unite(std::uint32_t item1, std::uint32_t item2);
+
+    std::unordered_map<std::uint32_t, std::vector<std::string>> nameKeys_;
+    std::vector<std::uint32_t> parent_;
+};
+
+} // namespace psyche
+
+#endif
@@ -0,0 +1,301 @@
+/******************************************************************************
+ * Copyright (c) 2016 Leandro T. C. Melo (ltcmelo@gmail.com)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ * USA
+ *****************************************************************************/
+
+#include "ConstraintRecorder.h"
+
+using namespace psyche;
+
+ConstraintRecorder::ConstraintRecorder(ConstraintWriter* writer)
+    : writer_(writer)
+{}
+
+ConstraintRecorder::~ConstraintRecorder()
+{}
+
+void ConstraintRecorder::record(Op op, TypeTerm ty1, TypeTerm ty2,
+                                  std::uint32_t aux, std::uint32_t list)
+{
+    entries_.push_back(Entry{ op, ty1, ty2, aux, list });
+}
+
+std::uint32_t ConstraintRecorder::keep(const std::string& s)
+{
+    strings_.push_back(s);
+    return static_cast<std::uint32_t>(strings_.size() - 1);
+}
+
+void ConstraintRecorder::count()
+{
+    if (!blocked_)
+        ++cnt_;
+}
+
+TypeTermPool& ConstraintRecorder::terms()
+{
+    return writer_->terms();
+}
+
+bool ConstraintRecorder::block(bool b)
+{
+    record(Op::Block, TypeTerm(), TypeTerm(), b);
+    return ConstraintWriter::block(b);
+}
+
+void ConstraintRecorder::writeText(const std::string& text)
+{
+    record(Op::Text, TypeTerm(), TypeTerm(), keep(text));
+}
+
+void ConstraintRecorder::writeTypedef(TypeTerm ty1, TypeTerm ty2)
+{
+    record(Op::Typedef, ty1, ty2);
+    count();
+}
+
+void ConstraintRecorder::writeVarDecl(const std::string& name, TypeTerm type)
+{
+    record(Op::VarDecl, type, TypeTerm(), keep(name));
+    count();
+}
+
+void ConstraintRecorder::writeFuncDecl(const std::string& name,
+                                         const std::vector<TypeTerm>& params,
+                                         TypeTerm ret)
+{
+    lists_.push_back(params);
+    record(Op::FuncDecl, ret, TypeTerm(), keep(name), static_cast<std::uint32_t>(lists_.size() - 1));
+    count();
+}
+
+void ConstraintRecorder::writeTypeof(const std::string& sym)
+{
+    record(Op::Typeof, TypeTerm(), TypeTerm(), keep(sym));
+    count();
+}
+
+void ConstraintRecorder::writeExists(TypeTerm ty)
+{
+    record(Op::Exists, ty);
+    count();
+}
+
+void ConstraintRecorder::writeTypeSection(TypeTerm ty)
+{
+    record(Op::TypeSection, ty);
+}
+
+void ConstraintRecorder::writeTypesSection(const std::vector<TypeTerm>& tys)
+{
+    lists_.push_back(tys);
+    record(Op::TypesSection, TypeTerm(), TypeTerm(), 0, static_cast<std::uint32_t>(lists_.size() - 1));
+    count();
+}
+
+void ConstraintRecorder::writeConstantExpression(const std::string& val)
+{
+    record(Op::ConstantExpression, TypeTerm(), TypeTerm(), keep(val));
+    count();
+}
+
+void ConstraintRecorder::writeStatic(const std::string& val)
+{
+    record(Op::Static, TypeTerm(), TypeTerm(), keep(val));
+    count();
+}
+
+void ConstraintRecorder::writeMemberRel(TypeTerm baseTy, const std::string& sym, TypeTerm symTy)
+{
+    record(Op::MemberRel, baseTy, symTy, keep(sym));
+    count();
+}
+
+void ConstraintRecorder::writePtrRel(TypeTerm ty1, TypeTerm ty2)
+{
+    record(Op::PtrRel, ty1, ty2);
+    count();
+}
+
+void ConstraintRecorder::writeEquivRel(TypeTerm ty1, TypeTerm ty2)
+{
+    record(Op::EquivRel, ty1, ty2);
+    count();
+}
+
+void ConstraintRecorder::writeSubtypeRel(TypeTerm ty, TypeTerm subTy)
+{
+    record(Op::SubtypeRel, ty, subTy);
+    count();
+}
+
+void ConstraintRecorder::writeEquivMark()
+{
+    record(Op::EquivMark);
+}
+
+void ConstraintRecorder::writeSubtypeMark()
+{
+    record(Op::SubtypeMark);
+}
+
+void ConstraintRecorder::enterGroup()
+{
+    record(Op::EnterGroup);
+}
+
+void ConstraintRecorder::leaveGroup()
+{
+    record(Op::LeaveGroup);
+}
+
+void ConstraintRecorder::openScope()
+{
+    record(Op::OpenScope);
+}
+
+void ConstraintRecorder::closeScope()
+{
+    record(Op::CloseScope);
+}
+
+void ConstraintRecorder::beginSection()
+{
+    record(Op::BeginSection);
+}
+
+void ConstraintRecorder::endSection()
+{
+    record(Op::EndSection);
+}
+
+void ConstraintRecorder::replay(const Entry& e, ConstraintWriter* writer)
+{
+    TypeTermPool& pool = writer->terms();
+    auto import = [this, &pool] (TypeTerm ty) {
+        return &pool == &terms() ? ty : pool.import(terms(), ty);
+    };
+    auto importList = [&import] (const std::vector<TypeTerm>& tys) {
+        std::vector<TypeTerm> imported;
+        imported.reserve(tys.size());
+        for (const auto ty : tys)
+            imported.push_back(import(ty));
+        return imported;
+    };
+
+    switch (e.op_) {
+    case Op::Block:
+        writer->block(e.aux_);
+        break;
+
+    case Op::Text:
+        writer->writeText(strings_[e.aux_]);
+        break;
+
+    case Op::Typedef:
+        writer->writeTypedef(import(e.ty1_), import(e.ty2_));
+        break;
+
+    case Op::VarDecl:
+        writer->writeVarDecl(strings_[e.aux_], import(e.ty1_));
+        break;
+
+    case Op::FuncDecl:
+        writer->writeFuncDecl(strings_[e.aux_], importList(lists_[e.list_]), import(e.ty1_));
+        break;
+
+    case Op::Typeof:
+        writer->writeTypeof(strings_[e.aux_]);
+        break;
+
+    case Op::Exists:
+        writer->writeExists(import(e.ty1_));
+        break;
+
+    case Op::TypeSection:
+        writer->writeTypeSection(import(e.ty1_));
+        break;
+
+    case Op::TypesSection:
+        writer->writeTypesSection(importList(lists_[e.list_]));
+        break;
+
+    case Op::ConstantExpression:
+        writer->writeConstantExpression(strings_[e.aux_]);
+        break;
+
+    case Op::Static:
+        writer->writeStatic(strings_[e.aux_]);
+        break;
+
+    case Op::MemberRel:
+        writer->writeMemberRel(import(e.ty1_), strings_[e.aux_], import(e.ty2_));
+        break;
+
+    case Op::PtrRel:
+        writer->writePtrRel(import(e.ty1_), import(e.ty2_));
+        break;
+
+    case Op::EquivRel:
+        writer->writeEquivRel(import(e.ty1_), import(e.ty2_));
+        break;
+
+    case Op::SubtypeRel:
+        writer->writeSubtypeRel(import(e.ty1_), import(e.ty2_));
+        break;
+
+    case Op::EquivMark:
+        writer->writeEquivMark();
+        break;
+
+    case Op::SubtypeMark:
+        writer->writeSubtypeMark();
+        break;
+
+    case Op::EnterGroup:
+        writer->enterGroup();
+        break;
+
+    case Op::LeaveGroup:
+        writer->leaveGroup();
+        break;
+
+    case Op::OpenScope:
+        writer->openScope();
+        break;
+
+    case Op::CloseScope:
+        writer->closeScope();
+        break;
+
+    case Op::BeginSection:
+        writer->beginSection();
+        break;
+
+    case Op::EndSection:
+        writer->endSection();
+        break;
+    }
+}
+
+void ConstraintRecorder::clear()
+{
+    cnt_ = 0;
+    entries_.clear();
+    strings_.clear();
+    lists_.clear();
+}
@@ -0,0 +1,133 @@
+/******************************************************************************
+ * Copyright (c) 2016 Leandro T. C. Melo (ltcmelo@gmail.com)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ * USA
+ *****************************************************************************/
+
+#ifndef PSYCHE_CONSTRAINTRECORDER_H__
+#define PSYCHE_CONSTRAINTRECORDER_H__
+
+#include "ConstraintWriter.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace psyche {
+
+/*!
+ * \brief The ConstraintRecorder class
+ *
+ * Base of the writers that record the constraints, to process them as a whole
+ * before writing them through another writer.
+ */
+class ConstraintRecorder : public ConstraintWriter
+{
+public:
+    ~ConstraintRecorder() override;
+
+    TypeTermPool& terms() override;
+    bool block(bool b) override;
+    void writeText(const std::string& text) override;
+    void writeTypedef(TypeTerm ty1, TypeTerm ty2) override;
+    void writeVarDecl(const std::string& name, TypeTerm type) override;
+    void writeFuncDecl(const std::string& name,
+                       const std::vector<TypeTerm>& params,
+                       TypeTerm ret) override;
+    void writeTypeof(const std::string& sym) override;
+    void writeExists(TypeTerm ty) override;
+    void writeTypeSection(TypeTerm ty) override;
+    void writeTypesSection(const std::vector<TypeTerm>& tys) override;
+    void writeConstantExpression(const std::string& val) override;
+    void writeStatic(const std::string& val) override;
+    void writeMemberRel(TypeTerm baseTy, const std::string& sym, TypeTerm symTy) override;
+    void writePtrRel(TypeTerm ty1, TypeTerm ty2) override;
+    void writeEquivRel(TypeTerm ty1, TypeTerm ty2) override;
+    void writeSubtypeRel(TypeTerm ty, TypeTerm subTy) override;
+    void writeEquivMark() override;
+    void writeSubtypeMark() override;
+    void enterGroup() override;
+    void leaveGroup() override;
+    void openScope() override;
+    void closeScope() override;
+    void beginSection() override;
+    void endSection() override;
+
+protected:
+    ConstraintRecorder(ConstraintWriter* writer);
+
+    enum class Op : std::uint8_t
+    {
+        Block,
+        Text,
+        Typedef,
+        VarDecl,
+        FuncDecl,
+        Typeof,
+        Exists,
+        TypeSection,
+        TypesSection,
+        ConstantExpression,
+        Static,
+        MemberRel,
+        PtrRel,
+        EquivRel,
+        SubtypeRel,
+        EquivMark,
+        SubtypeMark,
+        EnterGroup,
+        LeaveGroup,
+        OpenScope,
+        CloseScope,
+        BeginSection,
+        EndSection
+    };
+
+    struct Entry
+    {
+        Op op_;
+        TypeTerm ty1_;
+        TypeTerm ty2_;
+        std::uint32_t aux_; //!< Flag, or index of a string.
+        std::uint32_t list_; //!< Index of a list of types.
+    };
+
+    void record(Op op, TypeTerm ty1 = TypeTerm(), TypeTerm ty2 = TypeTerm(),
+                std::uint32_t aux = 0, std::uint32_t list = 0);
+    std::uint32_t keep(const std::string& s);
+    void count();
+
+    /*!
+     * \brief replay
+     * \param e
+     * \param writer
+     *
+     * Write a recorded entry, as is, through the writer; its terms are imported
+     * into the writer's pool if it's not the one of the recorder.
+     */
+    void replay(const Entry& e, ConstraintWriter* writer);
+
+    //! Discard the recorded entries.
+    void clear();
+
+    ConstraintWriter* writer_;
+    std::vector<Entry> entries_;
+    std::vector<std::string> strings_;
+    std::vector<std::vector<TypeTerm>> lists_;
+};
+
+} // namespace psyche
+
+#endif
@@ -0,0 +1,101 @@
+/******************************************************************************
+ * Copyright (c) 2016 Leandro T. C. Melo (ltcmelo@gmail.com)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ * USA
+ *****************************************************************************/
+
+#include "ConstraintSharder.h"
+#include <algorithm>
+
+using namespace psyche;
+
+ConstraintSharder::ConstraintSharder(ConstraintWriter* writer)
+    : ConstraintPartitioner(writer)
+{}
+
+ConstraintSharder::~ConstraintSharder()
+{}
+
+void ConstraintSharder::flush()
+{
+    for (const Entry& e : entries_)
+        replay(e, writer_);
+
+    partition();
+
+    // Components that declare no symbol and unreferenced shared declarations
+    // are kept together in a last shard.
+    shards_.clear();
+    Shard rest;
+    std::vector<bool> referenced(items_.size(), false);
+    for (const Component& component : components_) {
+        if (component.symbols_.empty()) {
+            rest.items_.insert(rest.items_.end(),
+                               component.items_.begin(), component.items_.end());
+            continue;
+        }
+
+        Shard shard;
+        shard.items_ = component.items_;
+        shard.items_.insert(shard.items_.end(),
+                            component.shared_.begin(), component.shared_.end());
+        std::sort(shard.items_.begin(), shard.items_.end());
+        shard.declarations_ = component.declarations_;
+        shard.symbols_ = component.symbols_;
+        for (const auto i : component.shared_)
+            referenced[i] = true;
+        shards_.push_back(std::move(shard));
+    }
+    for (auto i = 0u; i < items_.size(); ++i) {
+        if (!items_[i].shared_)
+            continue;
+        ++stats_.sharedDecls_;
+        if (referenced[i])
+            continue;
+        rest.items_.push_back(i);
+        const Entry& e = entries_[items_[i].head_];
+        if (e.op_ != Op::Typedef)
+            rest.symbols_.push_back(strings_[e.aux_]);
+    }
+    if (!rest.items_.empty()) {
+        std::sort(rest.items_.begin(), rest.items_.end());
+        shards_.push_back(std::move(rest));
+    }
+
+    stats_.items_ += items_.size();
+    stats_.shards_ += shards_.size();
+}
+
+void ConstraintSharder::writeShard(std::size_t idx, ConstraintWriter* writer)
+{
+    const auto cnt = writer->totalConstraints();
+    writeItems(shards_[idx].items_, shards_[idx].declarations_, writer);
+    stats_.largestShard_ = std::max(stats_.largestShard_, writer->totalConstraints() - cnt);
+}
+
+const std::vector<std::string>& ConstraintSharder::shardSymbols(std::size_t idx) const
+{
+    return shards_[idx].symbols_;
+}
+
+std::ostream& psyche::operator<<(std::ostream& os, const ConstraintSharder::Stats& s)
+{
+    os << "  Top-level items    : " << s.items_ << std::endl
+       << "  Shards             : " << s.shards_ << std::endl
+       << "  Shared decls       : " << s.sharedDecls_ << std::endl
+       << "  Largest shard      : " << s.largestShard_;
+    return os;
+}
@@ -0,0 +1,93 @@
+/******************************************************************************
+ * Copyright (c) 2016 Leandro T. C. Melo (ltcmelo@gmail.com)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ * USA
+ *****************************************************************************/
+
+#ifndef PSYCHE_CONSTRAINTSHARDER_H__
+#define PSYCHE_CONSTRAINTSHARDER_H__
+
+#include "ConstraintPartitioner.h"
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace psyche {
+
+/*!
+ * \brief The ConstraintSharder class
+ *
+ * A writer that records the constraints and, when flushed, writes them through
+ * another writer and partitions them into shards that can be solved apart. Each
+ * component declaring a symbol becomes a shard, with a copy of the shared
+ * declarations, and of the other declarations, it refers to.
+ */
+class ConstraintSharder final : public ConstraintPartitioner
+{
+public:
+    ConstraintSharder(ConstraintWriter* writer);
+    ~ConstraintSharder() override;
+
+    /*!
+     * \brief flush
+     *
+     * Write the constraints recorded so far and partition them into shards. The
+     * recorded constraints are kept, for the shards to be written.
+     */
+    void flush();
+
+    std::size_t shardCount() const { return shards_.size(); }
+
+    /*!
+     * \brief writeShard
+     * \param idx
+     * \param writer
+     *
+     * Write the constraints of a shard, in their original order, through the writer.
+     */
+    void writeShard(std::size_t idx, ConstraintWriter* writer);
+
+    //! Symbols declared at the top level of a shard.
+    const std::vector<std::string>& shardSymbols(std::size_t idx) const;
+
+    struct Stats
+    {
+        std::size_t items_ { 0 };
+        std::size_t shards_ { 0 };
+        std::size_t sharedDecls_ { 0 };
+        std::size_t largestShard_ { 0 }; //!< In constraints, as in the manifest.
+    };
+
+    const Stats& stats() const { return stats_; }
+
+private:
+    struct Shard
+    {
+        std::vector<std::uint32_t> items_;
+        std::vector<std::uint32_t> declarations_; //!< Written without a body.
+        std::vector<std::string> symbols_;
+    };
+
+    std::vector<Shard> shards_;
+    Stats stats_;
+};
+
+std::ostream& operator<<(std::ostream& os, const ConstraintSharder::Stats& s);
+
+} // namespace psyche
+
+#endif
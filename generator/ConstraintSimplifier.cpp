@@ -0,0 +1,327 @@
+/******************************************************************************
+ * Copyright (c) 2016 Leandro T. C. Melo (ltcmelo@gmail.com)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ * USA
+ *****************************************************************************/
+
+#include "ConstraintSimplifier.h"
+#include <unordered_set>
+
+using namespace psyche;
+
+namespace {
+
+const std::uint32_t kUnbound = ~0u;
+
+} // anonymous
+
+ConstraintSimplifier::ConstraintSimplifier(ConstraintWriter* writer)
+    : ConstraintRecorder(writer)
+{}
+
+ConstraintSimplifier::~ConstraintSimplifier()
+{}
+
+void ConstraintSimplifier::bind(std::uint32_t var,
+                                std::uint32_t depth,
+                                std::uint32_t pos,
+                                std::uint32_t scope)
+{
+    if (var >= parent_.size()) {
+        parent_.resize(var + 1, kUnbound);
+        binders_.resize(var + 1);
+    }
+    if (parent_[var] != kUnbound)
+        return;
+    parent_[var] = var;
+    binders_[var] = Binder{ depth, pos, scope, false };
+}
+
+void ConstraintSimplifier::use(TypeTerm ty, const std::vector<bool>& openScopes)
+{
+    if (ty.isVar()) {
+        if (isBound(ty.index()) && !openScopes[binders_[ty.index()].scope_])
+            binders_[ty.index()].escapes_ = true;
+    } else if (ty.isSeq()) {
+        use(terms().seqOf(ty).first, openScopes);
+        use(terms().seqOf(ty).second, openScopes);
+    }
+}
+
+bool ConstraintSimplifier::isBound(std::uint32_t var) const
+{
+    return var < parent_.size() && parent_[var] != kUnbound;
+}
+
+std::uint32_t ConstraintSimplifier::find(std::uint32_t var)
+{
+    while (parent_[var] != var) {
+        parent_[var] = parent_[parent_[var]];
+        var = parent_[var];
+    }
+    return var;
+}
+
+void ConstraintSimplifier::unite(std::uint32_t var1, std::uint32_t var2)
+{
+    var1 = find(var1);
+    var2 = find(var2);
+    if (var1 == var2)
+        return;
+
+    // The representative must be in scope wherever any variable of the class is
+    // used. Since the variables are related, their binders are nested, and the
+    // outermost one is that of least depth and, within a scope, the first one.
+    const Binder& b1 = binders_[var1];
+    const Binder& b2 = binders_[var2];
+    if (b2.depth_ < b1.depth_ || (b2.depth_ == b1.depth_ && b2.pos_ < b1.pos_))
+        std::swap(var1, var2);
+    parent_[var2] = var1;
+}
+
+TypeTerm ConstraintSimplifier::rewrite(TypeTerm ty)
+{
+    if (ty.isVar())
+        return isBound(ty.index()) ? TypeTerm::var(find(ty.index())) : ty;
+
+    if (ty.isSeq()) {
+        const auto parts = terms().seqOf(ty);
+        const TypeTerm first = rewrite(parts.first);
+        const TypeTerm second = rewrite(parts.second);
+        if (first != parts.first || second != parts.second)
+            return terms().seq(first, second);
+    }
+
+    return ty;
+}
+
+void ConstraintSimplifier::analyze()
+{
+    std::vector<std::pair<std::uint32_t, std::uint32_t>> equivs;
+    std::vector<std::uint32_t> scopes(1, 0);
+    std::vector<bool> openScopes(1, true);
+    bool blocked = false;
+    for (auto pos = 0u; pos < entries_.size(); ++pos) {
+        const Entry& e = entries_[pos];
+        if (blocked && e.op_ != Op::Block)
+            continue;
+
+        // A variable used outside of its binder's scope (which may happen for the
+        // return of undeclared functions) isn't merged.
+        use(e.ty1_, openScopes);
+        use(e.ty2_, openScopes);
+        if (e.op_ == Op::FuncDecl || e.op_ == Op::TypesSection) {
+            for (const auto ty : lists_[e.list_])
+                use(ty, openScopes);
+        }
+
+        switch (e.op_) {
+        case Op::Block:
+            blocked = e.aux_;
+            break;
+
+        case Op::OpenScope:
+            scopes.push_back(static_cast<std::uint32_t>(openScopes.size()));
+            openScopes.push_back(true);
+            break;
+
+        case Op::CloseScope:
+            if (scopes.size() > 1) {
+                openScopes[scopes.back()] = false;
+                scopes.pop_back();
+            }
+            break;
+
+        case Op::Exists:
+            if (e.ty1_.isVar())
+                bind(e.ty1_.index(), scopes.size() - 1, pos, scopes.back());
+            break;
+
+        case Op::EquivRel:
+            if (e.ty1_.isVar()
+                    && e.ty2_.isVar()
+                    && isBound(e.ty1_.index())
+                    && isBound(e.ty2_.index())) {
+                equivs.emplace_back(e.ty1_.index(), e.ty2_.index());
+            }
+            break;
+
+        default:
+            break;
+        }
+    }
+
+    for (const auto& equiv : equivs) {
+        if (!binders_[equiv.first].escapes_ && !binders_[equiv.second].escapes_)
+            unite(equiv.first, equiv.second);
+    }
+}
+
+void ConstraintSimplifier::writeSimplified()
+{
+    std::unordered_set<std::uint64_t> typedefs;
+    bool blocked = false;
+    for (const Entry& e : entries_) {
+        switch (e.op_) {
+        case Op::Block:
+            blocked = e.aux_;
+            writer_->block(blocked);
+            break;
+
+        case Op::Text:
+            writer_->writeText(strings_[e.aux_]);
+            break;
+
+        case Op::Typedef: {
+            const TypeTerm ty1 = rewrite(e.ty1_);
+            const TypeTerm ty2 = rewrite(e.ty2_);
+            // A typedef into a variable doesn't redefine a type that is already known.
+            if (!blocked && ty2.isVar()) {
+                const auto key = (static_cast<std::uint64_t>(ty1.bits()) << 32) | ty2.bits();
+                if (!typedefs.insert(key).second) {
+                    ++stats_.droppedTypedefs_;
+                    break;
+                }
+            }
+            writer_->writeTypedef(ty1, ty2);
+            break;
+        }
+
+        case Op::VarDecl:
+            writer_->writeVarDecl(strings_[e.aux_], rewrite(e.ty1_));
+            break;
+
+        case Op::FuncDecl: {
+            std::vector<TypeTerm> params;
+            for (const auto param : lists_[e.list_])
+                params.push_back(rewrite(param));
+            writer_->writeFuncDecl(strings_[e.aux_], params, rewrite(e.ty1_));
+            break;
+        }
+
+        case Op::Typeof:
+            writer_->writeTypeof(strings_[e.aux_]);
+            break;
+
+        case Op::Exists:
+            if (!blocked
+                    && e.ty1_.isVar()
+                    && isBound(e.ty1_.index())
+                    && find(e.ty1_.index()) != e.ty1_.index()) {
+                ++stats_.mergedVars_;
+                break;
+            }
+            writer_->writeExists(e.ty1_);
+            break;
+
+        case Op::TypeSection:
+            writer_->writeTypeSection(rewrite(e.ty1_));
+            break;
+
+        case Op::TypesSection: {
+            std::vector<TypeTerm> tys;
+            for (const auto ty : lists_[e.list_])
+                tys.push_back(rewrite(ty));
+            writer_->writeTypesSection(tys);
+            break;
+        }
+
+        case Op::ConstantExpression:
+            writer_->writeConstantExpression(strings_[e.aux_]);
+            break;
+
+        case Op::Static:
+            writer_->writeStatic(strings_[e.aux_]);
+            break;
+
+        case Op::MemberRel:
+            writer_->writeMemberRel(rewrite(e.ty1_), strings_[e.aux_], rewrite(e.ty2_));
+            break;
+
+        case Op::PtrRel:
+            writer_->writePtrRel(rewrite(e.ty1_), rewrite(e.ty2_));
+            break;
+
+        case Op::EquivRel: {
+            const TypeTerm ty1 = rewrite(e.ty1_);
+            const TypeTerm ty2 = rewrite(e.ty2_);
+            if (!blocked && e.ty1_.isVar() && e.ty2_.isVar() && ty1 == ty2)
+                break;
+            writer_->writeEquivRel(ty1, ty2);
+            break;
+        }
+
+        case Op::SubtypeRel:
+            writer_->writeSubtypeRel(rewrite(e.ty1_), rewrite(e.ty2_));
+            break;
+
+        case Op::EquivMark:
+            writer_->writeEquivMark();
+            break;
+
+        case Op::SubtypeMark:
+            writer_->writeSubtypeMark();
+            break;
+
+        case Op::EnterGroup:
+            writer_->enterGroup();
+            break;
+
+        case Op::LeaveGroup:
+            writer_->leaveGroup();
+            break;
+
+        case Op::OpenScope:
+            writer_->openScope();
+            break;
+
+        case Op::CloseScope:
+            writer_->closeScope();
+            break;
+
+        case Op::BeginSection:
+            writer_->beginSection();
+            break;
+
+        case Op::EndSection:
+            writer_->endSection();
+            break;
+        }
+    }
+}
+
+void ConstraintSimplifier::flush()
+{
+    analyze();
+
+    const auto written = writer_->totalConstraints();
+    writeSimplified();
+    stats_.constraintsBefore_ += cnt_;
+    stats_.constraintsAfter_ += writer_->totalConstraints() - written;
+
+    clear();
+    parent_.clear();
+    binders_.clear();
+}
+
+std::ostream& psyche::operator<<(std::ostream& os, const ConstraintSimplifier::Stats& s)
+{
+    os << "  Constraints before : " << s.constraintsBefore_ << std::endl
+       << "  Constraints after  : " << s.constraintsAfter_ << std::endl
+       << "  Merged variables   : " << s.mergedVars_ << std::endl
+       << "  Dropped typedefs   : " << s.droppedTypedefs_;
+    return os;
+}
@@ -0,0 +1,97 @@
+/******************************************************************************
+ * Copyright (c) 2016 Leandro T. C. Melo (ltcmelo@gmail.com)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ * USA
+ *****************************************************************************/
+
+#ifndef PSYCHE_CONSTRAINTSIMPLIFIER_H__
+#define PSYCHE_CONSTRAINTSIMPLIFIER_H__
+
+#include "ConstraintRecorder.h"
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace psyche {
+
+/*!
+ * \brief The ConstraintSimplifier class
+ *
+ * A writer that records the constraints and, when flushed, writes a simplified
+ * version of them through another writer. Type variables related by equivalences
+ * are merged, through a union-find, onto the one bound outermost; the binders of
+ * the other variables, their equivalences, and duplicate typedefs are dropped,
+ * and the remaining constraints are rewritten on the representatives.
+ */
+class ConstraintSimplifier final : public ConstraintRecorder
+{
+public:
+    ConstraintSimplifier(ConstraintWriter* writer);
+    ~ConstraintSimplifier() override;
+
+    /*!
+     * \brief flush
+     *
+     * Simplify the constraints recorded so far and write them.
+     */
+    void flush();
+
+    struct Stats
+    {
+        std::size_t constraintsBefore_ { 0 };
+        std::size_t constraintsAfter_ { 0 };
+        std::size_t mergedVars_ { 0 };
+        std::size_t droppedTypedefs_ { 0 };
+    };
+
+    const Stats& stats() const { return stats_; }
+
+private:
+    //!@{
+    /*!
+     * Union-find of type variables, indexed by their number.
+     */
+    struct Binder
+    {
+        std::uint32_t depth_;
+        std::uint32_t pos_;
+        std::uint32_t scope_;
+        bool escapes_; //!< Whether the variable is used outside of the binder's scope.
+    };
+
+    void bind(std::uint32_t var, std::uint32_t depth, std::uint32_t pos, std::uint32_t scope);
+    void use(TypeTerm ty, const std::vector<bool>& openScopes);
+    bool isBound(std::uint32_t var) const;
+    std::uint32_t find(std::uint32_t var);
+    void unite(std::uint32_t var1, std::uint32_t var2);
+    TypeTerm rewrite(TypeTerm ty);
+
+    std::vector<std::uint32_t> parent_;
+    std::vector<Binder> binders_;
+    //!@}
+
+    void analyze();
+    void writeSimplified();
+
+    Stats stats_;
+};
+
+std::ostream& operator<<(std::ostream& os, const ConstraintSimplifier::Stats& s);
+
+} // namespace psyche
+
+#endif
@@ -0,0 +1,79 @@
+/******************************************************************************
+ * Copyright (c) 2016 Leandro T. C. Melo (ltcmelo@gmail.com)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ * USA
+ *****************************************************************************/
+
+#include "ConstraintSlicer.h"
+#include <algorithm>
+
+using namespace psyche;
+
+ConstraintSlicer::ConstraintSlicer(ConstraintWriter* writer)
+    : ConstraintPartitioner(writer)
+{}
+
+ConstraintSlicer::~ConstraintSlicer()
+{}
+
+bool ConstraintSlicer::isSeed(const Component& component) const
+{
+    for (const auto i : component.items_) {
+        for (const auto& k : keys_[i]) {
+            if ((isSymbolKey(k) && !declaredSymbols_.count(k))
+                    || (isTypeNameKey(k) && !definedTypeNames_.count(k))) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+void ConstraintSlicer::flush()
+{
+    partition();
+
+    std::vector<std::uint32_t> kept;
+    std::vector<std::uint32_t> declarations;
+    for (const Component& component : components_) {
+        if (!isSeed(component))
+            continue;
+        ++stats_.seeds_;
+        kept.insert(kept.end(), component.items_.begin(), component.items_.end());
+        kept.insert(kept.end(), component.shared_.begin(), component.shared_.end());
+        declarations.insert(declarations.end(),
+                            component.declarations_.begin(), component.declarations_.end());
+    }
+
+    // Declarations may be referred to by more than one component.
+    std::sort(kept.begin(), kept.end());
+    kept.erase(std::unique(kept.begin(), kept.end()), kept.end());
+    std::sort(declarations.begin(), declarations.end());
+    declarations.erase(std::unique(declarations.begin(), declarations.end()), declarations.end());
+    writeItems(kept, declarations, writer_);
+
+    stats_.itemsKept_ += kept.size();
+    stats_.itemsDropped_ += items_.size() - kept.size();
+    clear();
+}
+
+std::ostream& psyche::operator<<(std::ostream& os, const ConstraintSlicer::Stats& s)
+{
+    os << "  Seeds              : " << s.seeds_ << std::endl
+       << "  Items kept         : " << s.itemsKept_ << std::endl
+       << "  Items dropped      : " << s.itemsDropped_;
+    return os;
+}
@@ -0,0 +1,69 @@
+/******************************************************************************
+ * Copyright (c) 2016 Leandro T. C. Melo (ltcmelo@gmail.com)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ * USA
+ *****************************************************************************/
+
+#ifndef PSYCHE_CONSTRAINTSLICER_H__
+#define PSYCHE_CONSTRAINTSLICER_H__
+
+#include "ConstraintPartitioner.h"
+#include <cstddef>
+#include <ostream>
+
+namespace psyche {
+
+/*!
+ * \brief The ConstraintSlicer class
+ *
+ * A writer that records the constraints and, when flushed, writes through
+ * another writer only the components related to the unknowns: symbols used
+ * but not declared, and type names used but not defined. The remaining
+ * components don't affect what the solver infers.
+ */
+class ConstraintSlicer final : public ConstraintPartitioner
+{
+public:
+    ConstraintSlicer(ConstraintWriter* writer);
+    ~ConstraintSlicer() override;
+
+    /*!
+     * \brief flush
+     *
+     * Write the slice of the constraints recorded so far, and clear them.
+     */
+    void flush();
+
+    struct Stats
+    {
+        std::size_t seeds_ { 0 };
+        std::size_t itemsKept_ { 0 };
+        std::size_t itemsDropped_ { 0 };
+    };
+
+    const Stats& stats() const { return stats_; }
+
+private:
+    bool isSeed(const Component& component) const;
+
+    Stats stats_;
+};
+
+std::ostream& operator<<(std::ostream& os, const ConstraintSlicer::Stats& s);
+
+} // namespace psyche
+
+#endif
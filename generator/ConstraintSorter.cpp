@@ -0,0 +1,222 @@
+/******************************************************************************
+ * Copyright (c) 2016 Leandro T. C. Melo (ltcmelo@gmail.com)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ * USA
+ *****************************************************************************/
+
+#include "ConstraintSorter.h"
+#include <algorithm>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+
+using namespace psyche;
+
+ConstraintSorter::ConstraintSorter(ConstraintWriter* writer)
+    : ConstraintPartitioner(writer)
+{}
+
+ConstraintSorter::~ConstraintSorter()
+{}
+
+void ConstraintSorter::provides(const Item& item, std::vector<std::string>& keys)
+{
+    const Entry& e = entries_[item.begin_];
+    switch (e.op_) {
+    case Op::VarDecl:
+    case Op::FuncDecl:
+        keys.push_back(symbolKey(strings_[e.aux_]));
+        break;
+
+    case Op::Typedef: {
+        std::vector<std::string> names;
+        collectKeys(e.ty1_, names);
+        std::copy_if(names.begin(), names.end(), std::back_inserter(keys), isTypeNameKey);
+        break;
+    }
+
+    case Op::Exists:
+        collectKeys(e.ty1_, keys);
+        break;
+
+    default:
+        break;
+    }
+}
+
+bool ConstraintSorter::declName(const Item& item, std::string& name)
+{
+    const Entry& e = entries_[item.begin_];
+    if (e.op_ == Op::VarDecl || e.op_ == Op::FuncDecl) {
+        name = strings_[e.aux_];
+        return true;
+    }
+    if (e.op_ != Op::Typedef || !e.ty1_.isName())
+        return false;
+
+    // A typedef of builtins only is not a declaration of its own.
+    std::vector<std::string> keys;
+    collectKeys(e.ty1_, keys);
+    if (keys.empty())
+        return false;
+    name = terms().nameOf(e.ty1_);
+    return true;
+}
+
+void ConstraintSorter::group()
+{
+    // A unit begins with the existentials and typedefs that bind the types of a
+    // declaration, has the declaration (with its body), and ends with the
+    // equations that follow it. The first item of a unit that has anything but
+    // binders begins the next unit.
+    units_.clear();
+    bool binding = false;
+    for (auto i = 0u; i < items_.size(); ++i) {
+        const Op op = entries_[items_[i].begin_].op_;
+        const bool binder = op == Op::Exists || op == Op::Typedef;
+        const bool decl = op == Op::VarDecl || op == Op::FuncDecl;
+        if (units_.empty() || ((binder || decl) && !binding)) {
+            units_.push_back(Unit{ i, i + 1 });
+            binding = binder;
+        } else {
+            units_.back().end_ = i + 1;
+            binding = binding && binder;
+        }
+    }
+}
+
+bool ConstraintSorter::unitName(const Unit& unit, std::string& name)
+{
+    // The unit's declaration or, without one, its first typedef of a name.
+    for (auto i = unit.begin_; i < unit.end_; ++i) {
+        const Op op = entries_[items_[i].begin_].op_;
+        if ((op == Op::VarDecl || op == Op::FuncDecl) && declName(items_[i], name))
+            return true;
+    }
+    for (auto i = unit.begin_; i < unit.end_; ++i) {
+        if (declName(items_[i], name))
+            return true;
+    }
+    return false;
+}
+
+void ConstraintSorter::flush()
+{
+    split();
+    group();
+    const auto cnt = static_cast<std::uint32_t>(units_.size());
+
+    // The keys a unit provides are its own; of the others, a unit depends on
+    // the nearest provider before it or, without one, the first after it.
+    std::vector<std::unordered_set<std::string>> provided(cnt);
+    std::unordered_map<std::string, std::vector<std::uint32_t>> providers;
+    for (auto u = 0u; u < cnt; ++u) {
+        for (auto i = units_[u].begin_; i < units_[u].end_; ++i) {
+            std::vector<std::string> keys;
+            provides(items_[i], keys);
+            for (auto& k : keys) {
+                if (provided[u].insert(k).second)
+                    providers[k].push_back(u);
+            }
+        }
+    }
+
+    std::vector<std::vector<std::uint32_t>> deps(cnt);
+    for (auto u = 0u; u < cnt; ++u) {
+        std::vector<std::string> keys;
+        for (auto i = units_[u].begin_; i < units_[u].end_; ++i)
+            collectKeys(items_[i], keys);
+        for (const auto& k : keys) {
+            if (provided[u].count(k))
+                continue;
+            auto it = providers.find(k);
+            if (it == providers.end())
+                continue;
+            const auto& us = it->second;
+            auto after = std::upper_bound(us.begin(), us.end(), u);
+            deps[u].push_back(after == us.begin() ? *after : *(after - 1));
+        }
+        std::sort(deps[u].begin(), deps[u].end());
+        deps[u].erase(std::unique(deps[u].begin(), deps[u].end()), deps[u].end());
+        stats_.edges_ += deps[u].size();
+    }
+
+    // A depth-first walk in the original order, in which a unit is taken
+    // right after its dependences; a unit already on the walk closes a cycle.
+    enum class Mark : char { New, Visiting, Taken };
+    std::vector<Mark> marks(cnt, Mark::New);
+    std::vector<std::uint32_t> order;
+    order.reserve(cnt);
+    std::vector<std::pair<std::uint32_t, std::size_t>> walk;
+    for (auto root = 0u; root < cnt; ++root) {
+        if (marks[root] != Mark::New)
+            continue;
+        marks[root] = Mark::Visiting;
+        walk.emplace_back(root, 0);
+        while (!walk.empty()) {
+            auto& top = walk.back();
+            const auto u = top.first;
+            if (top.second < deps[u].size()) {
+                const auto d = deps[u][top.second++];
+                if (marks[d] == Mark::New) {
+                    marks[d] = Mark::Visiting;
+                    walk.emplace_back(d, 0);
+                } else if (marks[d] == Mark::Visiting) {
+                    ++stats_.cycles_;
+                }
+                continue;
+            }
+            marks[u] = Mark::Taken;
+            if (walk.size() > 1)
+                ++stats_.moved_;
+            order.push_back(u);
+            walk.pop_back();
+        }
+    }
+
+    std::vector<std::uint32_t> items;
+    items.reserve(items_.size());
+    for (const auto u : order) {
+        for (auto i = units_[u].begin_; i < units_[u].end_; ++i)
+            items.push_back(i);
+    }
+    writeItems(items, writer_);
+
+    dependences_.clear();
+    for (const auto u : order) {
+        Dependence dep;
+        if (!unitName(units_[u], dep.decl_))
+            continue;
+        std::string name;
+        for (const auto d : deps[u]) {
+            if (unitName(units_[d], name))
+                dep.deps_.push_back(name);
+        }
+        dependences_.push_back(std::move(dep));
+    }
+
+    stats_.units_ += cnt;
+    clear();
+}
+
+std::ostream& psyche::operator<<(std::ostream& os, const ConstraintSorter::Stats& s)
+{
+    os << "  Declaration units  : " << s.units_ << std::endl
+       << "  Dependences        : " << s.edges_ << std::endl
+       << "  Moved items        : " << s.moved_ << std::endl
+       << "  Cycles broken      : " << s.cycles_;
+    return os;
+}
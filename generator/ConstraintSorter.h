@@ -0,0 +1,98 @@
+/******************************************************************************
+ * Copyright (c) 2016 Leandro T. C. Melo (ltcmelo@gmail.com)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ * USA
+ *****************************************************************************/
+
+#ifndef PSYCHE_CONSTRAINTSORTER_H__
+#define PSYCHE_CONSTRAINTSORTER_H__
+
+#include "ConstraintPartitioner.h"
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace psyche {
+
+/*!
+ * \brief The ConstraintSorter class
+ *
+ * A writer that records the constraints and, when flushed, writes them through
+ * another writer with every declaration after those it depends on: the
+ * declaration of a symbol, the typedef of a type name, or the existential of a
+ * type variable. A declaration moves as a unit, along with the existentials and
+ * typedefs that precede it and the equations that follow it. Otherwise, the
+ * constraints keep their original order. A dependency cycle is broken at the
+ * dependence that closes it.
+ */
+class ConstraintSorter final : public ConstraintPartitioner
+{
+public:
+    ConstraintSorter(ConstraintWriter* writer);
+    ~ConstraintSorter() override;
+
+    /*!
+     * \brief flush
+     *
+     * Write the constraints recorded so far, sorted, and clear them.
+     */
+    void flush();
+
+    //! A declaration, as written, and the declarations it directly depends on.
+    struct Dependence
+    {
+        std::string decl_;
+        std::vector<std::string> deps_;
+    };
+
+    const std::vector<Dependence>& dependences() const { return dependences_; }
+
+    struct Stats
+    {
+        std::size_t units_ { 0 };
+        std::size_t edges_ { 0 };
+        std::size_t moved_ { 0 }; //!< Taken ahead of their original position.
+        std::size_t cycles_ { 0 };
+    };
+
+    const Stats& stats() const { return stats_; }
+
+private:
+    //! A declaration with its binders and equations, as a range of items.
+    struct Unit
+    {
+        std::uint32_t begin_;
+        std::uint32_t end_;
+    };
+
+    void group();
+    void provides(const Item& item, std::vector<std::string>& keys);
+    bool declName(const Item& item, std::string& name);
+    bool unitName(const Unit& unit, std::string& name);
+
+    std::vector<Unit> units_;
+
+    std::vector<Dependence> dependences_;
+    Stats stats_;
+};
+
+std::ostream& operator<<(std::ostream& os, const ConstraintSorter::Stats& s);
+
+} // namespace psyche
+
+#endif
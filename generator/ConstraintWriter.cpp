@@ -24,18 +24,18 @@ using namespace psyche;
 
 namespace {
 
-const char* const kTypeDef = "$typedef$ ";
-const char* const kDecl = "$def$ ";
-const char* const kMember = "$has$ ";
-const char* const kExistence = "$exists$ ";
-const char* const kContainment = " $in$ ";
-const char* const kDeclDelim = " : ";
-const char* const kEquiv = " = ";
-const char* const kSubtype = " > ";
-const char* const kAlias = " $as$ ";
-const char* const kTypeOf = "$typeof$";
-const char* const kReadOnly = "$read_only$";
-const char* const kStatic = "$static$";
+const char kTypeDef[] = "$typedef$ ";
+const char kDecl[] = "$def$ ";
+const char kMember[] = "$has$ ";
+const char kExistence[] = "$exists$ ";
+const char kContainment[] = " $in$ ";
+const char kDeclDelim[] = " : ";
+const char kEquiv[] = " = ";
+const char kSubtype[] = " > ";
+const char kAlias[] = " $as$ ";
+const char kTypeOf[] = "$typeof$";
+const char kReadOnly[] = "$read_only$";
+const char kStatic[] = "$static$";
 
 } // anonymous
 
@@ -50,9 +50,16 @@ ConstraintWriter::ConstraintWriter(std::ostream &os)
     : os_(&os)
 {}
 
+ConstraintWriter::ConstraintWriter()
+    : os_(nullptr)
+{}
+
 ConstraintWriter::~ConstraintWriter()
 {}
 
+void ConstraintWriter::sync()
+{}
+
 bool ConstraintWriter::block(bool b)
 {
     bool prev = blocked_;
@@ -65,45 +72,60 @@ void ConstraintWriter::writeText(const std::string &text)
     HONOR_BLOCKING_STATE;
 
     beginSection();
-    *os_ << text;
+    put(text);
 }
 
-void ConstraintWriter::writeTypedef(const std::string &ty1, const std::string &ty2)
+void ConstraintWriter::writeTypedef(TypeTerm ty1, TypeTerm ty2)
 {
     HONOR_BLOCKING_STATE;
 
     beginSection();
     writeLineBreak();
-    *os_ << kTypeDef << ty1 << kAlias << ty2;
+    put(kTypeDef);
+    putTerm(ty1);
+    put(kAlias);
+    putTerm(ty2);
     endSection();
 
     ++cnt_;
 }
 
-void ConstraintWriter::writeVarDecl(const std::string &name, const std::string &ty)
+void ConstraintWriter::writeVarDecl(const std::string &name, TypeTerm ty)
 {
     HONOR_BLOCKING_STATE;
 
     beginSection();
     writeLineBreak();
-    *os_ << kDecl << name << kDeclDelim << ty << kContainment << " ";
+    put(kDecl);
+    put(name);
+    put(kDeclDelim);
+    putTerm(ty);
+    put(kContainment);
+    put(" ");
 
     ++cnt_;
 }
 
 void ConstraintWriter::writeFuncDecl(const std::string &name,
-                                     const std::vector<std::string> &params,
-                                     const std::string& ret)
+                                     const std::vector<TypeTerm> &params,
+                                     TypeTerm ret)
 {
     HONOR_BLOCKING_STATE;
 
     beginSection();
     writeLineBreak();
-    *os_ << kDecl << name << kDeclDelim << "(";
-    for (const auto& param : params)
-        *os_ << param << ", ";
-    *os_ << ret;
-    *os_ << ") " << kContainment << " ";
+    put(kDecl);
+    put(name);
+    put(kDeclDelim);
+    put("(");
+    for (const auto param : params) {
+        putTerm(param);
+        put(", ");
+    }
+    putTerm(ret);
+    put(") ");
+    put(kContainment);
+    put(" ");
 
     ++cnt_;
 }
@@ -112,18 +134,23 @@ void ConstraintWriter::writeTypeof(const std::string &sym)
 {
     HONOR_BLOCKING_STATE;
 
-    *os_ << kTypeOf << "(" << sym << ")";
+    put(kTypeOf);
+    put("(");
+    put(sym);
+    put(")");
 
     ++cnt_;
 }
 
-void ConstraintWriter::writeExists(const std::string &ty)
+void ConstraintWriter::writeExists(TypeTerm ty)
 {
     HONOR_BLOCKING_STATE;
 
     beginSection();
     writeLineBreak();
-    *os_ << kExistence << ty << ". ";
+    put(kExistence);
+    putTerm(ty);
+    put(". ");
 
     ++cnt_;
 }
@@ -132,17 +159,17 @@ void ConstraintWriter::writeEquivMark()
 {
     HONOR_BLOCKING_STATE;
 
-    *os_ << kEquiv;
+    put(kEquiv);
 }
 
 void ConstraintWriter::writeSubtypeMark()
 {
     HONOR_BLOCKING_STATE;
 
-    *os_ << kSubtype;
+    put(kSubtype);
 }
 
-void ConstraintWriter::writeSubtypeRel(const std::string& ty, const std::string& subTy)
+void ConstraintWriter::writeSubtypeRel(TypeTerm ty, TypeTerm subTy)
 {
     HONOR_BLOCKING_STATE;
 
@@ -154,11 +181,11 @@ void ConstraintWriter::writeSubtypeRel(const std::string& ty, const std::string&
     ++cnt_;
 }
 
-void ConstraintWriter::writeTypeSection(const std::string& ty)
+void ConstraintWriter::writeTypeSection(TypeTerm ty)
 {
     HONOR_BLOCKING_STATE;
 
-    *os_ << ty;
+    putTerm(ty);
 }
 
 void ConstraintWriter::writeConstantExpression(const std::string &val)
@@ -166,7 +193,10 @@ void ConstraintWriter::writeConstantExpression(const std::string &val)
     HONOR_BLOCKING_STATE;
 
     beginSection();
-    *os_ << kReadOnly << "(" << val << ")";
+    put(kReadOnly);
+    put("(");
+    put(val);
+    put(")");
     endSection();
 
     ++cnt_;
@@ -177,13 +207,16 @@ void ConstraintWriter::writeStatic(const std::string &val)
     HONOR_BLOCKING_STATE;
 
     beginSection();
-    *os_ << kStatic << "(" << val << ")";
+    put(kStatic);
+    put("(");
+    put(val);
+    put(")");
     endSection();
 
     ++cnt_;
 }
 
-void ConstraintWriter::writeTypesSection(const std::vector<std::string> &tys)
+void ConstraintWriter::writeTypesSection(const std::vector<TypeTerm> &tys)
 {
     HONOR_BLOCKING_STATE;
 
@@ -196,26 +229,27 @@ void ConstraintWriter::writeTypesSection(const std::vector<std::string> &tys)
     ++cnt_;
 }
 
-void ConstraintWriter::writeMemberRel(const std::string &baseTy,
+void ConstraintWriter::writeMemberRel(TypeTerm baseTy,
                                       const std::string &memberName,
-                                      const std::string &symTy)
+                                      TypeTerm symTy)
 {
     HONOR_BLOCKING_STATE;
 
     beginSection();
-    *os_ << kMember << "(";
+    put(kMember);
+    put("(");
     writeTypeSection(baseTy);
     writeAnd();
-    *os_ << memberName;
+    put(memberName);
     writeColon();
     writeTypeSection(symTy);
-    *os_ << ")";
+    put(")");
     endSection();
 
     ++cnt_;
 }
 
-void ConstraintWriter::writePtrRel(const std::string &ty1, const std::string &ty2)
+void ConstraintWriter::writePtrRel(TypeTerm ty1, TypeTerm ty2)
 {
     HONOR_BLOCKING_STATE;
 
@@ -223,12 +257,12 @@ void ConstraintWriter::writePtrRel(const std::string &ty1, const std::string &ty
     writeTypeSection(ty1);
     writeEquivMark();
     writeTypeSection(ty2);
-    *os_ << "*";
+    put("*");
     endSection();
     ++cnt_;
 }
 
-void ConstraintWriter::writeEquivRel(const std::string &ty1, const std::string &ty2)
+void ConstraintWriter::writeEquivRel(TypeTerm ty1, TypeTerm ty2)
 {
     HONOR_BLOCKING_STATE;
 
@@ -244,14 +278,14 @@ void ConstraintWriter::enterGroup()
 {
     HONOR_BLOCKING_STATE;
 
-    *os_ << "(";
+    put("(");
 }
 
 void ConstraintWriter::leaveGroup()
 {
     HONOR_BLOCKING_STATE;
 
-    *os_ << ")";
+    put(")");
 }
 
 void ConstraintWriter::openScope()
@@ -260,7 +294,7 @@ void ConstraintWriter::openScope()
 
     beginSection();
     writeLineBreak();
-    *os_ << "[ ";
+    put("[ ");
     ++indent_;
 }
 
@@ -270,7 +304,7 @@ void ConstraintWriter::closeScope()
 
     --indent_;
     writeLineBreak();
-    *os_ << "]";
+    put("]");
     endSection();
 }
 
@@ -278,14 +312,20 @@ void ConstraintWriter::writeAnd()
 {
     HONOR_BLOCKING_STATE;
 
-    *os_ << ", ";
+    put(", ");
 }
 
 void ConstraintWriter::writeLineBreak()
 {
     HONOR_BLOCKING_STATE;
 
-    *os_ << std::endl;
+    if (out_) {
+        out_->push_back('\n');
+        if (out_->size() >= syncSize_)
+            sync();
+    } else {
+        *os_ << std::endl;
+    }
     indent();
 }
 
@@ -293,8 +333,10 @@ void ConstraintWriter::indent()
 {
     HONOR_BLOCKING_STATE;
 
-    std::string space(indent_, ' ');
-    *os_ << space;
+    if (out_)
+        out_->append(indent_, ' ');
+    else
+        *os_ << std::string(indent_, ' ');
 }
 
 void ConstraintWriter::dedent()
@@ -317,5 +359,5 @@ void ConstraintWriter::endSection()
 
 void ConstraintWriter::writeColon()
 {
-    *os_ << kDeclDelim;
+    put(kDeclDelim);
 }
@@ -20,6 +20,8 @@
 #ifndef PSYCHE_CONSTRAINTWRITER_H__
 #define PSYCHE_CONSTRAINTWRITER_H__
 
+#include "TypeTerm.h"
+#include <cstddef>
 #include <ostream>
 #include <string>
 #include <tuple>
@@ -64,14 +66,14 @@ public:
      * \param ty1
      * \param ty2
      */
-    virtual void writeTypedef(const std::string& ty1, const std::string& ty2);
+    virtual void writeTypedef(TypeTerm ty1, TypeTerm ty2);
 
     /*!
      * \brief writeVarDecl
      * \param value
      * \param type
      */
-    virtual void writeVarDecl(const std::string& name, const std::string& type);
+    virtual void writeVarDecl(const std::string& name, TypeTerm type);
 
     /*!
      * \brief writeFuncDecl
@@ -82,8 +84,8 @@ public:
      *
      */
     virtual void writeFuncDecl(const std::string& name,
-                               const std::vector<std::string>& params,
-                               const std::string& ret);
+                               const std::vector<TypeTerm>& params,
+                               TypeTerm ret);
 
     /*!
      * \brief writeTypeofExpr
@@ -95,7 +97,7 @@ public:
      * \brief writeNewTypeVar
      * \param ty
      */
-    virtual void writeExists(const std::string& ty);
+    virtual void writeExists(TypeTerm ty);
 
     /*!
      * \brief writeTypeName
@@ -106,7 +108,7 @@ public:
      *
      * \sa writeTypeNames
      */
-    virtual void writeTypeSection(const std::string& ty);
+    virtual void writeTypeSection(TypeTerm ty);
 
     /*!
      * \brief writeTypeNames
@@ -114,7 +116,7 @@ public:
      *
      * Write a sequence of type names.
      */
-    virtual void writeTypesSection(const std::vector<std::string>& tys);
+    virtual void writeTypesSection(const std::vector<TypeTerm>& tys);
 
     /*!
      * \brief writeReadOnly
@@ -134,16 +136,16 @@ public:
      * \param sym
      * \param symTy
      */
-    virtual void writeMemberRel(const std::string& baseTy,
+    virtual void writeMemberRel(TypeTerm baseTy,
                                 const std::string& sym,
-                                const std::string& symTy);
+                                TypeTerm symTy);
 
     /*!
      * \brief writePtrRel
      * \param ty1
      * \param ty2
      */
-    virtual void writePtrRel(const std::string& ty1, const std::string& ty2);
+    virtual void writePtrRel(TypeTerm ty1, TypeTerm ty2);
 
     /*!
      * \brief writeEquivRel
@@ -153,14 +155,14 @@ public:
      * Essentially the same of sequentially writing a type, a type equivalence,
      * and another type.
      */
-    virtual void writeEquivRel(const std::string& ty1, const std::string& ty2);
+    virtual void writeEquivRel(TypeTerm ty1, TypeTerm ty2);
 
     /*!
      * \brief writeSubtypeRelation
      * \param ty
      * \param subTy
      */
-    virtual void writeSubtypeRel(const std::string &ty, const std::string &subTy);
+    virtual void writeSubtypeRel(TypeTerm ty, TypeTerm subTy);
 
     /*!
      * \brief writeTypeMark
@@ -194,10 +196,33 @@ public:
      */
     size_t totalConstraints() const { return cnt_; }
 
-    void endSection();
-    void beginSection();
+    /*!
+     * \brief terms
+     * \return
+     *
+     * The pool in which type names are interned, used to spell the terms.
+     */
+    virtual TypeTermPool& terms() { return terms_; }
+
+    virtual void endSection();
+    virtual void beginSection();
+
+    /*!
+     * \brief sync
+     *
+     * Make whatever was written so far reach its destination. Only needed for
+     * writers that hold the text back.
+     */
+    virtual void sync();
 
 protected:
+    /*!
+     * \brief ConstraintWriter
+     *
+     * For writers that don't write on a stream themselves.
+     */
+    ConstraintWriter();
+
     void writeAnd();
     void writeColon();
     void writeLineBreak();
@@ -205,11 +230,45 @@ protected:
     void indent();
     void dedent();
 
+    //!@{
+    /*!
+     * Write a fragment of text: append it to the buffer, if there's one, or
+     * write it on the stream.
+     */
+    template <std::size_t N>
+    void put(const char (&s)[N])
+    {
+        if (out_)
+            out_->append(s, N - 1);
+        else
+            *os_ << s;
+    }
+
+    void put(const std::string& s)
+    {
+        if (out_)
+            out_->append(s);
+        else
+            *os_ << s;
+    }
+
+    void putTerm(TypeTerm ty)
+    {
+        if (out_)
+            terms_.append(*out_, ty);
+        else
+            terms_.write(*os_, ty);
+    }
+    //!@}
+
     std::ostream* os_;
+    std::string* out_ { nullptr }; //!< Buffer, synced once it reaches syncSize_.
+    std::size_t syncSize_ { 0 };
     int indent_ { 0 };
     bool blocked_ { false };
     size_t cnt_ { 0 };
     bool wantComma { false };
+    TypeTermPool terms_;
 
 };
 
@@ -32,6 +32,12 @@
 #include "ExpressionTypeEvaluator.h"
 #include "TranslationUnit.h"
 #include <algorithm>
+#include <atomic>
+#include <functional>
+#include <map>
+#include <memory>
+#include <thread>
+#include <tuple>
 #include <unordered_set>
 #include <utility>
 
@@ -53,53 +59,70 @@ const char* const kArithmetic = "arithmetic";
 
 const char* const kZero = "0";
 
-} // anonymous
-
-const DomainLattice::Domain DomainLattice::Undefined(kUndefined);
-const DomainLattice::Domain DomainLattice::Scalar(kScalar);
-const DomainLattice::Domain DomainLattice::Pointer(kPointer);
-const DomainLattice::Domain DomainLattice::Integral(kIntegral);
-const DomainLattice::Domain DomainLattice::FloatingPoint(kFloatingPoint);
-const DomainLattice::Domain DomainLattice::Arithmetic(kArithmetic);
-
-bool DomainLattice::Domain::operator>=(const DomainLattice::Domain& other) const
+// The concrete types of domains, indexed as encoded.
+enum TypeIndex : std::uint8_t
 {
-    return name_ == other.name_ || (*this > other);
-}
-
-bool DomainLattice::Domain::operator>(const DomainLattice::Domain& other) const
-{
-    if (other == Undefined) {
-        return name_ == kScalar
-                || name_ == kPointer
-                || name_ == kIntegral
-                || name_ == kFloatingPoint
-                || name_ == kArithmetic;
-    }
-
-    if (other == Scalar) {
-        return name_ == kPointer
-                || name_ == kIntegral
-                || name_ == kFloatingPoint
-                || name_ == kArithmetic;
-    }
+    NoTy,
+    IntTy,
+    CharTy,
+    ShortTy,
+    LongTy,
+    LongLongTy,
+    FloatTy,
+    DoubleTy,
+    LongDoubleTy,
+    SizeTy,
+    PtrDiffTy,
+    IntPtrTy,
+    UIntPtrTy
+};
+
+const char* const kTypeNames[] = {
+    nullptr,
+    kIntTy,
+    kCharTy,
+    kShortTy,
+    kLongTy,
+    kLongLongTy,
+    kFloatTy,
+    kDoubleTy,
+    kLongDoubleTy,
+    kSizeTy,
+    kPtrDiffTy,
+    kIntPtrTy,
+    kUIntPtrTy
+};
 
-    if (other == Arithmetic) {
-        return name_ == kIntegral
-                || name_ == kFloatingPoint;
-    }
+} // anonymous
 
-    return false;
-}
+const DomainLattice::Domain DomainLattice::Undefined(Domain::UndefinedBits, NoTy);
+const DomainLattice::Domain DomainLattice::Scalar(Domain::ScalarBits, NoTy);
+const DomainLattice::Domain DomainLattice::Pointer(Domain::PointerBits, NoTy);
+const DomainLattice::Domain DomainLattice::Integral(Domain::IntegralBits, NoTy);
+const DomainLattice::Domain DomainLattice::FloatingPoint(Domain::FloatingPointBits, NoTy);
+const DomainLattice::Domain DomainLattice::Arithmetic(Domain::ArithmeticBits, NoTy);
 
-bool DomainLattice::Domain::operator==(const DomainLattice::Domain& other) const
+const char* DomainLattice::Domain::name() const
 {
-    return name_ == other.name_;
+    switch (bits_) {
+    case ScalarBits:
+        return kScalar;
+    case PointerBits:
+        return kPointer;
+    case ArithmeticBits:
+        return kArithmetic;
+    case IntegralBits:
+        return kIntegral;
+    case FloatingPointBits:
+        return kFloatingPoint;
+    default:
+        return kUndefined;
+    }
 }
 
-bool DomainLattice::Domain::operator!=(const DomainLattice::Domain& other) const
+const char* DomainLattice::Domain::typeName() const
 {
-    return !(*this == other);
+    return kTypeNames[ty_];
 }
 
 DomainLattice::DomainLattice(TranslationUnit *unit)
@@ -107,91 +130,417 @@ DomainLattice::DomainLattice(TranslationUnit *unit)
     , withinExpr_(0)
     , lastDom_(Undefined)
     , matcher_(unit)
+    , typeof_(unit)
     , scope_(nullptr)
     , globalScope_(nullptr)
     , cutoffScope_(nullptr)
-{}
+    , normalizing_(false)
+    , jobs_(1)
+    , main_(nullptr)
+    , local_(nullptr)
+    , lock_(nullptr)
+    , failed_(false)
+{
+    typeof_.enableMemoization();
+}
+
+void DomainLattice::employThreads(unsigned jobs)
+{
+    jobs_ = jobs;
+}
 
 void DomainLattice::categorize(TranslationUnitAST* ast, Scope* global)
 {
+    numberScopes(global);
     enterScope(global);
     globalScope_ = scope_;
 
-    for (DeclarationListAST* it = ast->declaration_list; it; it = it->next) {
-        resetCutoffScope();
-        accept(it->value);
+    if (jobs_ > 1) {
+        categorizeInParallel(ast);
+    } else {
+        for (DeclarationListAST* it = ast->declaration_list; it; it = it->next) {
+            resetCutoffScope();
+            accept(it->value);
+        }
     }
 
     // Use collected function arguments to normalize domains in every call.
-    for (auto& p : funcs_) {
-        auto& argsData = p.second;
-        for (auto& argData : argsData) {
-            Domain dom = argData.dom_;
-            bool needUpdate = false;
-            for (ExpressionAST* arg : argData.instances_) {
-                const Domain& argDom = retrieveDomain(arg, argData.callScope_); // TODO: Store scope.
-                if (argDom > dom) {
-                    dom = argDom;
-                    needUpdate = true;
-                }
-            }
+    normalizeArguments();
+}
+
+void DomainLattice::categorizeInParallel(TranslationUnitAST* ast)
+{
+    std::vector<DeclarationAST*> decls;
+    for (DeclarationListAST* it = ast->declaration_list; it; it = it->next)
+        decls.push_back(it->value);
+
+    std::vector<std::unique_ptr<DomainLattice>> workers(decls.size());
+    std::mutex lock;
+    std::atomic<std::size_t> next(0);
+    auto work = [&] () {
+        for (auto i = next++; i < decls.size(); i = next++) {
+            FunctionDefinitionAST* func = decls[i]->asFunctionDefinition();
+            if (!func || !func->symbol)
+                continue;
+            const ScopeRange* local = findRange(func->symbol);
+            if (!local)
+                continue;
+
+            std::unique_ptr<DomainLattice> worker(new DomainLattice(translationUnit()));
+            worker->main_ = this;
+            worker->local_ = local;
+            worker->lock_ = &lock;
+            worker->enterScope(globalScope_);
+            worker->globalScope_ = globalScope_;
+            worker->resetCutoffScope();
+            worker->accept(func);
+            workers[i] = std::move(worker);
+        }
+    };
+
+    std::vector<std::thread> threads;
+    const auto cnt = std::min<std::size_t>(jobs_, decls.size());
+    for (auto i = 1u; i < cnt; ++i)
+        threads.emplace_back(work);
+    work();
+    for (auto& thread : threads)
+        thread.join();
+
+    // Merge in source order, categorizing the remaining declarations.
+    for (auto i = 0u; i < decls.size(); ++i) {
+        resetCutoffScope();
+        if (workers[i] && !workers[i]->failed_ && merge(*workers[i])) {
+            ++stats_.functionsMerged_;
+        } else {
+            if (workers[i])
+                ++stats_.functionsRedone_;
+            accept(decls[i]);
+        }
+        workers[i].reset();
+    }
+}
+
+bool DomainLattice::isShared(const Scope* scope)
+{
+    if (!main_)
+        return false;
+    const ScopeRange& range = rangeOf(scope);
+    return range.id_ < local_->id_ || range.id_ > local_->last_;
+}
+
+void DomainLattice::share(SharedAccess::Kind kind,
+                          const void* key,
+                          const Scope* scope,
+                          unsigned idx)
+{
+    shared_.push_back(SharedAccess { kind, key, scope, idx, lastDom_ });
+}
+
+namespace {
+
+template <class LayersT>
+auto findLayer(LayersT& layers, unsigned id) -> decltype(&layers[0])
+{
+    for (auto& layer : layers) {
+        if (layer.id_ == id)
+            return &layer;
+    }
+    return nullptr;
+}
+
+bool isSame(const DomainLattice::Domain& a, const DomainLattice::Domain& b)
+{
+    return a == b && !strcmp(a.typeName() ? a.typeName() : "", b.typeName() ? b.typeName() : "");
+}
+
+} // anonymous
+
+bool DomainLattice::merge(const DomainLattice& worker)
+{
+    // The ASTs known by the worker, as known here.
+    std::unordered_map<const ExpressionAST*, ExpressionAST*> known;
+    std::vector<ExpressionAST*> unknown;
+    for (auto ast : worker.knownAsts_) {
+        auto equiv = isKnownAST(ast);
+        if (!equiv) {
+            equiv = ast;
+            unknown.push_back(ast);
+        }
+        known[ast] = equiv;
+    }
+
+    auto initial = [this] (const SharedAccess& access, const void* key) {
+        if (access.kind_ == SharedAccess::Argument) {
+            auto it = funcs_.find(static_cast<ExpressionAST*>(const_cast<void*>(key)));
+            if (it == funcs_.end() || access.idx_ >= it->second.size())
+                return Undefined;
+            return it->second[access.idx_].dom_;
+        }
+
+        const Layers* layers = nullptr;
+        if (access.kind_ == SharedAccess::Ast) {
+            auto it = astDoms_.find(static_cast<const ExpressionAST*>(key));
+            layers = it != astDoms_.end() ? &it->second : nullptr;
+        } else {
+            auto it = symDoms_.find(static_cast<const psyche::Symbol*>(key));
+            layers = it != symDoms_.end() ? &it->second : nullptr;
+        }
+        const Layer* layer = layers ? findLayer(*layers, rangeOf(access.scope_).id_) : nullptr;
+        return layer ? layer->dom_ : Undefined;
+    };
+
+    // Replay what the worker categorized outside of the function, both from
+    // the domains it assumed (none) and from the actual ones: if, at every
+    // point, the same domain is enforced, the categorization is the same.
+    using Slot = std::tuple<int, const void*, const Scope*, unsigned>;
+    std::map<Slot, std::pair<Domain, Domain>> slots;
+    auto replay = [] (Domain& dom, const Domain& categorized) {
+        if (categorized > dom) {
+            dom = categorized;
+            return Undefined;
+        }
+        return dom > categorized ? dom : Undefined;
+    };
+    for (const auto& access : worker.shared_) {
+        const void* key = access.key_;
+        if (access.kind_ != SharedAccess::Symbol)
+            key = known.at(static_cast<const ExpressionAST*>(key));
+        const Slot slot(access.kind_, key, access.scope_, access.idx_);
+        auto it = slots.find(slot);
+        if (it == slots.end())
+            it = slots.emplace(slot, std::make_pair(Undefined, initial(access, key))).first;
+
+        const Domain assumed = replay(it->second.first, access.dom_);
+        const Domain actual = replay(it->second.second, access.dom_);
+        if (access.kind_ != SharedAccess::Symbol && !isSame(assumed, actual))
+            return false;
+    }
+
+    knownAsts_.insert(knownAsts_.end(), unknown.begin(), unknown.end());
+
+    // The domains within the function.
+    for (const auto& p : worker.astDoms_) {
+        for (const auto& layer : p.second) {
+            if (layer.id_ < worker.local_->id_ || layer.id_ > worker.local_->last_)
+                continue;
+            astDoms_[known.at(p.first)].push_back(layer);
+            scopeKeys_[layer.id_].asts_.push_back(known.at(p.first));
+        }
+    }
+    for (const auto& p : worker.symDoms_) {
+        for (const auto& layer : p.second) {
+            if (layer.id_ < worker.local_->id_ || layer.id_ > worker.local_->last_)
+                continue;
+            symDoms_[p.first].push_back(layer);
+            scopeKeys_[layer.id_].syms_.push_back(p.first);
+        }
+    }
+
+    // The arguments, in order of appearance.
+    for (auto callee : worker.callees_) {
+        ExpressionAST* equiv = known.at(callee);
+        if (!funcs_.count(equiv))
+            callees_.push_back(equiv);
+        auto& data = funcs_[equiv];
+        const auto& workerData = worker.funcs_.at(callee);
+        if (data.size() < workerData.size())
+            data.resize(workerData.size());
+        for (auto idx = 0u; idx < workerData.size(); ++idx) {
+            data[idx].instances_.insert(data[idx].instances_.end(),
+                                        workerData[idx].instances_.begin(),
+                                        workerData[idx].instances_.end());
+        }
+    }
 
-            if (needUpdate) {
-                for (ExpressionAST* arg : argData.instances_) {
-                    resetCutoffScope();
-                    enforceLeastDomain(dom);
-                    visitExpression(arg);
-                }
+    // The domains outside of the function.
+    for (const auto& p : slots) {
+        const Domain& dom = p.second.second;
+        switch (std::get<0>(p.first)) {
+        case SharedAccess::Ast:
+            domainIn(astDoms_, &ScopeKeys::asts_,
+                     static_cast<const ExpressionAST*>(std::get<1>(p.first)),
+                     std::get<2>(p.first)) = dom;
+            break;
+        case SharedAccess::Symbol:
+            domainIn(symDoms_, &ScopeKeys::syms_,
+                     static_cast<const psyche::Symbol*>(std::get<1>(p.first)),
+                     std::get<2>(p.first)) = dom;
+            break;
+        default:
+            funcs_[static_cast<ExpressionAST*>(const_cast<void*>(std::get<1>(p.first)))]
+                    [std::get<3>(p.first)].dom_ = dom;
+            break;
+        }
+    }
+
+    lastDom_ = worker.lastDom_;
+
+    return true;
+}
+
+void DomainLattice::enqueue(const ArgumentKey& key)
+{
+    ArgumentData& argData = funcs_[key.first][key.second];
+    if (argData.queued_)
+        return;
+    argData.queued_ = true;
+    worklist_.push_back(key);
+}
+
+void DomainLattice::normalizeArguments()
+{
+    // The argument positions in which each (known) AST is an instance.
+    std::unordered_map<const ExpressionAST*, std::vector<ArgumentKey>> users;
+    for (auto callee : callees_) {
+        const auto& argsData = funcs_[callee];
+        for (auto idx = 0u; idx < argsData.size(); ++idx) {
+            for (const auto& inst : argsData[idx].instances_) {
+                if (auto equiv = isKnownAST(inst.ast_))
+                    users[equiv].push_back(ArgumentKey(callee, idx));
             }
+            enqueue(ArgumentKey(callee, idx));
         }
     }
+    stats_.argumentPositions_ = worklist_.size();
+
+    normalizing_ = true;
+    while (!worklist_.empty()) {
+        const ArgumentKey key = worklist_.front();
+        worklist_.pop_front();
+        ++stats_.iterations_;
+
+        ArgumentData& argData = funcs_[key.first][key.second];
+        argData.queued_ = false;
+
+        Domain dom = argData.dom_;
+        for (const auto& inst : argData.instances_) {
+            const Domain& argDom = retrieveDomain(inst.ast_, inst.scope_);
+            if (argDom > dom)
+                dom = argDom;
+        }
+        if (dom > argData.dom_) {
+            argData.dom_ = dom;
+            ++stats_.raisedPositions_;
+        }
+
+        // Only instances below the position's domain are recategorized.
+        for (const auto& inst : argData.instances_) {
+            if (!(dom > retrieveDomain(inst.ast_, inst.scope_)))
+                continue;
+
+            ++stats_.revisitedInstances_;
+            const Scope* prevScope = enterScope(inst.scope_);
+            resetCutoffScope();
+            enforceLeastDomain(dom);
+            visitExpression(inst.ast_);
+            enterScope(prevScope);
+        }
+
+        for (auto ast : raisedAsts_) {
+            auto it = users.find(ast);
+            if (it == users.end())
+                continue;
+            for (const auto& k : it->second)
+                enqueue(k);
+        }
+        raisedAsts_.clear();
+    }
+    normalizing_ = false;
 }
 
-const DomainLattice::DB* DomainLattice::searchDB(const Scope* scope) const
+void DomainLattice::numberScopes(const Scope* scope)
 {
-    PSYCHE_ASSERT(scope, return nullptr, "expected valid scope");
+    const unsigned id = scopeKeys_.size();
+    scopeKeys_.emplace_back();
+    for (auto i = 0u; i < scope->memberCount(); ++i) {
+        const Scope* nested = scope->memberAt(i)->asScope();
+        if (nested && nested->enclosingScope() == scope)
+            numberScopes(nested);
+    }
+    ranges_[scope] = ScopeRange { id, unsigned(scopeKeys_.size() - 1), true };
+}
 
-    auto it = index_.find(scope);
-    while (it == index_.end()) {
-        if (!scope->enclosingScope())
-            return nullptr;
-        return searchDB(scope->enclosingScope());
+const DomainLattice::ScopeRange& DomainLattice::rangeOf(const Scope* scope)
+{
+    if (const ScopeRange* range = findRange(scope))
+        return *range;
+
+    // A worker can't number scopes; its categorization is discarded.
+    if (main_) {
+        failed_ = true;
+        return *local_;
     }
-    return &it->second;
+
+    // A scope not reached from the global one encloses no other.
+    const unsigned id = scopeKeys_.size();
+    scopeKeys_.emplace_back();
+    return ranges_[scope] = ScopeRange { id, id, false };
 }
 
-DomainLattice::DB *DomainLattice::findOrCreateDB(const Scope *scope)
+const DomainLattice::ScopeRange* DomainLattice::findRange(const Scope* scope) const
 {
-    DB* db = nullptr;
-    auto it = index_.find(scope);
-    if (it == index_.end())
-        db = &index_[scope];
-    else
-        db = &it->second;
-    PSYCHE_ASSERT(db, return nullptr, "expected valid db");
+    if (main_)
+        return main_->findRange(scope);
 
-    return db;
+    auto it = ranges_.find(scope);
+    if (it == ranges_.end())
+        return nullptr;
+    return &it->second;
 }
 
-template <class T, class MapT>
+template <class T>
 DomainLattice::Domain DomainLattice::retrieveDomainCore(const T* v,
-                                                        const MapT DB::*m,
+                                                        const std::unordered_map<const T*, Layers>& m,
                                                         const psyche::Scope* scope) const
 {
+    auto it = m.find(v);
+    if (it == m.end())
+        return Undefined;
+    const Layers& layers = it->second;
+
+    const ScopeRange* range = findRange(scope);
+    if (range && range->nested_) {
+        const Layer* inner = nullptr;
+        for (const auto& layer : layers) {
+            if (layer.id_ <= range->id_
+                    && range->id_ <= layer.last_
+                    && (!inner || layer.id_ > inner->id_)) {
+                inner = &layer;
+            }
+        }
+        return inner ? inner->dom_ : Undefined;
+    }
+
     while (scope) {
-        if (const DB* db = searchDB(scope)) {
-            auto it = (db->*m).find(v);
-            if (it != (db->*m).end())
-                return it->second;
+        if (const ScopeRange* r = findRange(scope)) {
+            if (const Layer* layer = findLayer(layers, r->id_))
+                return layer->dom_;
         }
         scope = scope->enclosingScope();
     }
     return Undefined;
 }
 
+template <class T>
+DomainLattice::Domain& DomainLattice::domainIn(std::unordered_map<const T*, Layers>& m,
+                                               std::vector<const T*> ScopeKeys::* keys,
+                                               const T* v,
+                                               const psyche::Scope* scope)
+{
+    const ScopeRange& range = rangeOf(scope);
+    Layers& layers = m[v];
+    if (Layer* layer = findLayer(layers, range.id_))
+        return layer->dom_;
+
+    if (!main_)
+        (scopeKeys_[range.id_].*keys).push_back(v);
+    layers.push_back(Layer { range.id_, range.last_, Undefined });
+    return layers.back().dom_;
+}
+
 DomainLattice::Domain DomainLattice::retrieveDomain(const Symbol* sym, const Scope* scope) const
 {
-    return retrieveDomainCore(sym, &DB::second, scope);
+    return retrieveDomainCore(sym, symDoms_, scope);
 }
 
 DomainLattice::Domain DomainLattice::retrieveDomain(const ExpressionAST* ast, const Scope* scope) const
@@ -200,7 +549,15 @@ DomainLattice::Domain DomainLattice::retrieveDomain(const ExpressionAST* ast, co
     if (!equiv)
         return Undefined;
 
-    return retrieveDomainCore(equiv, &DB::first, scope);
+    return retrieveDomainCore(equiv, astDoms_, scope);
+}
+
+FullySpecifiedType DomainLattice::typeOf(ExpressionAST* ast, const Scope* scope) const
+{
+    std::unique_lock<std::mutex> guard;
+    if (lock_)
+        guard = std::unique_lock<std::mutex>(*lock_);
+    return typeof_.evaluate(ast, const_cast<Scope*>(scope));
 }
 
 DomainLattice::Domain DomainLattice::domainForType(const FullySpecifiedType& ty,
@@ -214,41 +571,41 @@ DomainLattice::Domain DomainLattice::domainForType(const FullySpecifiedType& ty,
     if (ty->asIntegerType()) {
         if (ty->asIntegerType()->kind() == IntegerType::Int) {
             debug("Symbol %s lookedup as integer\n");
-            return Domain(kIntegral, kIntTy);
+            return Domain(Domain::IntegralBits, IntTy);
         }
 
         if (ty->asIntegerType()->kind() == IntegerType::Bool) {
             debug("Symbol %s lookedup as boolean (taken as integer)\n");
-            return Domain(kIntegral, kIntTy);
+            return Domain(Domain::IntegralBits, IntTy);
         }
 
         if (ty->asIntegerType()->kind() == IntegerType::Char) {
             debug("Symbol %s looked as char\n");
-            return Domain(kIntegral, kCharTy);
+            return Domain(Domain::IntegralBits, CharTy);
         }
 
         if (ty->asIntegerType()->kind() == IntegerType::Short) {
             debug("Symbol %s looked as short\n");
-            return Domain(kIntegral, kShortTy);
+            return Domain(Domain::IntegralBits, ShortTy);
         }
 
         if (ty->asIntegerType()->kind() == IntegerType::Long) {
             debug("Symbol %s looked as long\n");
-            return Domain(kIntegral, kLongTy);
+            return Domain(Domain::IntegralBits, LongTy);
         }
 
         debug("Symbol %s looked as unknown integral\n");
-        return Domain(kIntegral, kIntTy);
+        return Domain(Domain::IntegralBits, IntTy);
     }
 
     if (ty->asFloatType()) {
         if (ty->asFloatType()->kind() == FloatType::Float) {
             debug("Symbol %s lookedup as float\n");
-            return Domain(kFloatingPoint, kFloatTy);
+            return Domain(Domain::FloatingPointBits, FloatTy);
         }
 
         debug("Symbol %s looked as double\n");
-        return Domain(kFloatingPoint, kDoubleTy);
+        return Domain(Domain::FloatingPointBits, DoubleTy);
     }
 
     if (ty->asPointerType() || ty->asArrayType()) {
@@ -262,13 +619,13 @@ DomainLattice::Domain DomainLattice::domainForType(const FullySpecifiedType& ty,
         // TODO: Compare char-by-char, matching at each substring.
         const Identifier* ident = ty->asNamedType()->name()->asNameId();
         return !strcmp(kSizeTy, ident->chars()) ?
-                    Domain(kIntegral, kSizeTy) :
+                    Domain(Domain::IntegralBits, SizeTy) :
                     !strcmp(kPtrDiffTy, ident->chars()) ?
-                        Domain(kIntegral, kPtrDiffTy) :
+                        Domain(Domain::IntegralBits, PtrDiffTy) :
                         !strcmp(kIntPtrTy, ident->chars()) ?
-                            Domain(kIntegral, kIntPtrTy) :
+                            Domain(Domain::IntegralBits, IntPtrTy) :
                             !strcmp(kUIntPtrTy, ident->chars()) ?
-                                Domain(kIntegral, kUIntPtrTy) : Undefined;
+                                Domain(Domain::IntegralBits, UIntPtrTy) : Undefined;
     }
 
     return Undefined;
@@ -291,15 +648,14 @@ void DomainLattice::assignDomain(ExpressionAST* ast)
     }
 
     if (checkTy) {
-        ExpressionTypeEvaluator exprType(translationUnit());
-        FullySpecifiedType ty = exprType.evaluate(ast, const_cast<Scope*>(scope_));
+        FullySpecifiedType ty = typeOf(ast, scope_);
 
         if (ty.isValid()) {
             auto dom = domainForType(ty, nullptr);
             if (dom > lastDom_) {
                 enforceLeastDomain(dom);
                 printDebug("Upgrade domain to %s, based on type information of AST <%s>\n",
-                           lastDom_.name_.c_str(), astText.c_str());
+                           lastDom_.name(), astText.c_str());
             }
         }
     }
@@ -314,11 +670,13 @@ void DomainLattice::assignDomain(ExpressionAST* ast)
             if (!symScope->encloses(cutoffScope_))
                 cutoffScope_ = symScope;
 
-            DB* db = findOrCreateDB(symScope);
-            if (lastDom_ > db->second[valSym]) {
+            if (isShared(symScope))
+                share(SharedAccess::Symbol, valSym, symScope, 0);
+            Domain& symDom = domainIn(symDoms_, &ScopeKeys::syms_, valSym, symScope);
+            if (lastDom_ > symDom) {
                 printDebug("Symbol %s (re)categorized as <%s>\n", valSym->name()->identifier()->chars(),
-                           lastDom_.name_.c_str());
-                db->second[valSym] = lastDom_;
+                           lastDom_.name());
+                symDom = lastDom_;
             }
         } else {
             resetCutoffScope();
@@ -327,29 +685,36 @@ void DomainLattice::assignDomain(ExpressionAST* ast)
 
     // The domain of an expression applies up to the least scope where the declaration
     // of a symbol involved in its subexpressions appears.
-    DB* db = findOrCreateDB(cutoffScope_);
-    if (auto equiv = isKnownAST(ast)) {
-        auto ait = db->first.find(equiv);
-        if (ait != db->first.end()) {
-            auto& astDom = ait->second;
+    ExpressionAST* equiv = isKnownAST(ast);
+    if (isShared(cutoffScope_))
+        share(SharedAccess::Ast, equiv ? equiv : ast, cutoffScope_, 0);
+    if (equiv) {
+        auto it = astDoms_.find(equiv);
+        Layer* layer = it != astDoms_.end() ? findLayer(it->second, rangeOf(cutoffScope_).id_) : nullptr;
+        if (layer) {
+            auto& astDom = layer->dom_;
             if (astDom > lastDom_) {
                 // Upgrade least domain
                 enforceLeastDomain(astDom);
             } else if (lastDom_ > astDom) {
                 // Update ast domain
                 printDebug("AST %s re-categorized as <%s>\n",
-                           astText.c_str(), lastDom_.name_.c_str());
+                           astText.c_str(), lastDom_.name());
                 astDom = lastDom_;
+                if (normalizing_)
+                    raisedAsts_.push_back(equiv);
             }
         } else {
             printDebug("AST %s categorized as <%s> in deeper scope\n",
-                       astText.c_str(), lastDom_.name_.c_str());
-            db->first[equiv] = lastDom_;
+                       astText.c_str(), lastDom_.name());
+            domainIn(astDoms_, &ScopeKeys::asts_, equiv, cutoffScope_) = lastDom_;
+            if (normalizing_)
+                raisedAsts_.push_back(equiv);
         }
     } else {
-        printDebug("New AST %s categorized as <%s>\n", astText.c_str(), lastDom_.name_.c_str());
+        printDebug("New AST %s categorized as <%s>\n", astText.c_str(), lastDom_.name());
         knownAsts_.push_back(ast);
-        db->first[ast] = lastDom_;
+        domainIn(astDoms_, &ScopeKeys::asts_, ast, cutoffScope_) = lastDom_;
     }
 }
 
@@ -537,18 +902,14 @@ bool DomainLattice::visit(BinaryExpressionAST* ast)
         } else if (lastDom_ == Pointer) {
             if (lhsDom == Scalar) {
                 enforceLeastDomain(isMinus ? Scalar : Pointer);
-            } else if (lhsDom == Arithmetic
-                            || lhsDom == Integral
-                            || lhsDom == FloatingPoint) {
+            } else if (lhsDom >= Arithmetic) {
                 enforceLeastDomain(Pointer);
             } else if (isMinus && lhsDom == Pointer) {
                 enforceLeastDomain(Integral);
             } else {
                 enforceLeastDomain(Scalar);
             }
-        } else if (lastDom_ == Arithmetic
-                        || lastDom_ == Integral
-                        || lastDom_ == FloatingPoint) {
+        } else if (lastDom_ >= Arithmetic) {
             if (lhsDom == Scalar || lhsDom == Pointer)
                 enforceLeastDomain(lhsDom);
         }
@@ -788,20 +1149,20 @@ bool DomainLattice::visit(NumericLiteralAST* ast)
     const Token& tk = tokenAt(ast->literal_token);
     if (tk.is(T_CHAR_LITERAL)) {
         // TODO: char/int
-        enforceLeastDomain(Domain(kIntegral, kCharTy));
+        enforceLeastDomain(Domain(Domain::IntegralBits, CharTy));
     } else {
         const NumericLiteral* numLit = numericLiteral(ast->literal_token);
         PSYCHE_ASSERT(numLit, return false, "numeric literal must exist");
         if (numLit->isDouble()) {
-            enforceLeastDomain(Domain(kFloatingPoint, kDoubleTy));
+            enforceLeastDomain(Domain(Domain::FloatingPointBits, DoubleTy));
         } else if (numLit->isFloat()) {
-            enforceLeastDomain(Domain(kFloatingPoint, kFloatTy));
+            enforceLeastDomain(Domain(Domain::FloatingPointBits, FloatTy));
         } else if (numLit->isLongDouble()) {
-            enforceLeastDomain(Domain(kFloatingPoint, kLongDoubleTy));
+            enforceLeastDomain(Domain(Domain::FloatingPointBits, LongDoubleTy));
         } else if (numLit->isLong()) {
-            enforceLeastDomain(Domain(kIntegral, kLongTy));
+            enforceLeastDomain(Domain(Domain::IntegralBits, LongTy));
         } else if (numLit->isLongLong()) {
-            enforceLeastDomain(Domain(kIntegral, kLongLongTy));
+            enforceLeastDomain(Domain(Domain::IntegralBits, LongLongTy));
         } else {
             if (!strcmp(numLit->chars(), kZero)) {
                 printDebug("Found null constant, 0, an integer or a pointer\n");
@@ -872,6 +1233,8 @@ bool DomainLattice::visit(CallAST* ast)
     ExpressionAST* equivalent = isKnownAST(ast->base_expression);
     if (equivalent == nullptr)
         equivalent = ast->base_expression;
+    if (!funcs_.count(equivalent))
+        callees_.push_back(equivalent);
     auto& data = funcs_[equivalent];
 
     // Ensure the argument data has the proper size. This must also account for variadic
@@ -895,8 +1258,8 @@ bool DomainLattice::visit(CallAST* ast)
 
     auto idx = 0u;
     for (ExpressionListAST* it = ast->expression_list; it; it = it->next, ++idx) {
-        data[idx].instances_.push_back(it->value);
-        data[idx].callScope_ = scope_; // TODO: Make this a call (not arg) data.
+        if (!normalizing_)
+            data[idx].instances_.push_back({ it->value, scope_ });
 
         auto paramDom = DomainLattice::Undefined;
         if (func) {
@@ -907,10 +1270,14 @@ bool DomainLattice::visit(CallAST* ast)
 
         enforceLeastDomain(paramDom);
         visitExpression(it->value);
+        if (main_)
+            share(SharedAccess::Argument, equivalent, nullptr, idx);
 
         // If a higher rank is reached, update the argument data.
         if (lastDom_ > data[idx].dom_) {
             data[idx].dom_ = lastDom_;
+            if (normalizing_)
+                enqueue(ArgumentKey(equivalent, idx));
         } else if (data[idx].dom_ > lastDom_) {
             lastDom_ = data[idx].dom_;
             visitExpression(it->value);
@@ -986,6 +1353,65 @@ bool DomainLattice::visit(SimpleDeclarationAST* ast)
     return false;
 }
 
+std::uint64_t DomainLattice::digest(const Scope* scope,
+                                    const std::unordered_set<const Identifier*>* ids) const
+{
+    const ScopeRange* range = findRange(scope);
+    if (!range)
+        return 0;
+
+    auto spelled = [this, ids] (const ExpressionAST* ast) {
+        if (!ids)
+            return true;
+        for (auto i = ast->firstToken(); i < ast->lastToken(); ++i) {
+            if (tokenKind(i) == T_IDENTIFIER && !ids->count(identifier(i)))
+                return false;
+        }
+        return true;
+    };
+
+    // Summed up, so the order of the entries doesn't matter.
+    auto text = [] (const Domain& dom) {
+        return std::string(dom.name()) + '\0' + (dom.typeName() ? dom.typeName() : "");
+    };
+    std::hash<std::string> hash;
+    std::uint64_t h = 0;
+    const ScopeKeys& keys = scopeKeys_[range->id_];
+    for (auto ast : keys.asts_) {
+        if (!spelled(ast))
+            continue;
+        const Domain& dom = findLayer(astDoms_.at(ast), range->id_)->dom_;
+        h += hash(fetchText(const_cast<ExpressionAST*>(ast)) + '\0' + text(dom));
+    }
+    for (auto sym : keys.syms_) {
+        const Identifier* id = sym->identifier();
+        if (ids && (!id || !ids->count(id)))
+            continue;
+        const Domain& dom = findLayer(symDoms_.at(sym), range->id_)->dom_;
+        h += hash((id ? std::string(id->chars(), id->size()) : std::string()) + '\1' + text(dom));
+    }
+    return h;
+}
+
+DomainLattice::Stats DomainLattice::stats() const
+{
+    Stats stats = stats_;
+    stats.scopes_ = scopeKeys_.size();
+    for (const auto& p : astDoms_)
+        stats.astLayers_ += p.second.size();
+    for (const auto& p : symDoms_)
+        stats.symbolLayers_ += p.second.size();
+
+    // Roughly: the entries, their layers, and the keys per scope.
+    const auto entries = astDoms_.size() + symDoms_.size();
+    const auto layers = stats.astLayers_ + stats.symbolLayers_;
+    stats.bytes_ = entries * (sizeof(AstMap::value_type) + sizeof(void*))
+            + layers * (sizeof(Layer) + sizeof(void*))
+            + ranges_.size() * (sizeof(decltype(ranges_)::value_type) + sizeof(void*))
+            + scopeKeys_.size() * sizeof(ScopeKeys);
+    return stats;
+}
+
 std::string DomainLattice::fetchText(AST* ast) const
 {
     const Token first = tokenAt(ast->firstToken());
@@ -1002,3 +1428,18 @@ std::string DomainLattice::fetchText(AST* ast) const
     }
     return s;
 }
+
+std::ostream& psyche::operator<<(std::ostream& os, const DomainLattice::Stats& s)
+{
+    os << "  Argument positions : " << s.argumentPositions_ << std::endl
+       << "  Fixpoint iterations: " << s.iterations_ << std::endl
+       << "  Positions raised   : " << s.raisedPositions_ << std::endl
+       << "  Instances revisited: " << s.revisitedInstances_ << std::endl
+       << "  Scopes             : " << s.scopes_ << std::endl
+       << "  AST layers         : " << s.astLayers_ << std::endl
+       << "  Symbol layers      : " << s.symbolLayers_ << std::endl
+       << "  Memory (bytes)     : " << s.bytes_ << std::endl
+       << "  Functions merged   : " << s.functionsMerged_ << std::endl
+       << "  Functions redone   : " << s.functionsRedone_;
+    return os;
+}
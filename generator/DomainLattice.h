@@ -22,10 +22,18 @@
 #include "ASTFwds.h"
 #include "ASTVisitor.h"
 #include "ASTIdentityMatcher.h"
+#include "ExpressionTypeEvaluator.h"
 #include "FrontendConfig.h"
+#include "FullySpecifiedType.h"
+#include <cstddef>
+#include <cstdint>
+#include <deque>
 #include <iostream>
+#include <mutex>
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
+#include <utility>
 #include <vector>
 
 namespace psyche {
@@ -40,26 +48,64 @@ public:
 
     void categorize(psyche::TranslationUnitAST* ast, psyche::Scope* global);
 
+    /*!
+     * \brief employThreads
+     * \param jobs
+     *
+     * Categorize each function definition apart, on one of the given number of
+     * threads, and merge the results in source order. A function whose
+     * categorization would have been affected by the domains of the preceding
+     * declarations is categorized again, sequentially, so the domains are the
+     * same as those of a sequential categorization.
+     */
+    void employThreads(unsigned jobs);
+
     /*!
      * \brief The domain
+     *
+     * Encoded as the set of itself and the domains below it (one bit each), so
+     * comparisons amount to bitwise operations. The concrete type, if known, is
+     * one of a few builtin ones, encoded by index.
      */
-    struct Domain
+    class Domain
     {
-        explicit Domain(const std::string& name = "undefined")
-            : name_(name)
-        {}
-
-        Domain(const std::string& name, const std::string& tyName)
-            : name_(name), ty_(tyName)
-        {}
-
-        bool operator>(const Domain& other) const;
-        bool operator>=(const Domain& other) const;
-        bool operator==(const Domain& other) const;
-        bool operator!=(const Domain& other) const;
-
-        std::string name_;
-        std::string ty_;
+    public:
+        constexpr Domain() : bits_(UndefinedBits), ty_(0) {}
+
+        bool operator>(const Domain& other) const
+        {
+            return bits_ != other.bits_ && *this >= other;
+        }
+        bool operator>=(const Domain& other) const
+        {
+            return (bits_ & other.bits_) == other.bits_;
+        }
+        bool operator==(const Domain& other) const { return bits_ == other.bits_; }
+        bool operator!=(const Domain& other) const { return bits_ != other.bits_; }
+
+        //! The name of the domain.
+        const char* name() const;
+
+        //! The concrete type of the domain, null if unknown.
+        const char* typeName() const;
+
+    private:
+        friend class DomainLattice;
+
+        enum Bits : std::uint8_t
+        {
+            UndefinedBits = 1 << 0,
+            ScalarBits = UndefinedBits | 1 << 1,
+            PointerBits = ScalarBits | 1 << 2,
+            ArithmeticBits = ScalarBits | 1 << 3,
+            IntegralBits = ArithmeticBits | 1 << 4,
+            FloatingPointBits = ArithmeticBits | 1 << 5
+        };
+
+        constexpr Domain(Bits bits, std::uint8_t ty) : bits_(bits), ty_(ty) {}
+
+        std::uint8_t bits_;
+        std::uint8_t ty_;
     };
 
     // The domains.
@@ -79,6 +125,16 @@ public:
     Domain retrieveDomain(const psyche::Symbol* sym, const psyche::Scope*) const;
     Domain retrieveDomain(const psyche::ExpressionAST* ast, const psyche::Scope*) const;
 
+    /*!
+     * \brief typeOf
+     * \return
+     *
+     * Return the type of the given AST, evaluated in the given scope. Types
+     * are memoized per unit, so an expression is typed once both during
+     * categorization and afterwards.
+     */
+    psyche::FullySpecifiedType typeOf(psyche::ExpressionAST* ast, const psyche::Scope* scope) const;
+
     /*!
      * \brief typeDomain
      * \param ty
@@ -89,9 +145,38 @@ public:
     static Domain domainForType(const psyche::FullySpecifiedType& ty,
                                 const psyche::Symbol* sym = nullptr);
 
+    /*!
+     * \brief digest
+     * \param scope
+     * \return
+     *
+     * Return a digest of the domains categorized within the given scope (but
+     * not within its nested ones), which is the same, across runs, for the same
+     * domains of ASTs and symbols spelled the same. If identifiers are given,
+     * only ASTs and symbols spelled with them alone are taken into account.
+     */
+    std::uint64_t digest(const psyche::Scope* scope,
+                         const std::unordered_set<const psyche::Identifier*>* ids = nullptr) const;
+
     // TEMP: Make this a utility.
     std::string fetchText(psyche::AST* ast) const;
 
+    struct Stats
+    {
+        std::size_t argumentPositions_ { 0 };
+        std::size_t iterations_ { 0 };
+        std::size_t raisedPositions_ { 0 };
+        std::size_t revisitedInstances_ { 0 };
+        std::size_t scopes_ { 0 };
+        std::size_t astLayers_ { 0 };
+        std::size_t symbolLayers_ { 0 };
+        std::size_t bytes_ { 0 };
+        std::size_t functionsMerged_ { 0 };
+        std::size_t functionsRedone_ { 0 };
+    };
+
+    Stats stats() const;
+
 private:
     // Declarations
     bool visit(psyche::SimpleDeclarationAST* ast) override;
@@ -144,14 +229,54 @@ private:
     std::vector<psyche::ExpressionAST*> knownAsts_;
     psyche::ExpressionAST* isKnownAST(const psyche::ExpressionAST*) const;
     mutable ASTIdentityMatcher matcher_;
+    mutable psyche::ExpressionTypeEvaluator typeof_;
 
-    using SymbolMap = std::unordered_map<const psyche::Symbol*, Domain>;
-    using AstMap = std::unordered_map<const psyche::ExpressionAST*, Domain>;
-    using DB = std::pair<AstMap, SymbolMap>;
-    std::unordered_map<const psyche::Scope*, DB> index_;
+    /*
+     * Scopes are numbered in pre-order, from the global one, so whether a scope
+     * encloses another is an interval test. The domains of an AST or symbol are
+     * kept in layers, one per scope in which it was categorized, and its domain
+     * within a scope is that of the innermost layer enclosing it.
+     */
+    struct ScopeRange
+    {
+        unsigned id_;
+        unsigned last_; //!< The highest id among the nested scopes.
+        bool nested_; //!< Numbered as a nested scope of the global one.
+    };
+    std::unordered_map<const psyche::Scope*, ScopeRange> ranges_;
+    void numberScopes(const psyche::Scope* scope);
+    const ScopeRange& rangeOf(const psyche::Scope* scope);
+    const ScopeRange* findRange(const psyche::Scope* scope) const;
 
-    template <class T, class MapT>
-    Domain retrieveDomainCore(const T* v, const MapT DB::*, const psyche::Scope*) const;
+    struct Layer
+    {
+        unsigned id_;
+        unsigned last_;
+        Domain dom_;
+    };
+    using Layers = std::vector<Layer>;
+    using SymbolMap = std::unordered_map<const psyche::Symbol*, Layers>;
+    using AstMap = std::unordered_map<const psyche::ExpressionAST*, Layers>;
+    AstMap astDoms_;
+    SymbolMap symDoms_;
+
+    // What was categorized within each scope, indexed by its number.
+    struct ScopeKeys
+    {
+        std::vector<const psyche::ExpressionAST*> asts_;
+        std::vector<const psyche::Symbol*> syms_;
+    };
+    std::vector<ScopeKeys> scopeKeys_;
+
+    template <class T>
+    Domain retrieveDomainCore(const T* v,
+                              const std::unordered_map<const T*, Layers>& m,
+                              const psyche::Scope* scope) const;
+    template <class T>
+    Domain& domainIn(std::unordered_map<const T*, Layers>& m,
+                     std::vector<const T*> ScopeKeys::* keys,
+                     const T* v,
+                     const psyche::Scope* scope);
 
     const Scope *enterScope(const psyche::Scope* scope);
     const psyche::Scope* scope_;
@@ -160,23 +285,76 @@ private:
     const psyche::Scope* globalScope_;
     const psyche::Scope* cutoffScope_;
 
-    const DB* searchDB(const psyche::Scope* scope) const;
-    DB* findOrCreateDB(const psyche::Scope* scope);
-
     // Function argument domains, taken from the call with highest rank.
+    struct ArgumentInstance
+    {
+        psyche::ExpressionAST* ast_;
+        const psyche::Scope* scope_; //!< Of the call.
+    };
+
     struct ArgumentData
     {
         Domain dom_;
-        std::vector<psyche::ExpressionAST*> instances_;
-        const psyche::Scope* callScope_; // TODO: This information is for call, not for arg.
+        std::vector<ArgumentInstance> instances_;
+        bool queued_ { false };
     };
 
     std::unordered_map<psyche::ExpressionAST*, std::vector<ArgumentData>> funcs_;
+    std::vector<psyche::ExpressionAST*> callees_; //!< In order of appearance.
+
+    /*
+     * Normalization of argument domains: a worklist fixpoint over (callee, argument
+     * position), in which a position is (re)visited when the domain of one of its
+     * instances (as a known AST) is raised, or when it's raised itself by a call.
+     */
+    using ArgumentKey = std::pair<psyche::ExpressionAST*, unsigned>;
+    void normalizeArguments();
+    void enqueue(const ArgumentKey& key);
+    std::deque<ArgumentKey> worklist_;
+    std::vector<const psyche::ExpressionAST*> raisedAsts_;
+    bool normalizing_;
+
+    /*
+     * Parallel categorization: a function is categorized apart by a worker,
+     * which keeps, in order, the domains it categorized for what lies outside
+     * the function (ASTs and symbols of enclosing scopes, and arguments). The
+     * function's categorization is merged if it's the same given the domains
+     * of the preceding declarations, which is the case when it enforces the
+     * same domains onto its expressions.
+     */
+    struct SharedAccess
+    {
+        enum Kind : std::uint8_t
+        {
+            Ast,
+            Symbol,
+            Argument
+        };
+        Kind kind_;
+        const void* key_;
+        const psyche::Scope* scope_;
+        unsigned idx_; //!< Of an argument.
+        Domain dom_;
+    };
+    void categorizeInParallel(psyche::TranslationUnitAST* ast);
+    bool isShared(const psyche::Scope* scope);
+    void share(SharedAccess::Kind kind, const void* key, const psyche::Scope* scope, unsigned idx);
+    bool merge(const DomainLattice& worker);
+    unsigned jobs_;
+    const DomainLattice* main_;
+    const ScopeRange* local_;
+    std::mutex* lock_;
+    bool failed_;
+    std::vector<SharedAccess> shared_;
+
+    Stats stats_;
 };
 
+std::ostream& operator<<(std::ostream& os, const DomainLattice::Stats& s);
+
 inline std::ostream& operator<<(std::ostream& os, const DomainLattice::Domain& h)
 {
-    os << h.name_;
+    os << h.name();
     return os;
 }
 
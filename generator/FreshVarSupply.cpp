@@ -21,29 +21,26 @@
 
 using namespace psyche;
 
-const std::string FreshVarSupply::typeVarPrefix_ = "#alpha";
-
 FreshVarSupply::FreshVarSupply()
     : typeVarCount_(0)
 {}
 
-std::string FreshVarSupply::createTypeVar1()
+TypeTerm FreshVarSupply::createTypeVar1()
 {
-    int count = ++typeVarCount_;
-    return typeVarPrefix_ + std::to_string(count);
+    return TypeTerm::var(++typeVarCount_);
 }
 
-std::tuple<std::string, std::string> FreshVarSupply::createTypeVar2()
+std::tuple<TypeTerm, TypeTerm> FreshVarSupply::createTypeVar2()
 {
     // Create the first one to make sure sequential ordering (remember
     // argument evaluation order in C++ is implementation-defined).
-    const std::string& alpha = createTypeVar1();
+    const TypeTerm alpha = createTypeVar1();
     return std::make_tuple(alpha, createTypeVar1());
 }
 
-std::tuple<std::string, std::string, std::string> FreshVarSupply::createTypeVar3()
+std::tuple<TypeTerm, TypeTerm, TypeTerm> FreshVarSupply::createTypeVar3()
 {
-    const std::string& alpha = createTypeVar1();
+    const TypeTerm alpha = createTypeVar1();
     return std::tuple_cat(std::make_tuple(alpha), createTypeVar2());
 }
 
@@ -51,3 +48,8 @@ void FreshVarSupply::resetCounter()
 {
     typeVarCount_ = 0;
 }
+
+void FreshVarSupply::skip(std::uint32_t cnt)
+{
+    typeVarCount_ += cnt;
+}
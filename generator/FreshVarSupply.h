@@ -20,7 +20,7 @@
 #ifndef PSYCHE_FRESHVARSUPPLY__
 #define PSYCHE_FRESHVARSUPPLY__
 
-#include <string>
+#include "TypeTerm.h"
 #include <tuple>
 
 namespace psyche {
@@ -28,22 +28,27 @@ namespace psyche {
 /*!
  * \brief The FreshVarSupply class
  *
- * Prefix, counter, and creation of type variables.
+ * Counter and creation of type variables.
  */
 class FreshVarSupply final
 {
 public:
     FreshVarSupply();
 
-    std::string createTypeVar1();
-    std::tuple<std::string, std::string> createTypeVar2();
-    std::tuple<std::string, std::string, std::string> createTypeVar3();
+    TypeTerm createTypeVar1();
+    std::tuple<TypeTerm, TypeTerm> createTypeVar2();
+    std::tuple<TypeTerm, TypeTerm, TypeTerm> createTypeVar3();
 
     void resetCounter();
 
+    //! Number of type variables created so far.
+    std::uint32_t count() const { return typeVarCount_; }
+
+    //! Take the given number of type variables as created.
+    void skip(std::uint32_t cnt);
+
 private:
-    int typeVarCount_;
-    static const std::string typeVarPrefix_;
+    std::uint32_t typeVarCount_;
 };
 
 } // namespace psyche
@@ -0,0 +1,320 @@
+/******************************************************************************
+ * Copyright (c) 2016 Leandro T. C. Melo (ltcmelo@gmail.com)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ * USA
+ *****************************************************************************/
+
+#include "TextConstraintReader.h"
+#include "ConstraintWriter.h"
+#include <cctype>
+#include <cstring>
+
+using namespace psyche;
+
+namespace {
+
+const char* const kTypeVarPrefix = "#alpha";
+
+} // anonymous
+
+TextConstraintReader::TextConstraintReader(const std::string& text)
+    : text_(text)
+    , pos_(0)
+    , terms_(nullptr)
+{}
+
+bool TextConstraintReader::fail(const char* reason)
+{
+    error_ = std::string(reason) + " at offset " + std::to_string(pos_);
+    return false;
+}
+
+bool TextConstraintReader::at(const char* s) const
+{
+    return !text_.compare(pos_, std::strlen(s), s);
+}
+
+bool TextConstraintReader::expect(const char* s)
+{
+    if (!at(s))
+        return false;
+    pos_ += std::strlen(s);
+    return true;
+}
+
+void TextConstraintReader::skipSeparators()
+{
+    // Separators and line breaks are written along with the constraints, so
+    // they're skipped; other spaces may belong to a type.
+    while (true) {
+        if (expect(", "))
+            continue;
+        if (!expect("\n"))
+            break;
+        while (expect(" ")) {}
+    }
+}
+
+std::size_t TextConstraintReader::scanType() const
+{
+    static const char* const kStops[] = { " = ", " > ", " $as$ ", " $in$ " };
+
+    int depth = 0;
+    auto i = pos_;
+    for (; i < text_.size(); ++i) {
+        const char c = text_[i];
+        if (depth == 0) {
+            if (c == ',' || c == ')' || c == ']' || c == '\n')
+                break;
+            bool stop = false;
+            for (const auto s : kStops) {
+                if (!text_.compare(i, std::strlen(s), s)) {
+                    stop = true;
+                    break;
+                }
+            }
+            if (stop)
+                break;
+        }
+        if (c == '(' || c == '{')
+            ++depth;
+        else if (c == ')' || c == '}')
+            --depth;
+    }
+    return i;
+}
+
+std::size_t TextConstraintReader::scanUntil(const char* s) const
+{
+    return text_.find(s, pos_);
+}
+
+std::size_t TextConstraintReader::scanParenthesized() const
+{
+    int depth = 0;
+    for (auto i = pos_; i < text_.size(); ++i) {
+        if (text_[i] == '(') {
+            ++depth;
+        } else if (text_[i] == ')') {
+            if (!depth)
+                return i;
+            --depth;
+        }
+    }
+    return std::string::npos;
+}
+
+bool TextConstraintReader::parenthesized(std::string& val)
+{
+    const auto end = scanParenthesized();
+    if (end == std::string::npos)
+        return false;
+    val = text_.substr(pos_, end - pos_);
+    pos_ = end + 1;
+    return true;
+}
+
+TypeTerm TextConstraintReader::termOf(std::size_t begin, std::size_t end)
+{
+    // Type variables within a type are kept apart from the surrounding names.
+    const auto prefixLen = std::strlen(kTypeVarPrefix);
+    TypeTerm ty;
+    bool first = true;
+    auto append = [&ty, &first, this] (TypeTerm piece) {
+        ty = first ? piece : terms_->seq(ty, piece);
+        first = false;
+    };
+
+    auto i = begin;
+    while (i < end) {
+        auto var = text_.find(kTypeVarPrefix, i);
+        auto digits = var + prefixLen;
+        if (var >= end
+                || digits >= end
+                || !std::isdigit(static_cast<unsigned char>(text_[digits]))) {
+            append(terms_->intern(text_.substr(i, end - i)));
+            return ty;
+        }
+        if (var > i)
+            append(terms_->intern(text_.substr(i, var - i)));
+
+        std::uint32_t n = 0;
+        auto j = digits;
+        for (; j < end && std::isdigit(static_cast<unsigned char>(text_[j])); ++j)
+            n = n * 10 + (text_[j] - '0');
+        append(TypeTerm::var(n));
+        i = j;
+    }
+
+    return first ? terms_->intern(std::string()) : ty;
+}
+
+bool TextConstraintReader::typeList(std::vector<TypeTerm>& tys)
+{
+    tys.clear();
+    while (true) {
+        const auto end = scanType();
+        tys.push_back(termOf(pos_, end));
+        pos_ = end;
+        if (!expect(", "))
+            break;
+    }
+    return expect(")");
+}
+
+bool TextConstraintReader::replay(ConstraintWriter* writer)
+{
+    terms_ = &writer->terms();
+    pos_ = 0;
+
+    std::vector<TypeTerm> tys;
+    std::string val;
+    while (true) {
+        skipSeparators();
+        if (pos_ == text_.size())
+            return true;
+
+        if (expect("[ ")) {
+            writer->openScope();
+            continue;
+        }
+
+        if (expect("]")) {
+            writer->closeScope();
+            continue;
+        }
+
+        if (expect("$exists$ ")) {
+            const auto end = scanUntil(". ");
+            if (end == std::string::npos)
+                return fail("unterminated existential");
+            writer->writeExists(termOf(pos_, end));
+            pos_ = end + 2;
+            continue;
+        }
+
+        if (expect("$typedef$ ")) {
+            const auto end = scanUntil(" $as$ ");
+            if (end == std::string::npos)
+                return fail("unterminated typedef");
+            const auto ty = termOf(pos_, end);
+            pos_ = end + 6;
+            const auto aliasEnd = scanType();
+            writer->writeTypedef(ty, termOf(pos_, aliasEnd));
+            pos_ = aliasEnd;
+            continue;
+        }
+
+        if (expect("$def$ ")) {
+            const auto nameEnd = scanUntil(" : ");
+            const auto end = scanUntil(" $in$ ");
+            if (nameEnd == std::string::npos || end == std::string::npos || nameEnd > end)
+                return fail("malformed declaration");
+            const auto name = text_.substr(pos_, nameEnd - pos_);
+            pos_ = nameEnd + 3;
+
+            // A function is written with its parameter and return types grouped.
+            const auto mark = pos_;
+            if (expect("(") && typeList(tys) && pos_ + 1 == end && text_[pos_] == ' ') {
+                const auto ret = tys.back();
+                tys.pop_back();
+                writer->writeFuncDecl(name, tys, ret);
+            } else {
+                pos_ = mark;
+                writer->writeVarDecl(name, termOf(pos_, end));
+            }
+            pos_ = end + 6;
+            expect(" ");
+            continue;
+        }
+
+        if (expect("$typeof$(")) {
+            if (!parenthesized(val))
+                return fail("unterminated typeof");
+            writer->beginSection();
+            writer->writeTypeof(val);
+            if (!expect(" = "))
+                return fail("expected ascription");
+            writer->writeEquivMark();
+            if (expect("(")) {
+                writer->enterGroup();
+                if (!typeList(tys))
+                    return fail("unterminated type group");
+                writer->writeTypesSection(tys);
+                writer->leaveGroup();
+            } else {
+                const auto tyEnd = scanType();
+                writer->writeTypeSection(termOf(pos_, tyEnd));
+                pos_ = tyEnd;
+            }
+            writer->endSection();
+            continue;
+        }
+
+        if (expect("$read_only$(")) {
+            if (!parenthesized(val))
+                return fail("unterminated constant expression");
+            writer->writeConstantExpression(val);
+            continue;
+        }
+
+        if (expect("$static$(")) {
+            if (!parenthesized(val))
+                return fail("unterminated static");
+            writer->writeStatic(val);
+            continue;
+        }
+
+        if (expect("$has$ (")) {
+            const auto baseEnd = scanType();
+            const auto baseTy = termOf(pos_, baseEnd);
+            pos_ = baseEnd;
+            if (!expect(", "))
+                return fail("malformed member");
+            const auto nameEnd = scanUntil(" : ");
+            if (nameEnd == std::string::npos)
+                return fail("malformed member");
+            const auto sym = text_.substr(pos_, nameEnd - pos_);
+            pos_ = nameEnd + 3;
+            const auto symEnd = scanType();
+            const auto symTy = termOf(pos_, symEnd);
+            pos_ = symEnd;
+            if (!expect(")"))
+                return fail("unterminated member");
+            writer->writeMemberRel(baseTy, sym, symTy);
+            continue;
+        }
+
+        // An equivalence or a subtyping.
+        const auto lhsEnd = scanType();
+        const auto lhs = termOf(pos_, lhsEnd);
+        pos_ = lhsEnd;
+        if (expect(" = ")) {
+            const auto rhsEnd = scanType();
+            if (rhsEnd > pos_ && text_[rhsEnd - 1] == '*')
+                writer->writePtrRel(lhs, termOf(pos_, rhsEnd - 1));
+            else
+                writer->writeEquivRel(lhs, termOf(pos_, rhsEnd));
+            pos_ = rhsEnd;
+        } else if (expect(" > ")) {
+            const auto rhsEnd = scanType();
+            writer->writeSubtypeRel(lhs, termOf(pos_, rhsEnd));
+            pos_ = rhsEnd;
+        } else {
+            return fail("unrecognized constraint");
+        }
+    }
+}
@@ -0,0 +1,81 @@
+/******************************************************************************
+ * Copyright (c) 2016 Leandro T. C. Melo (ltcmelo@gmail.com)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ * USA
+ *****************************************************************************/
+
+#ifndef PSYCHE_TEXTCONSTRAINTREADER_H__
+#define PSYCHE_TEXTCONSTRAINTREADER_H__
+
+#include "TypeTerm.h"
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace psyche {
+
+class ConstraintWriter;
+
+/*!
+ * \brief The TextConstraintReader class
+ *
+ * Read textual constraints, as written by the ConstraintWriter, and replay them
+ * through a writer. The text is split into the writer's calls that would have
+ * produced it, so replaying through the ConstraintWriter itself reproduces the
+ * text written by the generator; layout differences (e.g., in hand-written
+ * constraints) are not preserved.
+ */
+class TextConstraintReader final
+{
+public:
+    TextConstraintReader(const std::string& text);
+
+    /*!
+     * \brief replay
+     * \param writer
+     * \return
+     *
+     * Replay the constraints through the writer. On malformed input, stop and
+     * return false, with the reason available through error().
+     */
+    bool replay(ConstraintWriter* writer);
+
+    const std::string& error() const { return error_; }
+
+private:
+    bool fail(const char* reason);
+
+    bool at(const char* s) const;
+    bool expect(const char* s);
+    void skipSeparators();
+
+    std::size_t scanType() const;
+    std::size_t scanUntil(const char* s) const;
+    std::size_t scanParenthesized() const;
+    bool parenthesized(std::string& val);
+
+    TypeTerm termOf(std::size_t begin, std::size_t end);
+    bool typeList(std::vector<TypeTerm>& tys);
+
+    const std::string& text_;
+    std::size_t pos_;
+    TypeTermPool* terms_;
+    std::string error_;
+};
+
+} // namespace psyche
+
+#endif
@@ -0,0 +1,119 @@
+/******************************************************************************
+ * Copyright (c) 2016 Leandro T. C. Melo (ltcmelo@gmail.com)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ * USA
+ *****************************************************************************/
+
+#include "TypeTerm.h"
+#include <sstream>
+
+using namespace psyche;
+
+namespace {
+
+const char* const kTypeVarPrefix = "#alpha";
+const std::size_t kTypeVarPrefixLen = 6;
+
+} // anonymous
+
+TypeTermPool::TypeTermPool()
+{
+    intern(std::string());
+}
+
+TypeTerm TypeTermPool::intern(const std::string& name)
+{
+    auto it = ids_.find(name);
+    if (it != ids_.end())
+        return TypeTerm(it->second, TypeTerm::Name);
+
+    const auto id = static_cast<std::uint32_t>(names_.size());
+    it = ids_.emplace(name, id).first;
+    names_.push_back(&it->first);
+    return TypeTerm(id, TypeTerm::Name);
+}
+
+TypeTerm TypeTermPool::seq(TypeTerm first, TypeTerm second)
+{
+    const auto id = static_cast<std::uint32_t>(seqs_.size());
+    seqs_.emplace_back(first, second);
+    return TypeTerm(id, TypeTerm::Seq);
+}
+
+TypeTerm TypeTermPool::import(const TypeTermPool& other, TypeTerm ty)
+{
+    if (ty.isVar())
+        return ty;
+    if (ty.isName())
+        return intern(other.nameOf(ty));
+    return seq(import(other, other.seqOf(ty).first), import(other, other.seqOf(ty).second));
+}
+
+void TypeTermPool::write(std::ostream& os, TypeTerm ty) const
+{
+    switch (ty.bits_ & 3) {
+    case TypeTerm::Var:
+        os << kTypeVarPrefix << ty.index();
+        break;
+
+    case TypeTerm::Name:
+        os << nameOf(ty);
+        break;
+
+    default:
+        write(os, seqs_[ty.index()].first);
+        write(os, seqs_[ty.index()].second);
+        break;
+    }
+}
+
+void TypeTermPool::append(std::string& s, TypeTerm ty) const
+{
+    switch (ty.bits_ & 3) {
+    case TypeTerm::Var: {
+        char digits[10];
+        auto end = digits + sizeof(digits);
+        auto p = end;
+        auto n = ty.index();
+        do {
+            *--p = static_cast<char>('0' + n % 10);
+            n /= 10;
+        } while (n);
+        s.append(kTypeVarPrefix, kTypeVarPrefixLen);
+        s.append(p, end);
+        break;
+    }
+
+    case TypeTerm::Name:
+        s.append(nameOf(ty));
+        break;
+
+    default:
+        append(s, seqs_[ty.index()].first);
+        append(s, seqs_[ty.index()].second);
+        break;
+    }
+}
+
+std::string TypeTermPool::spell(TypeTerm ty) const
+{
+    if (ty.isName())
+        return nameOf(ty);
+
+    std::string s;
+    append(s, ty);
+    return s;
+}
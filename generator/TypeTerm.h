@@ -0,0 +1,114 @@
+/******************************************************************************
+ * Copyright (c) 2016 Leandro T. C. Melo (ltcmelo@gmail.com)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ * USA
+ *****************************************************************************/
+
+#ifndef PSYCHE_TYPETERM_H__
+#define PSYCHE_TYPETERM_H__
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace psyche {
+
+/*!
+ * \brief The TypeTerm class
+ *
+ * A compact handle to a type of the constraints: a type variable (identified by
+ * its number), an interned type name, or a structured term, both identified by
+ * their index in a TypeTermPool. Terms are only spelled when written.
+ */
+class TypeTerm final
+{
+public:
+    //! The empty type name.
+    TypeTerm() : bits_(Name) {}
+
+    static TypeTerm var(std::uint32_t n) { return TypeTerm((n << 2) | Var); }
+
+    bool isVar() const { return (bits_ & 3) == Var; }
+    bool isName() const { return (bits_ & 3) == Name; }
+    bool isSeq() const { return (bits_ & 3) == Seq; }
+
+    std::uint32_t index() const { return bits_ >> 2; }
+    std::uint32_t bits() const { return bits_; }
+
+    bool operator==(TypeTerm other) const { return bits_ == other.bits_; }
+    bool operator!=(TypeTerm other) const { return bits_ != other.bits_; }
+
+private:
+    friend class TypeTermPool;
+
+    enum Tag : std::uint32_t { Var = 0, Name = 1, Seq = 2 };
+
+    TypeTerm(std::uint32_t index, Tag tag) : bits_((index << 2) | tag) {}
+    explicit TypeTerm(std::uint32_t bits) : bits_(bits) {}
+
+    std::uint32_t bits_;
+};
+
+/*!
+ * \brief The TypeTermPool class
+ *
+ * Interns type names and keeps the arena of structured terms.
+ */
+class TypeTermPool final
+{
+public:
+    TypeTermPool();
+    TypeTermPool(const TypeTermPool&) = delete;
+    TypeTermPool& operator=(const TypeTermPool&) = delete;
+
+    TypeTerm intern(const std::string& name);
+
+    /*!
+     * \brief seq
+     *
+     * A term spelled as the juxtaposition of the given ones.
+     */
+    TypeTerm seq(TypeTerm first, TypeTerm second);
+
+    /*!
+     * \brief import
+     *
+     * The term, of another pool, as a term of this pool.
+     */
+    TypeTerm import(const TypeTermPool& other, TypeTerm ty);
+
+    //! Spelling of an interned name.
+    const std::string& nameOf(TypeTerm ty) const { return *names_[ty.index()]; }
+
+    //! Components of a structured term.
+    const std::pair<TypeTerm, TypeTerm>& seqOf(TypeTerm ty) const { return seqs_[ty.index()]; }
+
+    void write(std::ostream& os, TypeTerm ty) const;
+    void append(std::string& s, TypeTerm ty) const;
+    std::string spell(TypeTerm ty) const;
+
+private:
+    std::unordered_map<std::string, std::uint32_t> ids_;
+    std::vector<const std::string*> names_;
+    std::vector<std::pair<TypeTerm, TypeTerm>> seqs_;
+};
+
+} // namespace psyche
+
+#endif
@@ -0,0 +1,1025 @@
+/******************************************************************************
+ * Copyright (c) 2019 Leandro T. C. Melo (ltcmelo@gmail.com)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ * USA
+ *****************************************************************************/
+
+
+#include "ControlFlowGraph.h"
+#include "AST.h"
+#include "CoreTypes.h"
+#include "Literals.h"
+#include "Lookup.h"
+#include "PsycheAssert.h"
+#include "Scope.h"
+#include "Symbols.h"
+#include "TranslationUnit.h"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+
+using namespace psyche;
+
+namespace {
+
+const std::uint32_t kNone = ~0u;
+
+int mirrored(int relation)
+{
+    switch (relation) {
+    case T_LESS: return T_GREATER;
+    case T_LESS_EQUAL: return T_GREATER_EQUAL;
+    case T_GREATER: return T_LESS;
+    case T_GREATER_EQUAL: return T_LESS_EQUAL;
+    default: return relation;
+    }
+}
+
+int negated(int relation)
+{
+    switch (relation) {
+    case T_LESS: return T_GREATER_EQUAL;
+    case T_LESS_EQUAL: return T_GREATER;
+    case T_GREATER: return T_LESS_EQUAL;
+    case T_GREATER_EQUAL: return T_LESS;
+    case T_EQUAL_EQUAL: return T_EXCLAIM_EQUAL;
+    case T_EXCLAIM_EQUAL: return T_EQUAL_EQUAL;
+    default: return relation;
+    }
+}
+
+bool isRelational(int op)
+{
+    return op == T_LESS || op == T_LESS_EQUAL
+            || op == T_GREATER || op == T_GREATER_EQUAL
+            || op == T_EQUAL_EQUAL || op == T_EXCLAIM_EQUAL;
+}
+
+bool isAssignment(int op)
+{
+    switch (op) {
+    case T_EQUAL:
+    case T_PLUS_EQUAL:
+    case T_MINUS_EQUAL:
+    case T_STAR_EQUAL:
+    case T_SLASH_EQUAL:
+    case T_PERCENT_EQUAL:
+    case T_LESS_LESS_EQUAL:
+    case T_GREATER_GREATER_EQUAL:
+    case T_AMPER_EQUAL:
+    case T_PIPE_EQUAL:
+    case T_CARET_EQUAL:
+        return true;
+    default:
+        return false;
+    }
+}
+
+ExpressionAST* stripped(ExpressionAST* ast)
+{
+    while (ast && ast->asNestedExpression())
+        ast = ast->asNestedExpression()->expression;
+    return ast;
+}
+
+/*!
+ * \brief The StoreFinder class
+ *
+ * Whether an expression assigns to, or increments or decrements, anything.
+ */
+class StoreFinder final : public ASTVisitor
+{
+public:
+    StoreFinder(TranslationUnit* unit) : ASTVisitor(unit), found_(false) {}
+
+    bool find(ExpressionAST* ast)
+    {
+        found_ = false;
+        accept(ast);
+        return found_;
+    }
+
+private:
+    bool preVisit(AST* ast) override { return !found_ && !ast->asStatement(); }
+
+    bool visit(BinaryExpressionAST* ast) override
+    {
+        found_ = isAssignment(tokenKind(ast->binary_op_token));
+        return !found_;
+    }
+
+    bool visit(UnaryExpressionAST* ast) override
+    {
+        const int op = tokenKind(ast->unary_op_token);
+        found_ = op == T_PLUS_PLUS || op == T_MINUS_MINUS;
+        return !found_;
+    }
+
+    bool visit(PostIncrDecrAST*) override
+    {
+        found_ = true;
+        return false;
+    }
+
+    bool found_;
+};
+
+//! Width of an integer type.
+std::uint8_t width(IntegerType::Kind kind)
+{
+    switch (kind) {
+    case IntegerType::Bool: return 1;
+    case IntegerType::Char: return 8;
+    case IntegerType::Char16:
+    case IntegerType::Short: return 16;
+    case IntegerType::Char32:
+    case IntegerType::WideChar:
+    case IntegerType::Int: return 32;
+    default: return 64;
+    }
+}
+
+} // anonymous
+
+ControlFlowGraphBuilder::ControlFlowGraphBuilder(TranslationUnit* unit)
+    : ASTVisitor(unit)
+    , scope_(nullptr)
+    , cur_(ControlFlowGraph::Entry)
+    , ops_(nullptr)
+    , pure_(false)
+    , yielded_(nullptr)
+    , yieldedOp_(0)
+{}
+
+ControlFlowGraph ControlFlowGraphBuilder::build(FunctionDefinitionAST* ast)
+{
+    PSYCHE_ASSERT(ast && ast->symbol, return ControlFlowGraph(), "expected function");
+
+    graph_ = ControlFlowGraph();
+    graph_.func_ = ast->symbol;
+    newBlock(); // Entry
+    newBlock(); // Exit
+    labels_.clear();
+    variables_.clear();
+    addressTaken_.clear();
+    unsigned_.clear();
+
+    switchScope(ast->symbol);
+    cur_ = ControlFlowGraph::Entry;
+    accept(ast->function_body);
+    connect(cur_, ControlFlowGraph::Exit);
+
+    untrack();
+    order();
+
+    return std::move(graph_);
+}
+
+const Scope* ControlFlowGraphBuilder::switchScope(const Scope* scope)
+{
+    if (!scope)
+        return scope_;
+    std::swap(scope_, scope);
+    return scope;
+}
+
+std::uint32_t ControlFlowGraphBuilder::newBlock()
+{
+    graph_.blocks_.emplace_back();
+    return graph_.blocks_.size() - 1;
+}
+
+void ControlFlowGraphBuilder::connect(std::uint32_t from, std::uint32_t to)
+{
+    ControlFlowGraph::Edge edge;
+    edge.from_ = from;
+    edge.to_ = to;
+    graph_.edges_.push_back(std::move(edge));
+    const std::uint32_t idx = graph_.edges_.size() - 1;
+    graph_.blocks_[from].succs_.push_back(idx);
+    graph_.blocks_[to].preds_.push_back(idx);
+}
+
+void ControlFlowGraphBuilder::branch(std::uint32_t from,
+                                     std::uint32_t to,
+                                     ExpressionAST* cond,
+                                     bool holds)
+{
+    // A constant condition is never taken one of the ways.
+    bool truth;
+    if (constant(cond, truth) && truth != holds)
+        return;
+
+    connect(from, to);
+    if (cond) {
+        std::vector<Refinement> refinements;
+        refine(cond, holds, refinements);
+        graph_.edges_.back().refinements_ = std::move(refinements);
+    }
+}
+
+void ControlFlowGraphBuilder::enter(std::uint32_t block)
+{
+    cur_ = block;
+    ops_ = &graph_.blocks_[block].ops_;
+}
+
+void ControlFlowGraphBuilder::mark(StatementAST* ast)
+{
+    auto& block = graph_.blocks_[cur_];
+    block.marks_.emplace_back(block.ops_.size(), ast);
+}
+
+bool ControlFlowGraphBuilder::constant(ExpressionAST* ast, bool& truth)
+{
+    ast = stripped(ast);
+    NumericLiteralAST* lit = ast ? ast->asNumericLiteral() : nullptr;
+    if (!lit || tokenKind(lit->literal_token) != T_NUMERIC_LITERAL)
+        return false;
+
+    const NumericLiteral* numLit = numericLiteral(lit->literal_token);
+    PSYCHE_ASSERT(numLit, return false, "numeric literal must exist");
+
+    truth = std::strtod(numLit->chars(), nullptr) != 0;
+    return true;
+}
+
+std::uint32_t ControlFlowGraphBuilder::labelBlock(const Identifier* label)
+{
+    auto it = labels_.find(label);
+    if (it != labels_.end())
+        return it->second;
+    auto block = newBlock();
+    labels_.emplace(label, block);
+    return block;
+}
+
+void ControlFlowGraphBuilder::order()
+{
+    // A depth-first search from the entry: edges to blocks still on the
+    // stack close loops. Successors are taken last to first, so that a loop's
+    // body precedes its exit in reverse postorder, and a loop stabilizes
+    // before what follows it is visited.
+    enum : std::uint8_t { Unseen, Active, Done };
+    std::vector<std::uint8_t> state(graph_.blocks_.size(), Unseen);
+    std::vector<std::pair<std::uint32_t, std::size_t>> stack;
+    std::vector<std::uint32_t> post;
+
+    stack.emplace_back(ControlFlowGraph::Entry, 0);
+    state[ControlFlowGraph::Entry] = Active;
+    while (!stack.empty()) {
+        auto& top = stack.back();
+        const auto& succs = graph_.blocks_[top.first].succs_;
+        if (top.second == succs.size()) {
+            state[top.first] = Done;
+            post.push_back(top.first);
+            stack.pop_back();
+            continue;
+        }
+
+        auto& edge = graph_.edges_[succs[succs.size() - ++top.second]];
+        if (state[edge.to_] == Active) {
+            edge.back_ = true;
+            graph_.blocks_[edge.to_].loopHead_ = true;
+        } else if (state[edge.to_] == Unseen) {
+            state[edge.to_] = Active;
+            stack.emplace_back(edge.to_, 0);
+        }
+    }
+
+    graph_.order_.assign(post.rbegin(), post.rend());
+}
+
+void ControlFlowGraphBuilder::untrack()
+{
+    // A variable whose address is taken may change behind our back.
+    auto fix = [this] (std::vector<RangeOp>& ops) {
+        for (auto& op : ops) {
+            if (!op.symbol_ || !addressTaken_.count(op.symbol_))
+                continue;
+            if (op.code_ == RangeOp::Load)
+                op.code_ = RangeOp::Unbounded;
+            op.symbol_ = nullptr;
+        }
+    };
+
+    for (auto& block : graph_.blocks_)
+        fix(block.ops_);
+    for (auto& edge : graph_.edges_) {
+        auto& refinements = edge.refinements_;
+        refinements.erase(std::remove_if(refinements.begin(), refinements.end(),
+                                         [this] (const Refinement& r) {
+                                             return addressTaken_.count(r.symbol_);
+                                         }),
+                          refinements.end());
+        for (auto& refinement : refinements)
+            fix(refinement.ops_);
+    }
+
+    for (auto symbol : variables_) {
+        if (!addressTaken_.count(symbol))
+            graph_.variables_.push_back(symbol);
+    }
+    std::sort(graph_.variables_.begin(), graph_.variables_.end(),
+              [] (const Symbol* a, const Symbol* b) {
+                  return a->sourceLocation() < b->sourceLocation();
+              });
+}
+
+bool ControlFlowGraphBuilder::isVariable(const Symbol* symbol)
+{
+    if (!symbol
+            || !(symbol->isDeclaration() || symbol->isArgument())
+            || symbol->storage() == Symbol::Typedef
+            || symbol->enclosingFunction() != graph_.func_) {
+        return false;
+    }
+
+    const FullySpecifiedType ty = underlying(symbol);
+    if (ty->isEnumType())
+        return true;
+    if (ty->isIntegerType()) {
+        if (ty.isUnsigned() || ty->asIntegerType()->kind() == IntegerType::Bool)
+            unsigned_.emplace(symbol, width(ty->asIntegerType()->kind()));
+        return true;
+    }
+    if (ty.isUnsigned() && ty->isUndefinedType()) {
+        unsigned_.emplace(symbol, width(IntegerType::Int));
+        return true;
+    }
+    return false;
+}
+
+FullySpecifiedType ControlFlowGraphBuilder::underlying(const Symbol* symbol) const
+{
+    // Typedefs (and tags of enumerations) are followed to what they name; one
+    // that can't be, for it's missing or circular, is of no type we know.
+    constexpr int kMaxDepth = 16;
+
+    FullySpecifiedType ty = symbol->type();
+    const Scope* scope = symbol->enclosingScope();
+    for (auto depth = 0; ty->isNamedType(); ++depth) {
+        const Symbol* tySym = depth < kMaxDepth
+                ? lookupTypeSymbol(ty->asNamedType()->name(), scope)
+                : nullptr;
+        if (!tySym || !(tySym->isTypedef() || tySym->isEnum()))
+            return FullySpecifiedType();
+        ty = tySym->type();
+        scope = tySym->enclosingScope();
+    }
+    return ty;
+}
+
+const Symbol* ControlFlowGraphBuilder::variable(ExpressionAST* ast)
+{
+    ast = stripped(ast);
+    if (!ast || !ast->asIdExpression())
+        return nullptr;
+
+    NameAST* name = ast->asIdExpression()->name;
+    if (!name || !name->name || !name->name->asNameId())
+        return nullptr;
+
+    const Symbol* symbol = lookupValueSymbol(name->name, scope_);
+    if (!isVariable(symbol))
+        return nullptr;
+
+    variables_.insert(symbol);
+    return symbol;
+}
+
+void ControlFlowGraphBuilder::evaluate(ExpressionAST* ast)
+{
+    ops_ = &graph_.blocks_[cur_].ops_;
+    lower(ast);
+    ops_ = nullptr;
+}
+
+std::uint32_t ControlFlowGraphBuilder::lower(ExpressionAST* ast)
+{
+    yielded_ = nullptr;
+    accept(ast);
+    if (!ast || yielded_ != ast)
+        return emit(RangeOp(RangeOp::Unbounded));
+    return yieldedOp_;
+}
+
+std::uint32_t ControlFlowGraphBuilder::emit(const RangeOp& op)
+{
+    ops_->push_back(op);
+    return ops_->size() - 1;
+}
+
+void ControlFlowGraphBuilder::yield(ExpressionAST* ast, std::uint32_t op)
+{
+    yielded_ = ast;
+    yieldedOp_ = op;
+}
+
+std::uint32_t ControlFlowGraphBuilder::carried(std::uint32_t op, std::uint32_t block)
+{
+    // An operation of a block left behind, as an operand was lowered into
+    // blocks of its own, doesn't yield a range in the current one.
+    return block == cur_ ? op : emit(RangeOp(RangeOp::Unbounded));
+}
+
+std::uint32_t ControlFlowGraphBuilder::store(const Symbol* symbol, std::uint32_t value)
+{
+    if (pure_)
+        return value;
+
+    auto it = unsigned_.find(symbol);
+    if (it != unsigned_.end()) {
+        RangeOp wrap(RangeOp::Wrap, value);
+        wrap.number_ = it->second;
+        value = emit(wrap);
+    }
+
+    RangeOp op(RangeOp::Store, value);
+    op.symbol_ = symbol;
+    return emit(op);
+}
+
+bool ControlFlowGraphBuilder::stores(ExpressionAST* ast)
+{
+    return ast && StoreFinder(translationUnit()).find(ast);
+}
+
+void ControlFlowGraphBuilder::refine(ExpressionAST* ast,
+                                     bool holds,
+                                     std::vector<Refinement>& refinements)
+{
+    ast = stripped(ast);
+    if (!ast)
+        return;
+
+    if (UnaryExpressionAST* unary = ast->asUnaryExpression()) {
+        if (tokenKind(unary->unary_op_token) == T_EXCLAIM)
+            refine(unary->expression, !holds, refinements);
+        return;
+    }
+
+    // A variable by itself is compared against zero.
+    if (!holds) {
+        if (const Symbol* symbol = variable(ast)) {
+            Refinement refinement { symbol, T_EQUAL_EQUAL, {}, 0 };
+            refinement.ops_.push_back(RangeOp(RangeOp::Constant));
+            refinements.push_back(std::move(refinement));
+            return;
+        }
+    }
+
+    BinaryExpressionAST* binary = ast->asBinaryExpression();
+    if (!binary)
+        return;
+
+    const int op = tokenKind(binary->binary_op_token);
+    if (op == T_AMPER_AMPER || op == T_PIPE_PIPE) {
+        // Only when both operands are known to have held (or not), and the
+        // left one still does after the right one's stores.
+        if (holds == (op == T_AMPER_AMPER)) {
+            if (!stores(binary->right_expression))
+                refine(binary->left_expression, holds, refinements);
+            refine(binary->right_expression, holds, refinements);
+        }
+        return;
+    }
+
+    if (!isRelational(op))
+        return;
+
+    const int relation = holds ? op : negated(op);
+    auto add = [&] (const Symbol* symbol, int relation, ExpressionAST* other) {
+        Refinement refinement { symbol, relation, {}, 0 };
+        auto ops = ops_;
+        auto pure = pure_;
+        ops_ = &refinement.ops_;
+        pure_ = true;
+        refinement.value_ = lower(other);
+        ops_ = ops;
+        pure_ = pure;
+        refinements.push_back(std::move(refinement));
+    };
+    if (const Symbol* symbol = variable(binary->left_expression))
+        add(symbol, relation, binary->right_expression);
+    if (const Symbol* symbol = variable(binary->right_expression))
+        add(symbol, mirrored(relation), binary->left_expression);
+}
+
+bool ControlFlowGraphBuilder::preVisit(AST* ast)
+{
+    // Expressions are visited only while lowered, and statements only outside
+    // expressions (as in GNU's statement expressions, which we don't follow).
+    return ops_ ? !ast->asStatement() : !ast->asExpression();
+}
+
+    /* Expressions */
+
+bool ControlFlowGraphBuilder::visit(NumericLiteralAST* ast)
+{
+    if (tokenKind(ast->literal_token) != T_NUMERIC_LITERAL)
+        return false;
+
+    const NumericLiteral* numLit = numericLiteral(ast->literal_token);
+    PSYCHE_ASSERT(numLit, return false, "numeric literal must exist");
+
+    // We're interested only on natural numbers. In the case this literal
+    // is a floating-point, our interpretation is to truncate it.
+    char* end = nullptr;
+    RangeOp op(RangeOp::Constant);
+    op.number_ = std::strtoll(numLit->chars(), &end, 0);
+    if (*end == '.' || *end == 'e' || *end == 'E') {
+        // Clamped, since a conversion out of range is undefined.
+        const double number = std::strtod(numLit->chars(), nullptr);
+        if (number >= 9223372036854775807.0)
+            op.number_ = std::numeric_limits<int64_t>::max();
+        else if (number <= -9223372036854775808.0)
+            op.number_ = std::numeric_limits<int64_t>::min();
+        else
+            op.number_ = static_cast<int64_t>(number);
+    }
+    yield(ast, emit(op));
+    return false;
+}
+
+bool ControlFlowGraphBuilder::visit(IdExpressionAST* ast)
+{
+    const Symbol* symbol = variable(ast);
+    if (!symbol) {
+        yield(ast, emit(RangeOp(RangeOp::Unbounded)));
+        return false;
+    }
+
+    RangeOp op(RangeOp::Load);
+    op.symbol_ = symbol;
+    yield(ast, emit(op));
+    return false;
+}
+
+bool ControlFlowGraphBuilder::visit(NestedExpressionAST* ast)
+{
+    yield(ast, lower(ast->expression));
+    return false;
+}
+
+bool ControlFlowGraphBuilder::visit(CastExpressionAST* ast)
+{
+    yield(ast, lower(ast->expression));
+    return false;
+}
+
+bool ControlFlowGraphBuilder::visit(ConditionalExpressionAST* ast)
+{
+    lower(ast->condition);
+
+    // Alternatives without stores are taken into account in sequence.
+    if (pure_ || (!stores(ast->left_expression) && !stores(ast->right_expression))) {
+        auto a = lower(ast->left_expression);
+        auto b = lower(ast->right_expression);
+        yield(ast, emit(RangeOp(RangeOp::Hull, a, b)));
+        return false;
+    }
+
+    // Otherwise, each is lowered into blocks of its own, joined afterwards,
+    // so that only the stores of the one taken are seen.
+    const auto cond = cur_;
+    const auto left = newBlock();
+    const auto right = newBlock();
+    const auto join = newBlock();
+    branch(cond, left, ast->condition, true);
+    branch(cond, right, ast->condition, false);
+
+    enter(left);
+    lower(ast->left_expression);
+    connect(cur_, join);
+    enter(right);
+    lower(ast->right_expression);
+    connect(cur_, join);
+    enter(join);
+    yield(ast, emit(RangeOp(RangeOp::Unbounded)));
+    return false;
+}
+
+bool ControlFlowGraphBuilder::visit(BinaryExpressionAST* ast)
+{
+    const int op = tokenKind(ast->binary_op_token);
+
+    if (isAssignment(op)) {
+        const Symbol* symbol = variable(ast->left_expression);
+        auto lhs = lower(ast->left_expression);
+        const auto block = cur_;
+        auto rhs = lower(ast->right_expression);
+        lhs = carried(lhs, block);
+        if (!symbol) {
+            yield(ast, op == T_EQUAL ? rhs : emit(RangeOp(RangeOp::Unbounded)));
+            return false;
+        }
+
+        auto value = rhs;
+        if (op == T_PLUS_EQUAL)
+            value = emit(RangeOp(RangeOp::Add, lhs, rhs));
+        else if (op == T_MINUS_EQUAL)
+            value = emit(RangeOp(RangeOp::Subtract, lhs, rhs));
+        else if (op != T_EQUAL)
+            value = emit(RangeOp(RangeOp::Unbounded));
+        yield(ast, store(symbol, value));
+        return false;
+    }
+
+    // The right operand of a logical operator runs on one way out of the left
+    // one only; with stores, it's lowered into a block of its own.
+    if ((op == T_AMPER_AMPER || op == T_PIPE_PIPE)
+            && !pure_
+            && stores(ast->right_expression)) {
+        lower(ast->left_expression);
+        const auto cond = cur_;
+        const auto right = newBlock();
+        const auto join = newBlock();
+        branch(cond, right, ast->left_expression, op == T_AMPER_AMPER);
+        branch(cond, join, ast->left_expression, op == T_PIPE_PIPE);
+
+        enter(right);
+        lower(ast->right_expression);
+        connect(cur_, join);
+        enter(join);
+        yield(ast, emit(RangeOp(RangeOp::Boolean)));
+        return false;
+    }
+
+    auto lhs = lower(ast->left_expression);
+    const auto block = cur_;
+    auto rhs = lower(ast->right_expression);
+    lhs = carried(lhs, block);
+    switch (op) {
+    case T_PLUS:
+        yield(ast, emit(RangeOp(RangeOp::Add, lhs, rhs)));
+        break;
+
+    case T_MINUS:
+        yield(ast, emit(RangeOp(RangeOp::Subtract, lhs, rhs)));
+        break;
+
+    case T_COMMA:
+        yield(ast, rhs);
+        break;
+
+    case T_AMPER_AMPER:
+    case T_PIPE_PIPE:
+        yield(ast, emit(RangeOp(RangeOp::Boolean)));
+        break;
+
+    default:
+        yield(ast, emit(RangeOp(isRelational(op) ? RangeOp::Boolean : RangeOp::Unbounded)));
+        break;
+    }
+    return false;
+}
+
+bool ControlFlowGraphBuilder::visit(UnaryExpressionAST* ast)
+{
+    const int op = tokenKind(ast->unary_op_token);
+
+    if (op == T_AMPER) {
+        ExpressionAST* operand = stripped(ast->expression);
+        if (operand && operand->asIdExpression()) {
+            if (const Symbol* symbol = variable(operand))
+                addressTaken_.insert(symbol);
+        } else {
+            lower(ast->expression);
+        }
+        yield(ast, emit(RangeOp(RangeOp::Unbounded)));
+        return false;
+    }
+
+    if (op == T_PLUS_PLUS || op == T_MINUS_MINUS) {
+        const Symbol* symbol = variable(ast->expression);
+        auto old = lower(ast->expression);
+        if (!symbol) {
+            yield(ast, emit(RangeOp(RangeOp::Unbounded)));
+            return false;
+        }
+        RangeOp one(RangeOp::Constant);
+        one.number_ = 1;
+        auto value = emit(RangeOp(op == T_PLUS_PLUS ? RangeOp::Add : RangeOp::Subtract,
+                                  old, emit(one)));
+        yield(ast, store(symbol, value));
+        return false;
+    }
+
+    auto operand = lower(ast->expression);
+    switch (op) {
+    case T_PLUS:
+        yield(ast, operand);
+        break;
+
+    case T_MINUS:
+        yield(ast, emit(RangeOp(RangeOp::Negate, operand)));
+        break;
+
+    case T_EXCLAIM:
+        yield(ast, emit(RangeOp(RangeOp::Boolean)));
+        break;
+
+    default:
+        yield(ast, emit(RangeOp(RangeOp::Unbounded)));
+        break;
+    }
+    return false;
+}
+
+bool ControlFlowGraphBuilder::visit(PostIncrDecrAST* ast)
+{
+    const Symbol* symbol = variable(ast->base_expression);
+    auto old = lower(ast->base_expression);
+    if (!symbol) {
+        yield(ast, emit(RangeOp(RangeOp::Unbounded)));
+        return false;
+    }
+
+    RangeOp one(RangeOp::Constant);
+    one.number_ = 1;
+    const int op = tokenKind(ast->incr_decr_token);
+    auto value = emit(RangeOp(op == T_PLUS_PLUS ? RangeOp::Add : RangeOp::Subtract,
+                              old, emit(one)));
+    store(symbol, value);
+    yield(ast, old);
+    return false;
+}
+
+    /* Statements */
+
+bool ControlFlowGraphBuilder::visit(CompoundStatementAST* ast)
+{
+    const Scope* prevScope = switchScope(ast->symbol);
+    for (StatementListAST* it = ast->statement_list; it; it = it->next)
+        accept(it->value);
+    switchScope(prevScope);
+    return false;
+}
+
+bool ControlFlowGraphBuilder::visit(DeclarationStatementAST* ast)
+{
+    SimpleDeclarationAST* decl = ast->declaration ? ast->declaration->asSimpleDeclaration() : nullptr;
+    if (!decl)
+        return false;
+
+    mark(ast);
+    List<Symbol*>* symIt = decl->symbols;
+    for (DeclaratorListAST* it = decl->declarator_list; it; it = it->next) {
+        const Symbol* symbol = symIt ? symIt->value : nullptr;
+        if (symIt)
+            symIt = symIt->next;
+
+        ExpressionAST* init = it->value ? it->value->initializer : nullptr;
+        if (!isVariable(symbol)) {
+            if (init)
+                evaluate(init);
+            continue;
+        }
+
+        // Without an initializer, the variable may hold anything.
+        variables_.insert(symbol);
+        ops_ = &graph_.blocks_[cur_].ops_;
+        store(symbol, lower(init));
+        ops_ = nullptr;
+    }
+    return false;
+}
+
+bool ControlFlowGraphBuilder::visit(ExpressionStatementAST* ast)
+{
+    if (!ast->expression)
+        return false;
+
+    mark(ast);
+    evaluate(ast->expression);
+    return false;
+}
+
+bool ControlFlowGraphBuilder::visit(IfStatementAST* ast)
+{
+    const Scope* prevScope = switchScope(ast->symbol);
+
+    mark(ast);
+    evaluate(ast->condition);
+    const auto cond = cur_;
+    const auto join = newBlock();
+
+    cur_ = newBlock();
+    branch(cond, cur_, ast->condition, true);
+    accept(ast->statement);
+    connect(cur_, join);
+
+    if (ast->else_statement) {
+        cur_ = newBlock();
+        branch(cond, cur_, ast->condition, false);
+        accept(ast->else_statement);
+        connect(cur_, join);
+    } else {
+        branch(cond, join, ast->condition, false);
+    }
+    cur_ = join;
+
+    switchScope(prevScope);
+    return false;
+}
+
+bool ControlFlowGraphBuilder::visit(WhileStatementAST* ast)
+{
+    const Scope* prevScope = switchScope(ast->symbol);
+
+    // A `continue' goes through the latch, as does the end of the body, so
+    // that the head is entered from within the loop by a single edge.
+    const auto head = newBlock();
+    const auto latch = newBlock();
+    const auto exit = newBlock();
+    connect(cur_, head);
+    cur_ = head;
+    mark(ast);
+    evaluate(ast->condition);
+    const auto test = cur_;
+
+    cur_ = newBlock();
+    branch(test, cur_, ast->condition, true);
+    branch(test, exit, ast->condition, false);
+
+    breaks_.push_back(exit);
+    continues_.push_back(latch);
+    accept(ast->statement);
+    connect(cur_, latch);
+    breaks_.pop_back();
+    continues_.pop_back();
+
+    connect(latch, head);
+    cur_ = exit;
+
+    switchScope(prevScope);
+    return false;
+}
+
+bool ControlFlowGraphBuilder::visit(DoStatementAST* ast)
+{
+    const auto body = newBlock();
+    const auto cond = newBlock();
+    const auto exit = newBlock();
+    connect(cur_, body);
+    cur_ = body;
+    mark(ast);
+
+    breaks_.push_back(exit);
+    continues_.push_back(cond);
+    accept(ast->statement);
+    connect(cur_, cond);
+    breaks_.pop_back();
+    continues_.pop_back();
+
+    cur_ = cond;
+    evaluate(ast->expression);
+    branch(cur_, body, ast->expression, true);
+    branch(cur_, exit, ast->expression, false);
+    cur_ = exit;
+
+    return false;
+}
+
+bool ControlFlowGraphBuilder::visit(ForStatementAST* ast)
+{
+    const Scope* prevScope = switchScope(ast->symbol);
+
+    mark(ast);
+    accept(ast->initializer);
+
+    const auto head = newBlock();
+    const auto step = newBlock();
+    const auto exit = newBlock();
+    connect(cur_, head);
+    cur_ = head;
+    if (ast->condition)
+        evaluate(ast->condition);
+    const auto test = cur_;
+
+    cur_ = newBlock();
+    branch(test, cur_, ast->condition, true);
+    if (ast->condition)
+        branch(test, exit, ast->condition, false);
+
+    breaks_.push_back(exit);
+    continues_.push_back(step);
+    accept(ast->statement);
+    connect(cur_, step);
+    breaks_.pop_back();
+    continues_.pop_back();
+
+    cur_ = step;
+    if (ast->expression)
+        evaluate(ast->expression);
+    connect(step, head);
+    cur_ = exit;
+
+    switchScope(prevScope);
+    return false;
+}
+
+bool ControlFlowGraphBuilder::visit(SwitchStatementAST* ast)
+{
+    const Scope* prevScope = switchScope(ast->symbol);
+
+    mark(ast);
+    evaluate(ast->condition);
+
+    const auto exit = newBlock();
+    switches_.push_back(Switch { cur_, false });
+    breaks_.push_back(exit);
+    cur_ = newBlock();
+    accept(ast->statement);
+    connect(cur_, exit);
+    if (!switches_.back().default_)
+        connect(switches_.back().head_, exit);
+    breaks_.pop_back();
+    switches_.pop_back();
+    cur_ = exit;
+
+    switchScope(prevScope);
+    return false;
+}
+
+bool ControlFlowGraphBuilder::visit(CaseStatementAST* ast)
+{
+    const auto block = newBlock();
+    connect(cur_, block);
+    if (!switches_.empty())
+        connect(switches_.back().head_, block);
+    cur_ = block;
+    accept(ast->statement);
+    return false;
+}
+
+bool ControlFlowGraphBuilder::visit(LabeledStatementAST* ast)
+{
+    // In C dialects, `default' is lexed as an identifier.
+    const Identifier* label = identifier(ast->label_token);
+    std::uint32_t block;
+    if (tokenKind(ast->label_token) == T_DEFAULT
+            || (label && !std::strcmp(label->chars(), "default"))) {
+        block = newBlock();
+        if (!switches_.empty()) {
+            connect(switches_.back().head_, block);
+            switches_.back().default_ = true;
+        }
+    } else {
+        block = labelBlock(label);
+    }
+    connect(cur_, block);
+    cur_ = block;
+    accept(ast->statement);
+    return false;
+}
+
+bool ControlFlowGraphBuilder::visit(GotoStatementAST* ast)
+{
+    connect(cur_, labelBlock(identifier(ast->identifier_token)));
+    cur_ = newBlock();
+    return false;
+}
+
+bool ControlFlowGraphBuilder::visit(ReturnStatementAST* ast)
+{
+    mark(ast);
+    if (ast->expression)
+        evaluate(ast->expression);
+    connect(cur_, ControlFlowGraph::Exit);
+    cur_ = newBlock();
+    return false;
+}
+
+bool ControlFlowGraphBuilder::visit(BreakStatementAST* ast)
+{
+    if (!breaks_.empty()) {
+        connect(cur_, breaks_.back());
+        cur_ = newBlock();
+    }
+    return false;
+}
+
+bool ControlFlowGraphBuilder::visit(ContinueStatementAST* ast)
+{
+    if (!continues_.empty()) {
+        connect(cur_, continues_.back());
+        cur_ = newBlock();
+    }
+    return false;
+}
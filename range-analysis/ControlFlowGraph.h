@@ -0,0 +1,239 @@
+/******************************************************************************
+ * Copyright (c) 2019 Leandro T. C. Melo (ltcmelo@gmail.com)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ * USA
+ *****************************************************************************/
+
+
+#ifndef PSYCHE_CONTROL_FLOW_GRAPH_H__
+#define PSYCHE_CONTROL_FLOW_GRAPH_H__
+
+#include "ASTVisitor.h"
+#include "FullySpecifiedType.h"
+#include "Symbol.h"
+#include <cstdint>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace psyche {
+
+/*!
+ * \brief The RangeOp struct
+ *
+ * An operation of a range transfer function. Expressions are lowered into
+ * sequences of operations once, when the graph is built; each operation
+ * yields a range, referred to by the operation's index in its sequence.
+ */
+struct RangeOp
+{
+    enum Code : std::uint8_t
+    {
+        Constant,   //!< The number.
+        Unbounded,  //!< Any value.
+        Boolean,    //!< Either 0 or 1.
+        Load,       //!< The range of the symbol.
+        Store,      //!< Range `a' assigned to the symbol (if any).
+        Negate,     //!< Range `a' negated.
+        Add,        //!< Ranges `a' and `b' added.
+        Subtract,   //!< Range `b' subtracted from `a'.
+        Hull,       //!< The smallest range with both `a' and `b'.
+        Wrap        //!< Range `a' as an unsigned of the number's width.
+    };
+
+    RangeOp(Code code, std::uint32_t a = 0, std::uint32_t b = 0)
+        : code_(code), a_(a), b_(b), number_(0), symbol_(nullptr)
+    {}
+
+    Code code_;
+    std::uint32_t a_;
+    std::uint32_t b_;
+    int64_t number_;
+    const psyche::Symbol* symbol_;
+};
+
+/*!
+ * \brief The Refinement struct
+ *
+ * What the comparison of a variable implies about its range, on a branch.
+ */
+struct Refinement
+{
+    const psyche::Symbol* symbol_;
+    int relation_; //!< Token kind of the comparison, with the variable on the left.
+    std::vector<RangeOp> ops_; //!< Evaluate the other operand (without stores).
+    std::uint32_t value_; //!< The operation with the other operand's range.
+};
+
+/*!
+ * \brief The ControlFlowGraph class
+ *
+ * The control-flow graph of a function, for the range analysis.
+ */
+class ControlFlowGraph final
+{
+public:
+    enum : std::uint32_t
+    {
+        Entry,
+        Exit
+    };
+
+    struct Edge
+    {
+        std::uint32_t from_;
+        std::uint32_t to_;
+        std::vector<Refinement> refinements_; //!< Of the branch condition.
+        bool back_ { false }; //!< Whether it closes a loop.
+    };
+
+    struct Block
+    {
+        std::vector<RangeOp> ops_;
+        std::vector<std::pair<std::uint32_t, const psyche::StatementAST*>> marks_; //!< Where statements begin.
+        std::vector<std::uint32_t> succs_;
+        std::vector<std::uint32_t> preds_;
+        bool loopHead_ { false };
+    };
+
+    const psyche::Function* function() const { return func_; }
+    const std::vector<Block>& blocks() const { return blocks_; }
+    const std::vector<Edge>& edges() const { return edges_; }
+
+    //! Blocks reachable from the entry, in reverse postorder.
+    const std::vector<std::uint32_t>& order() const { return order_; }
+
+    //! Parameters and locals of integral type, whose addresses aren't taken.
+    const std::vector<const psyche::Symbol*>& variables() const { return variables_; }
+
+private:
+    friend class ControlFlowGraphBuilder;
+
+    const psyche::Function* func_ { nullptr };
+    std::vector<Block> blocks_;
+    std::vector<Edge> edges_;
+    std::vector<std::uint32_t> order_;
+    std::vector<const psyche::Symbol*> variables_;
+};
+
+/*!
+ * \brief The ControlFlowGraphBuilder class
+ */
+class ControlFlowGraphBuilder final : public psyche::ASTVisitor
+{
+public:
+    ControlFlowGraphBuilder(psyche::TranslationUnit* unit);
+
+    ControlFlowGraph build(psyche::FunctionDefinitionAST* ast);
+
+private:
+    std::uint32_t newBlock();
+    void connect(std::uint32_t from, std::uint32_t to);
+    void branch(std::uint32_t from, std::uint32_t to, psyche::ExpressionAST* cond, bool holds);
+    bool constant(psyche::ExpressionAST* ast, bool& truth);
+    void mark(psyche::StatementAST* ast);
+    std::uint32_t labelBlock(const psyche::Identifier* label);
+    void enter(std::uint32_t block);
+    void order();
+    void untrack();
+
+    const psyche::Scope* switchScope(const psyche::Scope* scope);
+    const psyche::Symbol* variable(psyche::ExpressionAST* ast);
+    bool isVariable(const psyche::Symbol* symbol);
+    psyche::FullySpecifiedType underlying(const psyche::Symbol* symbol) const;
+
+    //!@{
+    /*!
+     * Lowering of expressions.
+     */
+    void evaluate(psyche::ExpressionAST* ast);
+    std::uint32_t lower(psyche::ExpressionAST* ast);
+    std::uint32_t emit(const RangeOp& op);
+    void yield(psyche::ExpressionAST* ast, std::uint32_t op);
+    std::uint32_t carried(std::uint32_t op, std::uint32_t block);
+    std::uint32_t store(const psyche::Symbol* symbol, std::uint32_t value);
+    bool stores(psyche::ExpressionAST* ast);
+    void refine(psyche::ExpressionAST* ast, bool holds, std::vector<Refinement>& refinements);
+    //!@}
+
+    bool preVisit(psyche::AST* ast) override;
+
+    // Expressions
+    bool visit(psyche::BinaryExpressionAST* ast) override;
+    bool visit(psyche::CastExpressionAST* ast) override;
+    bool visit(psyche::ConditionalExpressionAST* ast) override;
+    bool visit(psyche::IdExpressionAST* ast) override;
+    bool visit(psyche::NestedExpressionAST* ast) override;
+    bool visit(psyche::NumericLiteralAST* ast) override;
+    bool visit(psyche::PostIncrDecrAST* ast) override;
+    bool visit(psyche::UnaryExpressionAST* ast) override;
+
+    // Statements
+    bool visit(psyche::BreakStatementAST* ast) override;
+    bool visit(psyche::CaseStatementAST* ast) override;
+    bool visit(psyche::CompoundStatementAST* ast) override;
+    bool visit(psyche::ContinueStatementAST* ast) override;
+    bool visit(psyche::DeclarationStatementAST* ast) override;
+    bool visit(psyche::DoStatementAST* ast) override;
+    bool visit(psyche::ExpressionStatementAST* ast) override;
+    bool visit(psyche::ForStatementAST* ast) override;
+    bool visit(psyche::GotoStatementAST* ast) override;
+    bool visit(psyche::IfStatementAST* ast) override;
+    bool visit(psyche::LabeledStatementAST* ast) override;
+    bool visit(psyche::ReturnStatementAST* ast) override;
+    bool visit(psyche::SwitchStatementAST* ast) override;
+    bool visit(psyche::WhileStatementAST* ast) override;
+
+    ControlFlowGraph graph_;
+
+    //! Scope we're in.
+    const psyche::Scope* scope_;
+
+    //! Block we're in (one without predecessors after a jump).
+    std::uint32_t cur_;
+
+    //! Operations being emitted, while lowering an expression.
+    std::vector<RangeOp>* ops_;
+
+    //! Whether stores are omitted, as for the operand of a refinement.
+    bool pure_;
+
+    //! The expression last lowered, and the operation with its range.
+    psyche::ExpressionAST* yielded_;
+    std::uint32_t yieldedOp_;
+
+    std::vector<std::uint32_t> breaks_;
+    std::vector<std::uint32_t> continues_;
+
+    struct Switch
+    {
+        std::uint32_t head_;
+        bool default_;
+    };
+    std::vector<Switch> switches_;
+
+    std::unordered_map<const psyche::Identifier*, std::uint32_t> labels_;
+    std::unordered_set<const psyche::Symbol*> variables_;
+    std::unordered_set<const psyche::Symbol*> addressTaken_;
+
+    //! Width of the variables of unsigned type.
+    std::unordered_map<const psyche::Symbol*, std::uint8_t> unsigned_;
+};
+
+} // namespace psyche
+
+#endif
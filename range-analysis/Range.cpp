@@ -17,77 +17,327 @@
  * USA
  *****************************************************************************/
 
+
 #include "Range.h"
 
+#include "Literals.h"
+#include "Names.h"
 #include "PsycheAssert.h"
 #include <algorithm>
 #include <functional>
+#include <limits>
+#include <utility>
 
 using namespace psyche;
 
-Range::Range(std::unique_ptr<AbstractValue> lower,
-             std::unique_ptr<AbstractValue> upper)
-    : lower_(std::move(lower))
-    , upper_(std::move(upper))
-{}
+namespace {
+
+const int64_t kMinInteger = std::numeric_limits<int64_t>::min();
 
-Range::Range(const Range &range)
-    : lower_(range.lower_->clone())
-    , upper_(range.upper_->clone())
-{}
+} // anonymous
+
+std::size_t ValueArena::ValueHash::operator()(const Value& value) const
+{
+    std::size_t h = std::hash<int>()(value.kind_);
+    auto mix = [&h] (std::size_t v) { h ^= v + 0x9e3779b9 + (h << 6) + (h >> 2); };
+    mix(std::hash<ValueId>()(value.a_));
+    mix(std::hash<ValueId>()(value.b_));
+    mix(std::hash<int64_t>()(value.number_));
+    mix(std::hash<const Symbol*>()(value.symbol_));
+    return h;
+}
 
-Range& Range::operator=(const Range& range)
+bool ValueArena::ValueEqual::operator()(const Value& a, const Value& b) const
 {
-    lower_ = range.lower_->clone();
-    upper_ = range.upper_->clone();
-    return *this;
+    return a.kind_ == b.kind_
+            && a.a_ == b.a_
+            && a.b_ == b.b_
+            && a.number_ == b.number_
+            && a.symbol_ == b.symbol_;
 }
 
-std::unique_ptr<AbstractValue> IntegerValue::clone() const
+ValueId ValueArena::intern(Kind kind,
+                           ValueId a,
+                           ValueId b,
+                           int64_t number,
+                           const Symbol* symbol)
 {
-    return std::make_unique<IntegerValue>(value_);
+    Value value { kind, a, b, number, symbol, Bound() };
+    auto it = index_.find(value);
+    if (it != index_.end())
+        return it->second;
+
+    switch (kind) {
+    case Integer:
+        value.bound_ = Bound(number);
+        break;
+
+    case Symbolic:
+    case MinusInfinity:
+    case PlusInfinity:
+        break;
+
+    case Negation:
+        if (values_[a].bound_.kind_ == Bound::Defined && values_[a].bound_.number_ != kMinInteger)
+            value.bound_ = Bound(-values_[a].bound_.number_);
+        break;
+
+    default: {
+        const Bound& x = values_[a].bound_;
+        const Bound& y = values_[b].bound_;
+        if (x.kind_ == Bound::Undefined || y.kind_ == Bound::Undefined)
+            break;
+        if (kind == Addition) {
+            // A sum that doesn't fit is left undefined.
+            int64_t number;
+            if (!__builtin_add_overflow(x.number_, y.number_, &number))
+                value.bound_ = Bound(number);
+        } else if (kind == Minimum)
+            value.bound_ = Bound(std::min(x.number_, y.number_));
+        else
+            value.bound_ = Bound(std::max(x.number_, y.number_));
+        break;
+    }
+    }
+
+    const ValueId id = values_.size();
+    values_.push_back(value);
+    index_.emplace(value, id);
+    return id;
 }
 
-std::unique_ptr<AbstractValue> SymbolValue::clone() const
+ValueId ValueArena::integer(int64_t value)
 {
-    return std::make_unique<SymbolValue>(symbol_);
+    return intern(Integer, 0, 0, value, nullptr);
 }
 
-AbstractValue::Bound SymbolValue::evaluate()
+ValueId ValueArena::symbol(const Symbol* symbol)
 {
-    // TODO: Lookup symbol.
-    return Bound();
+    return intern(Symbolic, 0, 0, 0, symbol);
 }
 
-CompositeValue::CompositeValue(std::unique_ptr<AbstractValue> a,
-                               std::unique_ptr<AbstractValue> b,
-                               Operation op)
-    : a_(std::move(a)), b_(std::move(b)), op_(op)
-{}
+ValueId ValueArena::minusInfinity()
+{
+    return intern(MinusInfinity, 0, 0, 0, nullptr);
+}
 
-std::unique_ptr<AbstractValue> CompositeValue::clone() const
+ValueId ValueArena::plusInfinity()
 {
-    return std::make_unique<CompositeValue>(a_->clone(), b_->clone(), op_);
+    return intern(PlusInfinity, 0, 0, 0, nullptr);
 }
 
-AbstractValue::Bound CompositeValue::evaluate()
+ValueId ValueArena::negation(ValueId a)
 {
-    const Bound& a = a_->evaluate();
-    const Bound& b = b_->evaluate();
-    auto check = a.kind_ == AbstractValue::Bound::Undefined
-            || b.kind_ == AbstractValue::Bound::Undefined;
-    switch (op_) {
+    switch (values_[a].kind_) {
+    case Integer:
+        // The negation of the least integer doesn't fit, it saturates.
+        if (values_[a].number_ == kMinInteger)
+            return plusInfinity();
+        return integer(-values_[a].number_);
+
+    case MinusInfinity:
+        return plusInfinity();
+
+    case PlusInfinity:
+        return minusInfinity();
+
+    case Negation:
+        return values_[a].a_;
+
     case Addition:
-        return check ? Bound() : Bound(a.number_ + b.number_);
+        if (values_[values_[a].b_].kind_ == Integer && values_[values_[a].b_].number_ != kMinInteger)
+            return addition(negation(values_[a].a_), negation(values_[a].b_));
+        break;
 
-    case Minimum:
-        return check ? Bound() : Bound(std::min(a.number_, b.number_));
+    default:
+        break;
+    }
+    return intern(Negation, a, 0, 0, nullptr);
+}
+
+ValueId ValueArena::subtraction(ValueId a, ValueId b)
+{
+    if (a == b && values_[a].kind_ != MinusInfinity && values_[a].kind_ != PlusInfinity)
+        return integer(0);
 
+    // Subtracting the least integer is adding its (unrepresentable) negation
+    // in two steps.
+    if (values_[b].kind_ == Integer && values_[b].number_ == kMinInteger)
+        return addition(addition(a, integer(std::numeric_limits<int64_t>::max())), integer(1));
+
+    return addition(a, negation(b));
+}
+
+ValueId ValueArena::addition(ValueId a, ValueId b)
+{
+    // An infinity absorbs whatever is added to it (adding opposite infinities
+    // doesn't happen on the bound of a range).
+    if (values_[a].kind_ == MinusInfinity || values_[a].kind_ == PlusInfinity)
+        return a;
+    if (values_[b].kind_ == MinusInfinity || values_[b].kind_ == PlusInfinity)
+        return b;
+
+    // Keep the constant on the right, so that (x + c1) + c2 folds into x + (c1 + c2).
+    if (values_[a].kind_ == Integer)
+        std::swap(a, b);
+    if (values_[b].kind_ == Integer) {
+        const int64_t c = values_[b].number_;
+        if (!c)
+            return a;
+
+        // A sum of constants that doesn't fit saturates; one that would only
+        // be reassociated is kept as it is.
+        int64_t sum;
+        if (values_[a].kind_ == Integer) {
+            if (__builtin_add_overflow(values_[a].number_, c, &sum))
+                return c > 0 ? plusInfinity() : minusInfinity();
+            return integer(sum);
+        }
+        if (values_[a].kind_ == Addition
+                && values_[values_[a].b_].kind_ == Integer
+                && !__builtin_add_overflow(values_[values_[a].b_].number_, c, &sum)) {
+            return addition(values_[a].a_, integer(sum));
+        }
+    }
+    return combine(Addition, a, b);
+}
+
+ValueId ValueArena::minimum(ValueId a, ValueId b)
+{
+    if (values_[a].kind_ == MinusInfinity || values_[b].kind_ == PlusInfinity)
+        return a;
+    if (values_[b].kind_ == MinusInfinity || values_[a].kind_ == PlusInfinity)
+        return b;
+    if (values_[a].kind_ == Integer && values_[b].kind_ == Integer)
+        return values_[a].number_ <= values_[b].number_ ? a : b;
+    return combine(Minimum, a, b);
+}
+
+ValueId ValueArena::maximum(ValueId a, ValueId b)
+{
+    if (values_[a].kind_ == PlusInfinity || values_[b].kind_ == MinusInfinity)
+        return a;
+    if (values_[b].kind_ == PlusInfinity || values_[a].kind_ == MinusInfinity)
+        return b;
+    if (values_[a].kind_ == Integer && values_[b].kind_ == Integer)
+        return values_[a].number_ >= values_[b].number_ ? a : b;
+    return combine(Maximum, a, b);
+}
+
+ValueId ValueArena::combine(Kind kind, ValueId a, ValueId b)
+{
+    PSYCHE_ASSERT(kind == Addition || kind == Minimum || kind == Maximum,
+                  return a, "expected composite kind");
+
+    if (a == b && kind != Addition)
+        return a;
+
+    // Absorption: min(a, max(a, x)) is a, and min(a, min(a, x)) is min(a, x).
+    if (kind != Addition) {
+        auto absorbs = [this, kind] (ValueId a, ValueId b) {
+            const Value& value = values_[b];
+            return (value.kind_ == Minimum || value.kind_ == Maximum)
+                    && (value.a_ == a || value.b_ == a);
+        };
+        if (absorbs(a, b))
+            return values_[b].kind_ == kind ? b : a;
+        if (absorbs(b, a))
+            return values_[a].kind_ == kind ? a : b;
+
+        // Constants are gathered: min(1, min(2, x)) is min(1, x).
+        if (values_[b].kind_ == Integer)
+            std::swap(a, b);
+        if (values_[a].kind_ == Integer && values_[b].kind_ == kind) {
+            const Value inner = values_[b];
+            if (values_[inner.a_].kind_ == Integer || values_[inner.b_].kind_ == Integer) {
+                const auto c = values_[inner.a_].kind_ == Integer ? inner.a_ : inner.b_;
+                const auto x = c == inner.a_ ? inner.b_ : inner.a_;
+                const auto k = kind == Minimum ? minimum(a, c) : maximum(a, c);
+                return kind == Minimum ? minimum(k, x) : maximum(k, x);
+            }
+        }
+    }
+
+    // The operations are commutative (but a constant addend stays on the right).
+    if (a > b && !(kind == Addition && values_[b].kind_ == Integer))
+        std::swap(a, b);
+    return intern(kind, a, b, 0, nullptr);
+}
+
+void ValueArena::print(std::ostream& os, const Range& range) const
+{
+    os << "[";
+    print(os, range.lower());
+    os << ", ";
+    print(os, range.upper());
+    os << "]";
+}
+
+void ValueArena::print(std::ostream& os, ValueId id) const
+{
+    const Value& value = values_[id];
+    if (value.bound_.kind_ == Bound::Defined) {
+        os << value.bound_.number_;
+        return;
+    }
+
+    switch (value.kind_) {
+    case Symbolic:
+        if (value.symbol_->name() && value.symbol_->name()->asNameId())
+            os << value.symbol_->name()->asNameId()->identifier()->chars();
+        else
+            os << "<anonymous>";
+        break;
+
+    case MinusInfinity:
+        os << -std::numeric_limits<double>::infinity();
+        break;
+
+    case PlusInfinity:
+        os << "+" << std::numeric_limits<double>::infinity();
+        break;
+
+    case Negation: {
+        const auto kind = values_[value.a_].kind_;
+        os << "-";
+        if (kind == Addition)
+            os << "(";
+        print(os, value.a_);
+        if (kind == Addition)
+            os << ")";
+        break;
+    }
+
+    case Addition:
+        print(os, value.a_);
+        if (values_[value.b_].kind_ == Integer
+                && values_[value.b_].number_ < 0
+                && values_[value.b_].number_ != kMinInteger) {
+            os << " - " << -values_[value.b_].number_;
+        } else if (values_[value.b_].kind_ == Negation) {
+            const auto negated = values_[value.b_].a_;
+            const bool nested = values_[negated].kind_ == Addition;
+            os << (nested ? " - (" : " - ");
+            print(os, negated);
+            if (nested)
+                os << ")";
+        } else {
+            os << " + ";
+            print(os, value.b_);
+        }
+        break;
+
+    case Minimum:
     case Maximum:
-        return check ? Bound() : Bound(std::max(a.number_, b.number_));
+        os << (value.kind_ == Minimum ? "min(" : "max(");
+        print(os, value.a_);
+        os << ", ";
+        print(os, value.b_);
+        os << ")";
+        break;
 
     default:
-        PSYCHE_ASSERT(false, return Bound(), "invalid enumerator");
-        return Bound();
+        PSYCHE_ASSERT(false, return, "integers are always defined");
+        break;
     }
 }
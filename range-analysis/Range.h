@@ -17,135 +17,137 @@
  * USA
  *****************************************************************************/
 
+
 #ifndef PSYCHE_RANGE_H__
 #define PSYCHE_RANGE_H__
 
 #include "Symbol.h"
 #include <cstdint>
 #include <iostream>
-#include <limits>
-#include <memory>
-#include <utility>
+#include <unordered_map>
+#include <vector>
 
 namespace psyche {
 
-class AbstractValue;
+//! Handle to a bound expression in a ValueArena.
+using ValueId = std::uint32_t;
 
 /*!
  * \brief The Range class
+ *
+ * A range is a pair of handles, so copying it is trivial.
  */
 class Range final
 {
 public:
-    Range(std::unique_ptr<AbstractValue> lower,
-          std::unique_ptr<AbstractValue> upper);
-    Range(const Range&);
-    Range(Range&&) = default;
-    Range& operator=(const Range&);
-    Range& operator=(Range&&) = default;
+    Range(ValueId lower, ValueId upper)
+        : lower_(lower), upper_(upper)
+    {}
 
-    friend std::ostream& operator<<(std::ostream& os, const Range& range);
+    ValueId lower() const { return lower_; }
+    ValueId upper() const { return upper_; }
 
-private:
-    friend class RangeAnalysis;
+    bool operator==(const Range& other) const
+    {
+        return lower_ == other.lower_ && upper_ == other.upper_;
+    }
+    bool operator!=(const Range& other) const { return !(*this == other); }
 
-    std::unique_ptr<AbstractValue> lower_;
-    std::unique_ptr<AbstractValue> upper_;
+private:
+    ValueId lower_;
+    ValueId upper_;
 };
 
 /*!
- * \brief The AbstractValue class
+ * \brief The ValueArena class
+ *
+ * An arena of immutable bound expressions (constants, symbols, infinities,
+ * negations, additions, minimums and maximums). Expressions are hash-consed,
+ * so structurally equal ones share a handle, constants are folded on
+ * construction, and the bound of each expression is evaluated once, when it's
+ * created.
  */
-class AbstractValue
+class ValueArena final
 {
 public:
-    virtual ~AbstractValue() = default;
-    virtual std::unique_ptr<AbstractValue> clone() const = 0;
+    enum Kind : std::uint8_t
+    {
+        Integer,
+        Symbolic,
+        MinusInfinity,
+        PlusInfinity,
+        Negation,
+        Addition,
+        Minimum,
+        Maximum
+    };
 
     struct Bound
     {
         enum Kind : uint8_t { Defined, Undefined };
-        Bound() : kind_(Undefined) {}
+        Bound() : kind_(Undefined), number_(0) {}
         Bound(int64_t number) : kind_(Defined), number_(number) {}
         Kind kind_;
         int64_t number_;
     };
 
-    virtual Bound evaluate() = 0;
+    ValueArena() = default;
+    ValueArena(const ValueArena&) = delete;
+    ValueArena& operator=(const ValueArena&) = delete;
 
-protected:
-    AbstractValue() = default;
-};
+    ValueId integer(int64_t value);
+    ValueId symbol(const psyche::Symbol* symbol);
+    ValueId minusInfinity();
+    ValueId plusInfinity();
+    ValueId negation(ValueId a);
+    ValueId addition(ValueId a, ValueId b);
+    ValueId subtraction(ValueId a, ValueId b);
+    ValueId minimum(ValueId a, ValueId b);
+    ValueId maximum(ValueId a, ValueId b);
 
-class IntegerValue final : public AbstractValue
-{
-public:
-    IntegerValue(int64_t value)
-        : value_(value)
-    {}
-
-    std::unique_ptr<AbstractValue> clone() const override;
-    Bound evaluate() override { return Bound(value_); }
+    //! The range of any value.
+    Range unbounded() { return Range(minusInfinity(), plusInfinity()); }
 
-private:
-    int64_t value_;
-};
+    Kind kind(ValueId id) const { return values_[id].kind_; }
+    Bound evaluate(ValueId id) const { return values_[id].bound_; }
 
-class SymbolValue final : public AbstractValue
-{
-public:
-    SymbolValue(const psyche::Symbol* symbol)
-        : symbol_(symbol)
-    {}
+    std::size_t size() const { return values_.size(); }
 
-    std::unique_ptr<AbstractValue> clone() const override;
-    Bound evaluate() override;
+    /*!
+     * Print a range, with a bound that doesn't evaluate to a number written
+     * as the expression it is (in terms of symbols).
+     */
+    void print(std::ostream& os, const Range& range) const;
 
 private:
-    const psyche::Symbol* symbol_;
-};
+    void print(std::ostream& os, ValueId id) const;
 
-class CompositeValue final : public AbstractValue
-{
-public:
-    enum Operation : std::uint8_t
+    struct Value
     {
-        Addition,
-        Minimum,
-        Maximum
+        Kind kind_;
+        ValueId a_;
+        ValueId b_;
+        int64_t number_;
+        const psyche::Symbol* symbol_;
+        Bound bound_;
     };
 
-    CompositeValue(std::unique_ptr<AbstractValue> a,
-                   std::unique_ptr<AbstractValue> b,
-                   Operation op);
+    struct ValueHash
+    {
+        std::size_t operator()(const Value& value) const;
+    };
+    struct ValueEqual
+    {
+        bool operator()(const Value& a, const Value& b) const;
+    };
 
-    std::unique_ptr<AbstractValue> clone() const override;
-    Bound evaluate() override;
+    ValueId intern(Kind kind, ValueId a, ValueId b, int64_t number, const psyche::Symbol* symbol);
+    ValueId combine(Kind kind, ValueId a, ValueId b);
 
-private:
-    std::unique_ptr<AbstractValue> a_;
-    std::unique_ptr<AbstractValue> b_;
-    Operation op_;
+    std::vector<Value> values_;
+    std::unordered_map<Value, ValueId, ValueHash, ValueEqual> index_;
 };
 
-inline std::ostream& operator<<(std::ostream& os, const Range& range)
-{
-    const auto& l = range.lower_->evaluate();
-    const auto& u = range.upper_->evaluate();
-    auto show = [&os] (const AbstractValue::Bound& bound, char sign) {
-        if (bound.kind_ == AbstractValue::Bound::Undefined)
-            os << sign << std::numeric_limits<double>::infinity();
-        else
-            os << bound.number_;
-    };
-    os << "[";
-    show(l, '-');
-    os << ", ";
-    show(u, '+');
-    os << "]";
-    return os;
-}
-
 } // namespace psyche
 
 #endif
@@ -17,178 +17,655 @@
  * USA
  *****************************************************************************/
 
+
 #include "RangeAnalysis.h"
 #include "AST.h"
-#include "PsycheAssert.h"
+#include "ControlFlowGraph.h"
 #include "Literals.h"
-#include "Lookup.h"
-#include "Scope.h"
+#include "Names.h"
+#include "PsycheAssert.h"
 #include "Symbols.h"
 #include "TranslationUnit.h"
-#include <cstdlib>
-#include <memory>
+#include <algorithm>
+#include <atomic>
+#include <set>
+#include <thread>
+#include <utility>
 
-using namespace psyche;
 using namespace psyche;
 
-RangeAnalysis::RangeAnalysis(TranslationUnit *unit)
-    : ASTVisitor(unit)
-{}
+namespace psyche {
 
-void RangeAnalysis::run(TranslationUnitAST* ast, Namespace *global)
+/*!
+ * \brief The RangeSolver class
+ *
+ * The fixpoint of a function. States are revisions of a persistent map, so
+ * joining, widening, narrowing, and comparing them costs in proportion to
+ * what differs between them.
+ */
+class RangeSolver final
 {
-    switchScope(global);
-    for (DeclarationListAST* it = ast->declaration_list; it; it = it->next)
-        accept(it->value);
-    dumpRanges();
-}
+public:
+    RangeSolver(const ControlFlowGraph& graph, FunctionRanges& ranges, RangeAnalysis::Stats& stats)
+        : graph_(graph)
+        , ranges_(ranges)
+        , arena_(ranges.arena_)
+        , states_(ranges.states_)
+        , stats_(stats)
+    {}
+
+    void solve();
+
+private:
+    using Revision = uint32_t;
+
+    void iterate();
+    void extrapolate(uint32_t block, Revision& in);
+    Revision transfer(uint32_t block, Revision in, bool record);
+    bool refine(const ControlFlowGraph::Edge& edge, Revision out, Revision& refined);
+    void run(const RangeOp& op);
+
+    Revision join(Revision a, Revision b);
+    Revision widen(Revision prev, Revision cur);
+    Revision narrow(Revision prev, Revision cur);
+    bool same(Revision a, Revision b) const;
+
+    Range hull(const Range& a, const Range& b);
+    Range lookup(const Symbol* symbol) const;
+    void assign(const Symbol* symbol, const Range& range);
+
+    template <class FuncT>
+    void differences(Revision a, Revision b, FuncT func) const;
+
+    const ControlFlowGraph& graph_;
+    FunctionRanges& ranges_;
+    ValueArena& arena_;
+    VersionedMap<const Symbol*, Range>& states_;
+    RangeAnalysis::Stats& stats_;
+
+    std::vector<Revision> in_;
+    std::vector<bool> reached_;
+    std::vector<bool> narrowing_; //!< Of each loop head, once its widening is stable.
+    std::vector<Revision> entries_; //!< Of each loop head, from outside, when it began narrowing.
+    std::vector<uint8_t> restarts_; //!< Of each loop head, how often its entry changed.
+    std::vector<uint8_t> revisits_; //!< Of each loop head, once everything else was stable.
+    std::vector<Revision> edgeStates_;
+    std::vector<bool> feasible_;
+    std::vector<uint32_t> position_; //!< Of each block, in reverse postorder.
+    std::set<uint32_t> worklist_; //!< Positions, so that blocks are visited in order.
+    std::vector<Range> regs_;
+};
 
-void RangeAnalysis::dumpRanges() const
+} // namespace psyche
+
+void RangeSolver::solve()
 {
-    // TEMP...
-    for (auto p : rangeMap_) {
-        if (p.first->name()
-                && p.first->name()->asNameId()) {
-            Range range = p.second;
-            std::cout << p.first->name()->asNameId()->identifier()->chars()
-                      << ": " << range << std::endl;
+    const auto& blocks = graph_.blocks();
+    in_.assign(blocks.size(), 0);
+    reached_.assign(blocks.size(), false);
+    narrowing_.assign(blocks.size(), false);
+    entries_.assign(blocks.size(), 0);
+    restarts_.assign(blocks.size(), 0);
+    revisits_.assign(blocks.size(), 0);
+    edgeStates_.assign(graph_.edges().size(), 0);
+    feasible_.assign(graph_.edges().size(), false);
+    position_.assign(blocks.size(), 0);
+    for (auto i = 0u; i < graph_.order().size(); ++i)
+        position_[graph_.order()[i]] = i;
+
+    // Parameters begin with their own (symbolic) values.
+    for (auto symbol : graph_.variables()) {
+        if (symbol->isArgument()) {
+            auto value = arena_.symbol(symbol);
+            assign(symbol, Range(value, value));
         }
     }
-}
+    in_[ControlFlowGraph::Entry] = states_.revision();
 
-const Scope *RangeAnalysis::switchScope(const Scope *scope)
-{
-    PSYCHE_ASSERT(scope, return nullptr, "scope must be valid");
-    std::swap(scope_, scope);
-    return scope;
+    worklist_.insert(position_[ControlFlowGraph::Entry]);
+    iterate();
+
+    // A loop head widened in its last visit isn't visited again when its body
+    // yields nothing new. Once nothing changes (so the state of each back edge
+    // derives from the head's own), such a head is revisited, to narrow.
+    constexpr uint8_t kMaxRevisits = 16;
+    while (true) {
+        for (auto block : graph_.order()) {
+            if (blocks[block].loopHead_
+                    && reached_[block]
+                    && !narrowing_[block]
+                    && revisits_[block] < kMaxRevisits) {
+                ++revisits_[block];
+                worklist_.insert(position_[block]);
+            }
+        }
+        if (worklist_.empty())
+            break;
+        iterate();
+    }
+
+    // Where each statement begins, first in order.
+    for (auto block : graph_.order()) {
+        if (reached_[block])
+            transfer(block, in_[block], true);
+    }
+    ranges_.returns_ = reached_[ControlFlowGraph::Exit];
+    ranges_.exit_ = in_[ControlFlowGraph::Exit];
+
+    // From now on, only the revisions where statements begin, and the one at
+    // exit, are looked at; those of the fixpoint's intermediate states go.
+    std::vector<Revision> live;
+    live.reserve(ranges_.revisions_.size() + 1);
+    for (const auto& it : ranges_.revisions_)
+        live.push_back(it.second);
+    live.push_back(ranges_.exit_);
+    states_.retainRevisions(live);
+    auto revision = live.begin();
+    for (auto& it : ranges_.revisions_)
+        it.second = *revision++;
+    ranges_.exit_ = *revision;
 }
 
-const Symbol* RangeAnalysis::switchSymbol(const Symbol* symbol)
+void RangeSolver::iterate()
 {
-    PSYCHE_ASSERT(symbol, return nullptr, "symbol must be valid");
-    std::swap(symbol_, symbol);
-    return symbol;
+    const auto& blocks = graph_.blocks();
+    const auto& edges = graph_.edges();
+    while (!worklist_.empty()) {
+        const auto block = graph_.order()[*worklist_.begin()];
+        worklist_.erase(worklist_.begin());
+
+        Revision in = in_[block];
+        if (block != ControlFlowGraph::Entry) {
+            bool any = false;
+            for (auto e : blocks[block].preds_) {
+                if (!feasible_[e])
+                    continue;
+                in = any ? join(in, edgeStates_[e]) : edgeStates_[e];
+                any = true;
+            }
+            if (!any)
+                continue;
+
+            if (blocks[block].loopHead_)
+                extrapolate(block, in);
+            if (reached_[block] && same(in, in_[block]))
+                continue;
+        }
+
+        in_[block] = in;
+        reached_[block] = true;
+        ++stats_.visits_;
+
+        const auto out = transfer(block, in, false);
+        for (auto e : blocks[block].succs_) {
+            Revision refined = out;
+            const bool feasible = refine(edges[e], out, refined);
+            if (feasible == feasible_[e] && (!feasible || same(refined, edgeStates_[e])))
+                continue;
+            feasible_[e] = feasible;
+            edgeStates_[e] = refined;
+            worklist_.insert(position_[edges[e].to_]);
+        }
+    }
 }
 
-void RangeAnalysis::resolve(const Name* name)
+/*!
+ * \brief RangeSolver::extrapolate
+ *
+ * Widen the state at a loop head until it's stable, then narrow it, before
+ * the blocks after the loop (further in reverse postorder) are visited: what
+ * follows the loop never sees its widened state. Narrowing goes on while the
+ * state entering the loop from outside stays put. When that state changes,
+ * the head is joined afresh instead, so that a loop doesn't widen what only
+ * an enclosing loop changes.
+ */
+void RangeSolver::extrapolate(uint32_t block, Revision& in)
 {
-    // We expect to see only simple names. Also, since range analysis assumes
-    // well-formed code, symbol lookup must succeed.
-    PSYCHE_ASSERT(name && name->asNameId(), return, "expected simple name");
-    symbol_ = lookupValueSymbol(name, scope_);
-    PSYCHE_ASSERT(symbol_, return, "expected successful lookup");
+    // Entries that change more than this (across irreducible loops) are
+    // no longer followed: the head only widens.
+    constexpr uint8_t kMaxRestarts = 16;
+
+    Revision entry = 0;
+    bool any = false;
+    for (auto e : graph_.blocks()[block].preds_) {
+        if (!feasible_[e] || graph_.edges()[e].back_)
+            continue;
+        entry = any ? join(entry, edgeStates_[e]) : edgeStates_[e];
+        any = true;
+    }
+
+    if (!reached_[block]) {
+        entries_[block] = entry;
+        return;
+    }
+
+    const bool settled = same(entry, entries_[block]);
+    if (!settled) {
+        narrowing_[block] = false;
+        if (restarts_[block] < kMaxRestarts) {
+            ++restarts_[block];
+            entries_[block] = entry;
+            return;
+        }
+    }
+
+    if (!narrowing_[block]) {
+        const auto widened = widen(in_[block], in);
+        if (!same(widened, in_[block])) {
+            in = widened;
+            ++stats_.widenings_;
+            return;
+        }
+        if (!settled) {
+            in = in_[block];
+            return;
+        }
+        narrowing_[block] = true;
+    }
+
+    in = narrow(in_[block], in);
+    if (!same(in, in_[block]))
+        ++stats_.narrowings_;
 }
 
-bool RangeAnalysis::visit(NumericLiteralAST* ast)
+auto RangeSolver::transfer(uint32_t block, Revision in, bool record) -> Revision
 {
-    const NumericLiteral* numLit = numericLiteral(ast->literal_token);
-    PSYCHE_ASSERT(numLit, return false, "numeric literal must exist");
+    const auto& ops = graph_.blocks()[block].ops_;
+    const auto& marks = graph_.blocks()[block].marks_;
+    auto mark = marks.begin();
 
-    // We're interested only on natural numbers. In the case this literal
-    // is a floating-point, our interpretation is to truncate it.
-    auto value = std::atoi(numLit->chars());
-    Range range(std::make_unique<IntegerValue>(value),
-                std::make_unique<IntegerValue>(value));
-    stack_.push(std::move(range));
+    states_.applyRevision(in);
+    regs_.clear();
+    for (auto i = 0u; i < ops.size(); ++i) {
+        for (; mark != marks.end() && mark->first == i; ++mark) {
+            if (record)
+                ranges_.revisions_.emplace(mark->second, states_.revision());
+        }
+        run(ops[i]);
+    }
+    for (; mark != marks.end(); ++mark) {
+        if (record)
+            ranges_.revisions_.emplace(mark->second, states_.revision());
+    }
 
-    return false;
+    return states_.revision();
 }
 
-bool RangeAnalysis::visit(IdExpressionAST* ast)
+void RangeSolver::run(const RangeOp& op)
 {
-    resolve(ast->name->name);
+    switch (op.code_) {
+    case RangeOp::Constant: {
+        auto value = arena_.integer(op.number_);
+        regs_.emplace_back(value, value);
+        break;
+    }
+
+    case RangeOp::Unbounded:
+        regs_.push_back(arena_.unbounded());
+        break;
+
+    case RangeOp::Boolean:
+        regs_.emplace_back(arena_.integer(0), arena_.integer(1));
+        break;
+
+    case RangeOp::Load:
+        regs_.push_back(op.symbol_ ? lookup(op.symbol_) : arena_.unbounded());
+        break;
+
+    case RangeOp::Store: {
+        Range range = regs_[op.a_];
+        if (op.symbol_)
+            assign(op.symbol_, range);
+        regs_.push_back(range);
+        break;
+    }
 
-    // When the symbol is a scope, we only need to enter it.
-    if (symbol_->type()->asClassType()) {
-        switchScope(symbol_->type()->asClassType());
-        return false;
+    case RangeOp::Negate: {
+        const Range a = regs_[op.a_];
+        regs_.emplace_back(arena_.negation(a.upper()), arena_.negation(a.lower()));
+        break;
     }
 
-    // We must push the range for this symbol onto the stack. If there's already
-    // a range associated to it, we use it. Otherwise a symbolic range is created.
-    const auto it = rangeMap_.find(symbol_);
-    if (it != rangeMap_.end()) {
-        stack_.push(it->second);
-    } else {
-        Range range(std::make_unique<SymbolValue>(symbol_),
-                    std::make_unique<SymbolValue>(symbol_));
-        stack_.push(std::move(range));
+    case RangeOp::Add: {
+        const Range a = regs_[op.a_];
+        const Range b = regs_[op.b_];
+        regs_.emplace_back(arena_.addition(a.lower(), b.lower()),
+                           arena_.addition(a.upper(), b.upper()));
+        break;
+    }
+
+    case RangeOp::Subtract: {
+        const Range a = regs_[op.a_];
+        const Range b = regs_[op.b_];
+        regs_.emplace_back(arena_.subtraction(a.lower(), b.upper()),
+                           arena_.subtraction(a.upper(), b.lower()));
+        break;
+    }
+
+    case RangeOp::Hull: {
+        const Range a = regs_[op.a_];
+        const Range b = regs_[op.b_];
+        regs_.push_back(hull(a, b));
+        break;
+    }
+
+    case RangeOp::Wrap: {
+        // Unsigned arithmetic is modular: a range that doesn't fit the type
+        // may wrap onto any of its values.
+        const Range a = regs_[op.a_];
+        const auto max = op.number_ < 63
+                ? arena_.integer((int64_t(1) << op.number_) - 1)
+                : arena_.plusInfinity();
+        const auto l = arena_.evaluate(a.lower());
+        const auto u = arena_.evaluate(a.upper());
+        const auto m = arena_.evaluate(max);
+        if (l.kind_ == ValueArena::Bound::Defined
+                && u.kind_ == ValueArena::Bound::Defined
+                && l.number_ >= 0
+                && (m.kind_ != ValueArena::Bound::Defined || u.number_ <= m.number_)) {
+            regs_.push_back(a);
+        } else {
+            regs_.emplace_back(arena_.integer(0), max);
+        }
+        break;
     }
 
-    return false;
+    default:
+        PSYCHE_ASSERT(false, return, "invalid enumerator");
+        break;
+    }
 }
 
-bool RangeAnalysis::visit(BinaryExpressionAST* ast)
+bool RangeSolver::refine(const ControlFlowGraph::Edge& edge, Revision out, Revision& refined)
 {
-    accept(ast->left_expression);
+    refined = out;
+    if (edge.refinements_.empty())
+        return true;
 
-    unsigned op = tokenKind(ast->binary_op_token);
+    states_.applyRevision(out);
+    for (const auto& refinement : edge.refinements_) {
+        regs_.clear();
+        for (const auto& op : refinement.ops_)
+            run(op);
+        const Range other = regs_[refinement.value_];
+        const Range cur = lookup(refinement.symbol_);
 
-    // In the case of an assignment, we drop the left-hand-side's range, since
-    // it will be overwritten by the one from the right-hand-side.
-    if (op == T_EQUAL) {
-        stack_.pop();
-        const Symbol* lhsSymbol = symbol_;
-        accept(ast->right_expression);
-        rangeMap_.insertOrAssign(lhsSymbol, std::move(stack_.top()));
-        stack_.pop();
-        return false;
-    }
+        auto lower = cur.lower();
+        auto upper = cur.upper();
+        switch (refinement.relation_) {
+        case T_LESS:
+            upper = arena_.minimum(upper, arena_.subtraction(other.upper(), arena_.integer(1)));
+            break;
+
+        case T_LESS_EQUAL:
+            upper = arena_.minimum(upper, other.upper());
+            break;
+
+        case T_GREATER:
+            lower = arena_.maximum(lower, arena_.addition(other.lower(), arena_.integer(1)));
+            break;
+
+        case T_GREATER_EQUAL:
+            lower = arena_.maximum(lower, other.lower());
+            break;
+
+        case T_EQUAL_EQUAL:
+            lower = arena_.maximum(lower, other.lower());
+            upper = arena_.minimum(upper, other.upper());
+            break;
+
+        default:
+            break;
+        }
 
-    // When two expressions are added, we must correspondigly add their ranges
-    // and push the result onto the stack.
-    if (op == T_PLUS) {
-        Range lhsRange = std::move(stack_.top());
-        stack_.pop();
-        accept(ast->right_expression);
-        Range rhsRange = std::move(stack_.top());
-        stack_.pop();
-        auto lower = std::make_unique<CompositeValue>(std::move(lhsRange.lower_),
-                                                      std::move(rhsRange.lower_),
-                                                      CompositeValue::Addition);
-        auto upper = std::make_unique<CompositeValue>(std::move(lhsRange.upper_),
-                                                      std::move(rhsRange.upper_),
-                                                      CompositeValue::Addition);
-        stack_.emplace(std::move(lower), std::move(upper));
-        return false;
+        // A branch whose condition can't hold isn't taken.
+        const auto l = arena_.evaluate(lower);
+        const auto u = arena_.evaluate(upper);
+        if (l.kind_ == ValueArena::Bound::Defined
+                && u.kind_ == ValueArena::Bound::Defined
+                && l.number_ > u.number_) {
+            return false;
+        }
+
+        // A single value can't be narrowed, only ruled out.
+        if (cur.lower() != cur.upper())
+            assign(refinement.symbol_, Range(lower, upper));
     }
+    refined = states_.revision();
+    return true;
+}
 
-    return false;
+template <class FuncT>
+void RangeSolver::differences(Revision a, Revision b, FuncT func) const
+{
+    // Collected before they're acted upon, since acting may add revisions.
+    std::vector<std::pair<const Symbol*, std::pair<const Range*, const Range*>>> diffs;
+    states_.diff(a, b, [&diffs] (const Symbol* symbol, const Range* x, const Range* y) {
+        if (!x || !y || *x != *y)
+            diffs.emplace_back(symbol, std::make_pair(x, y));
+    });
+    for (const auto& d : diffs)
+        func(d.first, d.second.first, d.second.second);
 }
 
-bool RangeAnalysis::visit(MemberAccessAST* ast)
+auto RangeSolver::join(Revision a, Revision b) -> Revision
 {
-    const Scope* prevScope = scope_;
-    accept(ast->base_expression);
-    resolve(ast->member_name->name);
-    switchScope(prevScope);
-    return false;
+    if (a == b)
+        return a;
+
+    // A variable absent from a state may hold anything.
+    states_.applyRevision(a);
+    differences(a, b, [this] (const Symbol* symbol, const Range* x, const Range* y) {
+        if (x)
+            assign(symbol, y ? hull(*x, *y) : arena_.unbounded());
+    });
+    return states_.revision();
 }
 
-bool RangeAnalysis::visit(DeclarationStatementAST* ast)
+auto RangeSolver::widen(Revision prev, Revision cur) -> Revision
 {
-    return false;
+    auto widened = [this] (ValueId prev, ValueId cur, bool lower) {
+        if (prev == cur)
+            return prev;
+        const auto kind = arena_.kind(prev);
+        if (kind == (lower ? ValueArena::MinusInfinity : ValueArena::PlusInfinity))
+            return prev;
+        const auto p = arena_.evaluate(prev);
+        const auto c = arena_.evaluate(cur);
+        if (p.kind_ == ValueArena::Bound::Defined
+                && c.kind_ == ValueArena::Bound::Defined
+                && (lower ? c.number_ >= p.number_ : c.number_ <= p.number_)) {
+            return prev;
+        }
+        return lower ? arena_.minusInfinity() : arena_.plusInfinity();
+    };
+
+    states_.applyRevision(cur);
+    differences(prev, cur, [&] (const Symbol* symbol, const Range* x, const Range* y) {
+        if (!x) {
+            if (y)
+                assign(symbol, arena_.unbounded());
+            return;
+        }
+        if (y)
+            assign(symbol, Range(widened(x->lower(), y->lower(), true),
+                                 widened(x->upper(), y->upper(), false)));
+    });
+    return states_.revision();
 }
 
-bool RangeAnalysis::visit(ExpressionStatementAST* ast)
+auto RangeSolver::narrow(Revision prev, Revision cur) -> Revision
 {
-    accept(ast->expression);
-    revisionMap_.insert(std::make_pair(ast, rangeMap_.revision()));
-    return false;
+    // Only infinite bounds are refined, so narrowing terminates.
+    states_.applyRevision(prev);
+    differences(prev, cur, [this] (const Symbol* symbol, const Range* x, const Range* y) {
+        if (!x) {
+            if (y)
+                assign(symbol, *y);
+            return;
+        }
+        if (!y)
+            return;
+        auto lower = arena_.kind(x->lower()) == ValueArena::MinusInfinity ? y->lower() : x->lower();
+        auto upper = arena_.kind(x->upper()) == ValueArena::PlusInfinity ? y->upper() : x->upper();
+        assign(symbol, Range(lower, upper));
+    });
+    return states_.revision();
+}
+
+bool RangeSolver::same(Revision a, Revision b) const
+{
+    if (a == b)
+        return true;
+    bool same = true;
+    states_.diff(a, b, [&same] (const Symbol*, const Range* x, const Range* y) {
+        if (!x || !y || *x != *y)
+            same = false;
+    });
+    return same;
 }
 
-bool RangeAnalysis::visit(IfStatementAST* ast)
+Range RangeSolver::hull(const Range& a, const Range& b)
 {
-    const auto revision = rangeMap_.revision();
-    accept(ast->statement);
-    rangeMap_.applyRevision(revision);
-    accept(ast->else_statement);
-    rangeMap_.applyRevision(revision);
-    // TODO: Unite commands from both branches (retrieve them from revisions).
-    return false;
+    return Range(arena_.minimum(a.lower(), b.lower()), arena_.maximum(a.upper(), b.upper()));
+}
+
+Range RangeSolver::lookup(const Symbol* symbol) const
+{
+    auto it = states_.find(symbol);
+    if (it != states_.end())
+        return it->second;
+    return arena_.unbounded();
+}
+
+void RangeSolver::assign(const Symbol* symbol, const Range& range)
+{
+    auto it = states_.find(symbol);
+    if (it == states_.end() || it->second != range)
+        states_.insertOrAssign(symbol, range);
+}
+
+const Range* FunctionRanges::rangeAt(uint32_t revision, const Symbol* symbol) const
+{
+    auto it = states_.find(symbol, revision);
+    if (it == states_.end())
+        return nullptr;
+    return &it->second;
+}
+
+const Range* FunctionRanges::before(const StatementAST* stmt, const Symbol* symbol) const
+{
+    auto it = revisions_.find(stmt);
+    if (it == revisions_.end())
+        return nullptr;
+    return rangeAt(it->second, symbol);
+}
+
+const Range* FunctionRanges::atExit(const Symbol* symbol) const
+{
+    if (!returns_)
+        return nullptr;
+    return rangeAt(exit_, symbol);
+}
+
+RangeAnalysis::RangeAnalysis(TranslationUnit *unit)
+    : unit_(unit)
+    , jobs_(1)
+{}
+
+void RangeAnalysis::run(TranslationUnitAST* ast, Namespace*)
+{
+    std::vector<FunctionDefinitionAST*> defs;
+    for (DeclarationListAST* it = ast->declaration_list; it; it = it->next) {
+        FunctionDefinitionAST* def = it->value->asFunctionDefinition();
+        if (def && def->symbol && def->function_body)
+            defs.push_back(def);
+    }
+
+    std::vector<std::unique_ptr<FunctionRanges>> results(defs.size());
+    std::vector<Stats> stats(defs.size());
+    std::atomic<std::size_t> next(0);
+    auto work = [&] () {
+        for (auto i = next++; i < defs.size(); i = next++)
+            results[i] = analyze(defs[i], stats[i]);
+    };
+
+    std::vector<std::thread> threads;
+    const auto cnt = std::min<std::size_t>(jobs_, defs.size());
+    for (auto i = 1u; i < cnt; ++i)
+        threads.emplace_back(work);
+    work();
+    for (auto& thread : threads)
+        thread.join();
+
+    for (auto i = 0u; i < defs.size(); ++i) {
+        index_[results[i]->function()] = results[i].get();
+        funcs_.push_back(std::move(results[i]));
+        stats_.functions_ += 1;
+        stats_.blocks_ += stats[i].blocks_;
+        stats_.loopHeads_ += stats[i].loopHeads_;
+        stats_.visits_ += stats[i].visits_;
+        stats_.widenings_ += stats[i].widenings_;
+        stats_.narrowings_ += stats[i].narrowings_;
+        stats_.values_ += stats[i].values_;
+    }
+}
+
+std::unique_ptr<FunctionRanges> RangeAnalysis::analyze(FunctionDefinitionAST* ast,
+                                                       Stats& stats) const
+{
+    ControlFlowGraphBuilder builder(unit_);
+    const ControlFlowGraph graph = builder.build(ast);
+
+    std::unique_ptr<FunctionRanges> ranges(new FunctionRanges(ast->symbol));
+    ranges->variables_ = graph.variables();
+    RangeSolver(graph, *ranges, stats).solve();
+
+    stats.blocks_ = graph.blocks().size();
+    for (const auto& block : graph.blocks())
+        stats.loopHeads_ += block.loopHead_;
+    stats.values_ = ranges->arena_.size();
+
+    return ranges;
+}
+
+const FunctionRanges* RangeAnalysis::rangesOf(const Function* func) const
+{
+    auto it = index_.find(func);
+    if (it == index_.end())
+        return nullptr;
+    return it->second;
+}
+
+void RangeAnalysis::print(std::ostream& os) const
+{
+    auto nameOf = [] (const Symbol* symbol) -> const char* {
+        if (symbol->name() && symbol->name()->asNameId())
+            return symbol->name()->asNameId()->identifier()->chars();
+        return "<anonymous>";
+    };
+
+    for (const auto& func : funcs_) {
+        os << nameOf(func->function()) << std::endl;
+        for (auto symbol : func->variables()) {
+            const Range* range = func->atExit(symbol);
+            if (!range)
+                continue;
+            os << "  " << nameOf(symbol) << ": ";
+            func->arena().print(os, *range);
+            os << std::endl;
+        }
+    }
 }
 
-bool RangeAnalysis::visit(WhileStatementAST* ast)
+std::ostream& psyche::operator<<(std::ostream& os, const RangeAnalysis::Stats& s)
 {
-    return false;
+    os << "  Functions          : " << s.functions_ << std::endl
+       << "  Blocks             : " << s.blocks_ << std::endl
+       << "  Loop heads         : " << s.loopHeads_ << std::endl
+       << "  Block visits       : " << s.visits_ << std::endl
+       << "  Widenings          : " << s.widenings_ << std::endl
+       << "  Narrowings         : " << s.narrowings_ << std::endl
+       << "  Bound expressions  : " << s.values_;
+    return os;
 }
@@ -17,78 +17,120 @@
  * USA
  *****************************************************************************/
 
+
 #ifndef PSYCHE_RANGEANALYSIS_H__
 #define PSYCHE_RANGEANALYSIS_H__
 
-#include "ASTVisitor.h"
+#include "ASTFwds.h"
 #include "Range.h"
 #include "Symbol.h"
 #include "VersionedMap.h"
+#include <cstddef>
+#include <cstdint>
 #include <iostream>
-#include <stack>
+#include <memory>
 #include <unordered_map>
+#include <vector>
 
 namespace psyche {
 
-class RangeAnalysis final : public psyche::ASTVisitor
+class ControlFlowGraph;
+
+/*!
+ * \brief The FunctionRanges class
+ *
+ * The ranges of the variables of a function, at each statement and at exit.
+ */
+class FunctionRanges final
 {
 public:
-    RangeAnalysis(psyche::TranslationUnit *unit);
+    const psyche::Function* function() const { return func_; }
+    const ValueArena& arena() const { return arena_; }
 
-    void run(psyche::TranslationUnitAST* ast, psyche::Namespace *global);
+    //! Parameters and locals whose ranges are tracked, in declaration order.
+    const std::vector<const psyche::Symbol*>& variables() const { return variables_; }
 
-private:
     /*!
-     * \brief switchScope
-     * \param scope
-     * \return
-     *
-     * Convenience to switch current scope.
+     * The range of a variable when control reaches a statement: null if the
+     * variable isn't tracked or the statement is unreachable.
      */
-    const psyche::Scope *switchScope(const psyche::Scope *scope);
+    const Range* before(const psyche::StatementAST* stmt, const psyche::Symbol* symbol) const;
 
-    /*!
-     * \brief switchSymbol
-     * \param symbol
-     * \return
-     */
-    const psyche::Symbol* switchSymbol(const psyche::Symbol* symbol);
+    //! The range of a variable when the function returns.
+    const Range* atExit(const psyche::Symbol* symbol) const;
+
+private:
+    friend class RangeAnalysis;
+    friend class RangeSolver;
+
+    explicit FunctionRanges(const psyche::Function* func) : func_(func) {}
+
+    const Range* rangeAt(uint32_t revision, const psyche::Symbol* symbol) const;
+
+    const psyche::Function* func_;
+    ValueArena arena_;
+    VersionedMap<const psyche::Symbol*, Range> states_;
+    std::unordered_map<const psyche::StatementAST*, uint32_t> revisions_;
+    bool returns_ { false };
+    uint32_t exit_ { 0 };
+    std::vector<const psyche::Symbol*> variables_;
+};
+
+/*!
+ * \brief The RangeAnalysis class
+ *
+ * A worklist fixpoint over the control-flow graph of each function, with
+ * joins at merge points, and widening followed by narrowing at loop heads.
+ * Functions are independent from one another, and analyzed in parallel.
+ */
+class RangeAnalysis final
+{
+public:
+    RangeAnalysis(psyche::TranslationUnit *unit);
 
     /*!
-     * \brief resolve
-     * \param name
+     * \brief employThreads
+     * \param jobs
      *
-     * Resolve a name to a symbol.
+     * Analyze functions on the given number of threads.
      */
-    void resolve(const psyche::Name* name);
+    void employThreads(unsigned jobs) { jobs_ = jobs; }
+
+    void run(psyche::TranslationUnitAST* ast, psyche::Namespace *global);
 
-    // Expressions
-    bool visit(psyche::BinaryExpressionAST* ast) override;
-    bool visit(psyche::IdExpressionAST* ast) override;
-    bool visit(psyche::MemberAccessAST* ast) override;
-    bool visit(psyche::NumericLiteralAST* ast) override;
+    //! The ranges of each function, in order of definition.
+    const std::vector<std::unique_ptr<FunctionRanges>>& functions() const { return funcs_; }
 
-    // Statements
-    bool visit(psyche::DeclarationStatementAST* ast) override;
-    bool visit(psyche::ExpressionStatementAST* ast) override;
-    bool visit(psyche::IfStatementAST* ast) override;
-    bool visit(psyche::WhileStatementAST* ast) override;
+    const FunctionRanges* rangesOf(const psyche::Function* func) const;
 
-    void dumpRanges() const;
+    //! Write the ranges of variables at the exit of each function.
+    void print(std::ostream& os) const;
 
-    //! Scope we're in.
-    const psyche::Scope *scope_;
+    struct Stats
+    {
+        std::size_t functions_ { 0 };
+        std::size_t blocks_ { 0 };
+        std::size_t loopHeads_ { 0 };
+        std::size_t visits_ { 0 };
+        std::size_t widenings_ { 0 };
+        std::size_t narrowings_ { 0 };
+        std::size_t values_ { 0 };
+    };
 
-    //! Symbol just looked-up.
-    const psyche::Symbol* symbol_;
+    Stats stats() const { return stats_; }
 
-    //! Range stack.
-    std::stack<Range> stack_;
+private:
+    std::unique_ptr<FunctionRanges> analyze(psyche::FunctionDefinitionAST* ast, Stats& stats) const;
 
-    std::unordered_map<const psyche::StatementAST*, int32_t> revisionMap_;
-    VersionedMap<const psyche::Symbol*, Range> rangeMap_;
+    psyche::TranslationUnit* unit_;
+    unsigned jobs_;
+    std::vector<std::unique_ptr<FunctionRanges>> funcs_;
+    std::unordered_map<const psyche::Function*, const FunctionRanges*> index_;
+    Stats stats_;
 };
 
+std::ostream& operator<<(std::ostream& os, const RangeAnalysis::Stats& s);
+
 } // namespace psyche
 
 #endif
@@ -17,8 +17,13 @@
  *****************************************************************************/
 
 #include "BaseTester.h"
+#include "TestConstraintPartitioner.h"
+#include "TestConstraintSorter.h"
 #include "TestDisambiguator.h"
 #include "TestParser.h"
+#include "TestRangeAnalysis.h"
+#include "TestSubstitution.h"
+#include "TestVersionedMap.h"
 #include <iostream>
 
 using namespace psyche;
@@ -30,4 +35,19 @@ void BaseTester::runSuite()
 
     std::cout << "\nAST disambiguation tests..." << std::endl;
     TestDisambiguator().testAll();
+
+    std::cout << "\nSubstitution tests..." << std::endl;
+    TestSubstitution().testAll();
+
+    std::cout << "\nVersioned map tests..." << std::endl;
+    TestVersionedMap().testAll();
+
+    std::cout << "\nRange analysis tests..." << std::endl;
+    TestRangeAnalysis().testAll();
+
+    std::cout << "\nConstraint sorter tests..." << std::endl;
+    TestConstraintSorter().testAll();
+
+    std::cout << "\nConstraint partitioner tests..." << std::endl;
+    TestConstraintPartitioner().testAll();
 }
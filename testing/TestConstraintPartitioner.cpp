@@ -0,0 +1,138 @@
+/******************************************************************************
+ Copyright (c) 2016-20 Leandro T. C. Melo (ltcmelo@gmail.com)
+
+ This library is free software; you can redistribute it and/or modify it under
+ the terms of the GNU Lesser General Public License as published by the Free
+ Software Foundation; either version 2.1 of the License, or (at your option)
+ any later version.
+
+ This library is distributed in the hope that it will be useful, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License
+ for more details.
+
+ You should have received a copy of the GNU Lesser General Public License along
+ with this library; if not, write to the Free Software Foundation, Inc., 51
+ Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA
+ *****************************************************************************/
+
+#include "TestConstraintPartitioner.h"
+#include "Configuration.h"
+#include "Driver.h"
+#include "Factory.h"
+
+using namespace psyche;
+
+void TestConstraintPartitioner::testAll()
+{
+    run<TestConstraintPartitioner>(tests_);
+}
+
+void TestConstraintPartitioner::testCase1()
+{
+    // The existentials and typedefs that bind the types of a function, which
+    // precede its declaration, are in the function's shard.
+
+    std::string source = R"raw(
+int known1(int x) { return x + 1; }
+int known2(int y) { return y * 2; }
+)raw";
+
+    Configuration config;
+    config.value_.shardConstraints = true;
+    Driver driver((Factory()));
+    PSYCHE_EXPECT_INT_EQ(Driver::Exit_OK, driver.process("testfile", source, config));
+    PSYCHE_EXPECT_INT_EQ(2, driver.shards_.size());
+
+    std::string expected = R"raw(
+$exists$ #alpha5. 
+$typedef$ int $as$ #alpha5, #alpha5 = int, 
+$exists$ #alpha6. 
+$typedef$ int $as$ #alpha6, 
+$def$ known2 : (int, int)  $in$  
+[ 
+ $def$ y : int $in$  
+ [ 
+  $exists$ #alpha7. 
+  $exists$ #alpha8. $typeof$(y) = #alpha7, int = #alpha8, #alpha7 = #alpha8, int = #alpha7, int > int
+ ], #alpha6 = int
+])raw";
+
+    PSYCHE_EXPECT_STR_EQ(expected, driver.shards_[1].constraints_);
+
+    // The count in the manifest is the one of the constraints written.
+    PSYCHE_EXPECT_STR_EQ("14 known2", driver.shards_[1].summary_);
+}
+
+void TestConstraintPartitioner::testCase2()
+{
+    // A global of a builtin type, bound in its prologue, doesn't relate the
+    // functions using it; so the one that uses only known symbols isn't part
+    // of the slice.
+
+    std::string source = R"raw(
+int g;
+int known1(int x) { return x + g; }
+int known2(int y) { return y * 2; }
+void m() { u = foo(g); }
+)raw";
+
+    Configuration config;
+    config.value_.sliceConstraints = true;
+    Driver driver((Factory()));
+    PSYCHE_EXPECT_INT_EQ(Driver::Exit_OK, driver.process("testfile", source, config));
+
+    std::string expected = R"raw(
+$exists$ #alpha1. 
+$typedef$ int $as$ #alpha1, #alpha1 = int, 
+$def$ g : #alpha1 $in$  
+$exists$ #alpha10. 
+$typedef$ void $as$ #alpha10, 
+$def$ m : (void)  $in$  
+[ 
+ [ 
+  $exists$ #alpha11. 
+  $exists$ #alpha12. 
+  $exists$ #alpha13. $typeof$(u) = #alpha12, 
+  $exists$ #alpha14. $typeof$(g) = #alpha14, $typeof$(foo) = (#alpha14, #alpha13), #alpha12 > #alpha13, #alpha11 = #alpha12
+ ]
+], #alpha10 = void)raw";
+
+    PSYCHE_EXPECT_STR_EQ(expected, driver.constraints());
+}
+
+void TestConstraintPartitioner::testCase3()
+{
+    // A function used by the slice is kept only as a declaration, without its body.
+
+    std::string source = R"raw(
+int known2(int y) { return y * 2; }
+void m() { u = foo(known2(1)); }
+)raw";
+
+    Configuration config;
+    config.value_.sliceConstraints = true;
+    Driver driver((Factory()));
+    PSYCHE_EXPECT_INT_EQ(Driver::Exit_OK, driver.process("testfile", source, config));
+
+    std::string expected = R"raw(
+$exists$ #alpha1. 
+$typedef$ int $as$ #alpha1, #alpha1 = int, 
+$exists$ #alpha2. 
+$typedef$ int $as$ #alpha2, 
+$def$ known2 : (int, int)  $in$  
+$exists$ #alpha5. 
+$typedef$ void $as$ #alpha5, 
+$def$ m : (void)  $in$  
+[ 
+ [ 
+  $exists$ #alpha6. 
+  $exists$ #alpha7. 
+  $exists$ #alpha8. $typeof$(u) = #alpha7, 
+  $exists$ #alpha9. 
+  $exists$ #alpha10. int = #alpha10, $typeof$(known2) = (#alpha10, #alpha9), $typeof$(foo) = (#alpha9, #alpha8), #alpha7 > #alpha8, #alpha6 = #alpha7
+ ]
+], #alpha5 = void)raw";
+
+    PSYCHE_EXPECT_STR_EQ(expected, driver.constraints());
+}
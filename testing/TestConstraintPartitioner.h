@@ -0,0 +1,62 @@
+/******************************************************************************
+ Copyright (c) 2016-20 Leandro T. C. Melo (ltcmelo@gmail.com)
+
+ This library is free software; you can redistribute it and/or modify it under
+ the terms of the GNU Lesser General Public License as published by the Free
+ Software Foundation; either version 2.1 of the License, or (at your option)
+ any later version.
+
+ This library is distributed in the hope that it will be useful, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License
+ for more details.
+
+ You should have received a copy of the GNU Lesser General Public License along
+ with this library; if not, write to the Free Software Foundation, Inc., 51
+ Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA
+ *****************************************************************************/
+
+#ifndef PSYCHE_TEST_CONSTRAINT_PARTITIONER_H__
+#define PSYCHE_TEST_CONSTRAINT_PARTITIONER_H__
+
+#include "BaseTester.h"
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#define CONSTRAINT_PARTITIONER_TEST(F) TestData { &TestConstraintPartitioner::F, #F }
+
+namespace psyche {
+
+/*!
+ * \brief The TestConstraintPartitioner class
+ *
+ * Tests of the writers that partition the constraints: the sharder and the slicer.
+ */
+class TestConstraintPartitioner final : public BaseTester
+{
+public:
+    void testAll() override;
+
+private:
+    void testCase1();
+    void testCase2();
+    void testCase3();
+
+    using TestData = std::pair<std::function<void(TestConstraintPartitioner*)>, const char*>;
+
+    /*
+     * Add the name of all test functions to the vector below. Use the macro.
+     */
+    std::vector<TestData> tests_
+    {
+        CONSTRAINT_PARTITIONER_TEST(testCase1),
+        CONSTRAINT_PARTITIONER_TEST(testCase2),
+        CONSTRAINT_PARTITIONER_TEST(testCase3),
+    };
+};
+
+} // namespace psyche
+
+#endif
@@ -0,0 +1,254 @@
+/******************************************************************************
+ Copyright (c) 2016-20 Leandro T. C. Melo (ltcmelo@gmail.com)
+
+ This library is free software; you can redistribute it and/or modify it under
+ the terms of the GNU Lesser General Public License as published by the Free
+ Software Foundation; either version 2.1 of the License, or (at your option)
+ any later version.
+
+ This library is distributed in the hope that it will be useful, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License
+ for more details.
+
+ You should have received a copy of the GNU Lesser General Public License along
+ with this library; if not, write to the Free Software Foundation, Inc., 51
+ Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA
+ *****************************************************************************/
+
+#include "TestConstraintSorter.h"
+#include "Configuration.h"
+#include "Driver.h"
+#include "Factory.h"
+#include <algorithm>
+#include <sstream>
+
+using namespace psyche;
+
+namespace {
+
+/*
+ * The lines of the constraints, without the separator that ends them (which
+ * depends on whether a line is the last one).
+ */
+std::vector<std::string> linesOf(const std::string& cstr)
+{
+    std::vector<std::string> lines;
+    std::istringstream iss(cstr);
+    for (std::string line; std::getline(iss, line);) {
+        while (!line.empty() && (line.back() == ' ' || line.back() == ','))
+            line.pop_back();
+        if (!line.empty())
+            lines.push_back(line);
+    }
+    return lines;
+}
+
+std::string joined(const std::vector<std::string>& lines)
+{
+    std::string text;
+    for (const auto& line : lines)
+        text += line + "\n";
+    return text;
+}
+
+} // anonymous
+
+void TestConstraintSorter::testAll()
+{
+    run<TestConstraintSorter>(tests_);
+}
+
+std::string TestConstraintSorter::checkReordering(const std::string& source)
+{
+    Driver original((Factory()));
+    PSYCHE_EXPECT_INT_EQ(Driver::Exit_OK, original.process("testfile", source, Configuration()));
+
+    Configuration config;
+    config.value_.sortDecls = true;
+    Driver sorted((Factory()));
+    PSYCHE_EXPECT_INT_EQ(Driver::Exit_OK, sorted.process("testfile", source, config));
+
+    auto a = linesOf(original.constraints());
+    auto b = linesOf(sorted.constraints());
+    const std::string text = joined(b);
+
+    std::sort(a.begin(), a.end());
+    std::sort(b.begin(), b.end());
+    PSYCHE_EXPECT_STR_EQ(joined(a), joined(b));
+
+    return text;
+}
+
+void TestConstraintSorter::testCase1()
+{
+    // A declaration moves along with the existential and the typedef that
+    // bind its return type (rather than those of an earlier declaration with
+    // the same type), and with the equation that follows it.
+
+    std::string source = R"raw(
+Result generate(double val)
+{
+  List list;
+  list->data = val;
+  list->next = list;
+  return analyse(list);
+}
+
+Result analyse(Chain chain) { }
+)raw";
+
+    std::string expected = R"raw($exists$ #alpha1.
+$typedef$ double $as$ #alpha1, #alpha1 = double
+$exists$ #alpha17.
+$typedef$ Chain $as$ #alpha17, #alpha17 = Chain
+$exists$ #alpha18.
+$typedef$ Result $as$ #alpha18
+$def$ analyse : (Chain, Result)  $in$
+[
+ $def$ chain : Chain $in$
+ [
+ ]
+], #alpha18 = Result
+$exists$ #alpha2.
+$typedef$ Result $as$ #alpha2
+$def$ generate : (double, Result)  $in$
+[
+ $def$ val : double $in$
+ [
+  $exists$ #alpha3.
+  $typedef$ List $as$ #alpha3, #alpha3 = List
+  $def$ list : #alpha3 $in$
+  $exists$ #alpha4.
+  $exists$ #alpha5.
+  $exists$ #alpha6.
+  $exists$ #alpha7.
+  $exists$ #alpha8.
+  $exists$ #alpha9. $typeof$(list) = #alpha7, #alpha7 = #alpha8*, $has$ (#alpha8, data : #alpha9), #alpha5 = #alpha9, $typeof$(val) = #alpha6, #alpha5 > #alpha6, #alpha4 = #alpha5
+  $exists$ #alpha10.
+  $exists$ #alpha11.
+  $exists$ #alpha12.
+  $exists$ #alpha13.
+  $exists$ #alpha14.
+  $exists$ #alpha15. $typeof$(list) = #alpha13, #alpha13 = #alpha14*, $has$ (#alpha14, next : #alpha15), #alpha11 = #alpha15, $typeof$(list) = #alpha12, #alpha11 > #alpha12, #alpha10 = #alpha11
+  $exists$ #alpha16. $typeof$(list) = #alpha16, $typeof$(analyse) = (#alpha16, Result)
+ ], #alpha2 = Result
+]
+)raw";
+
+    PSYCHE_EXPECT_STR_EQ(expected, checkReordering(source));
+}
+
+void TestConstraintSorter::testCase2()
+{
+    // The typedef of a type name used by a member moves ahead of the struct.
+
+    std::string source = R"raw(
+struct P { int x; };
+
+void h() {
+    struct P p;
+    p.x = 1;
+}
+
+struct Q { T x; };
+
+void k() {
+    struct Q q;
+    q.x = 3.14;
+}
+)raw";
+
+    std::string expected = R"raw($typedef$ struct P $as$ struct P{ int x; }
+$exists$ #alpha1. #alpha1 = struct P
+$exists$ #alpha2.
+$typedef$ int $as$ #alpha2, #alpha2 = int
+$def$ x : #alpha2 $in$  $has$ (#alpha1, x : #alpha2)
+$exists$ #alpha3.
+$typedef$ void $as$ #alpha3
+$def$ h : (void)  $in$
+[
+ [
+  $exists$ #alpha4.
+  $typedef$ struct P $as$ #alpha4, #alpha4 = struct P
+  $def$ p : #alpha4 $in$
+  $exists$ #alpha5.
+  $exists$ #alpha6.
+  $exists$ #alpha7.
+  $exists$ #alpha8.
+  $exists$ #alpha9. $typeof$(p) = #alpha8, $has$ (#alpha8, x : #alpha9), #alpha6 = #alpha9, int = #alpha7, #alpha6 > #alpha7, #alpha5 = #alpha6
+ ]
+], #alpha3 = void
+$exists$ #alpha11.
+$typedef$ T $as$ #alpha11, #alpha11 = T
+$typedef$ struct Q $as$ struct Q{ T x; }
+$exists$ #alpha10. #alpha10 = struct Q
+$def$ x : #alpha11 $in$  $has$ (#alpha10, x : #alpha11)
+$exists$ #alpha12.
+$typedef$ void $as$ #alpha12
+$def$ k : (void)  $in$
+[
+ [
+  $exists$ #alpha13.
+  $typedef$ struct Q $as$ #alpha13, #alpha13 = struct Q
+  $def$ q : #alpha13 $in$
+  $exists$ #alpha14.
+  $exists$ #alpha15.
+  $exists$ #alpha16.
+  $exists$ #alpha17.
+  $exists$ #alpha18. $typeof$(q) = #alpha17, $has$ (#alpha17, x : #alpha18), #alpha15 = #alpha18, double = #alpha16, #alpha15 > #alpha16, #alpha14 = #alpha15
+ ]
+], #alpha12 = void
+)raw";
+
+    PSYCHE_EXPECT_STR_EQ(expected, checkReordering(source));
+}
+
+void TestConstraintSorter::testCase3()
+{
+    std::string source = R"raw(
+void f()
+{
+    union O orphan;
+}
+
+void g()
+{
+    union U u;
+    u.w = 1;
+
+    struct ST st;
+    st.ww = 1;
+}
+
+union P { int xx; };
+
+void h() {
+    union P p;
+    p.xx = 1;
+}
+
+union Q { T x; };
+
+void k() {
+    union Q q;
+    q.x = 3.14;
+}
+
+typedef union S { double y; } S;
+
+void i() {
+    S s;
+    s.y = 3.14;
+}
+
+typedef union J { TT z; } J;
+
+void m() {
+    J j;
+    j.z = "foo";
+}
+)raw";
+
+    checkReordering(source);
+}
@@ -18,10 +18,19 @@
 
 #include "TestParser.h"
 #include "AST.h"
+#include "ASTListBuilder.h"
+#include "ASTMatcher.h"
+#include "ASTTraversal.h"
+#include "ASTVisitor.h"
+#include "Configuration.h"
+#include "Driver.h"
+#include "Factory.h"
 #include "IO.h"
 #include "Literals.h"
 #include <iostream>
+#include <sstream>
 #include <string>
+#include <unordered_set>
 #include <cstring>
 
 using namespace psyche;
@@ -46,7 +55,8 @@ void TestParser::reset()
     control_.diagnosticCollector()->reset();
 }
 
-void TestParser::testSource(const std::string& source)
+std::unique_ptr<TranslationUnit> TestParser::testSource(const std::string& source,
+                                                        std::size_t memoBudget)
 {
     // TODO: Get through the driver, to ensure the default dialect is the same.
     Dialect dialect;
@@ -59,6 +69,7 @@ void TestParser::testSource(const std::string& source)
 
     auto unit = std::make_unique<TranslationUnit>(&control_, name_.get());
     unit->setDialect(dialect);
+    unit->setParseMemoBudget(memoBudget);
     unit->setSource(source.c_str(), source.length());
     auto ret = unit->parse();
 
@@ -66,6 +77,8 @@ void TestParser::testSource(const std::string& source)
     PSYCHE_EXPECT_TRUE(unit->ast());
     PSYCHE_EXPECT_TRUE(unit->ast()->asTranslationUnit());
     PSYCHE_EXPECT_INT_EQ(0, collector_.seenBlockingIssue());
+
+    return unit;
 }
 
 /*
@@ -283,3 +296,244 @@ void TestParser::testCase30()
     const std::string& source = readFile("testing/data/string_gcc-pp_ubuntu.i");
     testSource(source);
 }
+
+namespace {
+
+struct TraversalRecorder : public ASTVisitor
+{
+    TraversalRecorder(TranslationUnit* unit, bool iterative)
+        : ASTVisitor(unit)
+    {
+        if (iterative)
+            enableIterativeTraversal();
+    }
+
+    bool preVisit(AST* ast) override { trace_ << "+" << ast->firstToken(); return true; }
+    void postVisit(AST* ast) override { trace_ << "-" << ast->lastToken(); }
+
+    bool visit(BinaryExpressionAST* ast) override { trace_ << "b"; return true; }
+    void endVisit(BinaryExpressionAST* ast) override { trace_ << "/b"; }
+
+    // A visitor that recurses on its own must see the same order.
+    bool visit(ReturnStatementAST* ast) override
+    {
+        trace_ << "r";
+        accept(ast->expression);
+        return false;
+    }
+    void endVisit(ReturnStatementAST* ast) override { trace_ << "/r"; }
+
+    std::ostringstream trace_;
+};
+
+struct KindChecker : public ASTVisitor
+{
+    KindChecker(TranslationUnit* unit)
+        : ASTVisitor(unit)
+    {}
+
+    bool preVisit(AST* ast) override
+    {
+        int casts = 0;
+#define PSYCHE_AST_NODE(NAME) \
+        if (ast->as##NAME()) { \
+            ++casts; \
+            if (ast->nodeKind() != AST::NodeKind::NAME) \
+                ++mismatches_; \
+        }
+#include "ASTNodes.inc"
+        if (casts != 1)
+            ++mismatches_;
+        ++nodes_;
+        return true;
+    }
+
+    int nodes_ { 0 };
+    int mismatches_ { 0 };
+};
+
+struct NodeCollector : public ASTVisitor
+{
+    NodeCollector(TranslationUnit* unit)
+        : ASTVisitor(unit)
+    {}
+
+    bool preVisit(AST* ast) override
+    {
+        if (!nodes_.insert(ast).second)
+            ++shared_;
+        return true;
+    }
+
+    std::unordered_set<AST*> nodes_;
+    int shared_ { 0 };
+};
+
+} // anonymous
+
+void TestParser::testCase31()
+{
+    std::string s = "int f(int a) { int b = a * (a - 1); return a";
+    for (int i = 0; i < 900; ++i)
+        s += " + a";
+    s += "; }";
+
+    auto unit = testSource(s);
+
+    TraversalRecorder recursive(unit.get(), false);
+    recursive.accept(unit->ast());
+    TraversalRecorder iterative(unit.get(), true);
+    iterative.accept(unit->ast());
+
+    PSYCHE_EXPECT_TRUE(iterative.traversal());
+    PSYCHE_EXPECT_TRUE(iterative.traversal()->maxStackDepth() > 900);
+    PSYCHE_EXPECT_STR_EQ(recursive.trace_.str(), iterative.trace_.str());
+}
+
+void TestParser::testCase32()
+{
+    // Without typedefs and structs, only the specifiers of a declaration and
+    // the body of a function are validated.
+
+    Configuration config;
+    config.value_.noTypedef = true;
+
+    auto check = [&config] (const std::string& source) {
+        Driver driver((Factory()));
+        return driver.process("testfile", source, config);
+    };
+
+    PSYCHE_EXPECT_INT_EQ(Driver::Exit_OK,
+                         check("struct S* g; int f(struct S* s) { return 0; }"));
+    PSYCHE_EXPECT_INT_EQ(Driver::Exit_SyntaxError,
+                         check("struct S { int x; };"));
+    PSYCHE_EXPECT_INT_EQ(Driver::Exit_SyntaxError,
+                         check("int f() { typedef int T; return 0; }"));
+    PSYCHE_EXPECT_INT_EQ(Driver::Exit_SyntaxError,
+                         check("int f() { struct S { int x; } s; return 0; }"));
+}
+
+void TestParser::testCase33()
+{
+    std::string s = R"(
+typedef struct S { int x : 3; double* y[2]; } T;
+enum E { A, B = 2 };
+int f(T* t, ...)
+{
+    int a[] = { 1, [1] = 2 };
+    struct S s = { .x = 1 };
+    switch (t->x) {
+    case A: return (int) sizeof(T);
+    default: break;
+    }
+    do { a[0]++; } while (!a[1] && f(t, "s" "t"));
+    return t->y[0] ? -1 : *a;
+}
+     )";
+
+    auto unit = testSource(s);
+
+    KindChecker checker(unit.get());
+    checker.accept(unit->ast());
+
+    PSYCHE_EXPECT_TRUE(checker.nodes_ > 0);
+    PSYCHE_EXPECT_INT_EQ(0, checker.mismatches_);
+}
+
+void TestParser::testCase34()
+{
+    // Large enough for the list cells not to fit in a single block of the pool,
+    // but within the parser's limit for initializer clauses.
+    const int kInits = 900;
+    std::string s = "int a[] = { 0";
+    for (int i = 1; i < kInits; ++i)
+        s += ", " + std::to_string(i);
+    s += " };";
+
+    auto unit = testSource(s);
+    auto decl = unit->ast()->asTranslationUnit()->declaration_list->value->asSimpleDeclaration();
+    auto init = decl->declarator_list->value->initializer->asBracedInitializer();
+    PSYCHE_EXPECT_TRUE(init);
+
+    int count = 0;
+    bool contiguous = true;
+    for (auto it = init->expression_list; it; it = it->next) {
+        if (it->next && it->next != it + 1)
+            contiguous = false;
+        ++count;
+    }
+    PSYCHE_EXPECT_INT_EQ(kInits, count);
+    PSYCHE_EXPECT_TRUE(contiguous);
+
+    count = 0;
+    for (ExpressionAST* expr : listRange(init->expression_list)) {
+        PSYCHE_EXPECT_TRUE(expr->asNumericLiteral());
+        ++count;
+    }
+    PSYCHE_EXPECT_INT_EQ(kInits, count);
+}
+
+void TestParser::testCase35()
+{
+    // Nested casts and parenthesized expressions are re-parsed on every backtrack
+    // unless the memo table kicks in; with and without it, the AST must be the same.
+    std::string e = "x";
+    for (int i = 0; i < 12; ++i)
+        e = "(T)(" + e + ") + ((T)x)";
+    const std::string s = "typedef int T; int f(int x) { T y; T* p; (T)*p; return " + e + "; }";
+
+    auto memo = testSource(s);
+    auto noMemo = testSource(s, 0);
+
+    const auto& stats = memo->parseStats();
+    PSYCHE_EXPECT_TRUE(stats.memoInserts_ > 0);
+    PSYCHE_EXPECT_TRUE(stats.memoHits_ > 0);
+    PSYCHE_EXPECT_INT_EQ(0, stats.memoFlushes_);
+    PSYCHE_EXPECT_INT_EQ(0, noMemo->parseStats().memoInserts_);
+    PSYCHE_EXPECT_TRUE(stats.backtracks_ <= noMemo->parseStats().backtracks_);
+
+    ASTMatcher matcher;
+    PSYCHE_EXPECT_TRUE(memo->ast()->match(noMemo->ast(), &matcher));
+}
+
+void TestParser::testCase36()
+{
+    // Binding and constraint generation of deep expressions (operator chains, nested
+    // parentheses, unary operators, and conditionals) must not exhaust the native stack.
+    std::string chain = "a";
+    for (int i = 0; i < 200; ++i)
+        chain += " + a";
+    const std::string nested = std::string(200, '(') + "a" + std::string(200, ')');
+    const std::string unary = std::string(200, '!') + "a";
+    std::string cond = "a";
+    for (int i = 0; i < 200; ++i)
+        cond = "a ? a : " + cond;
+
+    const std::string s = "int f(int a) { int b; b = " + chain + "; b = " + nested
+            + "; b = " + unary + "; b = " + cond + "; return b; }";
+
+    Driver driver((Factory()));
+    PSYCHE_EXPECT_INT_EQ(Driver::Exit_OK, driver.process("testfile", s, Configuration()));
+    PSYCHE_EXPECT_TRUE(driver.constraints().find("$typeof$(b)") != std::string::npos);
+}
+
+void TestParser::testCase37()
+{
+    // The same cast and declaration statement are re-parsed, through the memo,
+    // under ambiguous statements; no node may be shared among the alternatives.
+    const std::string s = R"(
+typedef int T;
+int f(int x, T* p)
+{
+    a(b) = (T) * p;
+    a(b) = ({ struct S s; (T) * p; });
+}
+     )";
+
+    auto unit = testSource(s);
+    PSYCHE_EXPECT_TRUE(unit->parseStats().memoHits_ > 0);
+
+    NodeCollector collector(unit.get());
+    collector.accept(unit->ast());
+    PSYCHE_EXPECT_INT_EQ(0, collector.shared_);
+}
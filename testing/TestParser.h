@@ -25,6 +25,7 @@
 #include "DiagnosticCollector.h"
 #include "TranslationUnit.h"
 #include <functional>
+#include <memory>
 #include <string>
 #include <utility>
 #include <vector>
@@ -46,7 +47,8 @@ private:
 
     void reset() override;
 
-    void testSource(const std::string& source);
+    std::unique_ptr<psyche::TranslationUnit> testSource(const std::string& source,
+                                                        std::size_t memoBudget = 32 * 1024 * 1024);
 
     void testCase1();
     void testCase2();
@@ -78,6 +80,13 @@ private:
     void testCase28();
     void testCase29();
     void testCase30();
+    void testCase31();
+    void testCase32();
+    void testCase33();
+    void testCase34();
+    void testCase35();
+    void testCase36();
+    void testCase37();
 
     std::vector<TestData> tests_
     {
@@ -110,7 +119,14 @@ private:
         PARSER_TEST(testCase27),
         PARSER_TEST(testCase28),
         PARSER_TEST(testCase29),
-        PARSER_TEST(testCase30)
+        PARSER_TEST(testCase30),
+        PARSER_TEST(testCase31),
+        PARSER_TEST(testCase32),
+        PARSER_TEST(testCase33),
+        PARSER_TEST(testCase34),
+        PARSER_TEST(testCase35),
+        PARSER_TEST(testCase36),
+        PARSER_TEST(testCase37)
     };
 
     psyche::DiagnosticCollector collector_;
@@ -0,0 +1,512 @@
+/******************************************************************************
+ Copyright (c) 2016-20 Leandro T. C. Melo (ltcmelo@gmail.com)
+
+ This library is free software; you can redistribute it and/or modify it under
+ the terms of the GNU Lesser General Public License as published by the Free
+ Software Foundation; either version 2.1 of the License, or (at your option)
+ any later version.
+
+ This library is distributed in the hope that it will be useful, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License
+ for more details.
+
+ You should have received a copy of the GNU Lesser General Public License along
+ with this library; if not, write to the Free Software Foundation, Inc., 51
+ Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA
+ *****************************************************************************/
+
+#include "TestRangeAnalysis.h"
+#include "AST.h"
+#include "Configuration.h"
+#include "ControlFlowGraph.h"
+#include "Driver.h"
+#include "Factory.h"
+#include <sstream>
+
+using namespace psyche;
+
+void TestRangeAnalysis::testAll()
+{
+    run<TestRangeAnalysis>(tests_);
+}
+
+void TestRangeAnalysis::checkRanges(const std::string& source, const std::string& expected)
+{
+    Configuration config;
+    config.value_.analyzeRanges = true;
+
+    Driver driver((Factory()));
+    PSYCHE_EXPECT_INT_EQ(Driver::Exit_OK, driver.process("testfile", source, config));
+    PSYCHE_EXPECT_STR_EQ(expected, driver.ranges());
+}
+
+void TestRangeAnalysis::checkLoops(const std::string& source, const std::string& expected)
+{
+    Driver driver((Factory()));
+    PSYCHE_EXPECT_INT_EQ(Driver::Exit_OK, driver.process("testfile", source, Configuration()));
+
+    FunctionDefinitionAST* def = nullptr;
+    for (DeclarationListAST* it = driver.ast()->declaration_list; it && !def; it = it->next)
+        def = it->value->asFunctionDefinition();
+    PSYCHE_EXPECT_TRUE(def);
+
+    const ControlFlowGraph graph = ControlFlowGraphBuilder(driver.unit()).build(def);
+    std::ostringstream oss;
+    for (auto block : graph.order()) {
+        if (!graph.blocks()[block].loopHead_)
+            continue;
+        auto back = 0;
+        for (auto e : graph.blocks()[block].preds_)
+            back += graph.edges()[e].back_;
+        oss << back << "/" << graph.blocks()[block].succs_.size() << " ";
+    }
+    PSYCHE_EXPECT_STR_EQ(expected, oss.str());
+}
+
+void TestRangeAnalysis::testCase1()
+{
+    // A sum of constants that overflows saturates.
+
+    std::string source = R"raw(
+int f(void) {
+    int q = 9223372036854775807;
+    q = q + 1;
+    return q;
+}
+)raw";
+
+    std::string expected = R"raw(f
+  q: [+inf, +inf]
+)raw";
+
+    checkRanges(source, expected);
+}
+
+void TestRangeAnalysis::testCase2()
+{
+    // The negation of the least integer saturates too.
+
+    std::string source = R"raw(
+int f(void) {
+    int q = -9223372036854775807 - 1;
+    int r = -q;
+    int s = q - 1;
+    return r;
+}
+)raw";
+
+    std::string expected = R"raw(f
+  q: [-9223372036854775808, -9223372036854775808]
+  r: [+inf, +inf]
+  s: [-inf, -inf]
+)raw";
+
+    checkRanges(source, expected);
+}
+
+void TestRangeAnalysis::testCase3()
+{
+    // Constants that would overflow aren't reassociated.
+
+    std::string source = R"raw(
+int f(int x) {
+    int r = x + 9223372036854775807;
+    r = r + 9223372036854775807;
+    return r;
+}
+)raw";
+
+    std::string expected = R"raw(f
+  x: [x, x]
+  r: [x + 9223372036854775807 + 9223372036854775807, x + 9223372036854775807 + 9223372036854775807]
+)raw";
+
+    checkRanges(source, expected);
+}
+
+void TestRangeAnalysis::testCase4()
+{
+    std::string source = R"raw(
+int f(int x) {
+    int r = x - (-9223372036854775807 - 1);
+    int s = 5 - (-9223372036854775807 - 1);
+    return r;
+}
+)raw";
+
+    std::string expected = R"raw(f
+  x: [x, x]
+  r: [x + 9223372036854775807 + 1, x + 9223372036854775807 + 1]
+  s: [+inf, +inf]
+)raw";
+
+    checkRanges(source, expected);
+}
+
+void TestRangeAnalysis::testCase5()
+{
+    // A floating-point literal out of range is clamped.
+
+    std::string source = R"raw(
+int f(void) {
+    int q = 1e300;
+    int r = -1e300;
+    return q;
+}
+)raw";
+
+    std::string expected = R"raw(f
+  q: [9223372036854775807, 9223372036854775807]
+  r: [-9223372036854775807, -9223372036854775807]
+)raw";
+
+    checkRanges(source, expected);
+}
+
+void TestRangeAnalysis::testCase6()
+{
+    // A `continue' in a `while' doesn't add an edge into the loop head.
+
+    std::string source = R"raw(
+int f(void) {
+    int i = 0;
+    while (i < 10) {
+        if (i == 4) {
+            i = i + 2;
+            continue;
+        }
+        i = i + 1;
+    }
+    return i;
+}
+)raw";
+
+    checkLoops(source, "1/2 ");
+}
+
+void TestRangeAnalysis::testCase7()
+{
+    std::string source = R"raw(
+int f(void) {
+    int i = 0;
+    while (i < 10) {
+        if (i == 4) {
+            i = i + 2;
+            continue;
+        }
+        i = i + 1;
+    }
+    return i;
+}
+)raw";
+
+    std::string expected = R"raw(f
+  i: [10, 10]
+)raw";
+
+    checkRanges(source, expected);
+}
+
+void TestRangeAnalysis::testCase8()
+{
+    std::string source = R"raw(
+int f(void) {
+    int i = 0;
+    while (i < 1000) {
+        if (i == 4) {
+            i = i + 2;
+            continue;
+        }
+        i = i + 1;
+    }
+    return i;
+}
+)raw";
+
+    std::string expected = R"raw(f
+  i: [1000, 1000]
+)raw";
+
+    checkRanges(source, expected);
+}
+
+void TestRangeAnalysis::testCase9()
+{
+    // A constant condition has a single way out of the loop head.
+
+    std::string source = R"raw(
+int f(void) {
+    int i = 0;
+    while (1) {
+        if (i > 20)
+            break;
+        i = i + 3;
+    }
+    return i;
+}
+)raw";
+
+    checkLoops(source, "1/1 ");
+}
+
+void TestRangeAnalysis::testCase10()
+{
+    // ... so only a `break' leaves the loop.
+
+    std::string source = R"raw(
+int f(void) {
+    int i = 0;
+    while (1) {
+        if (i > 20)
+            break;
+        i = i + 3;
+    }
+    return i;
+}
+)raw";
+
+    std::string expected = R"raw(f
+  i: [21, 23]
+)raw";
+
+    checkRanges(source, expected);
+}
+
+void TestRangeAnalysis::testCase11()
+{
+    // And without one, the function doesn't return.
+
+    std::string source = R"raw(
+int f(void) {
+    int i = 0;
+    while (1)
+        i = i + 1;
+    return i;
+}
+)raw";
+
+    checkRanges(source, "f\n");
+}
+
+void TestRangeAnalysis::testCase12()
+{
+    // Neither is a loop with a constant false condition, nor is a branch
+    // that isn't taken.
+
+    std::string source = R"raw(
+int f(void) {
+    int i = 0;
+    do {
+        i = i + 1;
+    } while (0);
+    if (0)
+        i = 5;
+    return i;
+}
+)raw";
+
+    std::string expected = R"raw(f
+  i: [1, 1]
+)raw";
+
+    checkLoops(source, "");
+    checkRanges(source, expected);
+}
+
+void TestRangeAnalysis::testCase13()
+{
+    // The outer loop is narrowed even though the inner one (whose bound is
+    // symbolic) yields nothing new after the outer widens.
+
+    std::string source = R"raw(
+int f(void) {
+    int i;
+    int j;
+    int s = 0;
+    for (i = 0; i < 10; i++)
+        for (j = 0; j < i; j++)
+            s = s + 1;
+    return s;
+}
+)raw";
+
+    std::string expected = R"raw(f
+  i: [10, 10]
+  j: [-inf, +inf]
+  s: [0, +inf]
+)raw";
+
+    checkLoops(source, "1/2 1/2 ");
+    checkRanges(source, expected);
+}
+
+void TestRangeAnalysis::testCase14()
+{
+    std::string source = R"raw(
+int f(void) {
+    int i = 0;
+    int k = 0;
+    while (i < 10) {
+        k = 0;
+        while (k < i) {
+            k = k + 1;
+            if (k == 3)
+                continue;
+        }
+        i = i + 1;
+    }
+    return i;
+}
+)raw";
+
+    std::string expected = R"raw(f
+  i: [10, 10]
+  k: [0, 9]
+)raw";
+
+    checkLoops(source, "1/2 1/2 ");
+    checkRanges(source, expected);
+}
+
+void TestRangeAnalysis::testCase15()
+{
+    std::string source = R"raw(
+int f(int x) {
+    int r = 0;
+    switch (x) {
+    case 1:
+        r = 1;
+        break;
+    default:
+        r = 2;
+    }
+    return r;
+}
+)raw";
+
+    std::string expected = R"raw(f
+  x: [x, x]
+  r: [1, 2]
+)raw";
+
+    checkRanges(source, expected);
+}
+
+void TestRangeAnalysis::testCase16()
+{
+    // Only one alternative of a conditional is evaluated, so the store in
+    // the other may not have happened.
+
+    std::string source = R"raw(
+int f(int c) {
+    int x = 0;
+    int y = 0;
+    c ? (x = 10) : 0;
+    y = c ? 1 : 2;
+    return x;
+}
+)raw";
+
+    std::string expected = R"raw(f
+  c: [c, c]
+  x: [0, 10]
+  y: [1, 2]
+)raw";
+
+    checkRanges(source, expected);
+}
+
+void TestRangeAnalysis::testCase17()
+{
+    // Nor is the right operand of a conjunction whose left one is false.
+
+    std::string source = R"raw(
+int f(int c) {
+    int y = 0;
+    if (c && (y = 10))
+        ;
+    return y;
+}
+)raw";
+
+    std::string expected = R"raw(f
+  c: [c, c]
+  y: [0, 10]
+)raw";
+
+    checkRanges(source, expected);
+}
+
+void TestRangeAnalysis::testCase18()
+{
+    // Or of a disjunction whose left one is true.
+
+    std::string source = R"raw(
+int f(int c) {
+    int z = 0;
+    c || (z = 7);
+    return z;
+}
+)raw";
+
+    std::string expected = R"raw(f
+  c: [c, c]
+  z: [0, 7]
+)raw";
+
+    checkRanges(source, expected);
+}
+
+void TestRangeAnalysis::testCase19()
+{
+    // An unsigned variable wraps around instead of going negative.
+
+    std::string source = R"raw(
+int f(void) {
+    unsigned u = 0;
+    unsigned char b = 255;
+    unsigned short s = 1;
+    u = u - 1;
+    b = b + 1;
+    s = s + 1;
+    return 0;
+}
+)raw";
+
+    std::string expected = R"raw(f
+  u: [0, 4294967295]
+  b: [0, 255]
+  s: [2, 2]
+)raw";
+
+    checkRanges(source, expected);
+}
+
+void TestRangeAnalysis::testCase20()
+{
+    // Typedefs are tracked only when they name an integral type.
+
+    std::string source = R"raw(
+typedef struct S { int a; } S;
+typedef int* P;
+typedef int I;
+typedef I J;
+typedef unsigned short U;
+int f(void) {
+    S s;
+    P p = 0;
+    J j = 3;
+    U w = 0;
+    w = w - 1;
+    return j;
+}
+)raw";
+
+    std::string expected = R"raw(f
+  j: [3, 3]
+  w: [0, 65535]
+)raw";
+
+    checkRanges(source, expected);
+}
@@ -0,0 +1,102 @@
+/******************************************************************************
+ Copyright (c) 2016-20 Leandro T. C. Melo (ltcmelo@gmail.com)
+
+ This library is free software; you can redistribute it and/or modify it under
+ the terms of the GNU Lesser General Public License as published by the Free
+ Software Foundation; either version 2.1 of the License, or (at your option)
+ any later version.
+
+ This library is distributed in the hope that it will be useful, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License
+ for more details.
+
+ You should have received a copy of the GNU Lesser General Public License along
+ with this library; if not, write to the Free Software Foundation, Inc., 51
+ Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA
+ *****************************************************************************/
+
+#ifndef PSYCHE_TEST_RANGE_ANALYSIS_H__
+#define PSYCHE_TEST_RANGE_ANALYSIS_H__
+
+#include "BaseTester.h"
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#define RANGE_ANALYSIS_TEST(F) TestData { &TestRangeAnalysis::F, #F }
+
+namespace psyche {
+
+/*!
+ * \brief The TestRangeAnalysis class
+ */
+class TestRangeAnalysis final : public BaseTester
+{
+public:
+    void testAll() override;
+
+private:
+    void testCase1();
+    void testCase2();
+    void testCase3();
+    void testCase4();
+    void testCase5();
+    void testCase6();
+    void testCase7();
+    void testCase8();
+    void testCase9();
+    void testCase10();
+    void testCase11();
+    void testCase12();
+    void testCase13();
+    void testCase14();
+    void testCase15();
+    void testCase16();
+    void testCase17();
+    void testCase18();
+    void testCase19();
+    void testCase20();
+
+    using TestData = std::pair<std::function<void(TestRangeAnalysis*)>, const char*>;
+
+    void checkRanges(const std::string& source, const std::string& expected);
+
+    /*!
+     * Check, for each loop head of the (first) function, in order, the
+     * number of edges into it that close the loop, and out of it.
+     */
+    void checkLoops(const std::string& source, const std::string& expected);
+
+    /*
+     * Add the name of all test functions to the vector below. Use the macro.
+     */
+    std::vector<TestData> tests_
+    {
+        RANGE_ANALYSIS_TEST(testCase1),
+        RANGE_ANALYSIS_TEST(testCase2),
+        RANGE_ANALYSIS_TEST(testCase3),
+        RANGE_ANALYSIS_TEST(testCase4),
+        RANGE_ANALYSIS_TEST(testCase5),
+        RANGE_ANALYSIS_TEST(testCase6),
+        RANGE_ANALYSIS_TEST(testCase7),
+        RANGE_ANALYSIS_TEST(testCase8),
+        RANGE_ANALYSIS_TEST(testCase9),
+        RANGE_ANALYSIS_TEST(testCase10),
+        RANGE_ANALYSIS_TEST(testCase11),
+        RANGE_ANALYSIS_TEST(testCase12),
+        RANGE_ANALYSIS_TEST(testCase13),
+        RANGE_ANALYSIS_TEST(testCase14),
+        RANGE_ANALYSIS_TEST(testCase15),
+        RANGE_ANALYSIS_TEST(testCase16),
+        RANGE_ANALYSIS_TEST(testCase17),
+        RANGE_ANALYSIS_TEST(testCase18),
+        RANGE_ANALYSIS_TEST(testCase19),
+        RANGE_ANALYSIS_TEST(testCase20),
+    };
+};
+
+} // namespace psyche
+
+#endif
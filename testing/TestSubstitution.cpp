@@ -0,0 +1,274 @@
+/******************************************************************************
+ Copyright (c) 2016-20 Leandro T. C. Melo (ltcmelo@gmail.com)
+
+ This library is free software; you can redistribute it and/or modify it under
+ the terms of the GNU Lesser General Public License as published by the Free
+ Software Foundation; either version 2.1 of the License, or (at your option)
+ any later version.
+
+ This library is distributed in the hope that it will be useful, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License
+ for more details.
+
+ You should have received a copy of the GNU Lesser General Public License along
+ with this library; if not, write to the Free Software Foundation, Inc., 51
+ Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA
+ *****************************************************************************/
+
+#include "TestSubstitution.h"
+#include <random>
+
+using namespace psyche;
+
+void TestSubstitution::testAll()
+{
+    run<TestSubstitution>(tests_);
+}
+
+std::string TestSubstitution::findReplace(const Substitution<std::string>& sub,
+                                          std::string input)
+{
+    std::string::size_type pos = 0;
+    while ((pos = input.find(sub.from(), pos)) != std::string::npos) {
+        input.replace(pos, sub.from().size(), sub.to());
+        pos += sub.to().size();
+    }
+    return input;
+}
+
+std::string TestSubstitution::findReplaceOnce(const Seq& seq, std::string input)
+{
+    std::string::size_type pos = 0;
+    for (const auto& sub : seq) {
+        if (sub == Substitution<std::string>::Trivial)
+            continue;
+
+        if ((pos = input.find(sub.from(), pos)) != std::string::npos) {
+            input.replace(pos, sub.from().size(), sub.to());
+            pos += sub.to().size();
+        }
+    }
+    return input;
+}
+
+std::string TestSubstitution::scanReplace(const Seq& seq, const std::string& input)
+{
+    std::string output;
+    std::string::size_type pos = 0;
+    while (pos < input.size()) {
+        auto sub = seq.end();
+        for (auto it = seq.begin(); it != seq.end(); ++it) {
+            if (!it->from().empty() && input.compare(pos, it->from().size(), it->from()) == 0) {
+                sub = it;
+                break;
+            }
+        }
+        if (sub == seq.end()) {
+            output += input[pos++];
+            continue;
+        }
+        output += sub->to();
+        pos += sub->from().size();
+    }
+    return output;
+}
+
+void TestSubstitution::testCase1()
+{
+    Substitution<std::string> sub("int", "long");
+    std::string input = "int f(int a) { return a; }";
+
+    PSYCHE_EXPECT_STR_EQ("long f(long a) { return a; }", apply(sub, input));
+    PSYCHE_EXPECT_STR_EQ(findReplace(sub, input), apply(sub, input));
+}
+
+void TestSubstitution::testCase2()
+{
+    // Replacements are not rescanned.
+    Substitution<std::string> sub("a", "aa");
+    std::string input = "banana";
+
+    PSYCHE_EXPECT_STR_EQ("baanaanaa", apply(sub, input));
+    PSYCHE_EXPECT_STR_EQ(findReplace(sub, input), apply(sub, input));
+}
+
+void TestSubstitution::testCase3()
+{
+    // Overlapping occurrences: the leftmost is taken, and the next search
+    // starts after it.
+    Substitution<std::string> sub("aa", "b");
+    std::string input = "aaaaa";
+
+    PSYCHE_EXPECT_STR_EQ("bba", apply(sub, input));
+    PSYCHE_EXPECT_STR_EQ(findReplace(sub, input), apply(sub, input));
+}
+
+void TestSubstitution::testCase4()
+{
+    Substitution<std::string> sub("aba", "X");
+    std::string input = "ababababa";
+
+    PSYCHE_EXPECT_STR_EQ("XbXba", apply(sub, input));
+    PSYCHE_EXPECT_STR_EQ(findReplace(sub, input), apply(sub, input));
+}
+
+void TestSubstitution::testCase5()
+{
+    Substitution<std::string> sub("xyz", "");
+
+    PSYCHE_EXPECT_STR_EQ("", apply(sub, std::string()));
+    PSYCHE_EXPECT_STR_EQ("xy", apply(sub, std::string("xy")));
+    PSYCHE_EXPECT_STR_EQ("", apply(sub, std::string("xyzxyz")));
+    PSYCHE_EXPECT_STR_EQ("ab", apply(sub, std::string("axyzb")));
+}
+
+void TestSubstitution::testCase6()
+{
+    // The trivial substitution leaves the input untouched.
+    std::string input = "abc";
+
+    PSYCHE_EXPECT_STR_EQ(input, apply(Substitution<std::string>::Trivial, input));
+    PSYCHE_EXPECT_STR_EQ(input, applyOnce(Substitution<std::string>::Trivial, input));
+}
+
+void TestSubstitution::testCase7()
+{
+    // An empty pattern never matches in apply (with find/replace, it would
+    // not terminate).
+    Seq seq { { "", "x" } };
+
+    PSYCHE_EXPECT_STR_EQ("abc", apply(seq, std::string("abc")));
+    PSYCHE_EXPECT_STR_EQ("", apply(seq, std::string()));
+    PSYCHE_EXPECT_STR_EQ("aYc", apply(Seq { { "", "x" }, { "b", "Y" } }, std::string("abc")));
+}
+
+void TestSubstitution::testCase8()
+{
+    // Leftmost first, regardless of the order in the sequence.
+    Seq seq { { "cd", "2" }, { "bc", "1" } };
+
+    PSYCHE_EXPECT_STR_EQ("a1d", apply(seq, std::string("abcd")));
+    PSYCHE_EXPECT_STR_EQ(scanReplace(seq, "abcd"), apply(seq, std::string("abcd")));
+}
+
+void TestSubstitution::testCase9()
+{
+    // At the same position, the earliest in the sequence, whether shorter or
+    // longer.
+    std::string input = "abcabc";
+
+    Seq shortFirst { { "ab", "1" }, { "abc", "2" } };
+    PSYCHE_EXPECT_STR_EQ("1c1c", apply(shortFirst, input));
+
+    Seq longFirst { { "abc", "2" }, { "ab", "1" } };
+    PSYCHE_EXPECT_STR_EQ("22", apply(longFirst, input));
+
+    Seq same { { "ab", "1" }, { "ab", "2" } };
+    PSYCHE_EXPECT_STR_EQ("1c1c", apply(same, input));
+}
+
+void TestSubstitution::testCase10()
+{
+    // A pattern within another that starts earlier is not taken.
+    Seq seq { { "b", "1" }, { "abc", "2" } };
+
+    PSYCHE_EXPECT_STR_EQ("2", apply(seq, std::string("abc")));
+    PSYCHE_EXPECT_STR_EQ("21", apply(seq, std::string("abcb")));
+    PSYCHE_EXPECT_STR_EQ("a1", apply(seq, std::string("ab")));
+}
+
+void TestSubstitution::testCase11()
+{
+    // Each once, in sequence, each after the previous replacement.
+    Seq seq { { "T", "int" }, { "T", "double" } };
+    std::string input = "T f(T a, T b);";
+
+    PSYCHE_EXPECT_STR_EQ("int f(double a, T b);", applyOnce(seq, input));
+    PSYCHE_EXPECT_STR_EQ(findReplaceOnce(seq, input), applyOnce(seq, input));
+}
+
+void TestSubstitution::testCase12()
+{
+    // A miss stops the rest, even of those that would be found.
+    Seq seq { { "b", "1" }, { "z", "2" }, { "c", "3" } };
+    std::string input = "abc";
+
+    PSYCHE_EXPECT_STR_EQ("a1c", applyOnce(seq, input));
+    PSYCHE_EXPECT_STR_EQ(findReplaceOnce(seq, input), applyOnce(seq, input));
+
+    // Also one found only before the previous replacement.
+    Seq back { { "c", "3" }, { "a", "1" }, { "b", "2" } };
+    PSYCHE_EXPECT_STR_EQ("ab3b", applyOnce(back, std::string("abcb")));
+    PSYCHE_EXPECT_STR_EQ(findReplaceOnce(back, "abcb"), applyOnce(back, std::string("abcb")));
+}
+
+void TestSubstitution::testCase13()
+{
+    // Trivial substitutions are skipped, not misses.
+    Seq seq { { "a", "1" }, Substitution<std::string>::Trivial, { "b", "2" } };
+    std::string input = "abab";
+
+    PSYCHE_EXPECT_STR_EQ("12ab", applyOnce(seq, input));
+    PSYCHE_EXPECT_STR_EQ(findReplaceOnce(seq, input), applyOnce(seq, input));
+}
+
+void TestSubstitution::testCase14()
+{
+    // An empty pattern is found where the previous replacement ended.
+    std::string input = "abc";
+
+    Seq seq { { "a", "1" }, { "", "_" }, { "c", "3" } };
+    PSYCHE_EXPECT_STR_EQ("1_b3", applyOnce(seq, input));
+    PSYCHE_EXPECT_STR_EQ(findReplaceOnce(seq, input), applyOnce(seq, input));
+
+    Seq first { { "", "_" } };
+    PSYCHE_EXPECT_STR_EQ("_abc", applyOnce(first, input));
+    PSYCHE_EXPECT_STR_EQ(findReplaceOnce(first, input), applyOnce(first, input));
+
+    Seq last { { "abc", "" }, { "", "_" } };
+    PSYCHE_EXPECT_STR_EQ("_", applyOnce(last, input));
+    PSYCHE_EXPECT_STR_EQ(findReplaceOnce(last, input), applyOnce(last, input));
+}
+
+void TestSubstitution::testCase15()
+{
+    // Overlapping patterns, each once.
+    std::string input = "aaaa";
+
+    Seq seq { { "aa", "b" }, { "aa", "c" }, { "a", "d" } };
+    PSYCHE_EXPECT_STR_EQ("bc", applyOnce(seq, input));
+    PSYCHE_EXPECT_STR_EQ(findReplaceOnce(seq, input), applyOnce(seq, input));
+
+    Seq self { { "a", "aa" }, { "a", "b" } };
+    PSYCHE_EXPECT_STR_EQ("aabaa", applyOnce(self, input));
+    PSYCHE_EXPECT_STR_EQ(findReplaceOnce(self, input), applyOnce(self, input));
+}
+
+void TestSubstitution::testCase16()
+{
+    // Against the references, over a small alphabet (so there is plenty of
+    // overlap).
+    std::mt19937 gen(20);
+    auto text = [&gen] (std::size_t max) {
+        std::string s(std::uniform_int_distribution<std::size_t>(0, max)(gen), ' ');
+        for (auto& c : s)
+            c = "abc"[std::uniform_int_distribution<int>(0, 2)(gen)];
+        return s;
+    };
+
+    for (auto i = 0; i < 2000; ++i) {
+        std::string input = text(16);
+        Seq seq;
+        auto cnt = std::uniform_int_distribution<int>(1, 4)(gen);
+        for (auto j = 0; j < cnt; ++j)
+            seq.emplace_back(text(3), text(3));
+
+        if (!seq[0].from().empty()) {
+            PSYCHE_EXPECT_STR_EQ(findReplace(seq[0], input), apply(seq[0], input));
+            PSYCHE_EXPECT_STR_EQ(findReplaceOnce({ seq[0] }, input), applyOnce(seq[0], input));
+        }
+        PSYCHE_EXPECT_STR_EQ(scanReplace(seq, input), apply(seq, input));
+        PSYCHE_EXPECT_STR_EQ(findReplaceOnce(seq, input), applyOnce(seq, input));
+    }
+}
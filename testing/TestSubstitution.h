@@ -0,0 +1,107 @@
+/******************************************************************************
+ Copyright (c) 2016-20 Leandro T. C. Melo (ltcmelo@gmail.com)
+
+ This library is free software; you can redistribute it and/or modify it under
+ the terms of the GNU Lesser General Public License as published by the Free
+ Software Foundation; either version 2.1 of the License, or (at your option)
+ any later version.
+
+ This library is distributed in the hope that it will be useful, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License
+ for more details.
+
+ You should have received a copy of the GNU Lesser General Public License along
+ with this library; if not, write to the Free Software Foundation, Inc., 51
+ Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA
+ *****************************************************************************/
+
+#ifndef PSYCHE_TEST_SUBSTITUTION_H__
+#define PSYCHE_TEST_SUBSTITUTION_H__
+
+#include "BaseTester.h"
+#include "Substitution.h"
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#define SUBSTITUTION_TEST(F) TestData { &TestSubstitution::F, #F }
+
+namespace psyche {
+
+/*!
+ * \brief The TestSubstitution class
+ *
+ * A single substitution, and a sequence applied once, are checked against
+ * plain find/replace; a sequence applied everywhere, against a brute-force scan.
+ */
+class TestSubstitution final : public BaseTester
+{
+public:
+    void testAll() override;
+
+private:
+    using Seq = std::vector<Substitution<std::string>>;
+
+    void testCase1();
+    void testCase2();
+    void testCase3();
+    void testCase4();
+    void testCase5();
+    void testCase6();
+    void testCase7();
+    void testCase8();
+    void testCase9();
+    void testCase10();
+    void testCase11();
+    void testCase12();
+    void testCase13();
+    void testCase14();
+    void testCase15();
+    void testCase16();
+
+    using TestData = std::pair<std::function<void(TestSubstitution*)>, const char*>;
+
+    /*!
+     * `apply' of a single (non-empty) substitution, by find/replace.
+     */
+    static std::string findReplace(const Substitution<std::string>& sub, std::string input);
+
+    /*!
+     * `applyOnce' of a sequence, by find/replace.
+     */
+    static std::string findReplaceOnce(const Seq& seq, std::string input);
+
+    /*!
+     * Leftmost-first, earliest in the sequence on ties, by brute force.
+     */
+    static std::string scanReplace(const Seq& seq, const std::string& input);
+
+    /*
+     * Add the name of all test functions to the vector below. Use the macro.
+     */
+    std::vector<TestData> tests_
+    {
+        SUBSTITUTION_TEST(testCase1),
+        SUBSTITUTION_TEST(testCase2),
+        SUBSTITUTION_TEST(testCase3),
+        SUBSTITUTION_TEST(testCase4),
+        SUBSTITUTION_TEST(testCase5),
+        SUBSTITUTION_TEST(testCase6),
+        SUBSTITUTION_TEST(testCase7),
+        SUBSTITUTION_TEST(testCase8),
+        SUBSTITUTION_TEST(testCase9),
+        SUBSTITUTION_TEST(testCase10),
+        SUBSTITUTION_TEST(testCase11),
+        SUBSTITUTION_TEST(testCase12),
+        SUBSTITUTION_TEST(testCase13),
+        SUBSTITUTION_TEST(testCase14),
+        SUBSTITUTION_TEST(testCase15),
+        SUBSTITUTION_TEST(testCase16),
+    };
+};
+
+} // namespace psyche
+
+#endif
@@ -0,0 +1,466 @@
+/******************************************************************************
+ Copyright (c) 2016-20 Leandro T. C. Melo (ltcmelo@gmail.com)
+
+ This library is free software; you can redistribute it and/or modify it under
+ the terms of the GNU Lesser General Public License as published by the Free
+ Software Foundation; either version 2.1 of the License, or (at your option)
+ any later version.
+
+ This library is distributed in the hope that it will be useful, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License
+ for more details.
+
+ You should have received a copy of the GNU Lesser General Public License along
+ with this library; if not, write to the Free Software Foundation, Inc., 51
+ Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA
+ *****************************************************************************/
+
+#include "TestVersionedMap.h"
+#include "VersionedMap.h"
+#include <cstddef>
+#include <map>
+#include <random>
+#include <set>
+#include <tuple>
+
+using namespace psyche;
+
+namespace {
+
+//! Every key collides, all the way down to the list below the last level.
+struct CollidingHash
+{
+    std::size_t operator()(int) const { return 0; }
+};
+
+//! Keys share the low bits (in groups of 4), so they split a few levels down.
+struct ClusteringHash
+{
+    std::size_t operator()(int key) const { return std::size_t(key % 4) << 20; }
+};
+
+template <class MapT>
+std::map<int, int> contents(const MapT& map)
+{
+    std::map<int, int> entries;
+    for (const auto& entry : map)
+        entries.insert(entry);
+    return entries;
+}
+
+template <class MapT>
+std::size_t distance(const MapT& map)
+{
+    std::size_t cnt = 0;
+    for (auto it = map.begin(); it != map.end(); ++it)
+        ++cnt;
+    return cnt;
+}
+
+template <class MapT>
+std::vector<int> order(const MapT& map)
+{
+    std::vector<int> keys;
+    for (const auto& entry : map)
+        keys.push_back(entry.first);
+    return keys;
+}
+
+//! Key, value in A (or -1 if absent), and value in B (likewise).
+using Delta = std::tuple<int, int, int>;
+
+template <class MapT>
+std::set<Delta> diff(const MapT& map, uint32_t revA, uint32_t revB)
+{
+    std::set<Delta> deltas;
+    map.diff(revA, revB, [&deltas] (int key, const int* a, const int* b) {
+        deltas.insert(Delta(key, a ? *a : -1, b ? *b : -1));
+    });
+    return deltas;
+}
+
+std::set<Delta> diff(const std::map<int, int>& a, const std::map<int, int>& b)
+{
+    std::set<Delta> deltas;
+    for (const auto& entry : a) {
+        auto it = b.find(entry.first);
+        if (it == b.end())
+            deltas.insert(Delta(entry.first, entry.second, -1));
+        else if (it->second != entry.second)
+            deltas.insert(Delta(entry.first, entry.second, it->second));
+    }
+    for (const auto& entry : b) {
+        if (!a.count(entry.first))
+            deltas.insert(Delta(entry.first, -1, entry.second));
+    }
+    return deltas;
+}
+
+/*!
+ * Insert and assign at random, from random revisions, and compare every
+ * revision against a plain map.
+ */
+template <class HashT>
+bool randomized(unsigned seed, int keys, int steps)
+{
+    std::mt19937 gen(seed);
+    VersionedMap<int, int, HashT> map;
+    std::vector<std::map<int, int>> models(1);
+
+    for (auto i = 0; i < steps; ++i) {
+        if (std::uniform_int_distribution<int>(0, 3)(gen) == 0) {
+            map.applyRevision(std::uniform_int_distribution<uint32_t>(0, models.size() - 1)(gen));
+        }
+        auto key = std::uniform_int_distribution<int>(0, keys - 1)(gen);
+        auto value = i; // Distinct, so that a distinct entry is a distinct value.
+        auto model = models[map.revision()];
+        model[key] = value;
+        map.insertOrAssign(key, value);
+        models.push_back(std::move(model));
+        if (map.revision() != models.size() - 1)
+            return false;
+    }
+
+    for (uint32_t rev = 0; rev < models.size(); ++rev) {
+        map.applyRevision(rev);
+        if (map.size() != models[rev].size()
+                || distance(map) != models[rev].size()
+                || contents(map) != models[rev]) {
+            return false;
+        }
+        for (auto key = 0; key < keys; ++key) {
+            auto it = map.find(key);
+            auto modelIt = models[rev].find(key);
+            if ((it == map.end()) != (modelIt == models[rev].end()))
+                return false;
+            if (it != map.end() && it->second != modelIt->second)
+                return false;
+        }
+    }
+
+    for (auto i = 0; i < 200; ++i) {
+        auto revA = std::uniform_int_distribution<uint32_t>(0, models.size() - 1)(gen);
+        auto revB = std::uniform_int_distribution<uint32_t>(0, models.size() - 1)(gen);
+        if (diff(map, revA, revB) != diff(models[revA], models[revB]))
+            return false;
+    }
+    return true;
+}
+
+} // anonymous
+
+void TestVersionedMap::testAll()
+{
+    run<TestVersionedMap>(tests_);
+}
+
+void TestVersionedMap::testCase1()
+{
+    VersionedMap<int, int> map;
+    PSYCHE_EXPECT_TRUE(map.empty());
+    PSYCHE_EXPECT_INT_EQ(0, map.revision());
+    PSYCHE_EXPECT_TRUE(map.begin() == map.end());
+    PSYCHE_EXPECT_TRUE(map.find(1) == map.end());
+
+    map.insertOrAssign(1, 10);
+    map.insertOrAssign(2, 20);
+    PSYCHE_EXPECT_INT_EQ(2, map.size());
+    PSYCHE_EXPECT_INT_EQ(10, map.find(1)->second);
+    PSYCHE_EXPECT_INT_EQ(20, map.find(2)->second);
+    PSYCHE_EXPECT_TRUE(map.find(3) == map.end());
+
+    // An assignment is a revision of its own, but doesn't grow the map.
+    auto rev = map.revision();
+    map.insertOrAssign(1, 11);
+    PSYCHE_EXPECT_INT_EQ(rev + 1, map.revision());
+    PSYCHE_EXPECT_INT_EQ(2, map.size());
+    PSYCHE_EXPECT_INT_EQ(11, map.find(1)->second);
+}
+
+void TestVersionedMap::testCase2()
+{
+    // Reverting to older revisions, including the empty one.
+    VersionedMap<int, int> map;
+    map.insertOrAssign(1, 10);
+    auto rev1 = map.revision();
+    map.insertOrAssign(2, 20);
+    auto rev2 = map.revision();
+    map.insertOrAssign(1, 11);
+    auto rev3 = map.revision();
+
+    map.applyRevision(rev1);
+    PSYCHE_EXPECT_INT_EQ(rev1, map.revision());
+    PSYCHE_EXPECT_INT_EQ(1, map.size());
+    PSYCHE_EXPECT_INT_EQ(10, map.find(1)->second);
+    PSYCHE_EXPECT_TRUE(map.find(2) == map.end());
+
+    map.applyRevision(rev2);
+    PSYCHE_EXPECT_INT_EQ(2, map.size());
+    PSYCHE_EXPECT_INT_EQ(10, map.find(1)->second);
+    PSYCHE_EXPECT_INT_EQ(20, map.find(2)->second);
+
+    map.applyRevision(0);
+    PSYCHE_EXPECT_TRUE(map.empty());
+    PSYCHE_EXPECT_TRUE(map.begin() == map.end());
+
+    map.applyRevision(rev3);
+    PSYCHE_EXPECT_INT_EQ(11, map.find(1)->second);
+
+    // Lookups into a revision other than the current one.
+    PSYCHE_EXPECT_INT_EQ(10, map.find(1, rev1)->second);
+    PSYCHE_EXPECT_TRUE(map.find(2, rev1) == map.end());
+    PSYCHE_EXPECT_INT_EQ(rev3, map.revision());
+}
+
+void TestVersionedMap::testCase3()
+{
+    // Extending an older revision leaves the newer ones intact.
+    VersionedMap<int, int> map;
+    map.insertOrAssign(1, 10);
+    auto base = map.revision();
+    map.insertOrAssign(2, 20);
+    map.insertOrAssign(1, 11);
+    auto left = map.revision();
+
+    map.applyRevision(base);
+    map.insertOrAssign(3, 30);
+    auto right = map.revision();
+    PSYCHE_EXPECT_TRUE(right > left);
+    PSYCHE_EXPECT_INT_EQ(2, map.size());
+    PSYCHE_EXPECT_INT_EQ(10, map.find(1)->second);
+    PSYCHE_EXPECT_TRUE(map.find(2) == map.end());
+
+    map.applyRevision(left);
+    PSYCHE_EXPECT_INT_EQ(2, map.size());
+    PSYCHE_EXPECT_INT_EQ(11, map.find(1)->second);
+    PSYCHE_EXPECT_INT_EQ(20, map.find(2)->second);
+    PSYCHE_EXPECT_TRUE(map.find(3) == map.end());
+}
+
+void TestVersionedMap::testCase4()
+{
+    // Iteration and size, per revision, once the trie is a few levels deep.
+    VersionedMap<int, int> map;
+    std::vector<std::map<int, int>> models(1);
+    for (auto i = 0; i < 2000; ++i) {
+        map.insertOrAssign(i * 7, i);
+        models.push_back(models.back());
+        models.back()[i * 7] = i;
+    }
+
+    for (auto rev : { 0u, 1u, 31u, 32u, 33u, 1000u, 2000u }) {
+        map.applyRevision(rev);
+        PSYCHE_EXPECT_INT_EQ(models[rev].size(), map.size());
+        PSYCHE_EXPECT_INT_EQ(models[rev].size(), distance(map));
+        PSYCHE_EXPECT_TRUE(contents(map) == models[rev]);
+    }
+}
+
+void TestVersionedMap::testCase5()
+{
+    // The order of iteration depends only on the keys, not on the revision,
+    // nor on the order of insertion.
+    VersionedMap<int, int> map;
+    for (auto i = 0; i < 300; ++i)
+        map.insertOrAssign(i, i);
+    auto forward = map.revision();
+    auto keys = order(map);
+    PSYCHE_EXPECT_INT_EQ(300, keys.size());
+    PSYCHE_EXPECT_INT_EQ(300, std::set<int>(keys.begin(), keys.end()).size());
+
+    for (auto i = 0; i < 300; ++i)
+        map.insertOrAssign(i, -i);
+    PSYCHE_EXPECT_TRUE(keys == order(map));
+
+    VersionedMap<int, int> other;
+    for (auto i = 299; i >= 0; --i)
+        other.insertOrAssign(i, i);
+    PSYCHE_EXPECT_TRUE(keys == order(other));
+
+    map.applyRevision(forward);
+    PSYCHE_EXPECT_TRUE(keys == order(map));
+    PSYCHE_EXPECT_TRUE(keys == order(map));
+}
+
+void TestVersionedMap::testCase6()
+{
+    // All keys collide.
+    VersionedMap<int, int, CollidingHash> map;
+    for (auto i = 0; i < 10; ++i)
+        map.insertOrAssign(i, i * 10);
+    auto full = map.revision();
+    PSYCHE_EXPECT_INT_EQ(10, map.size());
+    PSYCHE_EXPECT_INT_EQ(10, distance(map));
+    for (auto i = 0; i < 10; ++i)
+        PSYCHE_EXPECT_INT_EQ(i * 10, map.find(i)->second);
+    PSYCHE_EXPECT_TRUE(map.find(10) == map.end());
+
+    map.insertOrAssign(4, 44);
+    PSYCHE_EXPECT_INT_EQ(10, map.size());
+    PSYCHE_EXPECT_INT_EQ(44, map.find(4)->second);
+    PSYCHE_EXPECT_INT_EQ(40, map.find(4, full)->second);
+
+    map.applyRevision(3);
+    PSYCHE_EXPECT_INT_EQ(3, map.size());
+    PSYCHE_EXPECT_TRUE(contents(map) == (std::map<int, int>{ { 0, 0 }, { 1, 10 }, { 2, 20 } }));
+    PSYCHE_EXPECT_TRUE(map.find(3) == map.end());
+}
+
+void TestVersionedMap::testCase7()
+{
+    // Diff of collisions.
+    VersionedMap<int, int, CollidingHash> map;
+    for (auto i = 0; i < 5; ++i)
+        map.insertOrAssign(i, i);
+    auto base = map.revision();
+    map.insertOrAssign(1, 100);
+    map.insertOrAssign(7, 7);
+    auto left = map.revision();
+    map.applyRevision(base);
+    map.insertOrAssign(3, 300);
+    auto right = map.revision();
+
+    std::set<Delta> expected { Delta(1, 100, 1), Delta(3, 3, 300), Delta(7, 7, -1) };
+    PSYCHE_EXPECT_TRUE(diff(map, left, right) == expected);
+    PSYCHE_EXPECT_TRUE(diff(map, base, base).empty());
+}
+
+void TestVersionedMap::testCase8()
+{
+    // Diff of identical and of empty revisions.
+    VersionedMap<int, int> map;
+    PSYCHE_EXPECT_TRUE(diff(map, 0, 0).empty());
+
+    for (auto i = 0; i < 100; ++i)
+        map.insertOrAssign(i, i);
+    auto rev = map.revision();
+    PSYCHE_EXPECT_TRUE(diff(map, rev, rev).empty());
+
+    auto deltas = diff(map, 0, rev);
+    PSYCHE_EXPECT_INT_EQ(100, deltas.size());
+    PSYCHE_EXPECT_TRUE(deltas.count(Delta(42, -1, 42)));
+    PSYCHE_EXPECT_TRUE(diff(map, rev, 0).count(Delta(42, 42, -1)));
+}
+
+void TestVersionedMap::testCase9()
+{
+    // Diff of branches that share most of the trie: only what changed since
+    // they diverged is visited.
+    VersionedMap<int, int> map;
+    for (auto i = 0; i < 5000; ++i)
+        map.insertOrAssign(i, i);
+    auto base = map.revision();
+
+    map.insertOrAssign(10, -10);
+    map.insertOrAssign(5000, 5000);
+    auto left = map.revision();
+
+    map.applyRevision(base);
+    map.insertOrAssign(20, -20);
+    map.insertOrAssign(10, -10); // Same value, but a distinct entry.
+    auto right = map.revision();
+
+    std::set<Delta> expected {
+        Delta(10, -10, -10),
+        Delta(20, 20, -20),
+        Delta(5000, 5000, -1)
+    };
+    PSYCHE_EXPECT_TRUE(diff(map, left, right) == expected);
+
+    // Against the base, from either side.
+    PSYCHE_EXPECT_TRUE(diff(map, base, left) == (std::set<Delta>{ Delta(10, 10, -10), Delta(5000, -1, 5000) }));
+    PSYCHE_EXPECT_TRUE(diff(map, right, base) == (std::set<Delta>{ Delta(10, -10, 10), Delta(20, -20, 20) }));
+}
+
+void TestVersionedMap::testCase10()
+{
+    // Diff of branches that diverge throughout: a subtrie on one side and an
+    // entry (or nothing) on the other, at several levels.
+    VersionedMap<int, int, ClusteringHash> map;
+    map.insertOrAssign(0, 0);
+    map.insertOrAssign(1, 1);
+    auto base = map.revision();
+    for (auto i = 2; i < 40; ++i)
+        map.insertOrAssign(i, i);
+    auto left = map.revision();
+
+    map.applyRevision(base);
+    map.insertOrAssign(0, -1);
+    for (auto i = 40; i < 60; i += 4)
+        map.insertOrAssign(i, i);
+    auto right = map.revision();
+
+    std::map<int, int> modelLeft, modelRight { { 0, -1 }, { 1, 1 } };
+    for (auto i = 0; i < 40; ++i)
+        modelLeft[i] = i;
+    for (auto i = 40; i < 60; i += 4)
+        modelRight[i] = i;
+
+    PSYCHE_EXPECT_TRUE(contents((map.applyRevision(left), map)) == modelLeft);
+    PSYCHE_EXPECT_TRUE(contents((map.applyRevision(right), map)) == modelRight);
+    PSYCHE_EXPECT_TRUE(diff(map, left, right) == diff(modelLeft, modelRight));
+    PSYCHE_EXPECT_TRUE(diff(map, right, left) == diff(modelRight, modelLeft));
+}
+
+void TestVersionedMap::testCase11()
+{
+    // Against plain maps, with random revisions, for well-distributed,
+    // clustering, and colliding hashes.
+    PSYCHE_EXPECT_TRUE(randomized<std::hash<int>>(1, 500, 3000));
+    PSYCHE_EXPECT_TRUE(randomized<ClusteringHash>(2, 200, 2000));
+    PSYCHE_EXPECT_TRUE(randomized<CollidingHash>(3, 20, 500));
+}
+
+void TestVersionedMap::testCase12()
+{
+    // The pattern of the range analysis at if statements: take a revision,
+    // extend it in one arm, revert to it, and extend it in the other. (For
+    // timings, with joins and against a replayed log, see versionedmap-bench.)
+    VersionedMap<int, int> map;
+    const int kBranches = 16000;
+    for (auto i = 0; i < kBranches; ++i) {
+        auto rev = map.revision();
+        map.insertOrAssign(2 * i, i);
+        map.insertOrAssign(2 * i + 1, i);
+        map.applyRevision(rev);
+        map.insertOrAssign(2 * i, -i);
+        map.insertOrAssign(2 * i + 1, -i);
+    }
+    PSYCHE_EXPECT_INT_EQ(2 * kBranches, map.size());
+    PSYCHE_EXPECT_INT_EQ(-(kBranches - 1), map.find(2 * kBranches - 1)->second);
+    PSYCHE_EXPECT_INT_EQ(4 * kBranches, map.revision());
+}
+
+void TestVersionedMap::testCase13()
+{
+    // Dropping all but a few revisions: the kept ones are renumbered in
+    // place, and still see the same entries.
+    VersionedMap<int, int> map;
+    std::vector<uint32_t> kept;
+    for (auto i = 0; i < 100; ++i) {
+        map.insertOrAssign(i, i);
+        if (i % 25 == 0)
+            kept.push_back(map.revision());
+    }
+    kept.push_back(kept.front());
+    kept.push_back(0);
+    map.insertOrAssign(0, -1);
+    PSYCHE_EXPECT_INT_EQ(102, map.revisionCount());
+
+    map.retainRevisions(kept);
+    PSYCHE_EXPECT_INT_EQ(6, map.revisionCount());
+    PSYCHE_EXPECT_INT_EQ(1, map.revision());
+    PSYCHE_EXPECT_INT_EQ(100, map.size());
+    PSYCHE_EXPECT_INT_EQ(-1, map.find(0)->second);
+
+    PSYCHE_EXPECT_TRUE(kept == std::vector<uint32_t>({ 2, 3, 4, 5, 2, 0 }));
+    for (auto i = 0; i < 4; ++i) {
+        map.applyRevision(kept[i]);
+        PSYCHE_EXPECT_INT_EQ(i * 25 + 1, map.size());
+        PSYCHE_EXPECT_INT_EQ(0, map.find(0)->second);
+        PSYCHE_EXPECT_TRUE(map.find(i * 25 + 1) == map.end());
+    }
+    map.applyRevision(0);
+    PSYCHE_EXPECT_TRUE(map.empty());
+}
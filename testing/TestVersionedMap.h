@@ -0,0 +1,79 @@
+/******************************************************************************
+ Copyright (c) 2016-20 Leandro T. C. Melo (ltcmelo@gmail.com)
+
+ This library is free software; you can redistribute it and/or modify it under
+ the terms of the GNU Lesser General Public License as published by the Free
+ Software Foundation; either version 2.1 of the License, or (at your option)
+ any later version.
+
+ This library is distributed in the hope that it will be useful, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License
+ for more details.
+
+ You should have received a copy of the GNU Lesser General Public License along
+ with this library; if not, write to the Free Software Foundation, Inc., 51
+ Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA
+ *****************************************************************************/
+
+#ifndef PSYCHE_TEST_VERSIONED_MAP_H__
+#define PSYCHE_TEST_VERSIONED_MAP_H__
+
+#include "BaseTester.h"
+#include <functional>
+#include <utility>
+#include <vector>
+
+#define VERSIONED_MAP_TEST(F) TestData { &TestVersionedMap::F, #F }
+
+namespace psyche {
+
+/*!
+ * \brief The TestVersionedMap class
+ */
+class TestVersionedMap final : public BaseTester
+{
+public:
+    void testAll() override;
+
+private:
+    void testCase1();
+    void testCase2();
+    void testCase3();
+    void testCase4();
+    void testCase5();
+    void testCase6();
+    void testCase7();
+    void testCase8();
+    void testCase9();
+    void testCase10();
+    void testCase11();
+    void testCase12();
+    void testCase13();
+
+    using TestData = std::pair<std::function<void(TestVersionedMap*)>, const char*>;
+
+    /*
+     * Add the name of all test functions to the vector below. Use the macro.
+     */
+    std::vector<TestData> tests_
+    {
+        VERSIONED_MAP_TEST(testCase1),
+        VERSIONED_MAP_TEST(testCase2),
+        VERSIONED_MAP_TEST(testCase3),
+        VERSIONED_MAP_TEST(testCase4),
+        VERSIONED_MAP_TEST(testCase5),
+        VERSIONED_MAP_TEST(testCase6),
+        VERSIONED_MAP_TEST(testCase7),
+        VERSIONED_MAP_TEST(testCase8),
+        VERSIONED_MAP_TEST(testCase9),
+        VERSIONED_MAP_TEST(testCase10),
+        VERSIONED_MAP_TEST(testCase11),
+        VERSIONED_MAP_TEST(testCase12),
+        VERSIONED_MAP_TEST(testCase13),
+    };
+};
+
+} // namespace psyche
+
+#endif
@@ -0,0 +1,127 @@
+/******************************************************************************
+ * Copyright (c) 2016 Leandro T. C. Melo (ltcmelo@gmail.com)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ * USA
+ *****************************************************************************/
+
+#include "BinaryConstraintReader.h"
+#include "BinaryConstraintWriter.h"
+#include "ConstraintWriter.h"
+#include "IO.h"
+#include "TextConstraintReader.h"
+#include "cxxopts.hpp"
+
+#include <iostream>
+#include <sstream>
+
+using namespace psyche;
+
+namespace {
+
+const char* const kConvertPrefix = "cstr-convert: ";
+
+/*
+ * Convert textual constraints into binary ones. The conversion is checked by
+ * reading the result back into text: if it doesn't match (the text isn't laid
+ * out as the generator writes it), the text is kept verbatim.
+ */
+std::string toBinary(const std::string& text)
+{
+    std::ostringstream oss;
+    bool ok;
+    {
+        BinaryConstraintWriter writer(oss);
+        TextConstraintReader reader(text);
+        ok = reader.replay(&writer);
+        if (!ok)
+            std::cerr << kConvertPrefix << reader.error() << std::endl;
+    }
+
+    if (ok) {
+        std::ostringstream check;
+        ConstraintWriter writer(check);
+        ok = BinaryConstraintReader(oss.str()).replay(&writer) && check.str() == text;
+        if (ok)
+            return oss.str();
+    }
+
+    std::cerr << kConvertPrefix << "input not in generator's layout, kept verbatim" << std::endl;
+    std::ostringstream verbatim;
+    BinaryConstraintWriter writer(verbatim);
+    writer.writeText(text);
+    return verbatim.str();
+}
+
+bool toText(const std::string& data, std::string& text)
+{
+    std::ostringstream oss;
+    ConstraintWriter writer(oss);
+    BinaryConstraintReader reader(data);
+    if (!reader.replay(&writer)) {
+        std::cerr << kConvertPrefix << reader.error() << std::endl;
+        return false;
+    }
+    text = oss.str();
+    return true;
+}
+
+} // anonymous
+
+int main(int argc, char* argv[])
+{
+    cxxopts::Options options(argv[0], "PsycheC constraints converter (text <-> binary)");
+    try {
+        options.positional_help("file");
+        options.add_options()
+            ("h,help", "Print help")
+            ("o,output", "Specify output file (default is the standard output)",
+                cxxopts::value<std::string>())
+            ("positional", "Positional arguments",
+                cxxopts::value<std::vector<std::string>>());
+        options.parse_positional(std::vector<std::string>{"file", "positional"});
+        options.parse(argc, argv);
+    }
+    catch (const cxxopts::OptionException& e) {
+        std::cerr << kConvertPrefix << e.what() << std::endl;
+        return 1;
+    }
+
+    if (options.count("help")) {
+        std::cout << options.help({""}) << std::endl;
+        return 0;
+    }
+
+    if (!options.count("positional")) {
+        std::cerr << kConvertPrefix << "unspecified input file" << std::endl;
+        return 1;
+    }
+
+    const std::string& in = readFile(options["positional"].as<std::vector<std::string>>()[0]);
+    std::string out;
+    if (BinaryConstraintReader::isBinary(in)) {
+        if (!toText(in, out))
+            return 1;
+    } else {
+        out = toBinary(in);
+    }
+
+    if (options.count("output"))
+        writeFile(options["output"].as<std::string>(), out);
+    else
+        std::cout << out;
+
+    return 0;
+}
@@ -29,7 +29,10 @@ using namespace psyche;
 ProgramValidator::ProgramValidator(TranslationUnit *unit, bool forbidTypeDecl)
     : ASTVisitor(unit)
     , forbidTypeDecl_(forbidTypeDecl)
-{}
+    , violations_(0)
+{
+    enableIterativeTraversal();
+}
 
 void ProgramValidator::validate(TranslationUnitAST* ast)
 {
@@ -47,21 +50,15 @@ bool ProgramValidator::checksRegistered() const
 
 bool ProgramValidator::visit(FunctionDefinitionAST* ast)
 {
+    // Only the body of a function is validated.
     accept(ast->function_body);
 
     return false;
 }
 
-bool ProgramValidator::visit(CompoundStatementAST* ast)
-{
-    for (StatementListAST* it = ast->statement_list; it; it = it->next)
-        accept(it->value);
-
-    return false;
-}
-
 bool ProgramValidator::visit(SimpleDeclarationAST* ast)
 {
+    // Only the specifiers of a declaration are validated.
     for (SpecifierListAST* it = ast->decl_specifier_list; it; it = it->next)
         accept(it->value);
 
@@ -73,6 +70,7 @@ bool ProgramValidator::visit(ClassSpecifierAST* ast)
     if (forbidTypeDecl_) {
         translationUnit()->error(ast->firstToken(),
                                  "struct or union not allowed in this mode");
+        ++violations_;
     }
 
     return false;
@@ -83,6 +81,7 @@ bool ProgramValidator::visit(SimpleSpecifierAST* ast)
     if (forbidTypeDecl_
             && tokenKind(ast->specifier_token) == T_TYPEDEF) {
         translationUnit()->error(ast->firstToken(), "typedef not allowed in this mode");
+        ++violations_;
     }
 
     return false;
@@ -31,21 +31,23 @@ public:
 
     void validate(psyche::TranslationUnitAST* ast);
 
-private:
+    //! Whether there's any check to be performed.
     bool checksRegistered() const;
 
+    //! Number of violations reported (as errors) in the translation unit.
+    unsigned violations() const { return violations_; }
+
+private:
     // Declarations
     bool visit(psyche::FunctionDefinitionAST* ast) override;
     bool visit(psyche::SimpleDeclarationAST* ast) override;
 
-    // Statements
-    bool visit(psyche::CompoundStatementAST* ast) override;
-
     // Specifiers
     bool visit(psyche::ClassSpecifierAST* ast) override;
     bool visit(psyche::SimpleSpecifierAST* ast) override;
 
     bool forbidTypeDecl_;
+    unsigned violations_;
 };
 
 } // namespace psyche
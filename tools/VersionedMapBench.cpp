@@ -0,0 +1,196 @@
+/******************************************************************************
+ * Copyright (c) 2016 Leandro T. C. Melo (ltcmelo@gmail.com)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ * USA
+ *****************************************************************************/
+
+#include "VersionedMap.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <unordered_map>
+#include <vector>
+
+using namespace psyche;
+
+namespace {
+
+/*
+ * The states of a function with a chain of if-else statements, as the range
+ * analysis computes them: at each branch, take a revision, assign a few
+ * variables in one arm, revert, assign them in the other arm, and join both
+ * arms (by their differences) at the merge point.
+ */
+const int kVariables = 64;
+const int kAssignsPerArm = 4;
+
+template <class MapT>
+std::size_t runBranches(MapT& map, int count)
+{
+    for (auto var = 0; var < kVariables; ++var)
+        map.insertOrAssign(var, 0);
+
+    std::size_t joined = 0;
+    for (auto i = 0; i < count; ++i) {
+        const auto base = map.revision();
+        for (auto k = 0; k < kAssignsPerArm; ++k)
+            map.insertOrAssign((i * 7 + k) % kVariables, i);
+        const auto then = map.revision();
+
+        map.applyRevision(base);
+        for (auto k = 0; k < kAssignsPerArm; ++k)
+            map.insertOrAssign((i * 11 + k) % kVariables, -i);
+        const auto other = map.revision();
+
+        std::vector<std::pair<int, int>> merged;
+        map.diff(then, other, [&merged] (int var, const int* a, const int* b) {
+            merged.emplace_back(var, std::max(a ? *a : 0, b ? *b : 0));
+        });
+        map.applyRevision(then);
+        for (const auto& it : merged)
+            map.insertOrAssign(it.first, it.second);
+        joined += merged.size();
+    }
+    return joined;
+}
+
+/*
+ * What VersionedMap was before it became a trie: a log of assignments, which
+ * is replayed from the beginning to apply a revision, and compared entry by
+ * entry to diff two of them.
+ */
+class ReplayedMap
+{
+public:
+    void insertOrAssign(int key, int value)
+    {
+        log_.push_back({ key, value, curRevision_ });
+        curRevision_ = log_.size();
+        map_[key] = value;
+    }
+
+    uint32_t revision() const { return curRevision_; }
+
+    void applyRevision(uint32_t revision)
+    {
+        curRevision_ = revision;
+        map_ = replay(revision);
+    }
+
+    template <class VisitorT>
+    void diff(uint32_t revisionA, uint32_t revisionB, VisitorT visitor) const
+    {
+        const auto a = replay(revisionA);
+        const auto b = replay(revisionB);
+        for (const auto& it : a) {
+            auto other = b.find(it.first);
+            if (other == b.end())
+                visitor(it.first, &it.second, nullptr);
+            else if (other->second != it.second)
+                visitor(it.first, &it.second, &other->second);
+        }
+        for (const auto& it : b) {
+            if (!a.count(it.first))
+                visitor(it.first, nullptr, &it.second);
+        }
+    }
+
+private:
+    struct Command
+    {
+        int key_;
+        int value_;
+        uint32_t prev_;
+    };
+
+    std::unordered_map<int, int> replay(uint32_t revision) const
+    {
+        std::vector<const Command*> chain;
+        for (; revision; revision = log_[revision - 1].prev_)
+            chain.push_back(&log_[revision - 1]);
+        std::unordered_map<int, int> map;
+        for (auto it = chain.rbegin(); it != chain.rend(); ++it)
+            map[(*it)->key_] = (*it)->value_;
+        return map;
+    }
+
+    std::vector<Command> log_;
+    std::unordered_map<int, int> map_;
+    uint32_t curRevision_ { 0 };
+};
+
+template <class MapT>
+double timed(MapT& map, int count)
+{
+    const auto start = std::chrono::steady_clock::now();
+    volatile auto joined = runBranches(map, count);
+    (void) joined;
+    const std::chrono::duration<double, std::milli> elapsed =
+            std::chrono::steady_clock::now() - start;
+    return elapsed.count();
+}
+
+} // anonymous
+
+/*
+ * Usage: versionedmap-bench [branches...]
+ *
+ * Time the branch workload above on VersionedMap and on a replayed log, for
+ * each number of branches. The replayed log is quadratic, so it's skipped
+ * beyond a few thousand branches.
+ */
+int main(int argc, char* argv[])
+{
+    std::vector<int> counts;
+    for (auto i = 1; i < argc; ++i)
+        counts.push_back(std::atoi(argv[i]));
+    if (counts.empty())
+        counts = { 1000, 2000, 4000, 8000, 16000 };
+
+    const int kReplayLimit = 2000;
+
+    std::cout << std::setw(9) << "branches"
+              << std::setw(12) << "trie (ms)"
+              << std::setw(12) << "revisions"
+              << std::setw(12) << "retained"
+              << std::setw(14) << "replay (ms)" << std::endl;
+    for (auto count : counts) {
+        VersionedMap<int, int> map;
+        const auto trie = timed(map, count);
+        const auto revisions = map.revisionCount();
+        std::vector<uint32_t> none;
+        map.retainRevisions(none);
+
+        std::cout << std::fixed << std::setprecision(1)
+                  << std::setw(9) << count
+                  << std::setw(12) << trie
+                  << std::setw(12) << revisions
+                  << std::setw(12) << map.revisionCount();
+        if (count <= kReplayLimit) {
+            ReplayedMap replayed;
+            std::cout << std::setw(14) << timed(replayed, count);
+        } else {
+            std::cout << std::setw(14) << "-";
+        }
+        std::cout << std::endl;
+    }
+
+    return 0;
+}